@@ -0,0 +1,79 @@
+#ifndef ACCESS_PATTERN_H
+#define ACCESS_PATTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "perf_counters.h"
+#include "profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Traversal kernels over the data of a Matrix. Each kernel loads doubles
+// in a given order and returns their sum (four independent accumulators,
+// so the add chain does not hide the memory system):
+// - row major: m[i][j] with j fastest (unit stride)
+// - column major: m[i][j] with i fastest (stride of cols elements)
+// - stride: the flat array with a fixed element stride, repeated from each
+//   offset so that every element is loaded once per pass
+// - page stride: one line per page over the first `pages` pages, the line
+//   shifted by one per page so the loads do not all fall into one cache
+//   set; cost rises once the pages exceed the reach of each TLB level
+// - random gather: every element once, in a random order
+
+typedef enum {
+    ACCESS_ROW_MAJOR = 0,
+    ACCESS_COLUMN_MAJOR,
+    ACCESS_STRIDE,
+    ACCESS_PAGE_STRIDE,
+    ACCESS_RANDOM_GATHER
+} AccessPattern;
+
+// Result of one pattern (times are for the best pass)
+typedef struct {
+    AccessPattern pattern;
+    size_t param;           // stride in elements / pages touched (0 otherwise)
+    size_t accesses;        // loads per pass
+    double ms;
+    double ns_per_access;
+    double gbs;             // 8 bytes per load / time
+    double checksum;
+    uint64_t counters[PERF_COUNTER_COUNT];  // per pass (0 if unavailable)
+} AccessResult;
+
+double access_sum_row_major(const Matrix* m);
+double access_sum_column_major(const Matrix* m);
+double access_sum_stride(const Matrix* m, size_t stride);
+
+// rounds passes over the pages; pages must not exceed access_page_count(m)
+double access_sum_page_stride(const Matrix* m, size_t pages, size_t rounds);
+
+// Sum of data[indices[k]] for k in [0, count)
+double access_sum_gather(const Matrix* m, const size_t* indices, size_t count);
+
+// Fill indices with a random permutation of [0, count)
+void access_random_permutation(size_t* indices, size_t count, uint64_t seed);
+
+// System page size and the number of whole pages in the matrix data
+size_t access_page_size(void);
+size_t access_page_count(const Matrix* m);
+
+// Run a pattern iterations times (one untimed warm-up first), timing each
+// pass under a profiler section ("access_stride_64", ...) when profiler is
+// not NULL and reading counters when counters is not NULL.
+// param: stride (ACCESS_STRIDE) or pages (ACCESS_PAGE_STRIDE), ignored otherwise.
+// Page-stride passes repeat the pages to make about one load per element.
+// Returns 0 on success, -1 on invalid arguments or allocation failure
+int access_run(const Matrix* m, AccessPattern pattern, size_t param, int iterations,
+               PerfCounters* counters, Profiler* profiler, AccessResult* result);
+
+// Pattern name ("row_major", "column_major", "stride", "page_stride", "random_gather")
+const char* access_pattern_name(AccessPattern pattern);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACCESS_PATTERN_H
@@ -0,0 +1,66 @@
+#ifndef ANTAGONIST_H
+#define ANTAGONIST_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Noisy-neighbour antagonist threads.
+//
+// Background threads that compete with a kernel for the shared levels of
+// the memory hierarchy, the way other tenants of a machine do:
+// - cache: each thread increments one double per cache line of its own
+//   working set, round and round. With the set about the size of the L3 it
+//   keeps evicting the kernel's lines from the shared cache
+// - bandwidth: each thread copies between two arrays much larger than the
+//   L3 (STREAM copy), taking a share of the DRAM bandwidth
+//
+// The threads run until stopped; time a kernel in between. Antagonists
+// only contend for cache and memory when they have cores of their own, so
+// use fewer than the number of cores (see antagonists_start's pin).
+//
+// C++ library only (the threads use std::thread).
+
+typedef enum {
+    ANTAGONIST_CACHE = 0,
+    ANTAGONIST_BANDWIDTH
+} AntagonistKind;
+
+#define ANTAGONIST_KIND_COUNT 2
+
+typedef struct Antagonists Antagonists;
+
+// Start count threads of a kind, each with its own working set of
+// working_set_bytes (0 = antagonist_default_working_set). Returns once
+// every thread has touched its buffers and is running.
+// pin != 0 pins thread i to CPU (cpus - 1 - i) mod cpus, keeping CPU 0
+// free for the measured kernel (Linux only, ignored elsewhere).
+// Returns NULL on invalid arguments or allocation failure
+Antagonists* antagonists_start(AntagonistKind kind, int count, size_t working_set_bytes, int pin);
+
+// Stop and join the threads and free the handle
+// Returns the traffic the antagonists generated while running in GB/s
+// (a line read and written per cache increment, 16 bytes per copied
+// double), or a negative value for NULL
+double antagonists_stop(Antagonists* antagonists);
+
+// Working set per thread: the L3 size for cache, four times the L3
+// (64 MB .. 256 MB per array pair) for bandwidth
+size_t antagonist_default_working_set(AntagonistKind kind);
+
+// Pin the calling thread to one CPU (Linux only)
+// Returns 0 on success, -1 on failure or where unsupported
+int antagonist_pin_current_thread(int cpu);
+
+// Kind name ("cache", "bandwidth") and the reverse lookup
+// antagonist_kind_from_name returns 0 on success, -1 for an unknown name
+const char* antagonist_kind_name(AntagonistKind kind);
+int antagonist_kind_from_name(const char* name, AntagonistKind* kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANTAGONIST_H
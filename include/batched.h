@@ -0,0 +1,69 @@
+#ifndef BATCHED_H
+#define BATCHED_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Batched GEMM for many small matrices: C[b] = A[b] * B[b] for every b.
+ *
+ * Validation, thread start-up and scheduling are paid once per batch
+ * instead of once per product; worker threads split the batch dimension.
+ * All kernels overwrite C (no separate zeroing pass).
+ */
+
+/**
+ * Pointer-array batch. Each entry may have its own shape.
+ *
+ * @param A,B,C Arrays of batch_count matrices (A[b] is M x N, B[b] N x P, C[b] M x P)
+ * @param batch_count Number of products
+ * @param num_threads Number of threads (0 = auto-detect)
+ * @return 0 on success, -1 if any entry is NULL or has mismatched dimensions
+ */
+int matrix_multiply_batched(Matrix** A, Matrix** B, Matrix** C,
+                            int batch_count, int num_threads);
+
+/**
+ * Strided batch: all products share M, N, P; matrix b of A starts at
+ * A + b * stride_a (row-major, dense), likewise for B and C.
+ *
+ * @return 0 on success, -1 on invalid arguments
+ */
+int matrix_multiply_batched_strided(int M, int N, int P,
+                                    const double* A, size_t stride_a,
+                                    const double* B, size_t stride_b,
+                                    double* C, size_t stride_c,
+                                    int batch_count, int num_threads);
+
+/**
+ * Interleaved (batch-innermost) batch: element (r, c) of matrix b is stored
+ * at X[(r * cols + c) * batch_count + b]. The inner loop runs over the batch
+ * dimension with unit stride, so it vectorises for any M, N, P.
+ *
+ * @return 0 on success, -1 on invalid arguments
+ */
+int matrix_multiply_batched_interleaved(int M, int N, int P,
+                                        const double* A, const double* B, double* C,
+                                        int batch_count, int num_threads);
+
+/**
+ * Convert a strided batch of rows x cols matrices to the interleaved layout.
+ */
+void matrix_batch_interleave(const double* src, size_t stride, int rows, int cols,
+                             int batch_count, double* dst);
+
+/**
+ * Convert an interleaved batch back to the strided layout.
+ */
+void matrix_batch_deinterleave(const double* src, int rows, int cols, int batch_count,
+                               double* dst, size_t stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCHED_H
@@ -1,6 +1,8 @@
 #ifndef CACHE_LOCALITY_H
 #define CACHE_LOCALITY_H
 
+#include "results_store.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,6 +16,15 @@ extern "C" {
  */
 void test_cache_locality_speedup(int size, int iterations, const char* output_file);
 
+/**
+ * Same as test_cache_locality_speedup, and also append every section's
+ * timing samples to a results store.
+ *
+ * @param store Open results store (NULL = CSV only)
+ */
+void test_cache_locality_speedup_store(int size, int iterations, const char* output_file,
+                                       ResultsStore* store);
+
 #ifdef __cplusplus
 }
 #endif
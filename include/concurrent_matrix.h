@@ -2,6 +2,8 @@
 #define CONCURRENT_MATRIX_H
 
 #include "matrix.h"
+#include "results_store.h"
+#include "worker_timeline.h"
 #include <vector>
 #include <functional>
 
@@ -76,6 +78,11 @@ struct ConcurrentBenchmarkResult {
     double concurrent_ms;
     double speedup;
     int num_threads;
+    int size;
+    std::vector<double> sequential_samples;   // per iteration, ms
+    std::vector<double> concurrent_samples;
+    WorkerTimelineStats worker_stats;         // concurrent runs, mean over iterations
+    WorkerTimeline timeline;                  // workers of the last concurrent run
 };
 
 /**
@@ -91,14 +98,17 @@ void benchmark_concurrent_methods(int size, int iterations, int num_threads,
                                    std::vector<ConcurrentBenchmarkResult>& results);
 
 /**
- * Print benchmark results in a formatted table.
+ * Print benchmark results in a formatted table, followed by the worker
+ * balance of the concurrent runs (spawn latency, imbalance, idle tail) and
+ * the per-worker timeline of each method's last run.
  * 
  * @param results Vector of benchmark results to print
  */
 void print_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& results);
 
 /**
- * Save benchmark results to a CSV file.
+ * Save benchmark results to a CSV file (appended). A file with the
+ * column layout of older versions gets the worker columns added, empty.
  * 
  * @param results Vector of benchmark results
  * @param filename Output CSV filename
@@ -114,9 +124,11 @@ void save_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& result
  * @param iterations Number of iterations for timing
  * @param num_threads Number of threads (0 = auto)
  * @param output_file CSV file to save results (or NULL for default)
+ * @param store Results store for the per-iteration samples (NULL = CSV only)
  */
 void test_concurrent_matrix_multiplication(int size, int iterations, 
-                                            int num_threads, const char* output_file);
+                                            int num_threads, const char* output_file,
+                                            ResultsStore* store = nullptr);
 
 #endif // __cplusplus
 
@@ -0,0 +1,41 @@
+#ifndef DOT_KERNEL_H
+#define DOT_KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register-blocked kernel for the transpose path: C = A * B_T^T, i.e.
+// C[i][j] = sum_k A[i][k] * B_T[j][k] with both operands read along rows.
+//
+// A small block of C (4 x 4 portable, 2 x 4 AVX2) is computed at once with
+// independent accumulators, so every loaded A / B_T line is reused across
+// the block and the FP add latency is hidden behind parallel chains.
+
+// Code paths (selected at runtime from CPU features)
+typedef enum {
+    DOT_PATH_AUTO = 0,
+    DOT_PATH_PORTABLE,  // 4 x 4 block, 16 scalar accumulators
+    DOT_PATH_AVX2       // 2 x 4 block, 8 FMA vector accumulators along k
+} DotKernelPath;
+
+// Compute rows [row_start, row_end) of C (M x P, leading dimension ldc)
+// A is M x N (lda), B_T is P x N (ldb), all row-major. C is overwritten.
+void dot_kernel_rows(const double* A, int lda, const double* B_T, int ldb,
+                     double* C, int ldc, int N, int P, int row_start, int row_end);
+
+// Force a code path (DOT_PATH_AUTO restores CPU detection)
+// Returns the path that will actually be used
+DotKernelPath dot_kernel_select_path(DotKernelPath path);
+
+// Path currently used by dot_kernel_rows
+DotKernelPath dot_kernel_active_path(void);
+
+// Human readable path name
+const char* dot_kernel_path_name(DotKernelPath path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DOT_KERNEL_H
@@ -0,0 +1,94 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Benchmark environment capture and reproducibility controls.
+//
+// Timings are only comparable between runs on hosts in the same state.
+// environment_capture reads that state (Linux /proc and /sys; "unknown"
+// where a file is missing, as in most VMs), environment_save writes it
+// as a JSON sidecar next to a results file, and environment_check lists
+// the settings known to make timings noisy. environment_pin and
+// environment_warmup prepare the process before measuring.
+
+#define ENV_TEXT_LEN 128
+#define ENV_FLAGS_LEN 256
+
+typedef struct {
+    char cpu_model[ENV_TEXT_LEN];       // /proc/cpuinfo "model name"
+    char governor[ENV_TEXT_LEN];        // cpufreq scaling governor of CPU 0
+    double cur_mhz;                     // current / maximum frequency of CPU 0 (0 = unknown)
+    double max_mhz;
+    char turbo[ENV_TEXT_LEN];           // "on", "off" or "unknown"
+    char thp[ENV_TEXT_LEN];             // transparent huge pages mode ("always", "madvise", "never")
+    char smt[ENV_TEXT_LEN];             // "on", "off" or "unknown"
+    char kernel[ENV_TEXT_LEN];          // uname release
+    char compiler[ENV_TEXT_LEN];
+    char build_type[ENV_TEXT_LEN];
+    char build_flags[ENV_FLAGS_LEN];
+    char isolated_cpus[ENV_TEXT_LEN];   // kernel isolcpus list ("" = none)
+    char affinity[ENV_TEXT_LEN];        // CPUs this process may run on
+    char l3_shared_cpus[ENV_TEXT_LEN];  // CPUs sharing CPU 0's L3
+    int online_cpus;
+    int cache_line;
+    int l1d_bytes;
+    int l2_bytes;
+    int l3_bytes;
+    double load_average;                // 1-minute load average (< 0 = unknown)
+} BenchEnvironment;
+
+// Fill env with the current host and build state
+void environment_capture(BenchEnvironment* env);
+
+// Write env as one JSON object to filename
+// Returns 0 on success, -1 if the file cannot be written
+int environment_save(const BenchEnvironment* env, const char* filename);
+
+// Write env as one JSON object (no trailing newline): one key per line,
+// or all on one line with compact set (for JSON Lines records)
+void environment_write_json(const BenchEnvironment* env, FILE* fp, int compact);
+
+// Sidecar name for a results file: the extension replaced by ".env.json"
+// (profile_results.csv -> profile_results.env.json)
+void environment_sidecar_path(const char* results_file, char* path, size_t size);
+
+// Check for noisy settings: a governor other than performance, turbo on,
+// THP always, SMT on, and a load average above half the online CPUs.
+// Each finding is written to warnings as one line (may be NULL).
+// Returns the number of findings
+int environment_check(const BenchEnvironment* env, char* warnings, size_t size);
+
+// Pin the process to a CPU list ("2", "2-3,6") or "isolated" for the
+// kernel's isolated CPUs; threads started afterwards inherit the mask
+// Returns the number of CPUs pinned to, or -1 on an invalid or empty list
+// or where pinning is unsupported
+int environment_pin(const char* cpus);
+
+// Parse a CPU list ("0-3,6") into cpus[max]
+// Returns the number of CPUs, or -1 on a syntax error
+int environment_parse_cpulist(const char* text, int* cpus, int max);
+
+// Keep the CPU busy for ms milliseconds so the clock ramps up before timing
+void environment_warmup(double ms);
+
+// Harness start-up: pin to pin_cpus (NULL = leave as is), capture env,
+// print any environment_check findings to stderr, then warm up for
+// warmup_ms. With strict set, findings are fatal.
+// Returns 0 to go ahead, -1 if pinning failed or strict found problems
+int environment_prepare(const char* pin_cpus, double warmup_ms, int strict, BenchEnvironment* env);
+
+// Save env as the sidecar of results_file and print where it went
+// Returns 0 on success, -1 if the sidecar cannot be written
+int environment_save_sidecar(const BenchEnvironment* env, const char* results_file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENVIRONMENT_H
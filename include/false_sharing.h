@@ -0,0 +1,84 @@
+#ifndef FALSE_SHARING_H
+#define FALSE_SHARING_H
+
+#include "matrix.h"
+#include "perf_counters.h"
+
+#ifdef __cplusplus
+
+#include <vector>
+
+/**
+ * False-sharing diagnostic.
+ *
+ * Threads repeatedly update the rows of a narrow matrix they own. How rows
+ * are assigned decides how many cache lines two threads write:
+ * - interleaved: row i belongs to thread i % threads, so with rows shorter
+ *   than a line nearly every line is written by several threads
+ * - contiguous: ceil(rows / threads) rows per thread, the split the
+ *   parallel kernels used before; only boundary lines can be shared
+ * - aligned: matrix_partition_rows, boundaries on cache lines, nothing shared
+ *
+ * A line written by two cores ping-pongs between their caches (each write
+ * needs the line in Modified state, a HITM snoop on the other core), which
+ * shows up as extra time per update and as L1d / LLC misses on data that
+ * would otherwise stay in L1.
+ */
+
+enum RowLayout {
+    ROW_LAYOUT_INTERLEAVED = 0,
+    ROW_LAYOUT_CONTIGUOUS,
+    ROW_LAYOUT_ALIGNED
+};
+
+const int ROW_LAYOUT_COUNT = 3;
+
+/**
+ * Result of one layout.
+ */
+struct FalseSharingResult {
+    RowLayout layout;
+    int rows;
+    int cols;
+    int threads;
+    int passes;
+    int shared_lines;       // lines of the matrix written by more than one thread
+    double ms;              // best of the timed runs
+    double ns_per_update;   // ns per element update, all threads together
+    bool counter_available[PERF_COUNTER_COUNT];
+    uint64_t counters[PERF_COUNTER_COUNT];  // summed over threads, per run
+};
+
+/**
+ * Layout name ("interleaved", "contiguous", "aligned").
+ */
+const char* row_layout_name(RowLayout layout);
+
+/**
+ * Owning thread of every row of m under a layout.
+ */
+std::vector<int> row_layout_owners(RowLayout layout, const Matrix* m, int threads);
+
+/**
+ * Number of cache lines of m->data written by more than one thread.
+ */
+int count_shared_lines(const Matrix* m, const std::vector<int>& owners);
+
+/**
+ * Run the diagnostic for one layout: every thread adds 1 to each element
+ * of its rows `passes` times; one untimed run, then the best of iterations.
+ * Each worker reads its own perf counters (summed into the result).
+ *
+ * @return 0 on success, -1 on invalid arguments or allocation failure
+ */
+int run_false_sharing(RowLayout layout, int rows, int cols, int threads, int passes,
+                      int iterations, FalseSharingResult& result);
+
+/**
+ * Print results as a table (counters per update, '-' where unavailable).
+ */
+void print_false_sharing_results(const std::vector<FalseSharingResult>& results);
+
+#endif // __cplusplus
+
+#endif // FALSE_SHARING_H
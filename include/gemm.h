@@ -0,0 +1,51 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Operand transposition flag for matrix_gemm
+typedef enum {
+    GEMM_NO_TRANS = 0,
+    GEMM_TRANS = 1
+} GemmTranspose;
+
+// Non-owning strided view of a (sub)matrix: element (r, c) is data[r * ld + c]
+// A view never allocates; it stays valid as long as the viewed storage does.
+typedef struct {
+    double* data;
+    int rows;
+    int cols;
+    int ld;     // leading dimension (distance between rows), ld >= cols
+} MatrixView;
+
+// View of a whole matrix
+MatrixView matrix_view(Matrix* m);
+
+// View of rows x cols elements starting at (row, col) of m
+// Returns a view with data == NULL if the window does not fit
+MatrixView matrix_subview(Matrix* m, int row, int col, int rows, int cols);
+
+// Sub-window of an existing view (same rules as matrix_subview)
+MatrixView matrix_view_window(MatrixView v, int row, int col, int rows, int cols);
+
+// General matrix multiply: C = alpha * op(A) * op(B) + beta * C
+// op(X) is X or X^T depending on the transpose flag; op(A) is M x K,
+// op(B) is K x N and C is M x N. Transposed operands are read in place
+// (no copies) and beta is applied to each C tile the first time it is
+// visited, so accumulation needs no extra pass over C.
+// beta == 0 overwrites C without reading it. C must not overlap A or B.
+// block_size: size of sub-blocks (0 = auto-calculate optimal)
+// Returns 0 on success, -1 on dimension mismatch or invalid view
+int matrix_gemm(GemmTranspose trans_a, GemmTranspose trans_b,
+                double alpha, const MatrixView* A, const MatrixView* B,
+                double beta, const MatrixView* C, int block_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GEMM_H
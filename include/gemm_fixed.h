@@ -0,0 +1,69 @@
+#ifndef GEMM_FIXED_H
+#define GEMM_FIXED_H
+
+#ifdef __cplusplus
+
+/**
+ * Compile-time specialised GEMM kernels for small fixed shapes.
+ *
+ * gemm_fixed<M, N, K> computes C = A * B for dense row-major operands with
+ * A (M x K), B (K x N) and C (M x N). Every loop bound is a constant, and the
+ * column loop is expanded by template recursion, so one row of C lives in
+ * a register-resident accumulator array that the compiler vectorises.
+ * C is overwritten (no zeroing pass).
+ */
+
+// Compile-time loop: calls f(0), f(1), ..., f(Count - 1), fully expanded
+template <int Count>
+struct Unroll {
+    template <typename F>
+    static inline void run(F& f) {
+        Unroll<Count - 1>::run(f);
+        f(Count - 1);
+    }
+};
+
+template <>
+struct Unroll<0> {
+    template <typename F>
+    static inline void run(F&) {}
+};
+
+template <int M, int N, int K>
+inline void gemm_fixed(const double* a, const double* b, double* c) {
+    static_assert(M > 0 && N > 0 && K > 0, "gemm_fixed needs positive dimensions");
+
+    for (int i = 0; i < M; ++i) {
+        const double* a_row = a + i * K;
+        double acc[N];
+
+        // First k step initialises the accumulators
+        const double a0 = a_row[0];
+        auto init = [&](int j) { acc[j] = a0 * b[j]; };
+        Unroll<N>::run(init);
+
+        for (int k = 1; k < K; ++k) {
+            const double a_val = a_row[k];
+            const double* b_row = b + k * N;
+            auto update = [&](int j) { acc[j] += a_val * b_row[j]; };
+            Unroll<N>::run(update);
+        }
+
+        double* c_row = c + i * N;
+        auto store = [&](int j) { c_row[j] = acc[j]; };
+        Unroll<N>::run(store);
+    }
+}
+
+// Smallest and largest square size with a precompiled specialisation
+const int GEMM_FIXED_MIN_SIZE = 2;
+const int GEMM_FIXED_MAX_SIZE = 32;
+
+typedef void (*GemmFixedKernel)(const double* a, const double* b, double* c);
+
+// Specialised kernel for an M x K by K x N product, or nullptr if none exists
+GemmFixedKernel gemm_fixed_lookup(int M, int N, int K);
+
+#endif // __cplusplus
+
+#endif // GEMM_FIXED_H
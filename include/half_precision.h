@@ -0,0 +1,66 @@
+#ifndef HALF_PRECISION_H
+#define HALF_PRECISION_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 16-bit storage formats
+typedef enum {
+    HALF_BF16 = 1,   // 8-bit exponent, 7-bit mantissa (truncated float)
+    HALF_FP16 = 2    // IEEE 754 binary16
+} HalfType;
+
+// Accumulation precision used by the half-storage GEMM
+typedef enum {
+    HALF_ACCUM_FP32 = 1,   // fp32 products and partial sums within a k-block
+    HALF_ACCUM_FP64 = 2    // fp64 products and sums
+} HalfAccum;
+
+// Matrix stored in bf16 or fp16 (row-major)
+typedef struct {
+    uint16_t* data;
+    int rows;
+    int cols;
+    HalfType type;
+} HMatrix;
+
+// Create a half-storage matrix filled with zeros
+HMatrix* hmatrix_create(int rows, int cols, HalfType type);
+
+// Free half-storage matrix memory
+void hmatrix_free(HMatrix* h);
+
+// Scalar conversions (round to nearest even)
+uint16_t float_to_bf16(float value);
+float bf16_to_float(uint16_t value);
+uint16_t float_to_fp16(float value);
+float fp16_to_float(uint16_t value);
+
+// Convert a double matrix to half storage (dimensions must match)
+// Returns 0 on success, -1 on error
+int matrix_to_half(Matrix* m, HMatrix* h);
+
+// Convert half storage back to a double matrix (dimensions must match)
+// Returns 0 on success, -1 on error
+int matrix_from_half(HMatrix* h, Matrix* m);
+
+// Cache-blocked C = A * B with A and B in half storage
+// Operands are widened while being packed into per-block buffers, so each
+// element is converted once; C is written in double precision.
+// block_size: size of sub-blocks (0 = auto-calculate optimal)
+// Returns 0 on success, -1 on dimension/type mismatch
+int matrix_multiply_half_blocked(HMatrix* A, HMatrix* B, Matrix* C,
+                                 int block_size, HalfAccum accum);
+
+// Human readable format name ("bf16" / "fp16")
+const char* half_type_name(HalfType type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HALF_PRECISION_H
@@ -0,0 +1,54 @@
+#ifndef LOOP_ORDER_H
+#define LOOP_ORDER_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// All six loop orders of C += A * B, for the loop-permutation study.
+//
+// The order names the loops from outermost to innermost. The innermost
+// loop decides the access pattern:
+// - k innermost (ijk, jik): A row unit stride, B column strided, C fixed
+// - j innermost (ikj, kij): B and C rows unit stride, A fixed
+// - i innermost (jki, kji): A and C columns strided, B fixed
+//
+// Every order is generated from one loop-nest template (src/loop_order.cpp),
+// so the orders differ only in nesting. The blocked form tiles all three
+// loops with the same order for the tile loops and the loops inside a tile.
+// Both forms zero C first. C++ library only.
+
+typedef enum {
+    LOOP_IJK = 0,
+    LOOP_IKJ,
+    LOOP_JIK,
+    LOOP_JKI,
+    LOOP_KIJ,
+    LOOP_KJI
+} LoopOrder;
+
+#define LOOP_ORDER_COUNT 6
+
+// Unblocked C = A * B with the given loop order
+// Returns 0 on success, -1 on dimension mismatch or invalid order
+int matrix_multiply_loop_order(Matrix* A, Matrix* B, Matrix* C, LoopOrder order);
+
+// Blocked C = A * B with the given loop order
+// block_size: tile edge (0 = get_optimal_block_size())
+// Returns 0 on success, -1 on dimension mismatch or invalid order
+int matrix_multiply_loop_order_blocked(Matrix* A, Matrix* B, Matrix* C, LoopOrder order,
+                                       int block_size);
+
+// Order name ("ijk", "ikj", ...)
+const char* loop_order_name(LoopOrder order);
+
+// Parse an order name; returns 0 on success, -1 if unknown
+int loop_order_from_name(const char* name, LoopOrder* order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOOP_ORDER_H
@@ -1,10 +1,15 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Alignment in bytes of the data of matrices from matrix_create
+#define MATRIX_ALIGNMENT 64
+
 // Matrix structure
 typedef struct {
     double* data;
@@ -12,27 +17,53 @@ typedef struct {
     int cols;
 } Matrix;
 
-// Create a matrix with given dimensions
+// Create a zero-filled matrix with given dimensions; data is aligned to
+// MATRIX_ALIGNMENT bytes
+// Returns NULL on negative dimensions, if rows * cols * sizeof(double)
+// overflows size_t, or on allocation failure
 Matrix* matrix_create(int rows, int cols);
 
-// Free matrix memory
+// Free a matrix from matrix_create (data is not a plain malloc pointer)
 void matrix_free(Matrix* m);
 
+// Element bytes allocated since start-up by matrix_create and by the
+// library's internal operand copies (e.g. the B^T of the transpose
+// kernels); only grows, so the difference of two readings is what a
+// section allocated. Thread-safe.
+size_t matrix_allocated_bytes(void);
+
+// Add an internal operand allocation to matrix_allocated_bytes
+void matrix_count_allocation(size_t bytes);
+
+// Number of elements (rows * cols) computed in size_t; use for linear
+// indexing, which overflows int beyond 46340 x 46340
+size_t matrix_elements(const Matrix* m);
+
 // Set matrix element
 void matrix_set(Matrix* m, int row, int col, double value);
 
 // Get matrix element
 double matrix_get(Matrix* m, int row, int col);
 
-// Initialize matrix with random values
+// Initialize matrix with uniform random values in [0, 1)
+// Reproducible and thread-safe: see matrix_random.h for seeding
 void matrix_randomize(Matrix* m);
 
 // Initialize matrix with zeros
 void matrix_zeros(Matrix* m);
 
+// Copy src into dst (same shape)
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_copy(Matrix* src, Matrix* dst);
+
 // Print matrix (for debugging)
 void matrix_print(Matrix* m);
 
+// Compare m against a reference of the same shape
+// max_abs_err: max |m - ref|, rel_err: ||m - ref||_F / ||ref||_F (either may be NULL)
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_compare(Matrix* ref, Matrix* m, double* max_abs_err, double* rel_err);
+
 // Naive matrix multiplication: C = A * B
 // Returns 0 on success, -1 on dimension mismatch
 int matrix_multiply_naive(Matrix* A, Matrix* B, Matrix* C);
@@ -53,6 +84,24 @@ int get_cache_line_size(void);
 // Returns 32768 (32KB) as default if detection fails
 int get_l1_cache_size(void);
 
+// Get L2 / L3 cache sizes in bytes (unified caches; the L3 is usually shared)
+// Return 262144 (256KB) / 8388608 (8MB) as defaults if detection fails
+int get_l2_cache_size(void);
+int get_l3_cache_size(void);
+
+// Split rows [0, rows) of row-major data (row_stride elements apart) into
+// parts ranges for threads: part t is [bounds[t], bounds[t + 1]), bounds
+// has parts + 1 entries and ranges may be empty. Boundaries are the even
+// split moved to the nearest row that starts on a cache line, so no line
+// of the rows is written by two threads.
+// Returns 1 if every inner boundary is line aligned, 0 if some cannot be
+// (row starts never meet a line), -1 on invalid arguments
+int matrix_partition_rows(const double* data, size_t row_stride, int rows, int parts, int* bounds);
+
+// Block size used by the blocked kernels when block_size <= 0:
+// largest power of two with BLOCK^2 * 4 * sizeof(double) <= L1 (16..64)
+int get_optimal_block_size(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -64,6 +113,16 @@ extern "C" {
 int matrix_multiply_naive_parallel(Matrix* A, Matrix* B, Matrix* C, int num_threads);
 int matrix_multiply_transpose_parallel(Matrix* A, Matrix* B, Matrix* C, int num_threads);
 int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C, int block_size, int num_threads);
+
+// C++11 parallel initialisation: each thread writes a contiguous range, which
+// also places first-touched pages near the thread that will use them
+void matrix_zeros_parallel(Matrix* m, int num_threads);
+int matrix_copy_parallel(Matrix* src, Matrix* dst, int num_threads);
+
+// C++ compile-time specialised kernels for small square shapes (see gemm_fixed.h)
+// matrix_multiply_fixed returns -1 when no specialisation matches the dimensions
+int matrix_fixed_kernel_available(int M, int N, int P);
+int matrix_multiply_fixed(Matrix* A, Matrix* B, Matrix* C);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,125 @@
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "gemm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary matrix files.
+//
+// Two on-disk formats are supported, both little-endian:
+//
+// - CLM ("cache locality matrix"), a fixed 64-byte header followed by the
+//   payload at an aligned offset:
+//     offset  0  char[8]  magic "CLMATRIX"
+//     offset  8  u32      format version (1)
+//     offset 12  u32      dtype (MatrixDType)
+//     offset 16  u32      layout (MatrixLayout)
+//     offset 20  u32      alignment of the payload offset in bytes
+//     offset 24  u64      rows
+//     offset 32  u64      cols
+//     offset 40  u64      leading dimension in elements (>= cols, or >= rows
+//                         for column-major)
+//     offset 48  u64      payload offset in bytes
+//     offset 56  u64      reserved (0)
+//
+// - NumPy .npy (versions 1.0 and 2.0), 1-D or 2-D, '<f8' or '<f4', C or
+//   Fortran order. Files written here pad the header to 64 bytes.
+//
+// Row-major float64 payloads with an 8-byte aligned offset can be mapped
+// into memory and used in place (matrix_map); everything else is converted
+// on load (matrix_load).
+
+// Element type of the payload
+typedef enum {
+    MATRIX_DTYPE_F64 = 1,
+    MATRIX_DTYPE_F32 = 2
+} MatrixDType;
+
+// Storage order of the payload
+typedef enum {
+    MATRIX_LAYOUT_ROW_MAJOR = 0,
+    MATRIX_LAYOUT_COL_MAJOR = 1
+} MatrixLayout;
+
+// File formats (MATRIX_FORMAT_AUTO picks by extension: ".npy" or CLM)
+typedef enum {
+    MATRIX_FORMAT_AUTO = 0,
+    MATRIX_FORMAT_CLM,
+    MATRIX_FORMAT_NPY
+} MatrixFileFormat;
+
+// Header fields of a matrix file
+typedef struct {
+    MatrixFileFormat format;
+    MatrixDType dtype;
+    MatrixLayout layout;
+    int rows;
+    int cols;
+    size_t ld;              // leading dimension in elements
+    size_t alignment;       // payload alignment in bytes
+    size_t data_offset;     // payload offset in bytes
+} MatrixFileInfo;
+
+// Matrix backed by a memory-mapped file. matrix.data points into the
+// mapping (nothing is copied); view carries the leading dimension of the
+// file. Release with matrix_unmap, never matrix_free.
+typedef struct {
+    Matrix matrix;          // valid as a dense Matrix only when view.ld == cols
+    MatrixView view;
+    void* base;             // start of the mapping
+    size_t length;          // mapping length in bytes
+    int writable;
+} MappedMatrix;
+
+// Payload alignment used by matrix_save / matrix_map_create for CLM files
+#define MATRIX_FILE_ALIGNMENT 64
+
+// Read the header of a matrix file
+// Returns 0 on success, -1 on I/O error or unsupported/invalid header
+int matrix_file_info(const char* path, MatrixFileInfo* info);
+
+// Write m as row-major float64 (format AUTO chooses by extension)
+// Returns 0 on success, -1 on error
+int matrix_save(const char* path, Matrix* m, MatrixFileFormat format);
+
+// Read a file into a new dense row-major Matrix, converting dtype and layout
+// Returns NULL on error
+Matrix* matrix_load(const char* path);
+
+// Map a row-major float64 file without copying. writable = 1 maps it shared,
+// so stores reach the file; writable = 0 maps it copy-on-write, so stores
+// stay private to the process
+// Returns NULL on error or when the payload needs conversion (use matrix_load)
+MappedMatrix* matrix_map(const char* path, int writable);
+
+// Create (or truncate) a row-major float64 file of rows x cols elements;
+// the payload is allocated sparse and reads as zeros until written.
+// info (may be NULL) receives the header fields, e.g. the payload offset
+// for pread/pwrite access
+// Returns 0 on success, -1 on error
+int matrix_file_create(const char* path, int rows, int cols, MatrixFileFormat format,
+                       MatrixFileInfo* info);
+
+// Create (or truncate) a rows x cols float64 file and map it read-write, so
+// a kernel can write its result straight into the file
+// Returns NULL on error
+MappedMatrix* matrix_map_create(const char* path, int rows, int cols, MatrixFileFormat format);
+
+// Flush a writable mapping to disk
+// Returns 0 on success, -1 on error
+int matrix_map_sync(MappedMatrix* mm);
+
+// Unmap and free the handle (the file itself is kept)
+void matrix_unmap(MappedMatrix* mm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_IO_H
@@ -0,0 +1,67 @@
+#ifndef MATRIX_RANDOM_H
+#define MATRIX_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counter-based random numbers.
+//
+// Element i of the stream for a seed is a pure function of (seed, i): a
+// SplitMix64 finaliser applied to key(seed) + (i + 1) * golden ratio. There
+// is no generator state, so any range of the stream can be produced by any
+// thread, and a fill split across N threads is bit-identical to a serial
+// fill. Uniform doubles take the top 52 bits of each value and lie in [0, 1).
+
+// Seed used by matrix_randomize until matrix_random_set_seed is called
+#define MATRIX_RANDOM_DEFAULT_SEED 0x5EEDull
+
+// Code paths for random_fill_uniform (selected at runtime from CPU features)
+typedef enum {
+    RANDOM_PATH_AUTO = 0,
+    RANDOM_PATH_PORTABLE,   // one value at a time
+    RANDOM_PATH_AVX2        // four values per step, emulated 64-bit multiplies
+} RandomPath;
+
+// Raw 64-bit value i of the stream for seed
+uint64_t random_u64(uint64_t seed, uint64_t index);
+
+// Uniform double in [0, 1) for value i of the stream for seed
+double random_uniform(uint64_t seed, uint64_t index);
+
+// data[k] = random_uniform(seed, first_index + k) for k in [0, count)
+void random_fill_uniform(double* data, size_t count, uint64_t seed, uint64_t first_index);
+
+// Force a code path (RANDOM_PATH_AUTO restores CPU detection)
+// Returns the path that will actually be used
+RandomPath random_select_path(RandomPath path);
+
+// Path currently used by random_fill_uniform
+RandomPath random_active_path(void);
+
+// Human readable path name
+const char* random_path_name(RandomPath path);
+
+// Fill m with the stream for seed; element (r, c) is value r * cols + c,
+// so the contents depend only on the seed and the shape
+void matrix_randomize_seeded(Matrix* m, uint64_t seed);
+
+// Set the base seed of matrix_randomize and restart its call sequence.
+// Each matrix_randomize call derives its own seed from the base seed and
+// the call number, so a program that randomizes its matrices in the same
+// order gets the same values on every run
+void matrix_random_set_seed(uint64_t seed);
+
+// C++ library: matrix_randomize_seeded with worker threads (num_threads = 0
+// auto-detects); the result is identical for every thread count
+void matrix_randomize_parallel(Matrix* m, uint64_t seed, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_RANDOM_H
@@ -0,0 +1,78 @@
+#ifndef MEMBENCH_H
+#define MEMBENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory hierarchy microbenchmarks.
+//
+// - Latency: a pointer chase through one random cycle over the cache lines
+//   of a working set. Every load depends on the previous one and the next
+//   address is unpredictable, so hardware prefetchers cannot help and the
+//   time per step is the load-to-use latency of the level holding the set.
+// - Bandwidth: STREAM-style read, write, copy and triad over arrays split
+//   into one contiguous chunk per thread (each thread first-touches its own
+//   chunk).
+// - Knees: sizes where the latency curve climbs to a new plateau, i.e. the
+//   effective capacities of L1, L2, L3 before DRAM.
+//
+// C++ library only (the bandwidth kernels use std::thread).
+
+// STREAM kernels; bytes counted as in STREAM (8 per double read or written)
+typedef enum {
+    MEMBENCH_READ = 0,  // sum += a[i]           8 bytes / element
+    MEMBENCH_WRITE,     // a[i] = s              8 bytes / element
+    MEMBENCH_COPY,      // c[i] = a[i]          16 bytes / element
+    MEMBENCH_TRIAD      // a[i] = b[i] + s*c[i]  24 bytes / element
+} MembenchKernel;
+
+#define MEMBENCH_KERNEL_COUNT 4
+
+// One point of the latency curve
+typedef struct {
+    size_t bytes;
+    double latency_ns;
+} LatencyPoint;
+
+// A detected capacity transition
+typedef struct {
+    size_t bytes;           // largest working set still served by the faster level
+    double before_ns;       // latency at that size
+    double after_ns;        // latency where the curve levels off again
+} MemoryKnee;
+
+// Fill next[] with a single random cycle over [0, count) (Sattolo's
+// algorithm): following next from any index visits every index once
+void membench_random_cycle(size_t* next, size_t count, uint64_t seed);
+
+// Average ns per dependent load chasing a random cycle over a working set
+// of `bytes` (rounded down to whole cache lines, at least two)
+// Returns a negative value on allocation failure
+double membench_latency_ns(size_t bytes, size_t steps);
+
+// Bandwidth in GB/s of a kernel over arrays of bytes_per_array each,
+// best of iterations passes, split over num_threads (0 = auto-detect)
+// Returns a negative value on an invalid kernel or allocation failure
+double membench_bandwidth_gbs(MembenchKernel kernel, size_t bytes_per_array,
+                              int num_threads, int iterations);
+
+// Kernel name ("read", "write", "copy", "triad")
+const char* membench_kernel_name(MembenchKernel kernel);
+
+// Find knees in a latency curve sorted by size. A knee is a run of
+// consecutive rises of at least 10% per step whose total rise is at least
+// min_rise (e.g. 1.5 = +50%); gradual transitions count once. The curve is
+// median-of-three smoothed first, so isolated spikes are ignored.
+// Returns the number of knees written (at most max_knees)
+int membench_find_knees(const LatencyPoint* points, int count, double min_rise,
+                        MemoryKnee* knees, int max_knees);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMBENCH_H
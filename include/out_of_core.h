@@ -0,0 +1,66 @@
+#ifndef OUT_OF_CORE_H
+#define OUT_OF_CORE_H
+
+#include <stddef.h>
+#include "profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Out-of-core GEMM.
+//
+// C = A * B for operands stored in matrix files (see matrix_io.h) that need
+// not fit in memory. C is split into T x T tiles; for each tile the k
+// dimension is streamed as pairs of panels (A rows x T columns, B T rows x
+// tile columns) read with pread, multiplied into the resident C tile with
+// matrix_gemm, and the finished tile is written back with pwrite. Nothing
+// larger than the panel buffers and one C tile is ever allocated.
+//
+// With double buffering a reader thread fills the next panel pair while
+// the kernel works on the current one, so reads overlap compute.
+
+// Default memory budget for panel buffers and the C tile
+#define OOC_DEFAULT_BUDGET ((size_t)256 << 20)
+
+typedef struct {
+    size_t memory_budget;   // bytes for all buffers (0 = OOC_DEFAULT_BUDGET)
+    int tile;               // tile edge in elements (0 = largest that fits the budget)
+    int double_buffer;      // 1 = prefetch on a reader thread, 0 = read then compute
+    int block_size;         // matrix_gemm block size for each panel (0 = auto)
+} OocOptions;
+
+typedef struct {
+    int tile;               // tile edge actually used
+    long long panels;       // panel pairs streamed
+    size_t bytes_read;
+    size_t bytes_written;
+    double total_ms;
+    double read_ms;         // time spent in pread (reader thread when double buffered)
+    double write_ms;        // time spent writing C tiles
+    double compute_ms;      // time spent in the kernel
+    double wait_ms;         // time the kernel sat waiting for a panel
+    double overlap;         // fraction of read time hidden behind compute (0..1)
+} OocStats;
+
+// Defaults: 256 MB budget, automatic tile and block size, double buffered
+OocOptions ooc_default_options(void);
+
+// Multiply the files at a_path (M x N) and b_path (N x P) into a new file
+// c_path (M x P, format chosen by extension). Operands must be row-major
+// float64 (the layout matrix_map accepts); convert others with
+// matrix_load/matrix_save first.
+// options may be NULL (defaults); stats may be NULL. When profiler is not
+// NULL the phases are recorded as "ooc_total", "ooc_read", "ooc_compute",
+// "ooc_wait", "ooc_write" and "ooc_read_hidden" (read time overlapped with
+// compute).
+// Returns 0 on success, -1 on I/O error, unsupported file, dimension
+// mismatch or a budget too small for a single tile
+int matrix_multiply_out_of_core(const char* a_path, const char* b_path, const char* c_path,
+                                const OocOptions* options, OocStats* stats, Profiler* profiler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OUT_OF_CORE_H
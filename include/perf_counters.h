@@ -0,0 +1,48 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hardware event counters of the calling thread (Linux perf_event_open,
+// user space only). Each counter is opened on its own, so the ones the
+// kernel or the (virtual) CPU does not provide are simply unavailable;
+// on other platforms all counters are unavailable.
+
+typedef enum {
+    PERF_COUNTER_CACHE_MISSES = 0,  // last-level cache misses
+    PERF_COUNTER_L1D_MISSES,        // L1 data cache read misses
+    PERF_COUNTER_DTLB_MISSES,       // data TLB read misses
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+typedef struct {
+    int fds[PERF_COUNTER_COUNT];    // -1 = unavailable
+} PerfCounters;
+
+// Open all counters (disabled). Returns the number available (0 = none)
+int perf_counters_open(PerfCounters* pc);
+
+// Reset and enable the open counters
+void perf_counters_start(PerfCounters* pc);
+
+// Disable the counters and read them into values[PERF_COUNTER_COUNT];
+// unavailable counters read as 0
+void perf_counters_stop(PerfCounters* pc, uint64_t* values);
+
+// 1 if the counter was opened
+int perf_counter_available(const PerfCounters* pc, PerfCounter counter);
+
+void perf_counters_close(PerfCounters* pc);
+
+// Short counter name ("cache-misses", "L1d-misses", "dTLB-misses")
+const char* perf_counter_name(PerfCounter counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,58 @@
+#ifndef PIPELINED_H
+#define PIPELINED_H
+
+#include "matrix.h"
+#include "profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pipelined blocked GEMM.
+//
+// matrix_multiply_blocked stalls at the start of every (kk, jj) block
+// while the next B tile comes in from memory with a large row stride. The
+// pipelined kernel instead packs each BLOCK-row panel of B into contiguous
+// tiles and overlaps the memory traffic with compute in two ways:
+// - software prefetch: while a tile is multiplied, the cache lines of the
+//   packed tile prefetch_distance tiles ahead are requested, spread evenly
+//   over the rows of the current tile
+// - pack thread: one helper thread, started once per call, packs panel
+//   kk + 1 into the second buffer while panel kk is being multiplied, so
+//   packing leaves the critical path
+//
+// C++ library only (the pack thread uses std::thread).
+
+// Default prefetch distance in packed tiles
+#define PIPELINE_DEFAULT_PREFETCH_DISTANCE 1
+
+typedef struct {
+    int block_size;         // tile edge (0 = get_optimal_block_size())
+    int prefetch_distance;  // tiles ahead to prefetch (0 = no software prefetch)
+    int pack_thread;        // 1 = pack the next panel on a helper thread
+} PipelineOptions;
+
+typedef struct {
+    int panels;             // packed B panels
+    double total_ms;
+    double pack_ms;         // time spent packing (on either thread)
+    double wait_ms;         // time the kernel blocked waiting for a packed panel
+    double compute_ms;      // time spent multiplying packed tiles
+} PipelineStats;
+
+// Defaults: automatic block size, PIPELINE_DEFAULT_PREFETCH_DISTANCE, pack thread on
+PipelineOptions pipeline_default_options(void);
+
+// C = A * B (A is M x N, B is N x P, C is M x P; C is overwritten)
+// options may be NULL (defaults); stats may be NULL. When profiler is not
+// NULL the phases are recorded as "pipeline_total", "pipeline_pack",
+// "pipeline_wait" and "pipeline_compute".
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_multiply_pipelined(Matrix* A, Matrix* B, Matrix* C, const PipelineOptions* options,
+                              PipelineStats* stats, Profiler* profiler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIPELINED_H
@@ -0,0 +1,96 @@
+#ifndef PREPARED_H
+#define PREPARED_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Prepared right-hand operands.
+//
+// When the same B is multiplied against many A matrices, the O(N*P)
+// re-layout (B -> B_T) and its allocation can be done once: a PreparedB
+// handle holds B in the layout the transpose-path kernel reads, and is
+// reused by every matrix_multiply_prepared* call.
+
+// Opaque prepared operand for an N x P matrix B
+typedef struct PreparedB PreparedB;
+
+// Allocate a handle for an N x P operand (contents undefined until packed)
+// Returns NULL on invalid dimensions or allocation failure
+PreparedB* prepared_b_create(int rows, int cols);
+
+// Free a prepared operand
+void prepared_b_free(PreparedB* prep);
+
+// Dimensions of the original operand B (N x P)
+int prepared_b_rows(const PreparedB* prep);
+int prepared_b_cols(const PreparedB* prep);
+
+// (Re)pack B into an existing handle of the same shape, without allocating
+// Returns 0 on success, -1 on dimension mismatch
+int prepared_b_pack(PreparedB* prep, Matrix* B);
+
+// Pack only rows [row_start, row_end) of B; disjoint ranges may run on
+// different threads
+// Returns 0 on success, -1 on dimension mismatch
+int prepared_b_pack_rows(PreparedB* prep, Matrix* B, int row_start, int row_end);
+
+// Create and pack in one step
+// Returns NULL on allocation failure
+PreparedB* matrix_prepare_b(Matrix* B);
+
+// C = A * B using a prepared B (A is M x N, C is M x P; C is overwritten)
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_multiply_prepared(Matrix* A, const PreparedB* B, Matrix* C);
+
+// Same, restricted to rows [row_start, row_end) of C
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_multiply_prepared_rows(Matrix* A, const PreparedB* B, Matrix* C,
+                                  int row_start, int row_end);
+
+// C++ library: pack with worker threads / multiply with row-parallel threads
+// num_threads = 0 auto-detects
+int prepared_b_pack_parallel(PreparedB* prep, Matrix* B, int num_threads);
+int matrix_multiply_prepared_parallel(Matrix* A, const PreparedB* B, Matrix* C, int num_threads);
+
+// ============================================================================
+// LRU cache of prepared operands
+// ============================================================================
+
+// Entries are keyed by matrix identity (the Matrix pointer, its data pointer
+// and shape) plus a caller-maintained version counter: bump the version
+// whenever the contents of B change. Not thread-safe; use one cache per
+// thread or guard it externally.
+typedef struct PreparedCache PreparedCache;
+
+// Create a cache holding at most capacity prepared operands
+// Returns NULL on invalid capacity or allocation failure
+PreparedCache* prepared_cache_create(int capacity);
+
+// Free the cache and every prepared operand it owns
+void prepared_cache_free(PreparedCache* cache);
+
+// Prepared form of B at the given version. On a miss B is packed, reusing
+// the buffer of an older version of the same matrix when there is one and
+// otherwise evicting the least recently used entry if the cache is full.
+// The handle is owned by the cache and stays valid until the next call that
+// may evict it (prepared_cache_get/invalidate/clear/free).
+// Returns NULL on allocation failure
+const PreparedB* prepared_cache_get(PreparedCache* cache, Matrix* B, unsigned long version);
+
+// Drop the entry for B (e.g. before freeing B)
+void prepared_cache_invalidate(PreparedCache* cache, Matrix* B);
+
+// Drop every entry
+void prepared_cache_clear(PreparedCache* cache);
+
+// Lookup statistics since creation (either pointer may be NULL)
+void prepared_cache_stats(const PreparedCache* cache, unsigned long* hits, unsigned long* misses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PREPARED_H
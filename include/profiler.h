@@ -12,6 +12,16 @@ extern "C" {
 
 #define MAX_PROFILE_POINTS 100
 #define MAX_NAME_LEN 64
+#define MAX_PROFILE_SAMPLES 64
+
+// Process resource counters: page faults and peak RSS from getrusage (all
+// threads), allocated bytes from matrix_allocated_bytes
+typedef struct {
+    long minor_faults;
+    long major_faults;
+    long peak_rss_kb;
+    size_t alloc_bytes;
+} ProfileUsage;
 
 typedef struct {
     char name[MAX_NAME_LEN];
@@ -19,6 +29,15 @@ typedef struct {
     struct timespec end_time;
     double elapsed_ms;
     int active;
+    // Individual timings (each start/end pair or record), the first
+    // MAX_PROFILE_SAMPLES kept; elapsed_ms is their total
+    double samples[MAX_PROFILE_SAMPLES];
+    int sample_count;
+    // Counters at profiler_start, and the growth between each start/end
+    // pair summed (peak_rss_kb: how far the sections raised the process
+    // peak). Sections added with profiler_record have none.
+    ProfileUsage start_usage;
+    ProfileUsage usage;
 } ProfilePoint;
 
 typedef struct {
@@ -29,12 +48,15 @@ typedef struct {
 // Initialize the profiler
 void profiler_init(Profiler* p);
 
-// Start timing a named section
+// Start timing a named section (ignored with a warning while it is active)
 void profiler_start(Profiler* p, const char* name);
 
 // End timing a named section
 void profiler_end(Profiler* p, const char* name);
 
+// Add a time measured elsewhere (e.g. on another thread) to a named section
+void profiler_record(Profiler* p, const char* name, double elapsed_ms);
+
 // Print all profiling results
 void profiler_print_results(Profiler* p);
 
@@ -44,6 +66,9 @@ void profiler_save_results(Profiler* p, const char* filename);
 // Get current time in milliseconds
 double get_time_ms(void);
 
+// Read the process resource counters
+void profiler_read_usage(ProfileUsage* usage);
+
 #ifdef __cplusplus
 }
 #endif
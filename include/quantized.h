@@ -0,0 +1,93 @@
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Element type of a quantized matrix
+typedef enum {
+    QUANT_INT8 = 1,
+    QUANT_INT16 = 2
+} QuantType;
+
+// Quantized matrix with per-tensor affine parameters:
+// real_value = scale * (q - zero_point)
+typedef struct {
+    void* data;         // int8_t or int16_t elements, row-major
+    int rows;
+    int cols;
+    QuantType type;
+    double scale;
+    int zero_point;
+} QMatrix;
+
+// Integer GEMM code paths (selected at runtime from CPU features)
+typedef enum {
+    QGEMM_PATH_AUTO = 0,
+    QGEMM_PATH_PORTABLE,
+    QGEMM_PATH_AVX2,    // sign-extend + pmaddwd
+    QGEMM_PATH_VNNI     // vpdpbusd (int8 only; int16 uses the AVX2 kernel)
+} QGemmPath;
+
+// Largest inner dimension of qmatrix_multiply_int8 (INT32_MAX / (255 * 255))
+#define QGEMM_INT8_MAX_K 33025
+
+// Create a quantized matrix (scale = 1, zero_point = 0)
+QMatrix* qmatrix_create(int rows, int cols, QuantType type);
+
+// Free quantized matrix memory
+void qmatrix_free(QMatrix* q);
+
+// Compute per-tensor scale and zero point covering the value range of m
+// (the range is widened to include 0 so that zero is exactly representable)
+// Returns 0 on success, -1 on error
+int quantize_params(Matrix* m, QuantType type, double* scale, int* zero_point);
+
+// Quantize m into q (dimensions must match); stores the computed parameters in q
+// Returns 0 on success, -1 on error
+int matrix_quantize(Matrix* m, QMatrix* q);
+
+// Dequantize q into m (dimensions must match)
+// Returns 0 on success, -1 on error
+int matrix_dequantize(QMatrix* q, Matrix* m);
+
+// int8 x int8 -> int32 GEMM on the blocked tiling of matrix_multiply_blocked
+// C is M x P row-major: C[i][j] = sum_k (A[i][k] - zA) * (B[k][j] - zB)
+// After the zero-point correction a term can reach 255 * 255, so the result
+// only fits int32 for N <= QGEMM_INT8_MAX_K (INT32_MAX / 65025)
+// Returns 0 on success, -1 on type/dimension mismatch or N > QGEMM_INT8_MAX_K
+int qmatrix_multiply_int8(QMatrix* A, QMatrix* B, int32_t* C, int block_size);
+
+// Same GEMM with int64 output, exact for any N
+// Returns 0 on success, -1 on type/dimension mismatch
+int qmatrix_multiply_int8_wide(QMatrix* A, QMatrix* B, int64_t* C, int block_size);
+
+// int16 x int16 -> int64 GEMM (same tiling, products widened to 64-bit)
+// Returns 0 on success, -1 on type/dimension mismatch
+int qmatrix_multiply_int16(QMatrix* A, QMatrix* B, int64_t* C, int block_size);
+
+// Quantized GEMM with the integer result dequantized into C
+// C = scaleA * scaleB * sum_k (A[i][k] - zA) * (B[k][j] - zB)
+// Returns 0 on success, -1 on error
+int qmatrix_multiply(QMatrix* A, QMatrix* B, Matrix* C, int block_size);
+
+// Force a code path (QGEMM_PATH_AUTO restores CPU detection)
+// Paths not supported by the CPU fall back to the best supported one
+// Returns the path that will actually be used
+QGemmPath qgemm_select_path(QGemmPath path);
+
+// Path currently used by the integer GEMM kernels
+QGemmPath qgemm_active_path(void);
+
+// Human readable path name
+const char* qgemm_path_name(QGemmPath path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUANTIZED_H
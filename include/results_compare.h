@@ -0,0 +1,111 @@
+#ifndef RESULTS_COMPARE_H
+#define RESULTS_COMPARE_H
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+/**
+ * Comparison of two runs from results stores (results_store.h).
+ *
+ * Every kernel, size and thread count present in both runs is compared
+ * on its timing samples with a two-sided Mann-Whitney U test, which
+ * needs no assumption about the shape of the timing distribution. A
+ * result is a regression when the candidate median is slower than the
+ * baseline median by more than the threshold and the difference is
+ * significant. Small samples bound the smallest reachable p-value
+ * (3 vs 3 cannot go below 0.1), so every comparison records that bound.
+ */
+
+/**
+ * Samples of one kernel, size and thread count within a run.
+ */
+struct ResultSeries {
+    std::string kernel;
+    int size;
+    int threads;
+    std::vector<double> samples_ms;
+};
+
+/**
+ * One run: its run record and result records.
+ */
+struct ResultsRun {
+    std::string run_id;
+    std::string tool;
+    std::string time;
+    std::vector<ResultSeries> series;
+};
+
+/**
+ * Load every run of a JSON Lines results store, in file order.
+ * Lines that are not run or result records are skipped.
+ *
+ * @return Number of runs loaded, or -1 if the file cannot be read
+ */
+int load_results_runs(const char* filename, std::vector<ResultsRun>& runs);
+
+/**
+ * Two-sided Mann-Whitney U test of a against b. Exact for small samples
+ * without ties (n * m <= 400), otherwise the normal approximation with
+ * tie correction.
+ *
+ * @param u Set to the U statistic of a (may be null)
+ * @return p-value, 1 when either sample is empty
+ */
+double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b, double* u = nullptr);
+
+/**
+ * Smallest p-value mann_whitney_p can return for n against m samples,
+ * reached when the two samples do not overlap (2 / C(n + m, n) when exact).
+ * A comparison can only be significant at alpha if this is below alpha.
+ *
+ * @return Minimum p-value, 1 when n or m is 0
+ */
+double mann_whitney_min_p(int n, int m);
+
+/**
+ * Verdict of one comparison.
+ */
+enum CompareVerdict {
+    COMPARE_SAME = 0,       // not significant, or within the threshold
+    COMPARE_FASTER,
+    COMPARE_SLOWER          // a regression
+};
+
+/**
+ * One kernel, size and thread count compared.
+ */
+struct ResultComparison {
+    std::string kernel;
+    int size;
+    int threads;
+    int baseline_count;
+    int candidate_count;
+    double baseline_median_ms;
+    double candidate_median_ms;
+    double change;          // candidate / baseline median - 1
+    double p_value;
+    double min_p_value;     // mann_whitney_min_p of the sample counts
+    CompareVerdict verdict;
+};
+
+/**
+ * Compare the series two runs have in common.
+ *
+ * @param threshold Relative change that counts (0.05 = 5%)
+ * @param alpha Significance level
+ * @return Number of regressions
+ */
+int compare_results_runs(const ResultsRun& baseline, const ResultsRun& candidate, double threshold,
+                         double alpha, std::vector<ResultComparison>& comparisons);
+
+/**
+ * Verdict name ("same", "faster", "slower").
+ */
+const char* compare_verdict_name(CompareVerdict verdict);
+
+#endif // __cplusplus
+
+#endif // RESULTS_COMPARE_H
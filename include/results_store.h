@@ -0,0 +1,57 @@
+#ifndef RESULTS_STORE_H
+#define RESULTS_STORE_H
+
+#include <stdio.h>
+#include "environment.h"
+#include "profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Structured benchmark results (JSON Lines, appended).
+//
+// Each run appends a "run" record carrying a run id, the tool, a UTC
+// timestamp and the environment (see environment.h), then one "result"
+// record per kernel and size with every timing sample:
+//
+//   {"record":"run","run_id":"...","tool":"matrix_profile","time":"...","environment":{...}}
+//   {"record":"result","run_id":"...","kernel":"matrix_multiply_naive","size":512,
+//    "threads":1,"samples_ms":[...],"median_ms":...}
+//
+// Runs from different builds or hosts can share one file; matrix_compare
+// (results_compare.h) diffs two of them.
+
+#define RESULTS_RUN_ID_LEN 48
+
+typedef struct {
+    FILE* fp;
+    char run_id[RESULTS_RUN_ID_LEN];
+} ResultsStore;
+
+// Open filename for appending and write the run record
+// Returns 0 on success, -1 if the file cannot be opened
+int results_store_open(ResultsStore* store, const char* filename, const char* tool,
+                       const BenchEnvironment* env);
+
+// Append one result record (threads: 1 for serial kernels)
+// Returns 0 on success, -1 on invalid arguments
+int results_store_add(ResultsStore* store, const char* kernel, int size, int threads,
+                      const double* samples_ms, int count);
+
+// Append every profiler section with samples. Labels of the form
+// <kernel>_<N>x<N> give the kernel and size; a _t<T> suffix of the kernel
+// gives the thread count (1 otherwise)
+// Returns the number of records written, or -1 on invalid arguments
+int results_store_add_profiler(ResultsStore* store, const Profiler* profiler);
+
+void results_store_close(ResultsStore* store);
+
+// Median of count samples (0 for none)
+double results_median(const double* samples, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESULTS_STORE_H
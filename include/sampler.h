@@ -0,0 +1,84 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Statistical sampling profiler.
+//
+// profiler_start/profiler_end only say how long a section took. While the
+// sampler runs, a SIGPROF timer interrupts whichever thread is using CPU
+// every 1/hz seconds of process CPU time (setitimer ITIMER_PROF, so worker
+// threads are sampled too) and records the interrupted instruction, its
+// call stack and the stack of open profiler sections (scopes). Addresses
+// are resolved afterwards from the ELF symbol tables of the loaded objects
+// (static functions included), with C++ names demangled when libstdc++ is
+// loaded; no external tool is needed.
+//
+// Stacks are walked along the frame-pointer chain from the interrupted
+// register state. backtrace() is not async-signal-safe: the unwinder can
+// take the loader lock, so a sample landing in dlopen, dl_iterate_phdr or
+// C++ exception unwinding could deadlock the process. The frame walk only
+// reads the interrupted stack, but it needs frame pointers: the build adds
+// -fno-omit-frame-pointer (CMake option MATRIX_FRAME_POINTERS). Code built
+// without them (libc, most system libraries) shows up as the interrupted
+// function but may hide its callers, as does a sample taken in a function
+// prologue; inlined functions are attributed to their caller.
+// The timer is process-wide: only one sampler runs at a time.
+
+#define SAMPLER_DEFAULT_HZ 997
+#define SAMPLER_DEFAULT_MAX_SAMPLES 65536
+#define SAMPLER_MAX_FRAMES 32
+#define SAMPLER_MAX_SCOPE_DEPTH 8
+
+// Start sampling at hz samples per CPU second (0 = SAMPLER_DEFAULT_HZ)
+// into a buffer of max_samples (0 = SAMPLER_DEFAULT_MAX_SAMPLES); samples
+// beyond that are counted as dropped. Discards the previous profile.
+// Returns 0 on success, -1 if already running, on invalid arguments, or if
+// the buffer or timer cannot be set up
+int sampler_start(int hz, int max_samples);
+
+// Stop sampling; the samples stay available for the reports below
+// Returns the number of samples recorded, or -1 if not running
+int sampler_stop(void);
+
+// Nonzero while sampling
+int sampler_running(void);
+
+// Samples recorded / dropped (buffer full) by the last run
+int sampler_sample_count(void);
+int sampler_dropped_count(void);
+
+// Open and close a scope; profiler_start and profiler_end call these, so
+// every profiler section is a scope. Only the outermost
+// SAMPLER_MAX_SCOPE_DEPTH nested scopes are recorded, and names beyond the
+// first 127 distinct ones are recorded together as "(other)". No effect
+// while the sampler is stopped.
+void sampler_push_scope(const char* name);
+void sampler_pop_scope(const char* name);
+
+// Samples whose innermost scope is name (NULL = samples outside any scope)
+int sampler_scope_samples(const char* name);
+
+// Per-scope hot spots: for every innermost scope, its share of the samples
+// and the top functions by self samples (the interrupted function) with
+// their total samples (anywhere on the stack)
+void sampler_print_hotspots(FILE* fp, int top);
+
+// Write the profile in folded-stack format, one line per distinct stack:
+// "[outer scope];[inner scope];root;...;leaf count", the input of
+// flamegraph.pl and speedscope
+// Returns the number of lines written, or -1 if the file cannot be written
+int sampler_write_folded(const char* filename);
+
+// Free the recorded profile
+void sampler_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLER_H
@@ -0,0 +1,106 @@
+#ifndef SCALING_SWEEP_H
+#define SCALING_SWEEP_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Thread-count and size scaling sweep for the parallel kernels.
+ *
+ * For every kernel (naive, transpose, blocked) the sweep times the serial
+ * kernel and its *_parallel version at each thread count:
+ * - strong scaling: fixed size, speedup and efficiency relative to the
+ *   serial kernel, plus the parallel overhead (time above serial / threads)
+ * - weak scaling: the size grows with the thread count so the work per
+ *   thread stays constant (n = base * threads^(1/3)); efficiency is the
+ *   throughput per thread relative to one thread at the base size
+ *
+ * Results are written as JSON Lines: a "system" record (threads, cores,
+ * cache sizes) followed by one record per measurement.
+ */
+
+/**
+ * Sweep configuration. Empty lists are filled in by run_scaling_sweep
+ * with sweep_default_thread_counts / sweep_default_sizes.
+ */
+struct SweepConfig {
+    std::vector<std::string> kernels;   // subset of "naive", "transpose", "blocked" (empty = all)
+    std::vector<int> threads;
+    std::vector<int> sizes;
+    int max_size = 1024;                // upper bound for default sizes
+    int weak_base_size = 256;           // one-thread size for weak scaling (0 = skip)
+    int iterations = 3;
+};
+
+/**
+ * One measurement of the sweep.
+ */
+struct SweepRecord {
+    std::string scaling;    // "strong" or "weak"
+    std::string kernel;
+    int size;
+    int threads;
+    double time_ms;         // parallel kernel, averaged over iterations
+    double gflops;
+    double serial_ms;       // serial kernel at the same size
+    double speedup;         // serial_ms / time_ms
+    double efficiency;      // strong: speedup / threads; weak: see above
+    double overhead_ms;     // time_ms - serial_ms / threads
+};
+
+/**
+ * Number of physical cores (distinct core/package pairs in sysfs).
+ *
+ * @return Physical core count, or get_hardware_concurrency() if unknown
+ */
+int get_physical_core_count();
+
+/**
+ * Write the "system" JSON Lines record (thread and core counts, cache line
+ * and cache sizes) that opens the sweep and membench result files.
+ */
+void write_system_record(std::ostream& out);
+
+/**
+ * Default thread counts: powers of two up to hardware_threads, the
+ * physical core count and the first SMT thread after it, and
+ * hardware_threads itself; sorted and unique.
+ */
+std::vector<int> sweep_default_thread_counts(int hardware_threads, int physical_cores);
+
+/**
+ * Default sizes: powers of two from 64 to max_size, plus sizes just below
+ * and above each cache capacity, where the three n x n operands
+ * (24 n^2 bytes) stop fitting; multiples of 16, sorted and unique.
+ */
+std::vector<int> sweep_default_sizes(int max_size, int l1_bytes, int l2_bytes, int l3_bytes);
+
+/**
+ * Weak-scaling size for a thread count: base * threads^(1/3), rounded.
+ */
+int sweep_weak_size(int base_size, int threads);
+
+/**
+ * Run the sweep, printing a table as it goes.
+ *
+ * @param config Sweep configuration (empty lists take the defaults)
+ * @param records Vector to store the measurements
+ * @return 0 on success, -1 on an unknown kernel name
+ */
+int run_scaling_sweep(const SweepConfig& config, std::vector<SweepRecord>& records);
+
+/**
+ * Write a system record followed by the measurements as JSON Lines.
+ *
+ * @return 0 on success, -1 if the file cannot be written
+ */
+int save_sweep_results(const std::vector<SweepRecord>& records, const char* filename);
+
+#endif // __cplusplus
+
+#endif // SCALING_SWEEP_H
@@ -0,0 +1,73 @@
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Matrix transposition engine.
+//
+// Out-of-place transposes walk TRANSPOSE_TILE x TRANSPOSE_TILE tiles so that
+// both the reads and the strided writes of one tile stay in L1; inside a tile
+// 4 x 4 blocks are transposed in registers (AVX) or element by element
+// (portable). In-place transposes swap tile pairs (square) or follow the
+// permutation cycles (rectangular).
+
+// Tile edge in elements (32 x 32 doubles = 8 KB per tile)
+#define TRANSPOSE_TILE 32
+
+// Code paths (selected at runtime from CPU features)
+typedef enum {
+    TRANSPOSE_PATH_AUTO = 0,
+    TRANSPOSE_PATH_PORTABLE,
+    TRANSPOSE_PATH_AVX          // 4 x 4 in-register transposes (unpack + permute)
+} TransposePath;
+
+// dst = src^T: src is rows x cols (leading dimension ld_src), dst is
+// cols x rows (leading dimension ld_dst). src and dst must not overlap.
+void transpose_out_of_place(const double* src, int rows, int cols, int ld_src,
+                            double* dst, int ld_dst);
+
+// Same, restricted to source rows [row_start, row_end); disjoint row ranges
+// write disjoint dst columns, so ranges can run on different threads
+void transpose_out_of_place_rows(const double* src, int rows, int cols, int ld_src,
+                                 double* dst, int ld_dst, int row_start, int row_end);
+
+// In-place transpose of a dense n x n matrix
+void transpose_in_place_square(double* data, int n);
+
+// In-place transpose of a dense rows x cols matrix into cols x rows
+// (cycle following; needs a rows * cols bit visited map)
+// Returns 0 on success, -1 on invalid arguments or allocation failure
+int transpose_in_place(double* data, int rows, int cols);
+
+// dst = src^T (dst must be src->cols x src->rows)
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_transpose(Matrix* src, Matrix* dst);
+
+// Transpose m in place; rows and cols are swapped
+// Returns 0 on success, -1 on error
+int matrix_transpose_in_place(Matrix* m);
+
+// Parallel out-of-place transpose (C++ library; threads split source rows
+// in whole tiles). num_threads = 0 auto-detects.
+// Returns 0 on success, -1 on dimension mismatch
+int matrix_transpose_parallel(Matrix* src, Matrix* dst, int num_threads);
+
+// Force a code path (TRANSPOSE_PATH_AUTO restores CPU detection)
+// Returns the path that will actually be used
+TransposePath transpose_select_path(TransposePath path);
+
+// Path currently used by the out-of-place and square in-place kernels
+TransposePath transpose_active_path(void);
+
+// Human readable path name
+const char* transpose_path_name(TransposePath path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRANSPOSE_H
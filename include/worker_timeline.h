@@ -0,0 +1,124 @@
+#ifndef WORKER_TIMELINE_H
+#define WORKER_TIMELINE_H
+
+#ifdef __cplusplus
+
+#include <deque>
+
+/**
+ * Per-worker timeline of the parallel kernels.
+ *
+ * While a timeline is attached to the calling thread, every parallel kernel
+ * of matrix_parallel.cpp and concurrent_matrix.cpp records each of its
+ * workers: when the launching thread created it, when its body started and
+ * ended, and how many work items (rows, or elements for the initialisation
+ * kernels) it was given. Each launch of workers is a phase; the transpose
+ * kernels have two, the transpose of B and the multiplication. Without a
+ * timeline the kernels only pay a null check per worker.
+ *
+ * The summary splits poor scaling into its usual causes:
+ * - spawn latency: from creating a thread to its first instruction
+ * - imbalance: the slowest worker's busy time over the mean busy time
+ * - idle tail: from the first worker finishing to the last one finishing,
+ *   while finished workers' cores sit idle
+ * What remains (every worker busy, yet slow) points at memory bandwidth.
+ */
+
+/**
+ * One worker of one phase. Times are get_time_ms() values.
+ */
+struct WorkerSpan {
+    int phase;
+    bool caller_thread;  // run by the launching thread itself (no spawn)
+    double spawn_ms;     // launching thread about to create the worker
+    double start_ms;     // worker body entered
+    double end_ms;       // worker body left
+    long long items;
+};
+
+/**
+ * Workers recorded since the last clear().
+ */
+struct WorkerTimeline {
+    // A deque, so the launching thread can append while earlier workers
+    // write their own spans
+    std::deque<WorkerSpan> spans;
+    int phases = 0;
+
+    void clear() {
+        spans.clear();
+        phases = 0;
+    }
+};
+
+/**
+ * Summary of a timeline. Imbalance and worker count describe the main
+ * phase, the one with the most busy time; spawn latency covers every
+ * spawned worker, and the idle tail is summed over phases.
+ */
+struct WorkerTimelineStats {
+    int workers;
+    int phases;
+    int main_phase;                 // -1 for an empty timeline
+    double spawn_latency_ms;        // mean
+    double max_spawn_latency_ms;
+    double imbalance;               // max / mean busy time; 1 = balanced, 0 = no workers
+    double idle_tail_ms;
+};
+
+/**
+ * Record the workers of parallel kernels called from this thread into
+ * timeline (nullptr stops recording). The timeline must outlive the calls.
+ */
+void worker_timeline_attach(WorkerTimeline* timeline);
+
+/**
+ * Timeline attached to this thread, or nullptr.
+ */
+WorkerTimeline* worker_timeline_attached();
+
+/**
+ * Summarise a timeline.
+ */
+WorkerTimelineStats worker_timeline_stats(const WorkerTimeline& timeline);
+
+/**
+ * One launch of workers, for use inside the kernels: spawn() just before
+ * creating each thread, run_here() for a range the launching thread runs,
+ * and a WorkerSpanScope around the worker body.
+ */
+class WorkerPhase {
+public:
+    WorkerPhase();
+
+    /** Span of the next worker thread, or nullptr when not recording. */
+    WorkerSpan* spawn(long long items);
+
+    /** Span of work done by the launching thread, or nullptr. */
+    WorkerSpan* run_here(long long items);
+
+private:
+    WorkerSpan* add(long long items, bool caller_thread);
+
+    WorkerTimeline* timeline_;
+    int phase_;
+};
+
+/**
+ * Stamps the start and end of a worker body on a span (no-op for nullptr).
+ */
+class WorkerSpanScope {
+public:
+    explicit WorkerSpanScope(WorkerSpan* span);
+    ~WorkerSpanScope();
+
+private:
+    WorkerSpanScope(const WorkerSpanScope&);
+    WorkerSpanScope& operator=(const WorkerSpanScope&);
+
+    WorkerSpan* span_;
+};
+
+#endif // __cplusplus
+
+#endif // WORKER_TIMELINE_H
@@ -39,8 +39,11 @@ if [ -f "profile_results.csv" ]; then
     echo "----------------------------------------------"
     
     # Skip header and sort by time (descending)
-    tail -n +2 profile_results.csv | sort -t',' -k2 -nr | head -20 | while IFS=',' read -r section time_ms; do
-        printf "%-40s %10.4f ms\n" "$section" "$time_ms"
+    # Later columns: minor/major page faults, peak RSS growth, bytes allocated
+    tail -n +2 profile_results.csv | sort -t',' -k2 -nr | head -20 | \
+        while IFS=',' read -r section time_ms minor major rss_kb alloc _; do
+        printf "%-40s %10.4f ms %10s flt %8s KB RSS %12s B alloc\n" "$section" "$time_ms" \
+            "${minor:--}" "${rss_kb:--}" "${alloc:--}"
     done
     
     echo ""
@@ -49,7 +52,7 @@ if [ -f "profile_results.csv" ]; then
     
     # Extract multiplication times (naive vs transpose vs blocked)
     echo "Naive multiplication:"
-    grep "matrix_multiply_naive" profile_results.csv | while IFS=',' read -r section time_ms; do
+    grep "matrix_multiply_naive" profile_results.csv | while IFS=',' read -r section time_ms _; do
         # Extract size from section name
         size=$(echo "$section" | grep -oP '\d+x\d+' | head -1)
         printf "Size %s: %10.4f ms\n" "$size" "$time_ms"
@@ -57,7 +60,7 @@ if [ -f "profile_results.csv" ]; then
     
     echo ""
     echo "Transpose-optimized multiplication:"
-    grep "matrix_multiply_transpose" profile_results.csv | while IFS=',' read -r section time_ms; do
+    grep "matrix_multiply_transpose" profile_results.csv | while IFS=',' read -r section time_ms _; do
         # Extract size from section name
         size=$(echo "$section" | grep -oP '\d+x\d+' | head -1)
         printf "Size %s: %10.4f ms\n" "$size" "$time_ms"
@@ -65,7 +68,7 @@ if [ -f "profile_results.csv" ]; then
     
     echo ""
     echo "Cache-blocked multiplication (tiling):"
-    grep "matrix_multiply_blocked" profile_results.csv | while IFS=',' read -r section time_ms; do
+    grep "matrix_multiply_blocked" profile_results.csv | while IFS=',' read -r section time_ms _; do
         # Extract size from section name
         size=$(echo "$section" | grep -oP '\d+x\d+' | head -1)
         printf "Size %s: %10.4f ms\n" "$size" "$time_ms"
@@ -77,3 +80,15 @@ fi
 
 echo ""
 echo "Profiling complete!"
+
+# Compare against a baseline results store if one was given; a regression
+# fails the script (matrix_compare exits with 1, or 2 when the runs have too
+# few samples for the test to ever fire)
+if [ -n "$1" ]; then
+    echo ""
+    echo "Comparing with baseline $1..."
+    echo "----------------------------------------------"
+    compare=./build/bin/matrix_compare
+    [ -x "$compare" ] || compare=./build/matrix_compare
+    "$compare" "$1" results.jsonl
+fi
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "access_pattern.h"
+#include "matrix.h"
+#include "matrix_random.h"
+#include "perf_counters.h"
+#include "profiler.h"
+
+#define MAX_STRIDES 32
+#define MAX_RESULTS 64
+
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n\n", program_name);
+    printf("Traversal benchmarks over an n x n matrix: row- vs column-major walks,\n");
+    printf("stride sweep, page-stride (TLB reach) sweep and random gather.\n\n");
+    printf("Options:\n");
+    printf("  --size <N>          Matrix size (default: 4096, i.e. 128 MB)\n");
+    printf("  --strides <a,b>     Strides in elements (default: 1, 2, 4, ..., 4096)\n");
+    printf("  --max-pages <N>     Largest page-stride sweep point (default: all pages)\n");
+    printf("  --iterations <N>    Timed passes per pattern, best is reported (default: 3)\n");
+    printf("  --counters          Read hardware cache / TLB miss counters (Linux perf)\n");
+    printf("  --output <file>     Output CSV file (default: access_patterns.csv)\n");
+    printf("  --profile <file>    Also save the profiler sections to a CSV file\n");
+    printf("  --help              Show this help message\n");
+    printf("\nExamples:\n");
+    printf("  %s --size 2048 --counters\n", program_name);
+    printf("  %s --strides 1,8,64,512 --max-pages 4096\n", program_name);
+}
+
+// Comma separated list of positive integers; returns the count, 0 on any invalid entry
+static int parse_size_list(const char* text, size_t* values, int max_values) {
+    int count = 0;
+    const char* p = text;
+    while (*p) {
+        char* end = NULL;
+        long value = strtol(p, &end, 10);
+        if (end == p || value <= 0 || count >= max_values) return 0;
+        values[count++] = (size_t)value;
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return 0;
+        }
+        p = end;
+    }
+    return count;
+}
+
+static void print_header(int show_counters) {
+    printf("%-14s %8s %12s %12s %10s", "Pattern", "Param", "Time (ms)", "ns/access", "GB/s");
+    if (show_counters) {
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            char name[32];
+            snprintf(name, sizeof(name), "%s/acc", perf_counter_name((PerfCounter)c));
+            printf(" %16s", name);
+        }
+    }
+    printf("\n");
+}
+
+static void print_result(const AccessResult* r, int show_counters, const PerfCounters* pc) {
+    printf("%-14s %8zu %12.3f %12.3f %10.2f", access_pattern_name(r->pattern), r->param,
+           r->ms, r->ns_per_access, r->gbs);
+    if (show_counters) {
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (perf_counter_available(pc, (PerfCounter)c)) {
+                printf(" %16.4f", (double)r->counters[c] / (double)r->accesses);
+            } else {
+                printf(" %16s", "-");
+            }
+        }
+    }
+    printf("\n");
+}
+
+static int save_results(const AccessResult* results, int count, const PerfCounters* pc,
+                        const char* filename) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open %s for writing\n", filename);
+        return -1;
+    }
+    fprintf(fp, "pattern,param,accesses,time_ms,ns_per_access,gbs");
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        fprintf(fp, ",%s", perf_counter_name((PerfCounter)c));
+    }
+    fprintf(fp, "\n");
+    for (int i = 0; i < count; i++) {
+        const AccessResult* r = &results[i];
+        fprintf(fp, "%s,%zu,%zu,%.6f,%.6f,%.6f", access_pattern_name(r->pattern), r->param,
+                r->accesses, r->ms, r->ns_per_access, r->gbs);
+        // Unavailable counters are left empty rather than written as 0
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (pc && perf_counter_available(pc, (PerfCounter)c)) {
+                fprintf(fp, ",%llu", (unsigned long long)r->counters[c]);
+            } else {
+                fprintf(fp, ",");
+            }
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    printf("Results saved to %s\n", filename);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int size = 4096;
+    size_t strides[MAX_STRIDES];
+    int num_strides = 0;
+    size_t max_pages = 0;
+    int iterations = 3;
+    int use_counters = 0;
+    const char* output_file = "access_patterns.csv";
+    const char* profile_file = NULL;
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+            if (size <= 0) {
+                fprintf(stderr, "Error: Size must be > 0\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--strides") == 0 && i + 1 < argc) {
+            num_strides = parse_size_list(argv[++i], strides, MAX_STRIDES);
+            if (num_strides == 0) {
+                fprintf(stderr, "Error: --strides needs a comma separated list of positive strides\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--max-pages") == 0 && i + 1 < argc) {
+            long value = atol(argv[++i]);
+            if (value <= 0) {
+                fprintf(stderr, "Error: Max pages must be > 0\n");
+                return 1;
+            }
+            max_pages = (size_t)value;
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations <= 0) {
+                fprintf(stderr, "Error: Iterations must be > 0\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            use_counters = 1;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_file = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_strides == 0) {
+        for (size_t s = 1; s <= 4096; s *= 2) strides[num_strides++] = s;
+    }
+
+    Matrix* m = matrix_create(size, size);
+    if (!m) {
+        fprintf(stderr, "Error: cannot allocate %d x %d matrix\n", size, size);
+        return 1;
+    }
+    matrix_randomize(m);
+
+    size_t total_pages = access_page_count(m);
+    if (max_pages == 0 || max_pages > total_pages) max_pages = total_pages;
+
+    PerfCounters counters;
+    PerfCounters* pc = NULL;
+    if (use_counters) {
+        if (perf_counters_open(&counters) == 0) {
+            fprintf(stderr, "Warning: no hardware counters available (perf_event_paranoid or VM)\n");
+        }
+        pc = &counters;
+    }
+
+    Profiler profiler;
+    profiler_init(&profiler);
+
+    printf("Access patterns over %d x %d doubles (%.1f MB, %zu pages of %zu bytes), best of %d\n",
+           size, size, (double)matrix_elements(m) * sizeof(double) / (1 << 20), total_pages,
+           access_page_size(), iterations);
+    print_header(use_counters);
+
+    AccessResult results[MAX_RESULTS];
+    int count = 0;
+
+    const AccessPattern walks[] = {ACCESS_ROW_MAJOR, ACCESS_COLUMN_MAJOR, ACCESS_RANDOM_GATHER};
+    for (int w = 0; w < 3 && count < MAX_RESULTS; w++) {
+        if (access_run(m, walks[w], 0, iterations, pc, &profiler, &results[count]) != 0) {
+            fprintf(stderr, "Error: %s failed\n", access_pattern_name(walks[w]));
+            continue;
+        }
+        print_result(&results[count++], use_counters, pc);
+    }
+    for (int s = 0; s < num_strides && count < MAX_RESULTS; s++) {
+        if (access_run(m, ACCESS_STRIDE, strides[s], iterations, pc, &profiler, &results[count]) != 0) {
+            fprintf(stderr, "Error: stride %zu failed\n", strides[s]);
+            continue;
+        }
+        print_result(&results[count++], use_counters, pc);
+    }
+    for (size_t pages = 1; pages <= max_pages && count < MAX_RESULTS; pages *= 2) {
+        if (access_run(m, ACCESS_PAGE_STRIDE, pages, iterations, pc, &profiler, &results[count]) != 0) {
+            fprintf(stderr, "Error: %zu pages failed\n", pages);
+            continue;
+        }
+        print_result(&results[count++], use_counters, pc);
+    }
+
+    int status = save_results(results, count, pc, output_file);
+    if (profile_file) {
+        profiler_save_results(&profiler, profile_file);
+    }
+
+    if (pc) perf_counters_close(pc);
+    matrix_free(m);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#include "access_pattern.h"
+#include "matrix_random.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ACCESS_GATHER_SEED 0x6A7E
+
+double access_sum_row_major(const Matrix* m) {
+    if (!m || !m->data) return 0.0;
+
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for (int i = 0; i < m->rows; i++) {
+        const double* row = m->data + (size_t)i * m->cols;
+        int j = 0;
+        for (; j + 4 <= m->cols; j += 4) {
+            s0 += row[j];
+            s1 += row[j + 1];
+            s2 += row[j + 2];
+            s3 += row[j + 3];
+        }
+        for (; j < m->cols; j++) s0 += row[j];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+double access_sum_column_major(const Matrix* m) {
+    if (!m || !m->data) return 0.0;
+
+    const size_t cols = (size_t)m->cols;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for (int j = 0; j < m->cols; j++) {
+        const double* col = m->data + j;
+        int i = 0;
+        for (; i + 4 <= m->rows; i += 4) {
+            s0 += col[(size_t)i * cols];
+            s1 += col[(size_t)(i + 1) * cols];
+            s2 += col[(size_t)(i + 2) * cols];
+            s3 += col[(size_t)(i + 3) * cols];
+        }
+        for (; i < m->rows; i++) s0 += col[(size_t)i * cols];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+double access_sum_stride(const Matrix* m, size_t stride) {
+    if (!m || !m->data || stride == 0) return 0.0;
+
+    const size_t count = matrix_elements(m);
+    const double* data = m->data;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for (size_t offset = 0; offset < stride && offset < count; offset++) {
+        size_t i = offset;
+        for (; i + 3 * stride < count; i += 4 * stride) {
+            s0 += data[i];
+            s1 += data[i + stride];
+            s2 += data[i + 2 * stride];
+            s3 += data[i + 3 * stride];
+        }
+        for (; i < count; i += stride) s0 += data[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+size_t access_page_size(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+}
+
+size_t access_page_count(const Matrix* m) {
+    if (!m || !m->data) return 0;
+    return matrix_elements(m) * sizeof(double) / access_page_size();
+}
+
+double access_sum_page_stride(const Matrix* m, size_t pages, size_t rounds) {
+    if (!m || !m->data || pages == 0 || pages > access_page_count(m)) return 0.0;
+
+    const size_t page_elems = access_page_size() / sizeof(double);
+    const size_t line_elems = (size_t)get_cache_line_size() / sizeof(double);
+    const size_t lines_per_page = page_elems / (line_elems ? line_elems : 1);
+    const double* data = m->data;
+
+    double s0 = 0.0, s1 = 0.0;
+    for (size_t r = 0; r < rounds; r++) {
+        size_t p = 0;
+        for (; p + 2 <= pages; p += 2) {
+            s0 += data[p * page_elems + (p % lines_per_page) * line_elems];
+            s1 += data[(p + 1) * page_elems + ((p + 1) % lines_per_page) * line_elems];
+        }
+        for (; p < pages; p++) s0 += data[p * page_elems + (p % lines_per_page) * line_elems];
+    }
+    return s0 + s1;
+}
+
+double access_sum_gather(const Matrix* m, const size_t* indices, size_t count) {
+    if (!m || !m->data || !indices) return 0.0;
+
+    const double* data = m->data;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        s0 += data[indices[k]];
+        s1 += data[indices[k + 1]];
+        s2 += data[indices[k + 2]];
+        s3 += data[indices[k + 3]];
+    }
+    for (; k < count; k++) s0 += data[indices[k]];
+    return (s0 + s1) + (s2 + s3);
+}
+
+void access_random_permutation(size_t* indices, size_t count, uint64_t seed) {
+    if (!indices) return;
+    for (size_t i = 0; i < count; i++) {
+        indices[i] = i;
+    }
+    // Fisher-Yates
+    for (size_t i = count; i > 1; i--) {
+        size_t j = (size_t)(random_u64(seed, i) % i);
+        size_t tmp = indices[i - 1];
+        indices[i - 1] = indices[j];
+        indices[j] = tmp;
+    }
+}
+
+const char* access_pattern_name(AccessPattern pattern) {
+    switch (pattern) {
+        case ACCESS_ROW_MAJOR: return "row_major";
+        case ACCESS_COLUMN_MAJOR: return "column_major";
+        case ACCESS_STRIDE: return "stride";
+        case ACCESS_PAGE_STRIDE: return "page_stride";
+        case ACCESS_RANDOM_GATHER: return "random_gather";
+    }
+    return "unknown";
+}
+
+// One pass of a pattern; returns the checksum
+static double run_pass(const Matrix* m, AccessPattern pattern, size_t param, size_t rounds,
+                       const size_t* indices) {
+    switch (pattern) {
+        case ACCESS_ROW_MAJOR: return access_sum_row_major(m);
+        case ACCESS_COLUMN_MAJOR: return access_sum_column_major(m);
+        case ACCESS_STRIDE: return access_sum_stride(m, param);
+        case ACCESS_PAGE_STRIDE: return access_sum_page_stride(m, param, rounds);
+        case ACCESS_RANDOM_GATHER: return access_sum_gather(m, indices, matrix_elements(m));
+    }
+    return 0.0;
+}
+
+int access_run(const Matrix* m, AccessPattern pattern, size_t param, int iterations,
+               PerfCounters* counters, Profiler* profiler, AccessResult* result) {
+    if (!m || !m->data || !result || matrix_elements(m) == 0) return -1;
+    if (pattern < ACCESS_ROW_MAJOR || pattern > ACCESS_RANDOM_GATHER) return -1;
+    if (pattern == ACCESS_STRIDE && param == 0) return -1;
+    if (pattern == ACCESS_PAGE_STRIDE && (param == 0 || param > access_page_count(m))) return -1;
+    if (iterations <= 0) iterations = 1;
+
+    const size_t elements = matrix_elements(m);
+    size_t rounds = 1;
+    size_t accesses = elements;
+    char label[MAX_NAME_LEN];
+    switch (pattern) {
+        case ACCESS_STRIDE:
+            snprintf(label, sizeof(label), "access_stride_%zu", param);
+            break;
+        case ACCESS_PAGE_STRIDE:
+            rounds = elements / param > 0 ? elements / param : 1;
+            accesses = rounds * param;
+            snprintf(label, sizeof(label), "access_pages_%zu", param);
+            break;
+        default:
+            snprintf(label, sizeof(label), "access_%s", access_pattern_name(pattern));
+            param = 0;
+            break;
+    }
+
+    size_t* indices = NULL;
+    if (pattern == ACCESS_RANDOM_GATHER) {
+        indices = (size_t*)malloc(elements * sizeof(size_t));
+        if (!indices) return -1;
+        access_random_permutation(indices, elements, ACCESS_GATHER_SEED);
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->pattern = pattern;
+    result->param = param;
+    result->accesses = accesses;
+
+    // Untimed warm-up: page faults and cache state of a steady run
+    result->checksum = run_pass(m, pattern, param, rounds, indices);
+
+    uint64_t totals[PERF_COUNTER_COUNT] = {0};
+    for (int iter = 0; iter < iterations; iter++) {
+        uint64_t values[PERF_COUNTER_COUNT];
+        if (profiler) profiler_start(profiler, label);
+        if (counters) perf_counters_start(counters);
+        double start = get_time_ms();
+        result->checksum = run_pass(m, pattern, param, rounds, indices);
+        double elapsed = get_time_ms() - start;
+        if (counters) {
+            perf_counters_stop(counters, values);
+            for (int c = 0; c < PERF_COUNTER_COUNT; c++) totals[c] += values[c];
+        }
+        if (profiler) profiler_end(profiler, label);
+        if (iter == 0 || elapsed < result->ms) result->ms = elapsed;
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        result->counters[c] = totals[c] / (uint64_t)iterations;
+    }
+
+    if (result->ms > 0.0) {
+        result->ns_per_access = result->ms * 1e6 / (double)accesses;
+        result->gbs = (double)accesses * sizeof(double) / (result->ms * 1e6);
+    }
+
+    free(indices);
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "antagonist.h"
+#include "matrix.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Work between checks of the stop flag
+const size_t CHUNK_BYTES = 1 << 20;
+
+// Slots live in a std::vector, whose allocator only guarantees
+// alignof(max_align_t) under C++11, so alignas cannot keep them on separate
+// lines. A full line of padding in front of the fields puts more than a
+// line between the fields of neighbouring slots wherever the array starts.
+struct AntagonistSlot {
+    char pad[64];
+    uint64_t bytes = 0;
+    bool failed = false;
+};
+
+#ifdef __linux__
+int pin_thread(pthread_t thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0 ? 0 : -1;
+}
+#endif
+
+// One increment per line, a chunk at a time, until stopped
+void thrash_cache(size_t bytes, const std::atomic<bool>& running, std::atomic<int>& ready,
+                  AntagonistSlot& slot) {
+    const size_t line_doubles = std::max<size_t>(1, get_cache_line_size() / sizeof(double));
+    const size_t count = std::max(line_doubles, bytes / sizeof(double));
+    std::unique_ptr<double[]> buffer(new (std::nothrow) double[count]);
+    if (!buffer) {
+        slot.failed = true;
+        ready.fetch_add(1);
+        return;
+    }
+    volatile double* data = buffer.get();
+    for (size_t i = 0; i < count; i += line_doubles) data[i] = 0.0;
+    ready.fetch_add(1);
+
+    const size_t chunk = std::max(line_doubles, CHUNK_BYTES / sizeof(double));
+    size_t pos = 0;
+    uint64_t lines = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        size_t end = std::min(count, pos + chunk);
+        for (size_t i = pos; i < end; i += line_doubles) {
+            data[i] = data[i] + 1.0;
+            ++lines;
+        }
+        pos = end < count ? end : 0;
+    }
+    slot.bytes = lines * 2 * line_doubles * sizeof(double);
+}
+
+// STREAM copy between two halves of the working set, a chunk at a time
+void hog_bandwidth(size_t bytes, const std::atomic<bool>& running, std::atomic<int>& ready,
+                   AntagonistSlot& slot) {
+    const size_t count = std::max<size_t>(1, bytes / (2 * sizeof(double)));
+    std::unique_ptr<double[]> a(new (std::nothrow) double[count]);
+    std::unique_ptr<double[]> c(new (std::nothrow) double[count]);
+    if (!a || !c) {
+        slot.failed = true;
+        ready.fetch_add(1);
+        return;
+    }
+    std::fill(a.get(), a.get() + count, 1.0);
+    std::fill(c.get(), c.get() + count, 0.0);
+    ready.fetch_add(1);
+
+    const size_t chunk = CHUNK_BYTES / sizeof(double);
+    size_t pos = 0;
+    uint64_t copied = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        size_t end = std::min(count, pos + chunk);
+        std::memcpy(c.get() + pos, a.get() + pos, (end - pos) * sizeof(double));
+        copied += end - pos;
+        pos = end < count ? end : 0;
+    }
+    slot.bytes = copied * 2 * sizeof(double);
+}
+
+}  // namespace
+
+struct Antagonists {
+    std::atomic<bool> running{true};
+    std::atomic<int> ready{0};
+    std::vector<AntagonistSlot> slots;
+    std::vector<std::thread> threads;
+    double start_ms = 0.0;
+};
+
+extern "C" Antagonists* antagonists_start(AntagonistKind kind, int count, size_t working_set_bytes,
+                                          int pin) {
+    if (count <= 0) return nullptr;
+    if (kind < ANTAGONIST_CACHE || kind > ANTAGONIST_BANDWIDTH) return nullptr;
+    if (working_set_bytes == 0) working_set_bytes = antagonist_default_working_set(kind);
+
+    Antagonists* a = new (std::nothrow) Antagonists;
+    if (!a) return nullptr;
+    a->slots.resize(static_cast<size_t>(count));
+    a->threads.reserve(static_cast<size_t>(count));
+
+    for (int t = 0; t < count; ++t) {
+        AntagonistSlot& slot = a->slots[t];
+        if (kind == ANTAGONIST_CACHE) {
+            a->threads.emplace_back(thrash_cache, working_set_bytes, std::cref(a->running),
+                                    std::ref(a->ready), std::ref(slot));
+        } else {
+            a->threads.emplace_back(hog_bandwidth, working_set_bytes, std::cref(a->running),
+                                    std::ref(a->ready), std::ref(slot));
+        }
+#ifdef __linux__
+        if (pin) {
+            int cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            pin_thread(a->threads.back().native_handle(), ((cpus - 1 - t) % cpus + cpus) % cpus);
+        }
+#else
+        (void)pin;
+#endif
+    }
+
+    while (a->ready.load() < count) {
+        std::this_thread::yield();
+    }
+    a->start_ms = get_time_ms();
+
+    for (const AntagonistSlot& slot : a->slots) {
+        if (slot.failed) {
+            antagonists_stop(a);
+            return nullptr;
+        }
+    }
+    return a;
+}
+
+extern "C" double antagonists_stop(Antagonists* antagonists) {
+    if (!antagonists) return -1.0;
+
+    antagonists->running.store(false);
+    for (auto& thread : antagonists->threads) {
+        thread.join();
+    }
+    double elapsed_ms = get_time_ms() - antagonists->start_ms;
+
+    double bytes = 0.0;
+    for (const AntagonistSlot& slot : antagonists->slots) {
+        bytes += static_cast<double>(slot.bytes);
+    }
+    delete antagonists;
+    return elapsed_ms > 0.0 ? bytes / (elapsed_ms * 1e6) : 0.0;
+}
+
+extern "C" size_t antagonist_default_working_set(AntagonistKind kind) {
+    const size_t l3 = static_cast<size_t>(get_l3_cache_size());
+    if (kind == ANTAGONIST_BANDWIDTH) {
+        return std::min<size_t>(256u << 20, std::max<size_t>(64u << 20, 4 * l3));
+    }
+    return l3;
+}
+
+extern "C" int antagonist_pin_current_thread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) return -1;
+    return pin_thread(pthread_self(), cpu);
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+extern "C" const char* antagonist_kind_name(AntagonistKind kind) {
+    switch (kind) {
+        case ANTAGONIST_CACHE: return "cache";
+        case ANTAGONIST_BANDWIDTH: return "bandwidth";
+    }
+    return "unknown";
+}
+
+extern "C" int antagonist_kind_from_name(const char* name, AntagonistKind* kind) {
+    if (!name || !kind) return -1;
+    for (int k = 0; k < ANTAGONIST_KIND_COUNT; ++k) {
+        AntagonistKind candidate = static_cast<AntagonistKind>(k);
+        if (std::strcmp(name, antagonist_kind_name(candidate)) == 0) {
+            *kind = candidate;
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -5,6 +5,8 @@
 #include "profiler.h"
 #include "matrix.h"
 #include "cache_locality.h"
+#include "quantized.h"
+#include "half_precision.h"
 
 // Test matrix multiplication with profiling
 static void test_matrix_multiplication_internal(int size, int block_size, Profiler* profiler) {
@@ -154,6 +156,94 @@ static void test_matrix_multiplication_internal(int size, int block_size, Profil
     }
 #endif
     
+    // Quantized int8 / int16 paths (quantization itself is timed separately)
+    QMatrix* A_q8 = qmatrix_create(size, size, QUANT_INT8);
+    QMatrix* B_q8 = qmatrix_create(size, size, QUANT_INT8);
+    QMatrix* A_q16 = qmatrix_create(size, size, QUANT_INT16);
+    QMatrix* B_q16 = qmatrix_create(size, size, QUANT_INT16);
+    int32_t* C_q8 = (int32_t*)malloc(sizeof(int32_t) * (size_t)size * size);
+    int64_t* C_q16 = (int64_t*)malloc(sizeof(int64_t) * (size_t)size * size);
+
+    if (A_q8 && B_q8 && A_q16 && B_q16 && C_q8 && C_q16) {
+        snprintf(label, sizeof(label), "matrix_quantize_%dx%d", size, size);
+        profiler_start(profiler, label);
+        matrix_quantize(A, A_q8);
+        matrix_quantize(B, B_q8);
+        matrix_quantize(A, A_q16);
+        matrix_quantize(B, B_q16);
+        profiler_end(profiler, label);
+
+        snprintf(label, sizeof(label), "matrix_multiply_int8_%dx%d", size, size);
+        profiler_start(profiler, label);
+        int result_int8 = qmatrix_multiply_int8(A_q8, B_q8, C_q8, block_size);
+        profiler_end(profiler, label);
+
+        if (result_int8 != 0) {
+            fprintf(stderr, "Quantized int8 matrix multiplication failed\n");
+        }
+
+        snprintf(label, sizeof(label), "matrix_multiply_int16_%dx%d", size, size);
+        profiler_start(profiler, label);
+        int result_int16 = qmatrix_multiply_int16(A_q16, B_q16, C_q16, block_size);
+        profiler_end(profiler, label);
+
+        if (result_int16 != 0) {
+            fprintf(stderr, "Quantized int16 matrix multiplication failed\n");
+        }
+    } else {
+        fprintf(stderr, "Failed to allocate quantized matrices\n");
+    }
+
+    qmatrix_free(A_q8);
+    qmatrix_free(B_q8);
+    qmatrix_free(A_q16);
+    qmatrix_free(B_q16);
+    free(C_q8);
+    free(C_q16);
+    
+    // Half-precision storage (bf16 / fp16) with fp32 accumulation
+    HMatrix* A_bf16 = hmatrix_create(size, size, HALF_BF16);
+    HMatrix* B_bf16 = hmatrix_create(size, size, HALF_BF16);
+    HMatrix* A_fp16 = hmatrix_create(size, size, HALF_FP16);
+    HMatrix* B_fp16 = hmatrix_create(size, size, HALF_FP16);
+    Matrix* C_half = matrix_create(size, size);
+
+    if (A_bf16 && B_bf16 && A_fp16 && B_fp16 && C_half) {
+        snprintf(label, sizeof(label), "matrix_to_half_%dx%d", size, size);
+        profiler_start(profiler, label);
+        matrix_to_half(A, A_bf16);
+        matrix_to_half(B, B_bf16);
+        matrix_to_half(A, A_fp16);
+        matrix_to_half(B, B_fp16);
+        profiler_end(profiler, label);
+
+        snprintf(label, sizeof(label), "matrix_multiply_bf16_%dx%d", size, size);
+        profiler_start(profiler, label);
+        int result_bf16 = matrix_multiply_half_blocked(A_bf16, B_bf16, C_half, block_size, HALF_ACCUM_FP32);
+        profiler_end(profiler, label);
+
+        if (result_bf16 != 0) {
+            fprintf(stderr, "bf16 matrix multiplication failed\n");
+        }
+
+        snprintf(label, sizeof(label), "matrix_multiply_fp16_%dx%d", size, size);
+        profiler_start(profiler, label);
+        int result_fp16 = matrix_multiply_half_blocked(A_fp16, B_fp16, C_half, block_size, HALF_ACCUM_FP32);
+        profiler_end(profiler, label);
+
+        if (result_fp16 != 0) {
+            fprintf(stderr, "fp16 matrix multiplication failed\n");
+        }
+    } else {
+        fprintf(stderr, "Failed to allocate half-precision matrices\n");
+    }
+
+    hmatrix_free(A_bf16);
+    hmatrix_free(B_bf16);
+    hmatrix_free(A_fp16);
+    hmatrix_free(B_fp16);
+    matrix_free(C_half);
+    
     // Sanity check: compare results across methods
     double max_diff_transpose = 0.0;
     double max_diff_blocked = 0.0;
@@ -165,7 +255,8 @@ static void test_matrix_multiplication_internal(int size, int block_size, Profil
     double max_diff_blocked_parallel_t1 = 0.0;
     double max_diff_blocked_parallel_t2 = 0.0;
 #endif
-    for (int i = 0; i < size * size; i++) {
+    size_t count = (size_t)size * (size_t)size;
+    for (size_t i = 0; i < count; i++) {
         double naive_val = C_naive->data[i];
         double transpose_val = C_transpose->data[i];
         double blocked_val = C_blocked->data[i];
@@ -254,7 +345,92 @@ static void test_matrix_multiplication_internal(int size, int block_size, Profil
     profiler_end(profiler, label);
 }
 
+// Print operand footprint and accuracy of the reduced-precision paths
+// against the double-precision blocked result
+static void print_precision_report(int size, int block_size) {
+    Matrix* A = matrix_create(size, size);
+    Matrix* B = matrix_create(size, size);
+    Matrix* C_ref = matrix_create(size, size);
+    Matrix* C = matrix_create(size, size);
+    if (!A || !B || !C_ref || !C) {
+        fprintf(stderr, "Failed to allocate matrices for precision report\n");
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C_ref);
+        matrix_free(C);
+        return;
+    }
+    
+    matrix_randomize(A);
+    matrix_randomize(B);
+    matrix_multiply_blocked(A, B, C_ref, block_size);
+    
+    double double_bytes = 2.0 * size * (double)size * sizeof(double);
+    
+    printf("\nPrecision report %dx%d (reference: double blocked)\n", size, size);
+    printf("%-18s %14s %10s %14s %14s\n", "Storage", "A+B bytes", "Saving", "Max abs err", "Rel F-norm err");
+    printf("%-18s %14.0f %9.2fx %14.3e %14.3e\n", "double", double_bytes, 1.0, 0.0, 0.0);
+    
+    const HalfType half_types[] = {HALF_BF16, HALF_FP16};
+    const HalfAccum accums[] = {HALF_ACCUM_FP32, HALF_ACCUM_FP64};
+    for (int t = 0; t < 2; t++) {
+        HMatrix* A_h = hmatrix_create(size, size, half_types[t]);
+        HMatrix* B_h = hmatrix_create(size, size, half_types[t]);
+        if (!A_h || !B_h) {
+            hmatrix_free(A_h);
+            hmatrix_free(B_h);
+            continue;
+        }
+        matrix_to_half(A, A_h);
+        matrix_to_half(B, B_h);
+        double bytes = 2.0 * size * (double)size * sizeof(uint16_t);
+        
+        for (int a = 0; a < 2; a++) {
+            double max_err = 0.0;
+            double rel_err = 0.0;
+            char name[32];
+            matrix_multiply_half_blocked(A_h, B_h, C, block_size, accums[a]);
+            matrix_compare(C_ref, C, &max_err, &rel_err);
+            snprintf(name, sizeof(name), "%s/%s acc", half_type_name(half_types[t]),
+                     accums[a] == HALF_ACCUM_FP32 ? "fp32" : "fp64");
+            printf("%-18s %14.0f %9.2fx %14.3e %14.3e\n", name, bytes, double_bytes / bytes, max_err, rel_err);
+        }
+        
+        hmatrix_free(A_h);
+        hmatrix_free(B_h);
+    }
+    
+    const QuantType quant_types[] = {QUANT_INT8, QUANT_INT16};
+    for (int t = 0; t < 2; t++) {
+        QMatrix* A_q = qmatrix_create(size, size, quant_types[t]);
+        QMatrix* B_q = qmatrix_create(size, size, quant_types[t]);
+        if (A_q && B_q && matrix_quantize(A, A_q) == 0 && matrix_quantize(B, B_q) == 0 &&
+            qmatrix_multiply(A_q, B_q, C, block_size) == 0) {
+            double max_err = 0.0;
+            double rel_err = 0.0;
+            size_t elem = (quant_types[t] == QUANT_INT8) ? sizeof(int8_t) : sizeof(int16_t);
+            double bytes = 2.0 * size * (double)size * elem;
+            matrix_compare(C_ref, C, &max_err, &rel_err);
+            printf("%-18s %14.0f %9.2fx %14.3e %14.3e\n",
+                   quant_types[t] == QUANT_INT8 ? "int8" : "int16",
+                   bytes, double_bytes / bytes, max_err, rel_err);
+        }
+        qmatrix_free(A_q);
+        qmatrix_free(B_q);
+    }
+    
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+    matrix_free(C);
+}
+
 void test_cache_locality_speedup(int size, int iterations, const char* output_file) {
+    test_cache_locality_speedup_store(size, iterations, output_file, NULL);
+}
+
+void test_cache_locality_speedup_store(int size, int iterations, const char* output_file,
+                                       ResultsStore* store) {
     Profiler profiler;
     profiler_init(&profiler);
     
@@ -283,6 +459,16 @@ void test_cache_locality_speedup(int size, int iterations, const char* output_fi
     printf("Threads used for parallel runs: 1 and 2\n\n");
 #endif
     
+    // Operand traffic per flop if every operand is streamed once:
+    // (A + B inputs + C output) / (2 * size^3)
+    double flops = 2.0 * size * (double)size * size;
+    double elems_in = 2.0 * size * (double)size;
+    double elems_out = (double)size * size;
+    printf("Quantized GEMM path: %s\n", qgemm_path_name(qgemm_active_path()));
+    printf("Bytes/flop (double): %.5f\n", (elems_in * sizeof(double) + elems_out * sizeof(double)) / flops);
+    printf("Bytes/flop (int16 -> int64): %.5f\n", (elems_in * sizeof(int16_t) + elems_out * sizeof(int64_t)) / flops);
+    printf("Bytes/flop (int8 -> int32): %.5f\n\n", (elems_in * sizeof(int8_t) + elems_out * sizeof(int32_t)) / flops);
+    
     printf("Testing %dx%d matrix multiplication (%d iterations)...\n", 
            size, size, iterations);
     
@@ -294,4 +480,9 @@ void test_cache_locality_speedup(int size, int iterations, const char* output_fi
     profiler_print_results(&profiler);
     const char* file_to_save = output_file ? output_file : "profile_results.csv";
     profiler_save_results(&profiler, file_to_save);
+    if (store) {
+        results_store_add_profiler(store, &profiler);
+    }
+    
+    print_precision_report(size, block_size);
 }
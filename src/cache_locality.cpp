@@ -150,7 +150,8 @@ static void test_matrix_multiplication_internal(int size, int block_size, Profil
     double max_diff_transpose_parallel_t2 = 0.0;
     double max_diff_blocked_parallel_t1 = 0.0;
     double max_diff_blocked_parallel_t2 = 0.0;
-    for (int i = 0; i < size * size; i++) {
+    size_t count = (size_t)size * (size_t)size;
+    for (size_t i = 0; i < count; i++) {
         double naive_val = C_naive->data[i];
         double transpose_val = C_transpose->data[i];
         double blocked_val = C_blocked->data[i];
@@ -107,7 +107,8 @@ static void test_matrix_multiplication_internal(int size, int block_size, int nu
     double max_diff_naive_parallel = 0.0;
     double max_diff_transpose_parallel = 0.0;
     double max_diff_blocked_parallel = 0.0;
-    for (int i = 0; i < size * size; i++) {
+    size_t count = (size_t)size * (size_t)size;
+    for (size_t i = 0; i < count; i++) {
         double naive_val = C_naive->data[i];
         double transpose_val = C_transpose->data[i];
         double blocked_val = C_blocked->data[i];
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "results_compare.h"
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " <baseline.jsonl> [candidate.jsonl] [options]\n\n";
+    std::cout << "Compares two runs of a results store (written by matrix_profile,\n";
+    std::cout << "matrix_profile_cpp and matrix_concurrent_bench) per kernel, size and\n";
+    std::cout << "thread count with a Mann-Whitney U test on the timing samples.\n";
+    std::cout << "With one file, its last run is compared against the run before it.\n";
+    std::cout << "Exits with 1 if any result is significantly slower by more than the\n";
+    std::cout << "threshold, 2 on errors or when a result has too few samples to ever\n";
+    std::cout << "be significant at the chosen alpha.\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --baseline-run <id>  Baseline run id (default: last run of the baseline file)\n";
+    std::cout << "  --candidate-run <id> Candidate run id (default: last run of the candidate file)\n";
+    std::cout << "  --threshold <pct>    Slowdown that counts as a regression (default: 5)\n";
+    std::cout << "  --alpha <p>          Significance level (default: 0.05)\n";
+    std::cout << "  --all                Show every comparison, not only significant changes\n";
+    std::cout << "  --help               Show this help message\n";
+    std::cout << "\nExamples:\n";
+    std::cout << "  " << program_name << " baseline/results.jsonl results.jsonl --threshold 3\n";
+    std::cout << "  " << program_name << " results.jsonl --all\n";
+}
+
+// Run with the given id, or the last run (offset from the end) when id is empty
+const ResultsRun* select_run(const std::vector<ResultsRun>& runs, const std::string& id, size_t from_end) {
+    if (!id.empty()) {
+        for (const ResultsRun& run : runs) {
+            if (run.run_id == id) return &run;
+        }
+        return nullptr;
+    }
+    return runs.size() > from_end ? &runs[runs.size() - 1 - from_end] : nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    std::string baseline_id;
+    std::string candidate_id;
+    double threshold = 0.05;
+    double alpha = 0.05;
+    bool show_all = false;
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--baseline-run") == 0 && i + 1 < argc) {
+            baseline_id = argv[++i];
+        } else if (strcmp(argv[i], "--candidate-run") == 0 && i + 1 < argc) {
+            candidate_id = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]) / 100.0;
+            if (threshold < 0.0) {
+                std::cerr << "Error: Threshold must be >= 0\n";
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = std::atof(argv[++i]);
+            if (alpha <= 0.0 || alpha >= 1.0) {
+                std::cerr << "Error: Alpha must be between 0 and 1\n";
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--all") == 0) {
+            show_all = true;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty() || files.size() > 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<ResultsRun> baseline_runs;
+    std::vector<ResultsRun> candidate_runs;
+    if (load_results_runs(files[0].c_str(), baseline_runs) < 0) {
+        std::cerr << "Error: Cannot read " << files[0] << "\n";
+        return 2;
+    }
+    if (files.size() == 2 && load_results_runs(files[1].c_str(), candidate_runs) < 0) {
+        std::cerr << "Error: Cannot read " << files[1] << "\n";
+        return 2;
+    }
+
+    // One file: last run against the one before it
+    const bool single = files.size() == 1;
+    const std::vector<ResultsRun>& candidates = single ? baseline_runs : candidate_runs;
+    const ResultsRun* baseline = select_run(baseline_runs, baseline_id, single && candidate_id.empty() ? 1 : 0);
+    const ResultsRun* candidate = select_run(candidates, candidate_id, 0);
+    if (!baseline || !candidate) {
+        std::cerr << "Error: " << (baseline ? "candidate" : "baseline") << " run not found\n";
+        return 2;
+    }
+
+    std::vector<ResultComparison> comparisons;
+    int regressions = compare_results_runs(*baseline, *candidate, threshold, alpha, comparisons);
+
+    std::cout << "Baseline:  " << baseline->run_id << " (" << baseline->tool << ", " << baseline->time << ")\n";
+    std::cout << "Candidate: " << candidate->run_id << " (" << candidate->tool << ", " << candidate->time << ")\n";
+    std::cout << "Threshold: " << threshold * 100.0 << "%, alpha: " << alpha << "\n\n";
+    std::cout << std::left << std::setw(40) << "Kernel" << std::right << std::setw(7) << "Size"
+              << std::setw(8) << "Threads" << std::setw(14) << "Base (ms)" << std::setw(14) << "New (ms)"
+              << std::setw(10) << "Change" << std::setw(10) << "p" << std::setw(9) << "Verdict" << "\n";
+    std::cout << std::string(112, '-') << "\n";
+
+    int shown = 0;
+    int too_few = 0;
+    for (const ResultComparison& c : comparisons) {
+        if (c.min_p_value >= alpha) ++too_few;
+        if (!show_all && c.verdict == COMPARE_SAME) continue;
+        std::cout << std::left << std::setw(40) << c.kernel << std::right << std::setw(7) << c.size
+                  << std::setw(8) << c.threads << std::fixed << std::setprecision(4)
+                  << std::setw(14) << c.baseline_median_ms << std::setw(14) << c.candidate_median_ms
+                  << std::setw(9) << std::setprecision(1) << c.change * 100.0 << "%"
+                  << std::setw(10) << std::setprecision(4) << c.p_value
+                  << std::setw(9) << compare_verdict_name(c.verdict) << "\n";
+        ++shown;
+    }
+    if (shown == 0) {
+        std::cout << "(no significant changes)\n";
+    }
+
+    std::cout << "\n" << comparisons.size() << " compared, " << regressions << " regression(s)\n";
+    if (too_few > 0) {
+        // The gate could never fire for these; fail rather than pass silently
+        std::cerr << "Error: " << too_few << " comparison(s) have too few samples to be significant at alpha "
+                  << alpha << "; raise --iterations\n";
+        return 2;
+    }
+    return regressions > 0 ? 1 : 0;
+}
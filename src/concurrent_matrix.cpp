@@ -1,5 +1,9 @@
 #include "concurrent_matrix.h"
 #include "profiler.h"
+#include "dot_kernel.h"
+#include "transpose.h"
+#include "matrix_random.h"
+#include "worker_timeline.h"
 #include <thread>
 #include <vector>
 #include <mutex>
@@ -10,6 +14,8 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <cctype>
+#include <string>
 
 // Get the number of hardware threads available
 int get_hardware_concurrency() {
@@ -26,9 +32,9 @@ static void naive_multiply_worker(Matrix* A, Matrix* B, Matrix* C,
                                    int start_row, int end_row) {
     int N = A->cols;
     int P = B->cols;
-    int a_stride = A->cols;
-    int b_stride = B->cols;
-    int c_stride = C->cols;
+    size_t a_stride = static_cast<size_t>(A->cols);
+    size_t b_stride = static_cast<size_t>(B->cols);
+    size_t c_stride = static_cast<size_t>(C->cols);
     
     double* a_data = A->data;
     double* b_data = B->data;
@@ -65,14 +71,21 @@ int matrix_multiply_naive_concurrent(Matrix* A, Matrix* B, Matrix* C, int num_th
     
     // Create threads
     std::vector<std::thread> threads;
-    int rows_per_thread = (M + actual_threads - 1) / actual_threads;
+    // Boundaries on cache lines of C, so no line is written by two threads
+    std::vector<int> bounds(actual_threads + 1);
+    matrix_partition_rows(C->data, C->cols, M, actual_threads, bounds.data());
+    WorkerPhase phase;
     
     for (int t = 0; t < actual_threads; t++) {
-        int start_row = t * rows_per_thread;
-        int end_row = std::min((t + 1) * rows_per_thread, M);
+        int start_row = bounds[t];
+        int end_row = bounds[t + 1];
         
         if (start_row < end_row) {
-            threads.emplace_back(naive_multiply_worker, A, B, C, start_row, end_row);
+            WorkerSpan* span = phase.spawn(end_row - start_row);
+            threads.emplace_back([A, B, C, span, start_row, end_row]() {
+                WorkerSpanScope scope(span);
+                naive_multiply_worker(A, B, C, start_row, end_row);
+            });
         }
     }
     
@@ -93,25 +106,11 @@ static void transpose_multiply_worker(Matrix* A, Matrix* B_T, Matrix* C,
                                        int start_row, int end_row) {
     int N = A->cols;
     int P = B_T->rows;  // B_T is P x N
-    int a_stride = A->cols;
-    int bt_stride = B_T->cols;  // N
-    int c_stride = C->cols;
     
-    double* a_data = A->data;
-    double* bt_data = B_T->data;
-    double* c_data = C->data;
-    
-    // Process rows [start_row, end_row)
-    for (int i = start_row; i < end_row; i++) {
-        for (int j = 0; j < P; j++) {
-            double sum = 0.0;
-            for (int k = 0; k < N; k++) {
-                // A[i][k] and B_T[j][k] both have contiguous access
-                sum += a_data[i * a_stride + k] * bt_data[j * bt_stride + k];
-            }
-            c_data[i * c_stride + j] = sum;
-        }
-    }
+    // Process rows [start_row, end_row) with the register-blocked kernel:
+    // A[i][k] and B_T[j][k] both have contiguous access
+    dot_kernel_rows(A->data, A->cols, B_T->data, B_T->cols, C->data, C->cols,
+                    N, P, start_row, end_row);
 }
 
 int matrix_multiply_transpose_concurrent(Matrix* A, Matrix* B, Matrix* C, int num_threads) {
@@ -136,27 +135,26 @@ int matrix_multiply_transpose_concurrent(Matrix* A, Matrix* B, Matrix* C, int nu
     Matrix* B_T = matrix_create(P, N);
     if (!B_T) return -1;
     
-    // Transpose B into B_T (can also be parallelized for large matrices)
-    double* b_data = B->data;
-    double* bt_data = B_T->data;
-    int b_stride = B->cols;
-    
-    for (int i = 0; i < B->rows; i++) {
-        for (int j = 0; j < B->cols; j++) {
-            bt_data[j * N + i] = b_data[i * b_stride + j];
-        }
-    }
+    // Transpose B into B_T with the same threads as the multiplication
+    matrix_transpose_parallel(B, B_T, actual_threads);
     
     // Create threads for multiplication
     std::vector<std::thread> threads;
-    int rows_per_thread = (M + actual_threads - 1) / actual_threads;
+    // Boundaries on cache lines of C, so no line is written by two threads
+    std::vector<int> bounds(actual_threads + 1);
+    matrix_partition_rows(C->data, C->cols, M, actual_threads, bounds.data());
+    WorkerPhase phase;
     
     for (int t = 0; t < actual_threads; t++) {
-        int start_row = t * rows_per_thread;
-        int end_row = std::min((t + 1) * rows_per_thread, M);
+        int start_row = bounds[t];
+        int end_row = bounds[t + 1];
         
         if (start_row < end_row) {
-            threads.emplace_back(transpose_multiply_worker, A, B_T, C, start_row, end_row);
+            WorkerSpan* span = phase.spawn(end_row - start_row);
+            threads.emplace_back([A, B_T, C, span, start_row, end_row]() {
+                WorkerSpanScope scope(span);
+                transpose_multiply_worker(A, B_T, C, start_row, end_row);
+            });
         }
     }
     
@@ -180,9 +178,9 @@ static void blocked_multiply_worker(Matrix* A, Matrix* B, Matrix* C,
     double* a_data = A->data;
     double* b_data = B->data;
     double* c_data = C->data;
-    int a_stride = A->cols;
-    int b_stride = B->cols;
-    int c_stride = C->cols;
+    size_t a_stride = static_cast<size_t>(A->cols);
+    size_t b_stride = static_cast<size_t>(B->cols);
+    size_t c_stride = static_cast<size_t>(C->cols);
     
     // Process block rows [start_ii, end_ii)
     for (int ii = start_ii; ii < end_ii; ii += BLOCK) {
@@ -249,14 +247,18 @@ int matrix_multiply_blocked_concurrent(Matrix* A, Matrix* B, Matrix* C,
     std::vector<std::thread> threads;
     int block_rows_per_thread = ((M + BLOCK - 1) / BLOCK + actual_threads - 1) / actual_threads;
     int block_row_step = block_rows_per_thread * BLOCK;
+    WorkerPhase phase;
     
     for (int t = 0; t < actual_threads; t++) {
         int start_ii = t * block_row_step;
         int end_ii = std::min((t + 1) * block_row_step, M);
         
         if (start_ii < end_ii) {
-            threads.emplace_back(blocked_multiply_worker, A, B, C, 
-                                  M, N, P, BLOCK, start_ii, end_ii);
+            WorkerSpan* span = phase.spawn(end_ii - start_ii);
+            threads.emplace_back([A, B, C, M, N, P, BLOCK, span, start_ii, end_ii]() {
+                WorkerSpanScope scope(span);
+                blocked_multiply_worker(A, B, C, M, N, P, BLOCK, start_ii, end_ii);
+            });
         }
     }
     
@@ -300,8 +302,9 @@ void benchmark_concurrent_methods(int size, int iterations, int num_threads,
         return;
     }
     
-    matrix_randomize(A);
-    matrix_randomize(B);
+    // Fixed seeds: every run and thread count benchmarks the same operands
+    matrix_randomize_parallel(A, 1, actual_threads);
+    matrix_randomize_parallel(B, 2, actual_threads);
     
     // Calculate optimal block size
     int l1_size = get_l1_cache_size();
@@ -320,6 +323,7 @@ void benchmark_concurrent_methods(int size, int iterations, int num_threads,
         ConcurrentBenchmarkResult result;
         result.method_name = method_names[method];
         result.num_threads = actual_threads;
+        result.size = size;
         result.sequential_ms = 0.0;
         result.concurrent_ms = 0.0;
         
@@ -337,12 +341,16 @@ void benchmark_concurrent_methods(int size, int iterations, int num_threads,
             
             double end_time = get_time_ms_internal();
             result.sequential_ms += (end_time - start_time);
+            result.sequential_samples.push_back(end_time - start_time);
         }
         result.sequential_ms /= iterations;
         
-        // Concurrent benchmark
+        // Concurrent benchmark, recording the workers of every run
+        WorkerTimelineStats stats_sum = {0, 0, -1, 0.0, 0.0, 0.0, 0.0};
+        worker_timeline_attach(&result.timeline);
         for (int iter = 0; iter < iterations; iter++) {
             matrix_zeros(C_conc);
+            result.timeline.clear();
             
             double start_time = get_time_ms_internal();
             
@@ -354,15 +362,31 @@ void benchmark_concurrent_methods(int size, int iterations, int num_threads,
             
             double end_time = get_time_ms_internal();
             result.concurrent_ms += (end_time - start_time);
+            result.concurrent_samples.push_back(end_time - start_time);
+            
+            WorkerTimelineStats stats = worker_timeline_stats(result.timeline);
+            stats_sum.spawn_latency_ms += stats.spawn_latency_ms;
+            stats_sum.max_spawn_latency_ms = std::max(stats_sum.max_spawn_latency_ms, stats.max_spawn_latency_ms);
+            stats_sum.imbalance += stats.imbalance;
+            stats_sum.idle_tail_ms += stats.idle_tail_ms;
+            stats_sum.workers = stats.workers;
+            stats_sum.phases = stats.phases;
+            stats_sum.main_phase = stats.main_phase;
         }
+        worker_timeline_attach(nullptr);
         result.concurrent_ms /= iterations;
+        result.worker_stats = stats_sum;
+        result.worker_stats.spawn_latency_ms /= iterations;
+        result.worker_stats.imbalance /= iterations;
+        result.worker_stats.idle_tail_ms /= iterations;
         
         // Calculate speedup
         result.speedup = result.sequential_ms / result.concurrent_ms;
         
         // Verify correctness
         double max_diff = 0.0;
-        for (int i = 0; i < size * size; i++) {
+        size_t count = matrix_elements(C_seq);
+        for (size_t i = 0; i < count; i++) {
             double diff = std::abs(C_seq->data[i] - C_conc->data[i]);
             if (diff > max_diff) max_diff = diff;
         }
@@ -400,11 +424,70 @@ void print_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& resul
     }
     
     std::cout << "╚══════════════════════════════════════════════════════════════════════╝\n";
+    
+    // Where the concurrent time goes: thread start-up, uneven work, waiting
+    // for the slowest worker (mean over iterations)
+    std::cout << "\nWorker balance (concurrent runs, mean over iterations)\n";
+    std::cout << std::left << std::setw(12) << "Method" << std::right << std::setw(9) << "Workers"
+              << std::setw(8) << "Phases" << std::setw(13) << "Spawn (us)" << std::setw(17) << "Max spawn (us)"
+              << std::setw(11) << "Imbalance" << std::setw(16) << "Idle tail (ms)" << "\n";
+    std::cout << std::string(86, '-') << "\n";
+    for (const auto& result : results) {
+        const WorkerTimelineStats& stats = result.worker_stats;
+        std::cout << std::left << std::setw(12) << result.method_name << std::right << std::setw(9)
+                  << stats.workers << std::setw(8) << stats.phases << std::fixed << std::setprecision(1)
+                  << std::setw(13) << stats.spawn_latency_ms * 1000.0 << std::setw(17)
+                  << stats.max_spawn_latency_ms * 1000.0 << std::setprecision(3) << std::setw(11)
+                  << stats.imbalance << std::setw(16) << stats.idle_tail_ms << "\n";
+    }
+    
+    // Last run of each method, in ms from its first spawn
+    for (const auto& result : results) {
+        if (result.timeline.spans.empty()) continue;
+        double origin = result.timeline.spans.front().spawn_ms;
+        std::cout << "\n" << result.method_name << " timeline (last run, ms from first spawn)\n";
+        std::cout << std::setw(7) << "Phase" << std::setw(8) << "Worker" << std::setw(10) << "Spawn"
+                  << std::setw(10) << "Start" << std::setw(10) << "End" << std::setw(10) << "Busy"
+                  << std::setw(10) << "Items" << "\n";
+        int worker = 0, phase = -1;
+        for (const WorkerSpan& span : result.timeline.spans) {
+            worker = span.phase == phase ? worker + 1 : 0;
+            phase = span.phase;
+            std::cout << std::setw(7) << span.phase << std::setw(7) << worker << (span.caller_thread ? "*" : " ")
+                      << std::fixed << std::setprecision(3) << std::setw(10) << span.spawn_ms - origin
+                      << std::setw(10) << span.start_ms - origin << std::setw(10) << span.end_ms - origin
+                      << std::setw(10) << span.end_ms - span.start_ms << std::setw(10) << span.items << "\n";
+        }
+    }
+    if (!results.empty()) std::cout << "(* = run on the launching thread)\n";
     std::cout << std::endl;
 }
 
+static const char* const BENCHMARK_CSV_HEADER =
+    "method,sequential_ms,concurrent_ms,speedup,num_threads,spawn_latency_ms,imbalance,idle_tail_ms";
+static const char* const BENCHMARK_CSV_HEADER_V1 = "method,sequential_ms,concurrent_ms,speedup,num_threads";
+
+// Rewrite a file written by older versions with the current columns, the
+// new ones left empty, so appended rows line up
+static void upgrade_benchmark_csv(const char* filename) {
+    std::ifstream in(filename);
+    std::string line;
+    if (!in.is_open() || !std::getline(in, line) || line != BENCHMARK_CSV_HEADER_V1) return;
+    
+    std::vector<std::string> rows;
+    while (std::getline(in, line)) {
+        if (!line.empty()) rows.push_back(line + ",,,");
+    }
+    in.close();
+    
+    std::ofstream out(filename, std::ios::trunc);
+    out << BENCHMARK_CSV_HEADER << "\n";
+    for (const std::string& row : rows) out << row << "\n";
+}
+
 void save_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& results,
                              const char* filename) {
+    upgrade_benchmark_csv(filename);
     std::ofstream file(filename, std::ios::app);  // Append mode
     
     if (!file.is_open()) {
@@ -415,7 +498,7 @@ void save_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& result
     // Check if file is empty, write header if so
     file.seekp(0, std::ios::end);
     if (file.tellp() == 0) {
-        file << "method,sequential_ms,concurrent_ms,speedup,num_threads\n";
+        file << BENCHMARK_CSV_HEADER << "\n";
     }
     
     for (const auto& result : results) {
@@ -423,14 +506,18 @@ void save_benchmark_results(const std::vector<ConcurrentBenchmarkResult>& result
              << std::fixed << std::setprecision(3) << result.sequential_ms << ","
              << result.concurrent_ms << ","
              << result.speedup << ","
-             << result.num_threads << "\n";
+             << result.num_threads << ","
+             << std::setprecision(4) << result.worker_stats.spawn_latency_ms << ","
+             << std::setprecision(3) << result.worker_stats.imbalance << ","
+             << result.worker_stats.idle_tail_ms << "\n";
     }
     
     file.close();
 }
 
 void test_concurrent_matrix_multiplication(int size, int iterations, 
-                                            int num_threads, const char* output_file) {
+                                            int num_threads, const char* output_file,
+                                            ResultsStore* store) {
     std::cout << "\n";
     std::cout << "========================================================\n";
     std::cout << "  Concurrent Matrix Multiplication Performance Test\n";
@@ -463,4 +550,17 @@ void test_concurrent_matrix_multiplication(int size, int iterations,
     const char* file_to_save = output_file ? output_file : "concurrent_benchmark.csv";
     save_benchmark_results(results, file_to_save);
     std::cout << "Results saved to: " << file_to_save << "\n";
+    
+    if (store) {
+        // Kernels named like the profiler's: serial method, then its concurrent version
+        for (const auto& result : results) {
+            std::string name = result.method_name;
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            results_store_add(store, name.c_str(), result.size, 1, result.sequential_samples.data(),
+                              static_cast<int>(result.sequential_samples.size()));
+            results_store_add(store, (name + "_concurrent").c_str(), result.size, result.num_threads,
+                              result.concurrent_samples.data(),
+                              static_cast<int>(result.concurrent_samples.size()));
+        }
+    }
 }
@@ -0,0 +1,243 @@
+#include "dot_kernel.h"
+#include <stddef.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DOT_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define DOT_HAVE_X86 0
+#endif
+
+// Block of C computed per micro-kernel call
+#define DOT_MR 4
+#define DOT_NR 4
+#define DOT_MR_AVX2 2
+
+// ============================================================================
+// Path selection
+// ============================================================================
+
+static DotKernelPath forced_path = DOT_PATH_AUTO;
+
+static int path_supported(DotKernelPath path) {
+    switch (path) {
+        case DOT_PATH_PORTABLE:
+            return 1;
+#if DOT_HAVE_X86
+        case DOT_PATH_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        default:
+            return 0;
+    }
+}
+
+DotKernelPath dot_kernel_select_path(DotKernelPath path) {
+    forced_path = path;
+    return dot_kernel_active_path();
+}
+
+DotKernelPath dot_kernel_active_path(void) {
+    if (forced_path == DOT_PATH_AUTO || !path_supported(forced_path)) {
+        return path_supported(DOT_PATH_AVX2) ? DOT_PATH_AVX2 : DOT_PATH_PORTABLE;
+    }
+    return forced_path;
+}
+
+const char* dot_kernel_path_name(DotKernelPath path) {
+    switch (path) {
+        case DOT_PATH_AUTO: return "auto";
+        case DOT_PATH_PORTABLE: return "portable";
+        case DOT_PATH_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Edges: single dot product with four partial sums
+// ============================================================================
+
+static double dot_single(const double* a, const double* b, int N) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int k = 0;
+    for (; k + 4 <= N; k += 4) {
+        s0 += a[k] * b[k];
+        s1 += a[k + 1] * b[k + 1];
+        s2 += a[k + 2] * b[k + 2];
+        s3 += a[k + 3] * b[k + 3];
+    }
+    for (; k < N; k++) {
+        s0 += a[k] * b[k];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+// Elements of rows [row_start, row_end) and columns [col_start, P)
+static void dot_edge(const double* A, int lda, const double* B_T, int ldb,
+                     double* C, int ldc, int N, int row_start, int row_end,
+                     int col_start, int P) {
+    for (int i = row_start; i < row_end; i++) {
+        const double* a = A + (size_t)i * lda;
+        for (int j = col_start; j < P; j++) {
+            C[(size_t)i * ldc + j] = dot_single(a, B_T + (size_t)j * ldb, N);
+        }
+    }
+}
+
+// ============================================================================
+// Portable 4 x 4 micro-kernel
+// ============================================================================
+
+// Four A rows against four B_T rows: each of the 8 loaded values per k
+// feeds 4 multiply-adds, and the 16 sums form independent dependency chains
+static void block_4x4_portable(const double* a, int lda, const double* b, int ldb,
+                               double* c, int ldc, int N) {
+    const double* a0 = a;
+    const double* a1 = a + lda;
+    const double* a2 = a + 2 * (size_t)lda;
+    const double* a3 = a + 3 * (size_t)lda;
+    const double* b0 = b;
+    const double* b1 = b + ldb;
+    const double* b2 = b + 2 * (size_t)ldb;
+    const double* b3 = b + 3 * (size_t)ldb;
+
+    double c00 = 0.0, c01 = 0.0, c02 = 0.0, c03 = 0.0;
+    double c10 = 0.0, c11 = 0.0, c12 = 0.0, c13 = 0.0;
+    double c20 = 0.0, c21 = 0.0, c22 = 0.0, c23 = 0.0;
+    double c30 = 0.0, c31 = 0.0, c32 = 0.0, c33 = 0.0;
+
+    for (int k = 0; k < N; k++) {
+        double x0 = a0[k], x1 = a1[k], x2 = a2[k], x3 = a3[k];
+        double y0 = b0[k], y1 = b1[k], y2 = b2[k], y3 = b3[k];
+        c00 += x0 * y0; c01 += x0 * y1; c02 += x0 * y2; c03 += x0 * y3;
+        c10 += x1 * y0; c11 += x1 * y1; c12 += x1 * y2; c13 += x1 * y3;
+        c20 += x2 * y0; c21 += x2 * y1; c22 += x2 * y2; c23 += x2 * y3;
+        c30 += x3 * y0; c31 += x3 * y1; c32 += x3 * y2; c33 += x3 * y3;
+    }
+
+    c[0] = c00; c[1] = c01; c[2] = c02; c[3] = c03;
+    c += ldc;
+    c[0] = c10; c[1] = c11; c[2] = c12; c[3] = c13;
+    c += ldc;
+    c[0] = c20; c[1] = c21; c[2] = c22; c[3] = c23;
+    c += ldc;
+    c[0] = c30; c[1] = c31; c[2] = c32; c[3] = c33;
+}
+
+static void rows_portable(const double* A, int lda, const double* B_T, int ldb,
+                          double* C, int ldc, int N, int P, int row_start, int row_end) {
+    int i = row_start;
+    int P4 = P - P % DOT_NR;
+    for (; i + DOT_MR <= row_end; i += DOT_MR) {
+        for (int j = 0; j < P4; j += DOT_NR) {
+            block_4x4_portable(A + (size_t)i * lda, lda, B_T + (size_t)j * ldb, ldb,
+                               C + (size_t)i * ldc + j, ldc, N);
+        }
+        dot_edge(A, lda, B_T, ldb, C, ldc, N, i, i + DOT_MR, P4, P);
+    }
+    dot_edge(A, lda, B_T, ldb, C, ldc, N, i, row_end, 0, P);
+}
+
+// ============================================================================
+// AVX2 / FMA 2 x 4 micro-kernel
+// ============================================================================
+
+#if DOT_HAVE_X86
+// Horizontal sums of four vectors: returns {sum(v0), sum(v1), sum(v2), sum(v3)}
+__attribute__((target("avx2,fma")))
+static inline __m256d hsum4(__m256d v0, __m256d v1, __m256d v2, __m256d v3) {
+    __m256d h01 = _mm256_hadd_pd(v0, v1);   // v0[0]+v0[1], v1[0]+v1[1], v0[2]+v0[3], v1[2]+v1[3]
+    __m256d h23 = _mm256_hadd_pd(v2, v3);
+    __m256d swapped = _mm256_permute2f128_pd(h01, h23, 0x21);
+    __m256d blended = _mm256_blend_pd(h01, h23, 0xC);
+    return _mm256_add_pd(swapped, blended);
+}
+
+// Two A rows against four B_T rows, vectorised along k: 8 accumulators,
+// 2 A loads and 4 B_T loads per step (14 of the 16 ymm registers).
+// A 4 x 4 block would need 16 accumulators plus operands and spill.
+__attribute__((target("avx2,fma")))
+static void block_2x4_avx2(const double* a, int lda, const double* b, int ldb,
+                           double* c, int ldc, int N) {
+    const double* a0 = a;
+    const double* a1 = a + lda;
+    const double* b0 = b;
+    const double* b1 = b + ldb;
+    const double* b2 = b + 2 * (size_t)ldb;
+    const double* b3 = b + 3 * (size_t)ldb;
+
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c02 = _mm256_setzero_pd(), c03 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c12 = _mm256_setzero_pd(), c13 = _mm256_setzero_pd();
+
+    int k = 0;
+    for (; k + 4 <= N; k += 4) {
+        __m256d x0 = _mm256_loadu_pd(a0 + k);
+        __m256d x1 = _mm256_loadu_pd(a1 + k);
+        __m256d y = _mm256_loadu_pd(b0 + k);
+        c00 = _mm256_fmadd_pd(x0, y, c00);
+        c10 = _mm256_fmadd_pd(x1, y, c10);
+        y = _mm256_loadu_pd(b1 + k);
+        c01 = _mm256_fmadd_pd(x0, y, c01);
+        c11 = _mm256_fmadd_pd(x1, y, c11);
+        y = _mm256_loadu_pd(b2 + k);
+        c02 = _mm256_fmadd_pd(x0, y, c02);
+        c12 = _mm256_fmadd_pd(x1, y, c12);
+        y = _mm256_loadu_pd(b3 + k);
+        c03 = _mm256_fmadd_pd(x0, y, c03);
+        c13 = _mm256_fmadd_pd(x1, y, c13);
+    }
+
+    __m256d r0 = hsum4(c00, c01, c02, c03);
+    __m256d r1 = hsum4(c10, c11, c12, c13);
+
+    // k tail (N not a multiple of 4)
+    if (k < N) {
+        double t0[DOT_NR] = {0.0, 0.0, 0.0, 0.0};
+        double t1[DOT_NR] = {0.0, 0.0, 0.0, 0.0};
+        for (; k < N; k++) {
+            t0[0] += a0[k] * b0[k]; t0[1] += a0[k] * b1[k];
+            t0[2] += a0[k] * b2[k]; t0[3] += a0[k] * b3[k];
+            t1[0] += a1[k] * b0[k]; t1[1] += a1[k] * b1[k];
+            t1[2] += a1[k] * b2[k]; t1[3] += a1[k] * b3[k];
+        }
+        r0 = _mm256_add_pd(r0, _mm256_loadu_pd(t0));
+        r1 = _mm256_add_pd(r1, _mm256_loadu_pd(t1));
+    }
+
+    _mm256_storeu_pd(c, r0);
+    _mm256_storeu_pd(c + ldc, r1);
+}
+
+__attribute__((target("avx2,fma")))
+static void rows_avx2(const double* A, int lda, const double* B_T, int ldb,
+                      double* C, int ldc, int N, int P, int row_start, int row_end) {
+    int i = row_start;
+    int P4 = P - P % DOT_NR;
+    for (; i + DOT_MR_AVX2 <= row_end; i += DOT_MR_AVX2) {
+        for (int j = 0; j < P4; j += DOT_NR) {
+            block_2x4_avx2(A + (size_t)i * lda, lda, B_T + (size_t)j * ldb, ldb,
+                           C + (size_t)i * ldc + j, ldc, N);
+        }
+        dot_edge(A, lda, B_T, ldb, C, ldc, N, i, i + DOT_MR_AVX2, P4, P);
+    }
+    dot_edge(A, lda, B_T, ldb, C, ldc, N, i, row_end, 0, P);
+}
+#endif
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+void dot_kernel_rows(const double* A, int lda, const double* B_T, int ldb,
+                     double* C, int ldc, int N, int P, int row_start, int row_end) {
+    if (row_start >= row_end || P <= 0) return;
+#if DOT_HAVE_X86
+    if (dot_kernel_active_path() == DOT_PATH_AVX2) {
+        rows_avx2(A, lda, B_T, ldb, C, ldc, N, P, row_start, row_end);
+        return;
+    }
+#endif
+    rows_portable(A, lda, B_T, ldb, C, ldc, N, P, row_start, row_end);
+}
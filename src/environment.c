@@ -0,0 +1,399 @@
+// sched_setaffinity() and the CPU_* macros need _GNU_SOURCE
+#define _GNU_SOURCE
+
+#include "environment.h"
+#include "matrix.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifndef MATRIX_BUILD_TYPE
+#define MATRIX_BUILD_TYPE "unknown"
+#endif
+#ifndef MATRIX_BUILD_FLAGS
+#define MATRIX_BUILD_FLAGS "unknown"
+#endif
+
+#define MAX_PIN_CPUS 1024
+
+// First line of a file without the newline; 0 on success
+static int read_line(const char* path, char* out, size_t size) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+    int ok = fgets(out, (int)size, fp) != NULL;
+    fclose(fp);
+    if (!ok) return -1;
+    out[strcspn(out, "\n")] = '\0';
+    return 0;
+}
+
+static void copy_text(char* out, size_t size, const char* text) {
+    snprintf(out, size, "%s", text);
+}
+
+static void read_text(const char* path, char* out, size_t size, const char* fallback) {
+    if (read_line(path, out, size) != 0) copy_text(out, size, fallback);
+}
+
+// Value of the first "key : value" line of /proc/cpuinfo
+static void read_cpuinfo(const char* key, char* out, size_t size) {
+    copy_text(out, size, "unknown");
+    FILE* fp = fopen("/proc/cpuinfo", "r");
+    if (!fp) return;
+    char line[512];
+    size_t key_len = strlen(key);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, key, key_len) != 0) continue;
+        char* colon = strchr(line, ':');
+        if (!colon) continue;
+        colon++;
+        while (*colon == ' ' || *colon == '\t') colon++;
+        colon[strcspn(colon, "\n")] = '\0';
+        copy_text(out, size, colon);
+        break;
+    }
+    fclose(fp);
+}
+
+// Frequency file in kHz, returned in MHz (0 if missing)
+static double read_mhz(const char* path) {
+    char text[64];
+    if (read_line(path, text, sizeof(text)) != 0) return 0.0;
+    return atof(text) / 1000.0;
+}
+
+// intel_pstate reports no_turbo, acpi-cpufreq / amd-pstate report boost
+static void read_turbo(char* out, size_t size) {
+    char text[16];
+    if (read_line("/sys/devices/system/cpu/intel_pstate/no_turbo", text, sizeof(text)) == 0) {
+        copy_text(out, size, atoi(text) ? "off" : "on");
+    } else if (read_line("/sys/devices/system/cpu/cpufreq/boost", text, sizeof(text)) == 0) {
+        copy_text(out, size, atoi(text) ? "on" : "off");
+    } else {
+        copy_text(out, size, "unknown");
+    }
+}
+
+// The selected mode of "always [madvise] never"
+static void read_thp(char* out, size_t size) {
+    char text[128];
+    if (read_line("/sys/kernel/mm/transparent_hugepage/enabled", text, sizeof(text)) != 0) {
+        copy_text(out, size, "unknown");
+        return;
+    }
+    char* open = strchr(text, '[');
+    char* close = open ? strchr(open, ']') : NULL;
+    if (!open || !close) {
+        copy_text(out, size, text);
+        return;
+    }
+    *close = '\0';
+    copy_text(out, size, open + 1);
+}
+
+static void read_affinity(char* out, size_t size) {
+    copy_text(out, size, "unknown");
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return;
+
+    // Compress to a list of ranges
+    size_t len = 0;
+    out[0] = '\0';
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        int last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) last++;
+        int written = (last > cpu) ? snprintf(out + len, size - len, "%s%d-%d", len ? "," : "", cpu, last)
+                                   : snprintf(out + len, size - len, "%s%d", len ? "," : "", cpu);
+        if (written < 0 || (size_t)written >= size - len) break;
+        len += (size_t)written;
+        cpu = last;
+    }
+#endif
+}
+
+void environment_capture(BenchEnvironment* env) {
+    if (!env) return;
+    memset(env, 0, sizeof(*env));
+
+    read_cpuinfo("model name", env->cpu_model, sizeof(env->cpu_model));
+    read_text("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", env->governor,
+              sizeof(env->governor), "unknown");
+    env->cur_mhz = read_mhz("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+    env->max_mhz = read_mhz("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+    if (env->cur_mhz == 0.0) {
+        // No cpufreq (typical in VMs): the clock /proc/cpuinfo reports
+        char mhz[64];
+        read_cpuinfo("cpu MHz", mhz, sizeof(mhz));
+        env->cur_mhz = atof(mhz);
+    }
+    read_turbo(env->turbo, sizeof(env->turbo));
+    read_thp(env->thp, sizeof(env->thp));
+
+    char smt[16];
+    if (read_line("/sys/devices/system/cpu/smt/active", smt, sizeof(smt)) == 0) {
+        copy_text(env->smt, sizeof(env->smt), atoi(smt) ? "on" : "off");
+    } else {
+        copy_text(env->smt, sizeof(env->smt), "unknown");
+    }
+
+    struct utsname name;
+    if (uname(&name) == 0) {
+        snprintf(env->kernel, sizeof(env->kernel), "%.32s %.80s", name.sysname, name.release);
+    } else {
+        copy_text(env->kernel, sizeof(env->kernel), "unknown");
+    }
+
+#if defined(__clang__)
+    copy_text(env->compiler, sizeof(env->compiler), "clang " __clang_version__);
+#elif defined(__GNUC__)
+    copy_text(env->compiler, sizeof(env->compiler), "gcc " __VERSION__);
+#else
+    copy_text(env->compiler, sizeof(env->compiler), "unknown");
+#endif
+    copy_text(env->build_type, sizeof(env->build_type), MATRIX_BUILD_TYPE);
+    copy_text(env->build_flags, sizeof(env->build_flags), MATRIX_BUILD_FLAGS);
+
+    read_text("/sys/devices/system/cpu/isolated", env->isolated_cpus, sizeof(env->isolated_cpus), "");
+    read_affinity(env->affinity, sizeof(env->affinity));
+    read_text("/sys/devices/system/cpu/cpu0/cache/index3/shared_cpu_list", env->l3_shared_cpus,
+              sizeof(env->l3_shared_cpus), "unknown");
+
+    env->online_cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    env->cache_line = get_cache_line_size();
+    env->l1d_bytes = get_l1_cache_size();
+    env->l2_bytes = get_l2_cache_size();
+    env->l3_bytes = get_l3_cache_size();
+
+    char load[64];
+    env->load_average = (read_line("/proc/loadavg", load, sizeof(load)) == 0) ? atof(load) : -1.0;
+}
+
+// Layout of one JSON object: pretty (one key per line) or compact (one line)
+typedef struct {
+    const char* indent;
+    const char* colon;
+    const char* newline;
+} JsonLayout;
+
+// JSON string value: quotes and backslashes escaped, control characters dropped
+static void write_json_string(FILE* fp, const JsonLayout* layout, const char* key, const char* value) {
+    fprintf(fp, "%s\"%s\"%s\"", layout->indent, key, layout->colon);
+    for (const char* c = value; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', fp);
+            fputc(*c, fp);
+        } else if ((unsigned char)*c >= 0x20) {
+            fputc(*c, fp);
+        }
+    }
+    fprintf(fp, "\",%s", layout->newline);
+}
+
+static void write_json_number(FILE* fp, const JsonLayout* layout, const char* key, const char* format,
+                              double value, int last) {
+    fprintf(fp, "%s\"%s\"%s", layout->indent, key, layout->colon);
+    fprintf(fp, format, value);
+    fprintf(fp, "%s%s", last ? "" : ",", layout->newline);
+}
+
+void environment_write_json(const BenchEnvironment* env, FILE* fp, int compact) {
+    if (!env || !fp) return;
+    const JsonLayout pretty = {"  ", ": ", "\n"};
+    const JsonLayout one_line = {"", ":", ""};
+    const JsonLayout* layout = compact ? &one_line : &pretty;
+
+    fprintf(fp, "{%s", layout->newline);
+    write_json_string(fp, layout, "cpu_model", env->cpu_model);
+    write_json_string(fp, layout, "governor", env->governor);
+    write_json_number(fp, layout, "cur_mhz", "%.1f", env->cur_mhz, 0);
+    write_json_number(fp, layout, "max_mhz", "%.1f", env->max_mhz, 0);
+    write_json_string(fp, layout, "turbo", env->turbo);
+    write_json_string(fp, layout, "thp", env->thp);
+    write_json_string(fp, layout, "smt", env->smt);
+    write_json_string(fp, layout, "kernel", env->kernel);
+    write_json_string(fp, layout, "compiler", env->compiler);
+    write_json_string(fp, layout, "build_type", env->build_type);
+    write_json_string(fp, layout, "build_flags", env->build_flags);
+    write_json_string(fp, layout, "isolated_cpus", env->isolated_cpus);
+    write_json_string(fp, layout, "affinity", env->affinity);
+    write_json_string(fp, layout, "l3_shared_cpus", env->l3_shared_cpus);
+    write_json_number(fp, layout, "online_cpus", "%.0f", env->online_cpus, 0);
+    write_json_number(fp, layout, "cache_line", "%.0f", env->cache_line, 0);
+    write_json_number(fp, layout, "l1d_bytes", "%.0f", env->l1d_bytes, 0);
+    write_json_number(fp, layout, "l2_bytes", "%.0f", env->l2_bytes, 0);
+    write_json_number(fp, layout, "l3_bytes", "%.0f", env->l3_bytes, 0);
+    write_json_number(fp, layout, "load_average", "%.2f", env->load_average, 1);
+    fprintf(fp, "}");
+}
+
+int environment_save(const BenchEnvironment* env, const char* filename) {
+    if (!env || !filename) return -1;
+    FILE* fp = fopen(filename, "w");
+    if (!fp) return -1;
+
+    environment_write_json(env, fp, 0);
+    fprintf(fp, "\n");
+
+    int failed = ferror(fp);
+    fclose(fp);
+    return failed ? -1 : 0;
+}
+
+void environment_sidecar_path(const char* results_file, char* path, size_t size) {
+    if (!path || size == 0) return;
+    if (!results_file) results_file = "results";
+
+    // Strip the extension of the last path component only
+    const char* slash = strrchr(results_file, '/');
+    const char* dot = strrchr(results_file, '.');
+    size_t stem = (dot && (!slash || dot > slash) && dot != results_file) ? (size_t)(dot - results_file)
+                                                                        : strlen(results_file);
+    snprintf(path, size, "%.*s.env.json", (int)stem, results_file);
+}
+
+// Append one line to the warnings buffer
+static void add_warning(char* warnings, size_t size, const char* text) {
+    if (!warnings || size == 0) return;
+    size_t len = strlen(warnings);
+    if (len < size) snprintf(warnings + len, size - len, "%s\n", text);
+}
+
+int environment_check(const BenchEnvironment* env, char* warnings, size_t size) {
+    if (!env) return 0;
+    if (warnings && size > 0) warnings[0] = '\0';
+
+    int findings = 0;
+    char text[256];
+    if (strcmp(env->governor, "unknown") != 0 && strcmp(env->governor, "performance") != 0) {
+        snprintf(text, sizeof(text), "CPU frequency governor is '%s', not 'performance'", env->governor);
+        add_warning(warnings, size, text);
+        findings++;
+    }
+    if (strcmp(env->turbo, "on") == 0) {
+        add_warning(warnings, size, "Turbo boost is on: the clock depends on temperature and load");
+        findings++;
+    }
+    if (strcmp(env->thp, "always") == 0) {
+        add_warning(warnings, size, "Transparent huge pages are 'always': TLB behaviour varies between runs");
+        findings++;
+    }
+    if (strcmp(env->smt, "on") == 0) {
+        add_warning(warnings, size, "SMT is on: a sibling thread can share the core and its caches");
+        findings++;
+    }
+    if (env->online_cpus > 0 && env->load_average > 0.5 * env->online_cpus) {
+        snprintf(text, sizeof(text), "Load average %.2f on %d CPUs: other work is running",
+                 env->load_average, env->online_cpus);
+        add_warning(warnings, size, text);
+        findings++;
+    }
+    return findings;
+}
+
+int environment_parse_cpulist(const char* text, int* cpus, int max) {
+    if (!text || !cpus) return -1;
+    int count = 0;
+    const char* p = text;
+    while (*p) {
+        char* end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0) return -1;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            p++;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return -1;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (count >= max) return -1;
+            cpus[count++] = (int)cpu;
+        }
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0' && *p != '\n') {
+            return -1;
+        } else {
+            break;
+        }
+    }
+    return count;
+}
+
+int environment_pin(const char* cpus) {
+    if (!cpus) return -1;
+#ifdef __linux__
+    char list[ENV_TEXT_LEN];
+    if (strcmp(cpus, "isolated") == 0) {
+        if (read_line("/sys/devices/system/cpu/isolated", list, sizeof(list)) != 0) return -1;
+    } else {
+        copy_text(list, sizeof(list), cpus);
+    }
+
+    int parsed[MAX_PIN_CPUS];
+    int count = environment_parse_cpulist(list, parsed, MAX_PIN_CPUS);
+    if (count <= 0) return -1;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < count; i++) {
+        if (parsed[i] >= CPU_SETSIZE) return -1;
+        CPU_SET(parsed[i], &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0 ? count : -1;
+#else
+    return -1;
+#endif
+}
+
+void environment_warmup(double ms) {
+    volatile double x = 1.0;
+    double end = get_time_ms() + ms;
+    while (get_time_ms() < end) {
+        for (int i = 0; i < 10000; i++) x = x * 1.0000001 + 1e-9;
+    }
+}
+
+int environment_prepare(const char* pin_cpus, double warmup_ms, int strict, BenchEnvironment* env) {
+    if (!env) return -1;
+    if (pin_cpus) {
+        int pinned = environment_pin(pin_cpus);
+        if (pinned <= 0) {
+            fprintf(stderr, "Error: cannot pin to CPUs '%s'\n", pin_cpus);
+            return -1;
+        }
+        printf("Pinned to %d CPU(s): %s\n", pinned, pin_cpus);
+    }
+
+    environment_capture(env);
+    char warnings[1024];
+    int findings = environment_check(env, warnings, sizeof(warnings));
+    if (findings > 0) {
+        fprintf(stderr, "%s: noisy host configuration\n%s", strict ? "Error" : "Warning", warnings);
+        if (strict) return -1;
+    }
+
+    if (warmup_ms > 0.0) environment_warmup(warmup_ms);
+    return 0;
+}
+
+int environment_save_sidecar(const BenchEnvironment* env, const char* results_file) {
+    char path[512];
+    environment_sidecar_path(results_file, path, sizeof(path));
+    if (environment_save(env, path) != 0) {
+        fprintf(stderr, "Error: Cannot write environment to %s\n", path);
+        return -1;
+    }
+    printf("Environment saved to %s\n", path);
+    return 0;
+}
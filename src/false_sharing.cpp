@@ -0,0 +1,211 @@
+#include "false_sharing.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Per-worker state; padded so the diagnostic's own bookkeeping does not
+// share lines between threads
+struct alignas(64) WorkerSlot {
+    std::vector<int> rows;
+    bool available[PERF_COUNTER_COUNT];
+    uint64_t counters[PERF_COUNTER_COUNT];
+};
+
+void update_rows(volatile double* data, int cols, const std::vector<int>& rows, int passes) {
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int r : rows) {
+            volatile double* row = data + static_cast<size_t>(r) * cols;
+            for (int j = 0; j < cols; ++j) {
+                row[j] = row[j] + 1.0;
+            }
+        }
+    }
+}
+
+// One run with all workers released together; returns the elapsed ms
+double timed_run(Matrix* m, std::vector<WorkerSlot>& slots, int passes) {
+    const int threads = static_cast<int>(slots.size());
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    double* data = m->data;
+    const int cols = m->cols;
+
+    std::vector<std::thread> workers;
+    workers.reserve(slots.size());
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            WorkerSlot& slot = slots[t];
+            PerfCounters pc;
+            perf_counters_open(&pc);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            perf_counters_start(&pc);
+            update_rows(data, cols, slot.rows, passes);
+            perf_counters_stop(&pc, slot.counters);
+            for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+                slot.available[c] = perf_counter_available(&pc, static_cast<PerfCounter>(c)) != 0;
+            }
+            perf_counters_close(&pc);
+        });
+    }
+
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    double start = get_time_ms();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return get_time_ms() - start;
+}
+
+}  // namespace
+
+const char* row_layout_name(RowLayout layout) {
+    switch (layout) {
+        case ROW_LAYOUT_INTERLEAVED: return "interleaved";
+        case ROW_LAYOUT_CONTIGUOUS: return "contiguous";
+        case ROW_LAYOUT_ALIGNED: return "aligned";
+    }
+    return "unknown";
+}
+
+std::vector<int> row_layout_owners(RowLayout layout, const Matrix* m, int threads) {
+    const int rows = m ? m->rows : 0;
+    threads = std::max(1, threads);
+    std::vector<int> owners(static_cast<size_t>(rows), 0);
+
+    if (layout == ROW_LAYOUT_INTERLEAVED) {
+        for (int r = 0; r < rows; ++r) owners[r] = r % threads;
+    } else if (layout == ROW_LAYOUT_CONTIGUOUS) {
+        int rows_per_thread = (rows + threads - 1) / threads;
+        for (int r = 0; r < rows; ++r) owners[r] = r / rows_per_thread;
+    } else {
+        std::vector<int> bounds(static_cast<size_t>(threads) + 1);
+        matrix_partition_rows(m->data, static_cast<size_t>(m->cols), rows, threads, bounds.data());
+        for (int t = 0; t < threads; ++t) {
+            for (int r = bounds[t]; r < bounds[t + 1]; ++r) owners[r] = t;
+        }
+    }
+    return owners;
+}
+
+int count_shared_lines(const Matrix* m, const std::vector<int>& owners) {
+    if (!m || m->cols <= 0) return 0;
+
+    const uintptr_t line = static_cast<uintptr_t>(get_cache_line_size());
+    const size_t cols = static_cast<size_t>(m->cols);
+    int shared = 0;
+    uintptr_t current_line = 0;
+    int current_owner = -1;
+    bool current_shared = false;
+    bool have_line = false;
+
+    // Walk the elements in address order, tracking the owners seen per line
+    for (size_t r = 0; r < owners.size(); ++r) {
+        for (size_t j = 0; j < cols; ++j) {
+            uintptr_t l = reinterpret_cast<uintptr_t>(m->data + r * cols + j) / line;
+            if (!have_line || l != current_line) {
+                if (current_shared) ++shared;
+                current_line = l;
+                current_owner = owners[r];
+                current_shared = false;
+                have_line = true;
+            } else if (owners[r] != current_owner) {
+                current_shared = true;
+            }
+        }
+    }
+    if (current_shared) ++shared;
+    return shared;
+}
+
+int run_false_sharing(RowLayout layout, int rows, int cols, int threads, int passes,
+                      int iterations, FalseSharingResult& result) {
+    if (rows <= 0 || cols <= 0 || threads <= 0 || passes <= 0) return -1;
+    if (layout < ROW_LAYOUT_INTERLEAVED || layout > ROW_LAYOUT_ALIGNED) return -1;
+    iterations = std::max(1, iterations);
+
+    Matrix* m = matrix_create(rows, cols);
+    if (!m) return -1;
+
+    std::vector<int> owners = row_layout_owners(layout, m, threads);
+    std::vector<WorkerSlot> slots(static_cast<size_t>(threads));
+    for (int r = 0; r < rows; ++r) {
+        slots[owners[r]].rows.push_back(r);
+    }
+
+    result.layout = layout;
+    result.rows = rows;
+    result.cols = cols;
+    result.threads = threads;
+    result.passes = passes;
+    result.shared_lines = count_shared_lines(m, owners);
+    result.ms = 0.0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+        result.counter_available[c] = true;
+        result.counters[c] = 0;
+    }
+
+    timed_run(m, slots, passes);  // warm-up: page faults, thread start-up paths
+    for (int iter = 0; iter < iterations; ++iter) {
+        double ms = timed_run(m, slots, passes);
+        if (iter == 0 || ms < result.ms) result.ms = ms;
+        for (const WorkerSlot& slot : slots) {
+            for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+                result.counters[c] += slot.counters[c];
+                result.counter_available[c] = result.counter_available[c] && slot.available[c];
+            }
+        }
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+        result.counters[c] /= static_cast<uint64_t>(iterations);
+    }
+
+    double updates = static_cast<double>(rows) * cols * passes;
+    result.ns_per_update = result.ms * 1e6 / updates;
+
+    matrix_free(m);
+    return 0;
+}
+
+void print_false_sharing_results(const std::vector<FalseSharingResult>& results) {
+    if (results.empty()) return;
+    const FalseSharingResult& first = results.front();
+    std::cout << "\nFalse sharing: " << first.rows << " x " << first.cols << " matrix ("
+              << first.cols * sizeof(double) << "-byte rows, " << get_cache_line_size()
+              << "-byte lines), " << first.threads << " threads\n";
+    std::cout << "Counters are per element update, summed over threads\n";
+    std::cout << std::left << std::setw(13) << "Layout" << std::right << std::setw(14) << "Shared lines"
+              << std::setw(12) << "Time (ms)" << std::setw(12) << "ns/update";
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+        std::cout << std::setw(14) << perf_counter_name(static_cast<PerfCounter>(c));
+    }
+    std::cout << "\n" << std::string(51 + 14 * PERF_COUNTER_COUNT, '-') << "\n";
+
+    for (const FalseSharingResult& r : results) {
+        double updates = static_cast<double>(r.rows) * r.cols * r.passes;
+        std::cout << std::left << std::setw(13) << row_layout_name(r.layout) << std::right
+                  << std::setw(14) << r.shared_lines << std::fixed << std::setprecision(3)
+                  << std::setw(12) << r.ms << std::setw(12) << r.ns_per_update;
+        for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+            if (r.counter_available[c]) {
+                std::cout << std::setw(14) << std::setprecision(4) << r.counters[c] / updates;
+            } else {
+                std::cout << std::setw(14) << "-";
+            }
+        }
+        std::cout << "\n";
+    }
+}
@@ -0,0 +1,169 @@
+#include "gemm.h"
+#include <stdlib.h>
+
+MatrixView matrix_view(Matrix* m) {
+    MatrixView v;
+    if (!m) {
+        v.data = NULL;
+        v.rows = v.cols = v.ld = 0;
+        return v;
+    }
+    v.data = m->data;
+    v.rows = m->rows;
+    v.cols = m->cols;
+    v.ld = m->cols;
+    return v;
+}
+
+MatrixView matrix_view_window(MatrixView v, int row, int col, int rows, int cols) {
+    MatrixView w;
+    w.data = NULL;
+    w.rows = rows;
+    w.cols = cols;
+    w.ld = v.ld;
+
+    if (!v.data || row < 0 || col < 0 || rows < 0 || cols < 0) return w;
+    if (row + rows > v.rows || col + cols > v.cols) return w;
+
+    w.data = v.data + (size_t)row * v.ld + col;
+    return w;
+}
+
+MatrixView matrix_subview(Matrix* m, int row, int col, int rows, int cols) {
+    return matrix_view_window(matrix_view(m), row, col, rows, cols);
+}
+
+static int view_valid(const MatrixView* v) {
+    return v && v->data && v->rows >= 0 && v->cols >= 0 && v->ld >= v->cols;
+}
+
+// C tile *= beta (beta == 0 stores zeros so NaN/Inf in C do not propagate)
+static void scale_tile(double* c, int ldc, int i0, int i1, int j0, int j1, double beta) {
+    if (beta == 1.0) return;
+    for (int i = i0; i < i1; i++) {
+        double* c_row = c + (size_t)i * ldc;
+        if (beta == 0.0) {
+            for (int j = j0; j < j1; j++) c_row[j] = 0.0;
+        } else {
+            for (int j = j0; j < j1; j++) c_row[j] *= beta;
+        }
+    }
+}
+
+// Tile kernels: C[i0:i1, j0:j1] += alpha * op(A)[i0:i1, k0:k1] * op(B)[k0:k1, j0:j1]
+// Each picks the loop order that keeps its innermost loop unit-stride.
+
+// A and B as stored: i-k-j, contiguous B row and C row
+static void tile_nn(const double* a, int lda, const double* b, int ldb, double* c, int ldc,
+                    int i0, int i1, int k0, int k1, int j0, int j1, double alpha) {
+    for (int i = i0; i < i1; i++) {
+        const double* a_row = a + (size_t)i * lda;
+        double* c_row = c + (size_t)i * ldc;
+        for (int k = k0; k < k1; k++) {
+            double a_val = alpha * a_row[k];
+            const double* b_row = b + (size_t)k * ldb;
+            for (int j = j0; j < j1; j++) {
+                c_row[j] += a_val * b_row[j];
+            }
+        }
+    }
+}
+
+// op(A)[i][k] = A[k][i]: k-i-j, walks rows of the stored A and B
+static void tile_tn(const double* a, int lda, const double* b, int ldb, double* c, int ldc,
+                    int i0, int i1, int k0, int k1, int j0, int j1, double alpha) {
+    for (int k = k0; k < k1; k++) {
+        const double* a_row = a + (size_t)k * lda;
+        const double* b_row = b + (size_t)k * ldb;
+        for (int i = i0; i < i1; i++) {
+            double a_val = alpha * a_row[i];
+            double* c_row = c + (size_t)i * ldc;
+            for (int j = j0; j < j1; j++) {
+                c_row[j] += a_val * b_row[j];
+            }
+        }
+    }
+}
+
+// op(B)[k][j] = B[j][k]: i-j-k dot products over rows of A and stored B
+// (the layout matrix_multiply_transpose builds explicitly with B_T)
+static void tile_nt(const double* a, int lda, const double* b, int ldb, double* c, int ldc,
+                    int i0, int i1, int k0, int k1, int j0, int j1, double alpha) {
+    for (int i = i0; i < i1; i++) {
+        const double* a_row = a + (size_t)i * lda;
+        double* c_row = c + (size_t)i * ldc;
+        for (int j = j0; j < j1; j++) {
+            const double* b_row = b + (size_t)j * ldb;
+            double sum = 0.0;
+            for (int k = k0; k < k1; k++) {
+                sum += a_row[k] * b_row[k];
+            }
+            c_row[j] += alpha * sum;
+        }
+    }
+}
+
+// Both transposed: j-k-i, rows of the stored A are contiguous in i;
+// the strided C column stays inside the cache-resident tile
+static void tile_tt(const double* a, int lda, const double* b, int ldb, double* c, int ldc,
+                    int i0, int i1, int k0, int k1, int j0, int j1, double alpha) {
+    for (int j = j0; j < j1; j++) {
+        const double* b_row = b + (size_t)j * ldb;
+        for (int k = k0; k < k1; k++) {
+            double b_val = alpha * b_row[k];
+            const double* a_row = a + (size_t)k * lda;
+            for (int i = i0; i < i1; i++) {
+                c[(size_t)i * ldc + j] += a_row[i] * b_val;
+            }
+        }
+    }
+}
+
+int matrix_gemm(GemmTranspose trans_a, GemmTranspose trans_b,
+                double alpha, const MatrixView* A, const MatrixView* B,
+                double beta, const MatrixView* C, int block_size) {
+    if (!view_valid(A) || !view_valid(B) || !view_valid(C)) return -1;
+
+    // op(A) is M x K, op(B) is K x N
+    int M = (trans_a == GEMM_NO_TRANS) ? A->rows : A->cols;
+    int K = (trans_a == GEMM_NO_TRANS) ? A->cols : A->rows;
+    int K_b = (trans_b == GEMM_NO_TRANS) ? B->rows : B->cols;
+    int N = (trans_b == GEMM_NO_TRANS) ? B->cols : B->rows;
+
+    if (K != K_b) return -1;
+    if (C->rows != M || C->cols != N) return -1;
+
+    int BLOCK = (block_size > 0) ? block_size : get_optimal_block_size();
+
+    void (*tile)(const double*, int, const double*, int, double*, int,
+                 int, int, int, int, int, int, double);
+    if (trans_a == GEMM_NO_TRANS) {
+        tile = (trans_b == GEMM_NO_TRANS) ? tile_nn : tile_nt;
+    } else {
+        tile = (trans_b == GEMM_NO_TRANS) ? tile_tn : tile_tt;
+    }
+
+    double* c = C->data;
+    int ldc = C->ld;
+    int has_product = (alpha != 0.0 && K > 0);
+
+    for (int ii = 0; ii < M; ii += BLOCK) {
+        int i_max = (ii + BLOCK < M) ? ii + BLOCK : M;
+
+        for (int jj = 0; jj < N; jj += BLOCK) {
+            int j_max = (jj + BLOCK < N) ? jj + BLOCK : N;
+
+            // beta is folded in while the C tile is about to be reused
+            scale_tile(c, ldc, ii, i_max, jj, j_max, beta);
+            if (!has_product) continue;
+
+            for (int kk = 0; kk < K; kk += BLOCK) {
+                int k_max = (kk + BLOCK < K) ? kk + BLOCK : K;
+                tile(A->data, A->ld, B->data, B->ld, c, ldc,
+                     ii, i_max, kk, k_max, jj, j_max, alpha);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "gemm_fixed.h"
+#include "matrix.h"
+
+namespace {
+template <int S>
+void square_kernel(const double* a, const double* b, double* c) {
+    gemm_fixed<S, S, S>(a, b, c);
+}
+
+// Indexed by size; every square shape from GEMM_FIXED_MIN_SIZE to
+// GEMM_FIXED_MAX_SIZE is instantiated at compile time
+const GemmFixedKernel square_kernels[GEMM_FIXED_MAX_SIZE + 1] = {
+    nullptr,            nullptr,            &square_kernel<2>,  &square_kernel<3>,
+    &square_kernel<4>,  &square_kernel<5>,  &square_kernel<6>,  &square_kernel<7>,
+    &square_kernel<8>,  &square_kernel<9>,  &square_kernel<10>, &square_kernel<11>,
+    &square_kernel<12>, &square_kernel<13>, &square_kernel<14>, &square_kernel<15>,
+    &square_kernel<16>, &square_kernel<17>, &square_kernel<18>, &square_kernel<19>,
+    &square_kernel<20>, &square_kernel<21>, &square_kernel<22>, &square_kernel<23>,
+    &square_kernel<24>, &square_kernel<25>, &square_kernel<26>, &square_kernel<27>,
+    &square_kernel<28>, &square_kernel<29>, &square_kernel<30>, &square_kernel<31>,
+    &square_kernel<32>,
+};
+}
+
+GemmFixedKernel gemm_fixed_lookup(int M, int N, int K) {
+    if (M != N || N != K) return nullptr;
+    if (M < GEMM_FIXED_MIN_SIZE || M > GEMM_FIXED_MAX_SIZE) return nullptr;
+    return square_kernels[M];
+}
+
+extern "C" int matrix_fixed_kernel_available(int M, int N, int P) {
+    return gemm_fixed_lookup(M, P, N) != nullptr;
+}
+
+extern "C" int matrix_multiply_fixed(Matrix* A, Matrix* B, Matrix* C) {
+    if (!A || !B || !C) return -1;
+    if (A->cols != B->rows) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+
+    GemmFixedKernel kernel = gemm_fixed_lookup(A->rows, B->cols, A->cols);
+    if (!kernel) return -1;
+
+    kernel(A->data, B->data, C->data);
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include "half_precision.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HALF_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define HALF_HAVE_X86 0
+#endif
+
+HMatrix* hmatrix_create(int rows, int cols, HalfType type) {
+    if (rows <= 0 || cols <= 0) return NULL;
+    if (type != HALF_BF16 && type != HALF_FP16) return NULL;
+
+    HMatrix* h = (HMatrix*)malloc(sizeof(HMatrix));
+    if (!h) return NULL;
+
+    h->rows = rows;
+    h->cols = cols;
+    h->type = type;
+    h->data = (uint16_t*)calloc((size_t)rows * (size_t)cols, sizeof(uint16_t));
+
+    if (!h->data) {
+        free(h);
+        return NULL;
+    }
+
+    return h;
+}
+
+void hmatrix_free(HMatrix* h) {
+    if (h) {
+        free(h->data);
+        free(h);
+    }
+}
+
+const char* half_type_name(HalfType type) {
+    return (type == HALF_BF16) ? "bf16" : "fp16";
+}
+
+// ============================================================================
+// Scalar conversions
+// ============================================================================
+
+uint16_t float_to_bf16(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        // NaN: keep it quiet after truncation
+        return (uint16_t)((bits >> 16) | 0x0040u);
+    }
+
+    // Round to nearest even on the 16 discarded mantissa bits
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return (uint16_t)(bits >> 16);
+}
+
+float bf16_to_float(uint16_t value) {
+    uint32_t bits = (uint32_t)value << 16;
+    float out;
+    memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+uint16_t float_to_fp16(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000u);
+    uint32_t abs_bits = bits & 0x7FFFFFFFu;
+
+    if (abs_bits >= 0x7F800000u) {
+        // Inf stays Inf, NaN stays (quiet) NaN
+        return (uint16_t)(sign | 0x7C00u | (abs_bits > 0x7F800000u ? 0x0200u : 0u));
+    }
+    if (abs_bits >= 0x477FF000u) {
+        // 65520 and above round to infinity
+        return (uint16_t)(sign | 0x7C00u);
+    }
+    if (abs_bits < 0x38800000u) {
+        // Below 2^-14: subnormal, value = mantissa * 2^-24 (scaling is exact)
+        float abs_value;
+        memcpy(&abs_value, &abs_bits, sizeof(abs_value));
+        return (uint16_t)(sign | (uint16_t)rintf(abs_value * 16777216.0f));
+    }
+
+    // Normal: rebias exponent (127 -> 15) and round the 13 dropped bits
+    uint32_t h = (abs_bits >> 13) - ((127u - 15u) << 10);
+    uint32_t rest = abs_bits & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (h & 1u))) {
+        h++;
+    }
+    return (uint16_t)(sign | h);
+}
+
+float fp16_to_float(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        float v = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -v : v;
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+
+    float out;
+    memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+// ============================================================================
+// Row conversions used while packing
+// ============================================================================
+
+#if HALF_HAVE_X86
+__attribute__((target("avx,f16c")))
+static void fp16_row_to_float_f16c(const uint16_t* src, float* dst, int n) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + j));
+        _mm256_storeu_ps(dst + j, _mm256_cvtph_ps(h));
+    }
+    for (; j < n; j++) {
+        dst[j] = fp16_to_float(src[j]);
+    }
+}
+
+static int have_f16c(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        cached = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    }
+    return cached;
+}
+#endif
+
+static void half_row_to_float(const uint16_t* src, float* dst, int n, HalfType type) {
+    if (type == HALF_BF16) {
+        for (int j = 0; j < n; j++) {
+            dst[j] = bf16_to_float(src[j]);
+        }
+        return;
+    }
+
+#if HALF_HAVE_X86
+    if (have_f16c()) {
+        fp16_row_to_float_f16c(src, dst, n);
+        return;
+    }
+#endif
+    for (int j = 0; j < n; j++) {
+        dst[j] = fp16_to_float(src[j]);
+    }
+}
+
+static void half_row_to_double(const uint16_t* src, double* dst, int n, HalfType type) {
+    for (int j = 0; j < n; j++) {
+        dst[j] = (type == HALF_BF16) ? bf16_to_float(src[j]) : fp16_to_float(src[j]);
+    }
+}
+
+int matrix_to_half(Matrix* m, HMatrix* h) {
+    if (!m || !h) return -1;
+    if (m->rows != h->rows || m->cols != h->cols) return -1;
+
+    size_t count = (size_t)m->rows * (size_t)m->cols;
+    for (size_t i = 0; i < count; i++) {
+        float v = (float)m->data[i];
+        h->data[i] = (h->type == HALF_BF16) ? float_to_bf16(v) : float_to_fp16(v);
+    }
+
+    return 0;
+}
+
+int matrix_from_half(HMatrix* h, Matrix* m) {
+    if (!m || !h) return -1;
+    if (m->rows != h->rows || m->cols != h->cols) return -1;
+
+    for (int i = 0; i < h->rows; i++) {
+        half_row_to_double(h->data + (size_t)i * h->cols, m->data + (size_t)i * m->cols,
+                           h->cols, h->type);
+    }
+
+    return 0;
+}
+
+// ============================================================================
+// Blocked GEMM on half storage
+// ============================================================================
+
+int matrix_multiply_half_blocked(HMatrix* A, HMatrix* B, Matrix* C,
+                                 int block_size, HalfAccum accum) {
+    // Check dimensions: A (M x N) * B (N x P) = C (M x P)
+    if (!A || !B || !C) return -1;
+    if (A->type != B->type) return -1;
+    if (A->cols != B->rows) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+
+    int M = A->rows;
+    int N = A->cols;
+    int P = B->cols;
+    int BLOCK = (block_size > 0) ? block_size : get_optimal_block_size();
+    int use_fp32 = (accum != HALF_ACCUM_FP64);
+    size_t elem = use_fp32 ? sizeof(float) : sizeof(double);
+
+    // A panel: all M rows of the current k-block; B tile: one k-block x j-block
+    void* a_panel = malloc((size_t)M * BLOCK * elem);
+    void* b_tile = malloc((size_t)BLOCK * BLOCK * elem);
+    float* c_acc = (float*)malloc((size_t)BLOCK * sizeof(float));
+    if (!a_panel || !b_tile || !c_acc) {
+        free(a_panel);
+        free(b_tile);
+        free(c_acc);
+        return -1;
+    }
+
+    matrix_zeros(C);
+    double* c_data = C->data;
+    int c_stride = C->cols;
+
+    for (int kk = 0; kk < N; kk += BLOCK) {
+        int k_max = (kk + BLOCK < N) ? kk + BLOCK : N;
+        int kb = k_max - kk;
+
+        // Widen the A k-panel once; it is reused by every j-block
+        for (int i = 0; i < M; i++) {
+            const uint16_t* src = A->data + (size_t)i * N + kk;
+            if (use_fp32) {
+                half_row_to_float(src, (float*)a_panel + (size_t)i * kb, kb, A->type);
+            } else {
+                half_row_to_double(src, (double*)a_panel + (size_t)i * kb, kb, A->type);
+            }
+        }
+
+        for (int jj = 0; jj < P; jj += BLOCK) {
+            int j_max = (jj + BLOCK < P) ? jj + BLOCK : P;
+            int jb = j_max - jj;
+
+            // Widen the B tile once; it stays cache resident for all rows
+            for (int k = 0; k < kb; k++) {
+                const uint16_t* src = B->data + (size_t)(kk + k) * P + jj;
+                if (use_fp32) {
+                    half_row_to_float(src, (float*)b_tile + (size_t)k * jb, jb, B->type);
+                } else {
+                    half_row_to_double(src, (double*)b_tile + (size_t)k * jb, jb, B->type);
+                }
+            }
+
+            for (int i = 0; i < M; i++) {
+                double* c_row = c_data + (size_t)i * c_stride + jj;
+
+                if (use_fp32) {
+                    const float* a_row = (const float*)a_panel + (size_t)i * kb;
+                    const float* b = (const float*)b_tile;
+                    for (int j = 0; j < jb; j++) {
+                        c_acc[j] = 0.0f;
+                    }
+                    for (int k = 0; k < kb; k++) {
+                        float a_val = a_row[k];
+                        const float* b_row = b + (size_t)k * jb;
+                        for (int j = 0; j < jb; j++) {
+                            c_acc[j] += a_val * b_row[j];
+                        }
+                    }
+                    for (int j = 0; j < jb; j++) {
+                        c_row[j] += (double)c_acc[j];
+                    }
+                } else {
+                    const double* a_row = (const double*)a_panel + (size_t)i * kb;
+                    const double* b = (const double*)b_tile;
+                    for (int k = 0; k < kb; k++) {
+                        double a_val = a_row[k];
+                        const double* b_row = b + (size_t)k * jb;
+                        for (int j = 0; j < jb; j++) {
+                            c_row[j] += a_val * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    free(a_panel);
+    free(b_tile);
+    free(c_acc);
+    return 0;
+}
@@ -0,0 +1,1318 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "matrix.h"
+#include "profiler.h"
+#include "batched.h"
+#include "gemm_fixed.h"
+#include "dot_kernel.h"
+#include "transpose.h"
+#include "prepared.h"
+#include "matrix_io.h"
+#include "out_of_core.h"
+#include "pipelined.h"
+#include "matrix_random.h"
+#include "loop_order.h"
+#include "perf_counters.h"
+#include "antagonist.h"
+#include "concurrent_matrix.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct BenchOptions {
+    int threads = 0;        // 0 = auto-detect
+    int iterations = 3;
+    int batch = 10000;
+    std::vector<int> sizes;
+    std::string a_path;     // operand files for the 'file' benchmark
+    std::string b_path;
+    std::string out_path;
+    size_t budget_mb = 0;   // out-of-core memory budget (0 = library default)
+    std::vector<int> prefetch_distances;
+    std::vector<int> antagonists;   // antagonist thread counts (interference)
+    std::string antagonist_kind = "cache";
+    size_t working_set_mb = 0;      // per antagonist (0 = antagonist default)
+    std::vector<int> blocks;        // blocked kernel block sizes (interference)
+    bool pin = false;
+};
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " <benchmark> [options]\n\n";
+    std::cout << "Benchmarks:\n";
+    std::cout << "  batched          Batched small GEMM vs looping over matrix_multiply_blocked\n";
+    std::cout << "  fixed            Compile-time gemm_fixed<N,N,N> vs naive and blocked kernels\n";
+    std::cout << "  transpose        Register-blocked A * B_T kernel vs serial dot products and blocked\n";
+    std::cout << "  transpose-bw     Transpose bandwidth: naive, tiled, SIMD, parallel and in-place\n";
+    std::cout << "  prepared         One B against many A: per-call B_T vs prepared operand vs cache\n";
+    std::cout << "  file             Kernels on operands loaded from .npy / CLM files (--a, --b)\n";
+    std::cout << "  ooc              Out-of-core GEMM streamed from files: serial vs double-buffered reads\n";
+    std::cout << "  pipelined        Packed blocked GEMM: prefetch distances and pack thread vs blocked\n";
+    std::cout << "  init             Matrix initialisation: rand() loop vs counter RNG, parallel fill/zero/copy\n";
+    std::cout << "  loops            All six GEMM loop orders, unblocked and blocked, with miss counters\n";
+    std::cout << "  interference     Kernel slowdown with cache-thrashing or bandwidth-hogging antagonists\n";
+    std::cout << "\nOptions:\n";
+    std::cout << "  --sizes <a,b,..> Matrix sizes (default depends on benchmark)\n";
+    std::cout << "  --threads <N>    Number of threads (0 = auto, default: auto)\n";
+    std::cout << "  --iterations <N> Number of iterations (default: 3)\n";
+    std::cout << "  --batch <N>      Products per batch / repeated calls (default: 10000)\n";
+    std::cout << "  --a <file>       Left operand file (file benchmark)\n";
+    std::cout << "  --b <file>       Right operand file (file benchmark)\n";
+    std::cout << "  --out <file>     Write the product to this file, mapped (file benchmark)\n";
+    std::cout << "                   or the locality matrix CSV (loops, default: loop_orders.csv)\n";
+    std::cout << "                   or the slowdown CSV (interference, default: interference.csv)\n";
+    std::cout << "  --budget <MB>    Memory budget for the ooc benchmark (default: 256)\n";
+    std::cout << "  --prefetch <a,b> Prefetch distances in tiles (pipelined, default: 1,2,4)\n";
+    std::cout << "  --antagonists <a,b> Antagonist thread counts (interference, default: 1,2,.. < cores)\n";
+    std::cout << "  --antagonist <kind> Antagonist kind: cache or bandwidth (default: cache)\n";
+    std::cout << "  --ws-mb <N>      Working set per antagonist in MB (default: L3 size for cache,\n";
+    std::cout << "                   4x L3 for bandwidth)\n";
+    std::cout << "  --blocks <a,b>   Block sizes of the blocked kernel (interference, default: 32,optimal,128)\n";
+    std::cout << "  --pin            Pin the kernel to CPU 0 and antagonists to the last CPUs\n";
+    std::cout << "  --help           Show this help message\n";
+    std::cout << "\nExamples:\n";
+    std::cout << "  " << program_name << " batched --sizes 4,8,16 --threads 4\n";
+    std::cout << "  " << program_name << " fixed --batch 100000\n";
+    std::cout << "  " << program_name << " transpose --sizes 256,512,1024\n";
+    std::cout << "  " << program_name << " transpose-bw --sizes 1024,4096 --threads 4\n";
+    std::cout << "  " << program_name << " prepared --sizes 256,1024 --batch 64\n";
+    std::cout << "  " << program_name << " file --a A.npy --b B.npy --out C.npy\n";
+    std::cout << "  " << program_name << " ooc --sizes 4096 --budget 64\n";
+    std::cout << "  " << program_name << " pipelined --sizes 1024,2048 --prefetch 1,2,4,8\n";
+    std::cout << "  " << program_name << " init --sizes 4096,8192 --threads 8\n";
+    std::cout << "  " << program_name << " loops --sizes 128,256,512 --out loop_orders.csv\n";
+    std::cout << "  " << program_name << " interference --sizes 512 --antagonists 1,2,3 --antagonist bandwidth --pin\n";
+}
+
+std::vector<int> parse_sizes(const char* text) {
+    std::vector<int> sizes;
+    std::string list = text;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        int value = std::atoi(list.substr(pos, comma - pos).c_str());
+        if (value > 0) sizes.push_back(value);
+        pos = comma + 1;
+    }
+    return sizes;
+}
+
+std::string threads_label(int threads) {
+    return threads > 0 ? std::to_string(threads) : std::string("auto");
+}
+
+double gflops(double flops, double ms) {
+    return (ms > 0.0) ? flops / (ms * 1e6) : 0.0;
+}
+
+// Time fn() averaged over iterations (milliseconds)
+template <typename Fn>
+double time_average_ms(int iterations, Fn fn) {
+    double total = 0.0;
+    for (int iter = 0; iter < iterations; ++iter) {
+        double start = get_time_ms();
+        fn();
+        total += get_time_ms() - start;
+    }
+    return total / iterations;
+}
+
+void print_row(int size, const char* method, double ms, double flops, double baseline_ms) {
+    std::cout << std::left << std::setw(6) << size
+              << std::setw(34) << method
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << ms
+              << std::setw(12) << std::setprecision(2) << gflops(flops, ms)
+              << std::setw(10) << baseline_ms / ms << "x\n";
+}
+
+double max_abs_diff(const double* a, const double* b, size_t count) {
+    double max_diff = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        max_diff = std::max(max_diff, std::fabs(a[i] - b[i]));
+    }
+    return max_diff;
+}
+
+// ============================================================================
+// Batched GEMM
+// ============================================================================
+
+void bench_batched(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {4, 8, 16, 32, 64};
+
+    std::cout << "\nBatched GEMM (threads: " << threads_label(opts.threads) << ", iterations: "
+              << opts.iterations << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        // Keep the three operand arrays under ~256 MB
+        size_t elems = static_cast<size_t>(n) * n;
+        size_t max_batch = (256u << 20) / (3 * elems * sizeof(double));
+        int batch = static_cast<int>(std::min<size_t>(opts.batch, std::max<size_t>(1, max_batch)));
+        double flops = 2.0 * n * n * static_cast<double>(n) * batch;
+
+        std::vector<Matrix*> A(batch), B(batch), C_loop(batch), C_batch(batch);
+        for (int b = 0; b < batch; ++b) {
+            A[b] = matrix_create(n, n);
+            B[b] = matrix_create(n, n);
+            C_loop[b] = matrix_create(n, n);
+            C_batch[b] = matrix_create(n, n);
+            matrix_randomize(A[b]);
+            matrix_randomize(B[b]);
+        }
+
+        std::vector<double> A_strided(elems * batch), B_strided(elems * batch), C_strided(elems * batch);
+        for (int b = 0; b < batch; ++b) {
+            std::copy(A[b]->data, A[b]->data + elems, A_strided.begin() + b * elems);
+            std::copy(B[b]->data, B[b]->data + elems, B_strided.begin() + b * elems);
+        }
+        std::vector<double> A_inter(elems * batch), B_inter(elems * batch), C_inter(elems * batch);
+        matrix_batch_interleave(A_strided.data(), elems, n, n, batch, A_inter.data());
+        matrix_batch_interleave(B_strided.data(), elems, n, n, batch, B_inter.data());
+
+        double loop_ms = time_average_ms(opts.iterations, [&]() {
+            for (int b = 0; b < batch; ++b) {
+                matrix_multiply_blocked(A[b], B[b], C_loop[b], 0);
+            }
+        });
+        double loop_parallel_ms = time_average_ms(opts.iterations, [&]() {
+            for (int b = 0; b < batch; ++b) {
+                matrix_multiply_blocked_parallel(A[b], B[b], C_batch[b], 0, opts.threads);
+            }
+        });
+        double pointer_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_batched(A.data(), B.data(), C_batch.data(), batch, opts.threads);
+        });
+        double strided_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_batched_strided(n, n, n, A_strided.data(), elems, B_strided.data(), elems,
+                                            C_strided.data(), elems, batch, opts.threads);
+        });
+        double inter_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_batched_interleaved(n, n, n, A_inter.data(), B_inter.data(),
+                                                C_inter.data(), batch, opts.threads);
+        });
+
+        print_row(n, "loop matrix_multiply_blocked", loop_ms, flops, loop_ms);
+        print_row(n, "loop matrix_multiply_blocked_par", loop_parallel_ms, flops, loop_ms);
+        print_row(n, "batched (pointer array)", pointer_ms, flops, loop_ms);
+        print_row(n, "batched (strided)", strided_ms, flops, loop_ms);
+        print_row(n, "batched (interleaved)", inter_ms, flops, loop_ms);
+
+        // Verify every batched layout against the per-pair loop
+        std::vector<double> C_check(elems * batch);
+        matrix_batch_deinterleave(C_inter.data(), n, n, batch, C_check.data(), elems);
+        double max_diff = 0.0;
+        for (int b = 0; b < batch; ++b) {
+            max_diff = std::max(max_diff, max_abs_diff(C_loop[b]->data, C_batch[b]->data, elems));
+            max_diff = std::max(max_diff, max_abs_diff(C_loop[b]->data, &C_strided[b * elems], elems));
+            max_diff = std::max(max_diff, max_abs_diff(C_loop[b]->data, &C_check[b * elems], elems));
+        }
+        if (max_diff > 1e-9) {
+            std::cerr << "Warning: batched results differ from loop (max diff: " << max_diff << ")\n";
+        }
+        std::cout << std::left << std::setw(6) << "" << "batch = " << batch << "\n";
+
+        for (int b = 0; b < batch; ++b) {
+            matrix_free(A[b]);
+            matrix_free(B[b]);
+            matrix_free(C_loop[b]);
+            matrix_free(C_batch[b]);
+        }
+    }
+}
+
+// ============================================================================
+// Compile-time specialised kernels
+// ============================================================================
+
+void bench_fixed(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {4, 8, 16, 32};
+
+    std::cout << "\nFixed-size GEMM (single thread, iterations: " << opts.iterations
+              << ", repeats: " << opts.batch << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        GemmFixedKernel kernel = gemm_fixed_lookup(n, n, n);
+        if (!kernel) {
+            std::cout << std::left << std::setw(6) << n << "no specialisation (supported: "
+                      << GEMM_FIXED_MIN_SIZE << ".." << GEMM_FIXED_MAX_SIZE << ")\n";
+            continue;
+        }
+
+        // The operands stay in L1, so each call is repeated to get a measurable time
+        int repeats = opts.batch;
+        double flops = 2.0 * n * n * static_cast<double>(n) * repeats;
+        size_t elems = static_cast<size_t>(n) * n;
+
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C_naive = matrix_create(n, n);
+        Matrix* C_blocked = matrix_create(n, n);
+        Matrix* C_fixed = matrix_create(n, n);
+        matrix_randomize(A);
+        matrix_randomize(B);
+
+        double naive_ms = time_average_ms(opts.iterations, [&]() {
+            for (int r = 0; r < repeats; ++r) {
+                matrix_multiply_naive(A, B, C_naive);
+            }
+        });
+        double blocked_ms = time_average_ms(opts.iterations, [&]() {
+            for (int r = 0; r < repeats; ++r) {
+                matrix_multiply_blocked(A, B, C_blocked, 0);
+            }
+        });
+        double fixed_ms = time_average_ms(opts.iterations, [&]() {
+            for (int r = 0; r < repeats; ++r) {
+                kernel(A->data, B->data, C_fixed->data);
+            }
+        });
+
+        print_row(n, "matrix_multiply_naive", naive_ms, flops, naive_ms);
+        print_row(n, "matrix_multiply_blocked", blocked_ms, flops, naive_ms);
+        print_row(n, "gemm_fixed<N,N,N>", fixed_ms, flops, naive_ms);
+
+        double max_diff = std::max(max_abs_diff(C_naive->data, C_fixed->data, elems),
+                                   max_abs_diff(C_naive->data, C_blocked->data, elems));
+        if (max_diff > 1e-9) {
+            std::cerr << "Warning: fixed kernel differs from naive (max diff: " << max_diff << ")\n";
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C_naive);
+        matrix_free(C_blocked);
+        matrix_free(C_fixed);
+    }
+}
+
+// ============================================================================
+// Transpose path
+// ============================================================================
+
+// Previous transpose kernel: one serial dot product per element of C
+void serial_dot_abt(const double* A, const double* B_T, double* C, int M, int N, int P) {
+    for (int i = 0; i < M; ++i) {
+        const double* a_row = A + static_cast<size_t>(i) * N;
+        for (int j = 0; j < P; ++j) {
+            const double* b_row = B_T + static_cast<size_t>(j) * N;
+            double sum = 0.0;
+            for (int k = 0; k < N; ++k) {
+                sum += a_row[k] * b_row[k];
+            }
+            C[static_cast<size_t>(i) * P + j] = sum;
+        }
+    }
+}
+
+void bench_transpose(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {256, 512, 1024};
+
+    std::cout << "\nTranspose-path GEMM (single thread, iterations: " << opts.iterations << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        double flops = 2.0 * n * n * static_cast<double>(n);
+        size_t elems = static_cast<size_t>(n) * n;
+
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* B_T = matrix_create(n, n);
+        Matrix* C_ref = matrix_create(n, n);
+        Matrix* C = matrix_create(n, n);
+        matrix_randomize(A);
+        matrix_randomize(B);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                B_T->data[static_cast<size_t>(j) * n + i] = B->data[static_cast<size_t>(i) * n + j];
+            }
+        }
+
+        // Kernel-only timings share one pre-transposed B_T
+        double serial_ms = time_average_ms(opts.iterations, [&]() {
+            serial_dot_abt(A->data, B_T->data, C_ref->data, n, n, n);
+        });
+        print_row(n, "serial dot (previous kernel)", serial_ms, flops, serial_ms);
+
+        const DotKernelPath paths[] = {DOT_PATH_PORTABLE, DOT_PATH_AVX2};
+        for (DotKernelPath path : paths) {
+            if (dot_kernel_select_path(path) != path) continue;
+            double ms = time_average_ms(opts.iterations, [&]() {
+                dot_kernel_rows(A->data, n, B_T->data, n, C->data, n, n, n, 0, n);
+            });
+            std::string label = std::string("register-blocked (") + dot_kernel_path_name(path) + ")";
+            print_row(n, label.c_str(), ms, flops, serial_ms);
+            double max_diff = max_abs_diff(C_ref->data, C->data, elems);
+            if (max_diff > 1e-9 * n) {
+                std::cerr << "Warning: " << label << " differs from serial (max diff: " << max_diff << ")\n";
+            }
+        }
+        dot_kernel_select_path(DOT_PATH_AUTO);
+
+        // Full entry points, including the transpose of B
+        double transpose_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_transpose(A, B, C);
+        });
+        double blocked_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_blocked(A, B, C, 0);
+        });
+        print_row(n, "matrix_multiply_transpose", transpose_ms, flops, serial_ms);
+        print_row(n, "matrix_multiply_blocked", blocked_ms, flops, serial_ms);
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(B_T);
+        matrix_free(C_ref);
+        matrix_free(C);
+    }
+}
+
+// ============================================================================
+// Transpose bandwidth
+// ============================================================================
+
+// Previous B_T construction: row-order reads, column-order (strided) writes
+void naive_transpose(const double* src, double* dst, int rows, int cols) {
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            dst[static_cast<size_t>(j) * rows + i] = src[static_cast<size_t>(i) * cols + j];
+        }
+    }
+}
+
+void print_bw_row(int size, const char* method, double ms, double bytes, double baseline_ms) {
+    std::cout << std::left << std::setw(6) << size
+              << std::setw(34) << method
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << ms
+              << std::setw(12) << std::setprecision(2) << (ms > 0.0 ? bytes / (ms * 1e6) : 0.0)
+              << std::setw(10) << baseline_ms / ms << "x\n";
+}
+
+void bench_transpose_bw(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {512, 1024, 2048, 4096};
+
+    std::cout << "\nTranspose bandwidth (threads: " << threads_label(opts.threads) << ", iterations: "
+              << opts.iterations << "; GB/s counts one read and one write per element)\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GB/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        size_t elems = static_cast<size_t>(n) * n;
+        double bytes = 2.0 * sizeof(double) * static_cast<double>(elems);
+
+        Matrix* src = matrix_create(n, n);
+        Matrix* dst = matrix_create(n, n);
+        Matrix* ref = matrix_create(n, n);
+        matrix_randomize(src);
+        naive_transpose(src->data, ref->data, n, n);
+
+        double naive_ms = time_average_ms(opts.iterations, [&]() {
+            naive_transpose(src->data, dst->data, n, n);
+        });
+        print_bw_row(n, "naive double loop", naive_ms, bytes, naive_ms);
+
+        const TransposePath paths[] = {TRANSPOSE_PATH_PORTABLE, TRANSPOSE_PATH_AVX};
+        for (TransposePath path : paths) {
+            if (transpose_select_path(path) != path) continue;
+            double ms = time_average_ms(opts.iterations, [&]() {
+                matrix_transpose(src, dst);
+            });
+            std::string label = std::string("tiled (") + transpose_path_name(path) + ")";
+            print_bw_row(n, label.c_str(), ms, bytes, naive_ms);
+        }
+        transpose_select_path(TRANSPOSE_PATH_AUTO);
+
+        double parallel_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_transpose_parallel(src, dst, opts.threads);
+        });
+        std::string parallel_label = "tiled parallel (" + threads_label(opts.threads) + " threads)";
+        print_bw_row(n, parallel_label.c_str(), parallel_ms, bytes, naive_ms);
+        if (max_abs_diff(ref->data, dst->data, elems) != 0.0) {
+            std::cerr << "Warning: tiled transpose differs from naive\n";
+        }
+
+        // In-place runs transpose the same buffer back and forth
+        double square_ms = time_average_ms(opts.iterations, [&]() {
+            transpose_in_place_square(dst->data, n);
+        });
+        print_bw_row(n, "in-place square (tile pairs)", square_ms, bytes, naive_ms);
+
+        int half = std::max(1, n / 2);
+        double rect_ms = time_average_ms(opts.iterations, [&]() {
+            transpose_in_place(dst->data, 2 * half, half);
+            transpose_in_place(dst->data, half, 2 * half);
+        }) / 2.0;
+        // Half the elements of the square runs: scale the baseline to match
+        double rect_bytes = 2.0 * sizeof(double) * 2.0 * half * half;
+        print_bw_row(n, "in-place rect 2:1 (cycles)", rect_ms, rect_bytes,
+                     naive_ms * rect_bytes / bytes);
+
+        matrix_free(src);
+        matrix_free(dst);
+        matrix_free(ref);
+    }
+}
+
+// ============================================================================
+// Prepared operands
+// ============================================================================
+
+void bench_prepared(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {256, 1024};
+
+    // Many thin A (16 rows) against one square B, as with a fixed weight matrix
+    const int a_rows = 16;
+    int calls = std::min(opts.batch, 256);
+
+    std::cout << "\nPrepared B (" << calls << " calls of " << a_rows << " x N * N x N, iterations: "
+              << opts.iterations << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        double flops = 2.0 * a_rows * n * static_cast<double>(n) * calls;
+
+        Matrix* A = matrix_create(a_rows, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C_ref = matrix_create(a_rows, n);
+        Matrix* C = matrix_create(a_rows, n);
+        matrix_randomize(A);
+        matrix_randomize(B);
+
+        double transpose_ms = time_average_ms(opts.iterations, [&]() {
+            for (int c = 0; c < calls; ++c) matrix_multiply_transpose(A, B, C_ref);
+        });
+        double prepared_ms = time_average_ms(opts.iterations, [&]() {
+            PreparedB* prep = matrix_prepare_b(B);
+            for (int c = 0; c < calls; ++c) matrix_multiply_prepared(A, prep, C);
+            prepared_b_free(prep);
+        });
+        PreparedCache* cache = prepared_cache_create(4);
+        double cache_ms = time_average_ms(opts.iterations, [&]() {
+            for (int c = 0; c < calls; ++c) {
+                matrix_multiply_prepared(A, prepared_cache_get(cache, B, 0), C);
+            }
+        });
+        unsigned long hits = 0, misses = 0;
+        prepared_cache_stats(cache, &hits, &misses);
+        prepared_cache_free(cache);
+
+        print_row(n, "matrix_multiply_transpose per call", transpose_ms, flops, transpose_ms);
+        print_row(n, "prepared once + multiply_prepared", prepared_ms, flops, transpose_ms);
+        print_row(n, "prepared_cache_get per call", cache_ms, flops, transpose_ms);
+        std::cout << std::left << std::setw(6) << "" << "cache hits = " << hits
+                  << ", misses = " << misses << "\n";
+
+        double max_diff = max_abs_diff(C_ref->data, C->data, static_cast<size_t>(a_rows) * n);
+        if (max_diff > 1e-9) {
+            std::cerr << "Warning: prepared result differs (max diff: " << max_diff << ")\n";
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C_ref);
+        matrix_free(C);
+    }
+}
+
+// ============================================================================
+// Operands from files
+// ============================================================================
+
+// Map a row-major float64 file in place, or fall back to a converting load.
+// Exactly one of *mapped / *loaded is set on success.
+Matrix* open_operand(const std::string& path, MappedMatrix** mapped, Matrix** loaded) {
+    *mapped = nullptr;
+    *loaded = nullptr;
+    MatrixFileInfo info;
+    if (matrix_file_info(path.c_str(), &info) != 0) {
+        std::cerr << "Error: cannot read matrix file " << path << "\n";
+        return nullptr;
+    }
+
+    *mapped = matrix_map(path.c_str(), 0);
+    if (*mapped && (*mapped)->view.ld == info.cols) {
+        std::cout << path << ": " << info.rows << " x " << info.cols << " mapped (zero copy)\n";
+        return &(*mapped)->matrix;
+    }
+    matrix_unmap(*mapped);
+    *mapped = nullptr;
+
+    *loaded = matrix_load(path.c_str());
+    if (*loaded) {
+        std::cout << path << ": " << info.rows << " x " << info.cols << " loaded (converted)\n";
+    }
+    return *loaded;
+}
+
+int bench_file(const BenchOptions& opts) {
+    if (opts.a_path.empty() || opts.b_path.empty()) {
+        std::cerr << "Error: the file benchmark needs --a <file> and --b <file>\n";
+        return 1;
+    }
+
+    MappedMatrix *a_map, *b_map;
+    Matrix *a_loaded, *b_loaded;
+    double open_start = get_time_ms();
+    Matrix* A = open_operand(opts.a_path, &a_map, &a_loaded);
+    Matrix* B = open_operand(opts.b_path, &b_map, &b_loaded);
+    double open_ms = get_time_ms() - open_start;
+
+    int status = 1;
+    MappedMatrix* out = nullptr;
+    Matrix* C = nullptr;
+    if (!A || !B) {
+        // error already reported
+    } else if (A->cols != B->rows) {
+        std::cerr << "Error: dimension mismatch (" << A->rows << " x " << A->cols << " * "
+                  << B->rows << " x " << B->cols << ")\n";
+    } else {
+        if (!opts.out_path.empty()) {
+            out = matrix_map_create(opts.out_path.c_str(), A->rows, B->cols, MATRIX_FORMAT_AUTO);
+            if (!out) std::cerr << "Error: cannot create " << opts.out_path << "\n";
+        }
+        C = out ? &out->matrix : matrix_create(A->rows, B->cols);
+    }
+
+    if (C) {
+        std::cout << "Opened operands in " << std::fixed << std::setprecision(3) << open_ms << " ms\n";
+        double flops = 2.0 * A->rows * static_cast<double>(A->cols) * B->cols;
+
+        std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+                  << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+                  << std::setw(11) << "Speedup" << "\n";
+        std::cout << std::string(75, '-') << "\n";
+
+        double blocked_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_blocked(A, B, C, 0);
+        });
+        double transpose_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_transpose(A, B, C);
+        });
+        double parallel_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_blocked_parallel(A, B, C, 0, opts.threads);
+        });
+        print_row(A->rows, "matrix_multiply_blocked", blocked_ms, flops, blocked_ms);
+        print_row(A->rows, "matrix_multiply_transpose", transpose_ms, flops, blocked_ms);
+        print_row(A->rows, "matrix_multiply_blocked_parallel", parallel_ms, flops, blocked_ms);
+
+        if (out) {
+            matrix_map_sync(out);
+            std::cout << "Result written to " << opts.out_path << "\n";
+        }
+        status = 0;
+    }
+
+    if (out) {
+        matrix_unmap(out);
+    } else {
+        matrix_free(C);
+    }
+    matrix_unmap(a_map);
+    matrix_unmap(b_map);
+    matrix_free(a_loaded);
+    matrix_free(b_loaded);
+    return status;
+}
+
+// ============================================================================
+// Out-of-core GEMM
+// ============================================================================
+
+// Write an n x n random operand straight into a mapped file, then drop it
+// from the page cache so the benchmark reads it from the device
+bool write_random_operand(const std::string& path, int n) {
+    MappedMatrix* mm = matrix_map_create(path.c_str(), n, n, MATRIX_FORMAT_CLM);
+    if (!mm) return false;
+    matrix_randomize(&mm->matrix);
+    int status = matrix_map_sync(mm);
+    matrix_unmap(mm);
+    return status == 0;
+}
+
+void drop_cached(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+int bench_ooc(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {1024, 2048};
+
+    OocOptions ooc = ooc_default_options();
+    if (opts.budget_mb > 0) ooc.memory_budget = opts.budget_mb << 20;
+
+    std::cout << "\nOut-of-core GEMM (budget: " << (ooc.memory_budget >> 20) << " MB, iterations: "
+              << opts.iterations << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(16) << "Reads"
+              << std::right << std::setw(7) << "Tile" << std::setw(12) << "Time (ms)"
+              << std::setw(10) << "GFLOP/s" << std::setw(12) << "Read MB/s"
+              << std::setw(11) << "Wait (ms)" << std::setw(10) << "Overlap" << "\n";
+    std::cout << std::string(84, '-') << "\n";
+
+    std::string dir = "/tmp";
+    if (const char* tmp = std::getenv("TMPDIR")) dir = tmp;
+    std::string a_path = dir + "/ooc_bench_a.clm";
+    std::string b_path = dir + "/ooc_bench_b.clm";
+    std::string c_path = dir + "/ooc_bench_c.clm";
+
+    int status = 0;
+    for (int n : sizes) {
+        if (!write_random_operand(a_path, n) || !write_random_operand(b_path, n)) {
+            std::cerr << "Error: cannot write operands to " << dir << "\n";
+            status = 1;
+            break;
+        }
+        double flops = 2.0 * n * n * static_cast<double>(n);
+
+        const char* modes[] = {"serial", "double-buffered"};
+        for (int double_buffer = 0; double_buffer <= 1; ++double_buffer) {
+            ooc.double_buffer = double_buffer;
+            OocStats total = {};
+            for (int iter = 0; iter < opts.iterations; ++iter) {
+                drop_cached(a_path);
+                drop_cached(b_path);
+                OocStats stats;
+                if (matrix_multiply_out_of_core(a_path.c_str(), b_path.c_str(), c_path.c_str(),
+                                                &ooc, &stats, nullptr) != 0) {
+                    std::cerr << "Error: out-of-core multiply failed\n";
+                    status = 1;
+                    break;
+                }
+                total.tile = stats.tile;
+                total.total_ms += stats.total_ms / opts.iterations;
+                total.read_ms += stats.read_ms / opts.iterations;
+                total.wait_ms += stats.wait_ms / opts.iterations;
+                total.overlap += stats.overlap / opts.iterations;
+                total.bytes_read = stats.bytes_read;
+            }
+            if (status != 0) break;
+
+            double read_mb_s = total.read_ms > 0.0 ? total.bytes_read / (total.read_ms * 1e3) : 0.0;
+            std::cout << std::left << std::setw(6) << n << std::setw(16) << modes[double_buffer]
+                      << std::right << std::setw(7) << total.tile
+                      << std::fixed << std::setprecision(3) << std::setw(12) << total.total_ms
+                      << std::setprecision(2) << std::setw(10) << gflops(flops, total.total_ms)
+                      << std::setprecision(1) << std::setw(12) << read_mb_s
+                      << std::setprecision(3) << std::setw(11) << total.wait_ms
+                      << std::setprecision(1) << std::setw(9) << total.overlap * 100.0 << "%\n";
+        }
+        if (status != 0) break;
+    }
+
+    std::remove(a_path.c_str());
+    std::remove(b_path.c_str());
+    std::remove(c_path.c_str());
+    return status;
+}
+
+// ============================================================================
+// Pipelined blocked GEMM
+// ============================================================================
+
+double section_ms(const Profiler& profiler, const char* name) {
+    for (int i = 0; i < profiler.count; ++i) {
+        if (std::strcmp(profiler.points[i].name, name) == 0) return profiler.points[i].elapsed_ms;
+    }
+    return 0.0;
+}
+
+void bench_pipelined(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {512, 1024, 2048};
+    std::vector<int> distances = opts.prefetch_distances;
+    if (distances.empty()) distances = {1, 2, 4};
+
+    std::cout << "\nPipelined blocked GEMM (block: " << get_optimal_block_size()
+              << ", iterations: " << opts.iterations << ")\n";
+    std::cout << "Stall = time the kernel waited for B panels to be packed (profiler 'pipeline_wait')\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup" << std::setw(12) << "Stall (ms)" << "\n";
+    std::cout << std::string(87, '-') << "\n";
+
+    for (int n : sizes) {
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C_ref = matrix_create(n, n);
+        Matrix* C = matrix_create(n, n);
+        matrix_randomize(A);
+        matrix_randomize(B);
+        double flops = 2.0 * n * n * static_cast<double>(n);
+
+        double blocked_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_multiply_blocked(A, B, C_ref, 0);
+        });
+        print_row(n, "matrix_multiply_blocked", blocked_ms, flops, blocked_ms);
+        std::cout << "\n";
+
+        // (pack thread, distance) pairs: serial baseline, then each knob alone and combined
+        std::vector<std::pair<int, int>> variants = {{0, 0}};
+        for (int d : distances) variants.push_back({0, d});
+        variants.push_back({1, 0});
+        for (int d : distances) variants.push_back({1, d});
+
+        for (const auto& variant : variants) {
+            PipelineOptions popts = pipeline_default_options();
+            popts.pack_thread = variant.first;
+            popts.prefetch_distance = variant.second;
+
+            Profiler profiler;
+            profiler_init(&profiler);
+            for (int iter = 0; iter < opts.iterations; ++iter) {
+                matrix_multiply_pipelined(A, B, C, &popts, nullptr, &profiler);
+            }
+            double ms = section_ms(profiler, "pipeline_total") / opts.iterations;
+            double stall_ms = section_ms(profiler, "pipeline_wait") / opts.iterations;
+
+            std::string label = std::string(variant.first ? "pack thread" : "serial pack") +
+                                ", prefetch " + (variant.second ? std::to_string(variant.second) : "off");
+            std::cout << std::left << std::setw(6) << n << std::setw(34) << label
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(12) << ms
+                      << std::setw(12) << std::setprecision(2) << gflops(flops, ms)
+                      << std::setw(10) << blocked_ms / ms << "x"
+                      << std::setw(12) << std::setprecision(3) << stall_ms << "\n";
+
+            double max_diff = max_abs_diff(C_ref->data, C->data, matrix_elements(C));
+            if (max_diff > 1e-9) {
+                std::cerr << "Warning: pipelined result differs (max diff: " << max_diff << ")\n";
+            }
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C_ref);
+        matrix_free(C);
+    }
+}
+
+// ============================================================================
+// Initialisation
+// ============================================================================
+
+void print_bandwidth_row(int size, const char* method, double ms, double bytes, double baseline_ms) {
+    std::cout << std::left << std::setw(6) << size << std::setw(34) << method
+              << std::right << std::fixed << std::setprecision(3) << std::setw(12) << ms
+              << std::setw(12) << std::setprecision(2) << (ms > 0.0 ? bytes / (ms * 1e6) : 0.0)
+              << std::setw(10) << baseline_ms / ms << "x\n";
+}
+
+void bench_init(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {2048, 4096, 8192};
+
+    std::cout << "\nMatrix initialisation (threads: " << threads_label(opts.threads) << ", iterations: "
+              << opts.iterations << ", rng path: " << random_path_name(random_active_path()) << ")\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(34) << "Method"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GB/s"
+              << std::setw(11) << "Speedup" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int n : sizes) {
+        Matrix* a = matrix_create(n, n);
+        Matrix* b = matrix_create(n, n);
+        if (!a || !b) {
+            std::cerr << "Error: cannot allocate " << n << " x " << n << " matrices\n";
+            matrix_free(a);
+            matrix_free(b);
+            continue;
+        }
+        size_t count = matrix_elements(a);
+        double bytes = static_cast<double>(count) * sizeof(double);
+        matrix_zeros(a);  // fault the pages in before timing
+        matrix_zeros(b);
+
+        // The generator matrix_randomize used before the counter RNG
+        double rand_ms = time_average_ms(opts.iterations, [&]() {
+            for (size_t i = 0; i < count; ++i) a->data[i] = static_cast<double>(rand()) / RAND_MAX;
+        });
+        double seeded_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_randomize_seeded(a, 1);
+        });
+        double random_parallel_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_randomize_parallel(b, 1, opts.threads);
+        });
+        print_bandwidth_row(n, "rand() loop", rand_ms, bytes, rand_ms);
+        print_bandwidth_row(n, "matrix_randomize_seeded", seeded_ms, bytes, rand_ms);
+        print_bandwidth_row(n, "matrix_randomize_parallel", random_parallel_ms, bytes, rand_ms);
+        if (std::memcmp(a->data, b->data, count * sizeof(double)) != 0) {
+            std::cerr << "Warning: parallel fill differs from serial fill\n";
+        }
+
+        double zeros_ms = time_average_ms(opts.iterations, [&]() { matrix_zeros(a); });
+        double zeros_parallel_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_zeros_parallel(a, opts.threads);
+        });
+        print_bandwidth_row(n, "matrix_zeros", zeros_ms, bytes, zeros_ms);
+        print_bandwidth_row(n, "matrix_zeros_parallel", zeros_parallel_ms, bytes, zeros_ms);
+
+        // Copy moves the bytes twice (read + write)
+        double copy_ms = time_average_ms(opts.iterations, [&]() { matrix_copy(b, a); });
+        double copy_parallel_ms = time_average_ms(opts.iterations, [&]() {
+            matrix_copy_parallel(b, a, opts.threads);
+        });
+        print_bandwidth_row(n, "matrix_copy", copy_ms, 2.0 * bytes, copy_ms);
+        print_bandwidth_row(n, "matrix_copy_parallel", copy_parallel_ms, 2.0 * bytes, copy_ms);
+
+        matrix_free(a);
+        matrix_free(b);
+    }
+}
+
+// ============================================================================
+// Loop orders
+// ============================================================================
+
+struct LoopOrderRow {
+    int size;
+    const char* order;
+    const char* form;
+    double ms;
+    double gflops;
+    uint64_t counters[PERF_COUNTER_COUNT];  // per call
+};
+
+int bench_loops(const BenchOptions& opts) {
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {128, 256, 512};
+    const std::string out_path = opts.out_path.empty() ? "loop_orders.csv" : opts.out_path;
+    const int block = get_optimal_block_size();
+
+    PerfCounters counters;
+    if (perf_counters_open(&counters) == 0) {
+        std::cerr << "Note: no hardware counters available, miss columns show '-'\n";
+    }
+
+    std::cout << "\nGEMM loop orders (block: " << block << ", iterations: " << opts.iterations << ")\n";
+    std::cout << "Misses are per 1000 flops; speedup is relative to unblocked ijk\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(7) << "Order" << std::setw(11) << "Form"
+              << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "GFLOP/s"
+              << std::setw(11) << "Speedup";
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+        std::cout << std::setw(14) << perf_counter_name(static_cast<PerfCounter>(c));
+    }
+    std::cout << "\n" << std::string(59 + 14 * PERF_COUNTER_COUNT, '-') << "\n";
+
+    std::vector<LoopOrderRow> rows;
+    for (int n : sizes) {
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C_ref = matrix_create(n, n);
+        Matrix* C = matrix_create(n, n);
+        if (!A || !B || !C_ref || !C) {
+            std::cerr << "Error: cannot allocate " << n << " x " << n << " matrices\n";
+            matrix_free(A);
+            matrix_free(B);
+            matrix_free(C_ref);
+            matrix_free(C);
+            continue;
+        }
+        matrix_randomize(A);
+        matrix_randomize(B);
+        matrix_multiply_loop_order(A, B, C_ref, LOOP_IJK);
+        double flops = 2.0 * n * n * static_cast<double>(n);
+        double baseline_ms = 0.0;
+
+        for (int blocked = 0; blocked <= 1; ++blocked) {
+            for (int o = 0; o < LOOP_ORDER_COUNT; ++o) {
+                LoopOrder order = static_cast<LoopOrder>(o);
+                uint64_t totals[PERF_COUNTER_COUNT] = {0};
+                double ms = time_average_ms(opts.iterations, [&]() {
+                    uint64_t values[PERF_COUNTER_COUNT];
+                    perf_counters_start(&counters);
+                    if (blocked) {
+                        matrix_multiply_loop_order_blocked(A, B, C, order, block);
+                    } else {
+                        matrix_multiply_loop_order(A, B, C, order);
+                    }
+                    perf_counters_stop(&counters, values);
+                    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) totals[c] += values[c];
+                });
+                if (!blocked && order == LOOP_IJK) baseline_ms = ms;
+
+                LoopOrderRow row = {n, loop_order_name(order), blocked ? "blocked" : "unblocked",
+                                    ms, gflops(flops, ms), {0}};
+                std::cout << std::left << std::setw(6) << n << std::setw(7) << row.order
+                          << std::setw(11) << row.form << std::right << std::fixed
+                          << std::setprecision(3) << std::setw(12) << ms
+                          << std::setw(12) << std::setprecision(2) << row.gflops
+                          << std::setw(10) << baseline_ms / ms << "x";
+                for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+                    row.counters[c] = totals[c] / static_cast<uint64_t>(opts.iterations);
+                    if (perf_counter_available(&counters, static_cast<PerfCounter>(c))) {
+                        std::cout << std::setw(14) << std::setprecision(3)
+                                  << row.counters[c] * 1000.0 / flops;
+                    } else {
+                        std::cout << std::setw(14) << "-";
+                    }
+                }
+                std::cout << "\n";
+                rows.push_back(row);
+
+                double max_diff = max_abs_diff(C_ref->data, C->data, matrix_elements(C));
+                if (max_diff > 1e-9) {
+                    std::cerr << "Warning: " << row.order << " " << row.form
+                              << " result differs (max diff: " << max_diff << ")\n";
+                }
+            }
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C_ref);
+        matrix_free(C);
+    }
+
+    // Locality matrix: one row per (size, order, form); unavailable counters are empty
+    FILE* fp = fopen(out_path.c_str(), "w");
+    if (!fp) {
+        std::cerr << "Error: Cannot open " << out_path << " for writing\n";
+        perf_counters_close(&counters);
+        return 1;
+    }
+    fprintf(fp, "size,order,form,block,time_ms,gflops");
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+        fprintf(fp, ",%s", perf_counter_name(static_cast<PerfCounter>(c)));
+    }
+    fprintf(fp, "\n");
+    for (const LoopOrderRow& row : rows) {
+        fprintf(fp, "%d,%s,%s,%d,%.6f,%.6f", row.size, row.order, row.form,
+                std::strcmp(row.form, "blocked") == 0 ? block : 0, row.ms, row.gflops);
+        for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+            if (perf_counter_available(&counters, static_cast<PerfCounter>(c))) {
+                fprintf(fp, ",%llu", static_cast<unsigned long long>(row.counters[c]));
+            } else {
+                fprintf(fp, ",");
+            }
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    std::cout << "Results saved to " << out_path << "\n";
+
+    perf_counters_close(&counters);
+    return 0;
+}
+
+// ============================================================================
+// Interference (noisy neighbours)
+// ============================================================================
+
+struct InterferenceRow {
+    int size;
+    std::string kernel;
+    int block;          // 0 for the unblocked kernels
+    int antagonists;
+    double ms;
+    double gflops;
+    double slowdown;    // ms / ms without antagonists
+    double antagonist_gbs;
+};
+
+int bench_interference(const BenchOptions& opts) {
+    AntagonistKind kind;
+    if (antagonist_kind_from_name(opts.antagonist_kind.c_str(), &kind) != 0) {
+        std::cerr << "Error: unknown antagonist kind '" << opts.antagonist_kind
+                  << "' (use cache or bandwidth)\n";
+        return 1;
+    }
+    std::vector<int> sizes = opts.sizes;
+    if (sizes.empty()) sizes = {256, 512};
+    const std::string out_path = opts.out_path.empty() ? "interference.csv" : opts.out_path;
+    const size_t working_set = opts.working_set_mb > 0 ? opts.working_set_mb << 20
+                                                       : antagonist_default_working_set(kind);
+
+    // Antagonists need cores of their own; default to counts that leave one for the kernel
+    const int cpus = std::max(1, get_hardware_concurrency());
+    std::vector<int> levels = opts.antagonists;
+    if (levels.empty()) {
+        for (int n = 1; n < cpus; n *= 2) levels.push_back(n);
+        if (cpus > 1 && levels.back() != cpus - 1) levels.push_back(cpus - 1);
+        if (levels.empty()) levels.push_back(1);
+    }
+    levels.push_back(0);
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    if (levels.back() >= cpus) {
+        std::cerr << "Note: " << levels.back() << " antagonists on " << cpus
+                  << " CPUs time-share with the kernel; slowdowns include lost CPU time\n";
+    }
+
+    std::vector<int> blocks = opts.blocks;
+    if (blocks.empty()) blocks = {32, get_optimal_block_size(), 128};
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    if (opts.pin && antagonist_pin_current_thread(0) != 0) {
+        std::cerr << "Note: cannot pin threads on this system, running unpinned\n";
+    }
+
+    std::cout << "\nInterference: " << antagonist_kind_name(kind) << " antagonists, "
+              << (working_set >> 20) << " MB working set each, iterations: " << opts.iterations
+              << (opts.pin ? ", pinned" : "") << "\n";
+    std::cout << "Slowdown is relative to the same kernel without antagonists\n";
+    std::cout << std::left << std::setw(6) << "Size" << std::setw(16) << "Kernel"
+              << std::right << std::setw(12) << "Antagonists" << std::setw(12) << "Time (ms)"
+              << std::setw(12) << "GFLOP/s" << std::setw(11) << "Slowdown"
+              << std::setw(16) << "Antag. GB/s" << "\n";
+    std::cout << std::string(85, '-') << "\n";
+
+    std::vector<InterferenceRow> rows;
+    for (int n : sizes) {
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C = matrix_create(n, n);
+        if (!A || !B || !C) {
+            std::cerr << "Error: cannot allocate " << n << " x " << n << " matrices\n";
+            matrix_free(A);
+            matrix_free(B);
+            matrix_free(C);
+            continue;
+        }
+        matrix_randomize(A);
+        matrix_randomize(B);
+        double flops = 2.0 * n * n * static_cast<double>(n);
+
+        // Kernels under test: naive, transpose and blocked at each block size
+        std::vector<std::pair<std::string, int>> kernels = {{"naive", 0}, {"transpose", 0}};
+        for (int block : blocks) kernels.push_back({"blocked", block});
+        std::vector<double> baseline_ms(kernels.size(), 0.0);
+
+        for (int level : levels) {
+            Antagonists* antagonists = nullptr;
+            if (level > 0) {
+                antagonists = antagonists_start(kind, level, working_set, opts.pin ? 1 : 0);
+                if (!antagonists) {
+                    std::cerr << "Error: cannot start " << level << " antagonists\n";
+                    break;
+                }
+            }
+
+            size_t first_row = rows.size();
+            for (size_t k = 0; k < kernels.size(); ++k) {
+                const std::string& name = kernels[k].first;
+                const int block = kernels[k].second;
+                auto run = [&]() {
+                    if (name == "naive") {
+                        matrix_multiply_naive(A, B, C);
+                    } else if (name == "transpose") {
+                        matrix_multiply_transpose(A, B, C);
+                    } else {
+                        matrix_multiply_blocked(A, B, C, block);
+                    }
+                };
+                run();  // warm-up: the kernel's operands back in cache
+                double ms = time_average_ms(opts.iterations, run);
+                if (level == 0) baseline_ms[k] = ms;
+
+                InterferenceRow row = {n, name, block, level, ms, gflops(flops, ms),
+                                       baseline_ms[k] > 0.0 ? ms / baseline_ms[k] : 0.0, 0.0};
+                rows.push_back(row);
+            }
+
+            double antagonist_gbs = antagonists ? antagonists_stop(antagonists) : 0.0;
+            for (size_t r = first_row; r < rows.size(); ++r) {
+                InterferenceRow& row = rows[r];
+                row.antagonist_gbs = antagonist_gbs;
+                std::string label = row.block > 0 ? row.kernel + " (" + std::to_string(row.block) + ")"
+                                                  : row.kernel;
+                std::cout << std::left << std::setw(6) << n << std::setw(16) << label
+                          << std::right << std::setw(12) << level << std::fixed
+                          << std::setprecision(3) << std::setw(12) << row.ms
+                          << std::setw(12) << std::setprecision(2) << row.gflops
+                          << std::setw(10) << row.slowdown << "x"
+                          << std::setw(16) << antagonist_gbs << "\n";
+            }
+        }
+
+        // Under the heaviest contention: fastest kernel and flattest curve
+        const int worst = levels.back();
+        const InterferenceRow* fastest = nullptr;
+        const InterferenceRow* flattest = nullptr;
+        for (const InterferenceRow& row : rows) {
+            if (row.size != n || row.antagonists != worst) continue;
+            if (!fastest || row.ms < fastest->ms) fastest = &row;
+            if (!flattest || row.slowdown < flattest->slowdown) flattest = &row;
+        }
+        if (fastest && worst > 0) {
+            auto label = [](const InterferenceRow* row) {
+                return row->block > 0 ? row->kernel + " (" + std::to_string(row->block) + ")" : row->kernel;
+            };
+            std::cout << "Size " << n << " with " << worst << " antagonists: fastest " << label(fastest)
+                      << ", least slowdown " << label(flattest) << " (" << std::setprecision(2)
+                      << flattest->slowdown << "x)\n";
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C);
+    }
+
+    FILE* fp = fopen(out_path.c_str(), "w");
+    if (!fp) {
+        std::cerr << "Error: Cannot open " << out_path << " for writing\n";
+        return 1;
+    }
+    fprintf(fp, "size,kernel,block,antagonist,working_set_bytes,antagonists,time_ms,gflops,slowdown,"
+                "antagonist_gbs\n");
+    for (const InterferenceRow& row : rows) {
+        fprintf(fp, "%d,%s,%d,%s,%zu,%d,%.6f,%.6f,%.6f,%.6f\n", row.size, row.kernel.c_str(), row.block,
+                antagonist_kind_name(kind), working_set, row.antagonists, row.ms, row.gflops,
+                row.slowdown, row.antagonist_gbs);
+    }
+    fclose(fp);
+    std::cout << "Results saved to " << out_path << "\n";
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || strcmp(argv[1], "--help") == 0) {
+        print_usage(argv[0]);
+        return argc < 2 ? 1 : 0;
+    }
+
+    std::string benchmark = argv[1];
+    BenchOptions opts;
+
+    // Parse command line arguments
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            opts.sizes = parse_sizes(argv[++i]);
+            if (opts.sizes.empty()) {
+                std::cerr << "Error: --sizes needs a comma separated list of positive sizes\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            opts.threads = std::atoi(argv[++i]);
+            if (opts.threads < 0) {
+                std::cerr << "Error: Threads must be >= 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            opts.iterations = std::atoi(argv[++i]);
+            if (opts.iterations <= 0) {
+                std::cerr << "Error: Iterations must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            opts.batch = std::atoi(argv[++i]);
+            if (opts.batch <= 0) {
+                std::cerr << "Error: Batch must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--a") == 0 && i + 1 < argc) {
+            opts.a_path = argv[++i];
+        } else if (strcmp(argv[i], "--b") == 0 && i + 1 < argc) {
+            opts.b_path = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            opts.out_path = argv[++i];
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            int budget = std::atoi(argv[++i]);
+            if (budget <= 0) {
+                std::cerr << "Error: Budget must be > 0 MB\n";
+                return 1;
+            }
+            opts.budget_mb = static_cast<size_t>(budget);
+        } else if (strcmp(argv[i], "--prefetch") == 0 && i + 1 < argc) {
+            opts.prefetch_distances = parse_sizes(argv[++i]);
+            if (opts.prefetch_distances.empty()) {
+                std::cerr << "Error: --prefetch needs a comma separated list of positive distances\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--antagonists") == 0 && i + 1 < argc) {
+            opts.antagonists = parse_sizes(argv[++i]);
+            if (opts.antagonists.empty()) {
+                std::cerr << "Error: --antagonists needs a comma separated list of positive counts\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--antagonist") == 0 && i + 1 < argc) {
+            opts.antagonist_kind = argv[++i];
+        } else if (strcmp(argv[i], "--ws-mb") == 0 && i + 1 < argc) {
+            int mb = std::atoi(argv[++i]);
+            if (mb <= 0) {
+                std::cerr << "Error: Working set must be > 0 MB\n";
+                return 1;
+            }
+            opts.working_set_mb = static_cast<size_t>(mb);
+        } else if (strcmp(argv[i], "--blocks") == 0 && i + 1 < argc) {
+            opts.blocks = parse_sizes(argv[++i]);
+            if (opts.blocks.empty()) {
+                std::cerr << "Error: --blocks needs a comma separated list of positive block sizes\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            opts.pin = true;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (benchmark == "batched") {
+        bench_batched(opts);
+    } else if (benchmark == "fixed") {
+        bench_fixed(opts);
+    } else if (benchmark == "transpose") {
+        bench_transpose(opts);
+    } else if (benchmark == "transpose-bw") {
+        bench_transpose_bw(opts);
+    } else if (benchmark == "prepared") {
+        bench_prepared(opts);
+    } else if (benchmark == "file") {
+        return bench_file(opts);
+    } else if (benchmark == "ooc") {
+        return bench_ooc(opts);
+    } else if (benchmark == "pipelined") {
+        bench_pipelined(opts);
+    } else if (benchmark == "init") {
+        bench_init(opts);
+    } else if (benchmark == "loops") {
+        return bench_loops(opts);
+    } else if (benchmark == "interference") {
+        return bench_interference(opts);
+    } else {
+        std::cerr << "Unknown benchmark: " << benchmark << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
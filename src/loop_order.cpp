@@ -0,0 +1,125 @@
+#include "loop_order.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Loop indices: each order is a permutation of these
+enum Index { I = 0, J = 1, K = 2 };
+
+// Dense row-major operands: A (M x N), B (N x P), C (M x P)
+struct Operands {
+    const double* __restrict a;
+    const double* __restrict b;
+    double* __restrict c;
+    int n;      // A cols = B rows
+    int p;      // B cols = C cols
+};
+
+// C[i][j] += A[i][k] * B[k][j] over lo[x] <= idx[x] < hi[x], with loop
+// Outer outermost and Inner innermost. idx is a local array indexed by
+// constants, so the compiler keeps it in registers.
+template <int Outer, int Middle, int Inner>
+void loop_nest(const Operands& op, const int lo[3], const int hi[3]) {
+    const double* __restrict a = op.a;
+    const double* __restrict b = op.b;
+    double* __restrict c = op.c;
+    const size_t n = static_cast<size_t>(op.n);
+    const size_t p = static_cast<size_t>(op.p);
+
+    int idx[3];
+    for (idx[Outer] = lo[Outer]; idx[Outer] < hi[Outer]; ++idx[Outer]) {
+        for (idx[Middle] = lo[Middle]; idx[Middle] < hi[Middle]; ++idx[Middle]) {
+            for (idx[Inner] = lo[Inner]; idx[Inner] < hi[Inner]; ++idx[Inner]) {
+                const size_t i = static_cast<size_t>(idx[I]);
+                const size_t j = static_cast<size_t>(idx[J]);
+                const size_t k = static_cast<size_t>(idx[K]);
+                c[i * p + j] += a[i * n + k] * b[k * p + j];
+            }
+        }
+    }
+}
+
+// Tiles visited in the same order as the loops inside a tile
+template <int Outer, int Middle, int Inner>
+void blocked_nest(const Operands& op, const int dims[3], int block) {
+    int lo[3], hi[3];
+    for (lo[Outer] = 0; lo[Outer] < dims[Outer]; lo[Outer] += block) {
+        hi[Outer] = std::min(lo[Outer] + block, dims[Outer]);
+        for (lo[Middle] = 0; lo[Middle] < dims[Middle]; lo[Middle] += block) {
+            hi[Middle] = std::min(lo[Middle] + block, dims[Middle]);
+            for (lo[Inner] = 0; lo[Inner] < dims[Inner]; lo[Inner] += block) {
+                hi[Inner] = std::min(lo[Inner] + block, dims[Inner]);
+                loop_nest<Outer, Middle, Inner>(op, lo, hi);
+            }
+        }
+    }
+}
+
+template <int Outer, int Middle, int Inner>
+void run_order(const Operands& op, const int dims[3], int block) {
+    if (block <= 0) {
+        const int lo[3] = {0, 0, 0};
+        loop_nest<Outer, Middle, Inner>(op, lo, dims);
+    } else {
+        blocked_nest<Outer, Middle, Inner>(op, dims, block);
+    }
+}
+
+typedef void (*OrderKernel)(const Operands&, const int[3], int);
+
+// Indexed by LoopOrder
+const OrderKernel ORDER_KERNELS[LOOP_ORDER_COUNT] = {
+    &run_order<I, J, K>,
+    &run_order<I, K, J>,
+    &run_order<J, I, K>,
+    &run_order<J, K, I>,
+    &run_order<K, I, J>,
+    &run_order<K, J, I>,
+};
+
+const char* const ORDER_NAMES[LOOP_ORDER_COUNT] = {"ijk", "ikj", "jik", "jki", "kij", "kji"};
+
+// block <= 0 runs the unblocked nest
+int multiply(Matrix* A, Matrix* B, Matrix* C, LoopOrder order, int block) {
+    if (!A || !B || !C) return -1;
+    if (A->cols != B->rows) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+    if (order < LOOP_IJK || order > LOOP_KJI) return -1;
+
+    std::memset(C->data, 0, matrix_elements(C) * sizeof(double));
+
+    Operands op = {A->data, B->data, C->data, A->cols, B->cols};
+    const int dims[3] = {A->rows, B->cols, A->cols};
+    ORDER_KERNELS[order](op, dims, block);
+    return 0;
+}
+
+}  // namespace
+
+extern "C" int matrix_multiply_loop_order(Matrix* A, Matrix* B, Matrix* C, LoopOrder order) {
+    return multiply(A, B, C, order, 0);
+}
+
+extern "C" int matrix_multiply_loop_order_blocked(Matrix* A, Matrix* B, Matrix* C, LoopOrder order,
+                                                  int block_size) {
+    if (block_size <= 0) block_size = get_optimal_block_size();
+    return multiply(A, B, C, order, block_size);
+}
+
+extern "C" const char* loop_order_name(LoopOrder order) {
+    if (order < LOOP_IJK || order > LOOP_KJI) return "unknown";
+    return ORDER_NAMES[order];
+}
+
+extern "C" int loop_order_from_name(const char* name, LoopOrder* order) {
+    if (!name || !order) return -1;
+    for (int o = 0; o < LOOP_ORDER_COUNT; ++o) {
+        if (std::strcmp(name, ORDER_NAMES[o]) == 0) {
+            *order = static_cast<LoopOrder>(o);
+            return 0;
+        }
+    }
+    return -1;
+}
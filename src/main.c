@@ -1,41 +1,108 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <math.h>
 #include "profiler.h"
 #include "matrix.h"
 #include "cache_locality.h"
+#include "environment.h"
+#include "results_store.h"
+#include "sampler.h"
 
 int main(int argc, char* argv[]) {
     // Default sizes
     int sizes[] = {64, 128, 256, 512};
     int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
     
-    // Optional size from command line
+    // Optional size and reproducibility controls from command line
     int extra_size = 0;
-    if (argc > 1) {
+    const char* pin_cpus = NULL;
+    double warmup_ms = 0.0;
+    int strict = 0;
+    const char* results_file = "results.jsonl";
+    // Number of iterations (timing samples per kernel)
+    int iterations = 8;
+    // Sampling profiler: rate in Hz (0 = off) and folded-stack output
+    int sample_hz = 0;
+    const char* folded_file = "profile.folded";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            pin_cpus = argv[++i];
+            continue;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup_ms = atof(argv[++i]);
+            continue;
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = 1;
+            continue;
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_file = argv[++i];
+            continue;
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations <= 0 || iterations > MAX_PROFILE_SAMPLES) {
+                fprintf(stderr, "Error: Iterations must be between 1 and %d\n", MAX_PROFILE_SAMPLES);
+                return 1;
+            }
+            continue;
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            sample_hz = atoi(argv[++i]);
+            if (sample_hz <= 0) {
+                fprintf(stderr, "Error: Sampling rate must be positive\n");
+                return 1;
+            }
+            continue;
+        } else if (strcmp(argv[i], "--folded") == 0 && i + 1 < argc) {
+            folded_file = argv[++i];
+            continue;
+        }
         char* endptr = NULL;
-        long value = strtol(argv[1], &endptr, 10);
-        if (endptr == argv[1] || *endptr != '\0' || value <= 0) {
-            fprintf(stderr, "Invalid size '%s'. Using default sizes only.\n", argv[1]);
-        } else if (value > 4096) {
-            fprintf(stderr, "Requested size %ld too large (max 4096). Using default sizes only.\n", value);
+        long value = strtol(argv[i], &endptr, 10);
+        if (endptr == argv[i] || *endptr != '\0' || value <= 0) {
+            fprintf(stderr, "Invalid size '%s'. Using default sizes only.\n", argv[i]);
+        } else if (value > INT_MAX) {
+            fprintf(stderr, "Requested size %ld too large (max %d). Using default sizes only.\n", value, INT_MAX);
         } else {
             extra_size = (int)value;
             printf("Adding user-specified size: %dx%d\n", extra_size, extra_size);
         }
     }
     
-    // Number of iterations for averaging
-    int iterations = 3;
+    BenchEnvironment env;
+    if (environment_prepare(pin_cpus, warmup_ms, strict, &env) != 0) {
+        return 2;
+    }
+    
+    ResultsStore store;
+    if (results_store_open(&store, results_file, "matrix_profile", &env) != 0) {
+        return 1;
+    }
+    
+    if (sample_hz > 0 && sampler_start(sample_hz, 0) != 0) {
+        fprintf(stderr, "Warning: Sampling profiler unavailable, running without it\n");
+        sample_hz = 0;
+    }
     
     for (int s = 0; s < num_sizes; s++) {
-        test_cache_locality_speedup(sizes[s], iterations, "profile_results.csv");
+        test_cache_locality_speedup_store(sizes[s], iterations, "profile_results.csv", &store);
     }
     
     if (extra_size > 0) {
-        test_cache_locality_speedup(extra_size, iterations, "profile_results.csv");
+        test_cache_locality_speedup_store(extra_size, iterations, "profile_results.csv", &store);
+    }
+    
+    if (sample_hz > 0) {
+        sampler_stop();
+        sampler_print_hotspots(stdout, 5);
+        if (sampler_write_folded(folded_file) >= 0) {
+            printf("Folded stacks saved to %s\n", folded_file);
+        }
+        sampler_clear();
     }
     
+    results_store_close(&store);
+    printf("Samples appended to %s (run %s)\n", results_file, store.run_id);
+    environment_save_sidecar(&env, "profile_results.csv");
     return 0;
 }
@@ -2,7 +2,12 @@
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include "cache_locality.h"
+#include "environment.h"
+#include "results_store.h"
+#include "sampler.h"
 
 int main(int argc, char* argv[]) {
     std::cout << "Matrix Multiplication Profiling (C++ Interface)" << std::endl;
@@ -11,37 +16,101 @@ int main(int argc, char* argv[]) {
     // Default sizes
     std::vector<int> sizes = {64, 128, 256, 512};
     
-    // Optional size from command line
+    // Optional size and reproducibility controls from command line
     int extra_size = 0;
-    if (argc > 1) {
+    const char* pin_cpus = nullptr;
+    double warmup_ms = 0.0;
+    bool strict = false;
+    const char* results_file = "results_cpp.jsonl";
+    // Number of iterations (timing samples per kernel)
+    int iterations = 8;
+    // Sampling profiler: rate in Hz (0 = off) and folded-stack output
+    int sample_hz = 0;
+    const char* folded_file = "profile_cpp.folded";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            pin_cpus = argv[++i];
+            continue;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup_ms = std::atof(argv[++i]);
+            continue;
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
+            continue;
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_file = argv[++i];
+            continue;
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+            if (iterations <= 0 || iterations > MAX_PROFILE_SAMPLES) {
+                std::cerr << "Error: Iterations must be between 1 and " << MAX_PROFILE_SAMPLES << std::endl;
+                return 1;
+            }
+            continue;
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            sample_hz = std::atoi(argv[++i]);
+            if (sample_hz <= 0) {
+                std::cerr << "Error: Sampling rate must be positive" << std::endl;
+                return 1;
+            }
+            continue;
+        } else if (strcmp(argv[i], "--folded") == 0 && i + 1 < argc) {
+            folded_file = argv[++i];
+            continue;
+        }
         try {
-            std::string arg = argv[1];
+            std::string arg = argv[i];
             size_t pos;
             long value = std::stol(arg, &pos);
             
             if (pos != arg.length() || value <= 0) {
-                std::cerr << "Invalid size '" << argv[1] << "'. Using default sizes only." << std::endl;
-            } else if (value > 4096) {
-                std::cerr << "Requested size " << value << " too large (max 4096). Using default sizes only." << std::endl;
+                std::cerr << "Invalid size '" << argv[i] << "'. Using default sizes only." << std::endl;
+            } else if (value > std::numeric_limits<int>::max()) {
+                std::cerr << "Requested size " << value << " too large (max "
+                          << std::numeric_limits<int>::max() << "). Using default sizes only." << std::endl;
             } else {
                 extra_size = static_cast<int>(value);
                 std::cout << "Adding user-specified size: " << extra_size << "x" << extra_size << std::endl;
             }
         } catch (...) {
-            std::cerr << "Invalid size '" << argv[1] << "'. Using default sizes only." << std::endl;
+            std::cerr << "Invalid size '" << argv[i] << "'. Using default sizes only." << std::endl;
         }
     }
     
-    // Number of iterations for averaging
-    int iterations = 3;
+    BenchEnvironment env;
+    if (environment_prepare(pin_cpus, warmup_ms, strict ? 1 : 0, &env) != 0) {
+        return 2;
+    }
+    
+    ResultsStore store;
+    if (results_store_open(&store, results_file, "matrix_profile_cpp", &env) != 0) {
+        return 1;
+    }
+    
+    if (sample_hz > 0 && sampler_start(sample_hz, 0) != 0) {
+        std::cerr << "Warning: Sampling profiler unavailable, running without it" << std::endl;
+        sample_hz = 0;
+    }
     
     for (int size : sizes) {
-        test_cache_locality_speedup(size, iterations, "profile_results_cpp.csv");
+        test_cache_locality_speedup_store(size, iterations, "profile_results_cpp.csv", &store);
     }
     
     if (extra_size > 0) {
-        test_cache_locality_speedup(extra_size, iterations, "profile_results_cpp.csv");
+        test_cache_locality_speedup_store(extra_size, iterations, "profile_results_cpp.csv", &store);
+    }
+    
+    if (sample_hz > 0) {
+        sampler_stop();
+        sampler_print_hotspots(stdout, 5);
+        if (sampler_write_folded(folded_file) >= 0) {
+            std::cout << "Folded stacks saved to " << folded_file << std::endl;
+        }
+        sampler_clear();
     }
     
+    results_store_close(&store);
+    std::cout << "Samples appended to " << results_file << " (run " << store.run_id << ")" << std::endl;
+    environment_save_sidecar(&env, "profile_results_cpp.csv");
     return 0;
 }
@@ -1,65 +1,104 @@
 #include "matrix.h"
+#include "prepared.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
+#include <math.h>
 #include <unistd.h>
 
+// Extra bytes allocated by matrix_create: alignment slack plus the
+// original calloc pointer stored just before the data
+#define ALIGN_PADDING (MATRIX_ALIGNMENT + sizeof(void*))
+
+// Running total for matrix_allocated_bytes
+static size_t allocated_bytes = 0;
+
+size_t matrix_allocated_bytes(void) {
+#if defined(__GNUC__)
+    return __atomic_load_n(&allocated_bytes, __ATOMIC_RELAXED);
+#else
+    return allocated_bytes;
+#endif
+}
+
+void matrix_count_allocation(size_t bytes) {
+#if defined(__GNUC__)
+    __atomic_fetch_add(&allocated_bytes, bytes, __ATOMIC_RELAXED);
+#else
+    allocated_bytes += bytes;
+#endif
+}
+
 Matrix* matrix_create(int rows, int cols) {
+    if (rows < 0 || cols < 0) return NULL;
+    
+    // rows * cols is computed in size_t; refuse sizes whose byte count overflows
+    size_t count = (size_t)rows * (size_t)cols;
+    if (cols > 0 && count / (size_t)cols != (size_t)rows) return NULL;
+    if (count > (SIZE_MAX - ALIGN_PADDING) / sizeof(double)) return NULL;
+    
     Matrix* m = (Matrix*)malloc(sizeof(Matrix));
     if (!m) return NULL;
     
     m->rows = rows;
     m->cols = cols;
-    m->data = (double*)calloc(rows * cols, sizeof(double));
     
-    if (!m->data) {
+    // calloc keeps large allocations lazily zeroed (untouched pages); the
+    // data starts at the first MATRIX_ALIGNMENT boundary after room for the
+    // pointer matrix_free needs
+    size_t bytes = (count > 0 ? count : 1) * sizeof(double) + ALIGN_PADDING;
+    char* raw = (char*)calloc(bytes, 1);
+    if (!raw) {
         free(m);
         return NULL;
     }
+    uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + MATRIX_ALIGNMENT - 1) &
+                        ~(uintptr_t)(MATRIX_ALIGNMENT - 1);
+    m->data = (double*)aligned;
+    ((void**)m->data)[-1] = raw;
+    matrix_count_allocation(count * sizeof(double));
     
     return m;
 }
 
 void matrix_free(Matrix* m) {
     if (m) {
-        free(m->data);
+        if (m->data) free(((void**)m->data)[-1]);
         free(m);
     }
 }
 
+size_t matrix_elements(const Matrix* m) {
+    return m ? (size_t)m->rows * (size_t)m->cols : 0;
+}
+
 void matrix_set(Matrix* m, int row, int col, double value) {
     if (m && row >= 0 && row < m->rows && col >= 0 && col < m->cols) {
-        m->data[row * m->cols + col] = value;
+        m->data[(size_t)row * (size_t)m->cols + (size_t)col] = value;
     }
 }
 
 double matrix_get(Matrix* m, int row, int col) {
     if (m && row >= 0 && row < m->rows && col >= 0 && col < m->cols) {
-        return m->data[row * m->cols + col];
+        return m->data[(size_t)row * (size_t)m->cols + (size_t)col];
     }
     return 0.0;
 }
 
-void matrix_randomize(Matrix* m) {
+void matrix_zeros(Matrix* m) {
     if (!m) return;
     
-    static int seeded = 0;
-    if (!seeded) {
-        srand((unsigned int)time(NULL));
-        seeded = 1;
-    }
-    
-    for (int i = 0; i < m->rows * m->cols; i++) {
-        m->data[i] = (double)rand() / RAND_MAX;
-    }
+    // All-zero bytes are +0.0 in IEEE 754
+    memset(m->data, 0, matrix_elements(m) * sizeof(double));
 }
 
-void matrix_zeros(Matrix* m) {
-    if (!m) return;
+int matrix_copy(Matrix* src, Matrix* dst) {
+    if (!src || !dst) return -1;
+    if (src->rows != dst->rows || src->cols != dst->cols) return -1;
     
-    for (int i = 0; i < m->rows * m->cols; i++) {
-        m->data[i] = 0.0;
-    }
+    if (src != dst) memcpy(dst->data, src->data, matrix_elements(src) * sizeof(double));
+    return 0;
 }
 
 void matrix_print(Matrix* m) {
@@ -74,6 +113,26 @@ void matrix_print(Matrix* m) {
     }
 }
 
+int matrix_compare(Matrix* ref, Matrix* m, double* max_abs_err, double* rel_err) {
+    if (!ref || !m) return -1;
+    if (ref->rows != m->rows || ref->cols != m->cols) return -1;
+    
+    double max_diff = 0.0;
+    double diff_sq = 0.0;
+    double ref_sq = 0.0;
+    size_t count = matrix_elements(ref);
+    for (size_t i = 0; i < count; i++) {
+        double diff = fabs(m->data[i] - ref->data[i]);
+        if (diff > max_diff) max_diff = diff;
+        diff_sq += diff * diff;
+        ref_sq += ref->data[i] * ref->data[i];
+    }
+    
+    if (max_abs_err) *max_abs_err = max_diff;
+    if (rel_err) *rel_err = (ref_sq > 0.0) ? sqrt(diff_sq / ref_sq) : sqrt(diff_sq);
+    return 0;
+}
+
 // Naive matrix multiplication: C = A * B
 // Triple nested loop - most straightforward implementation
 int matrix_multiply_naive(Matrix* A, Matrix* B, Matrix* C) {
@@ -108,36 +167,68 @@ int matrix_multiply_transpose(Matrix* A, Matrix* B, Matrix* C) {
     if (A->cols != B->rows) return -1;
     if (C->rows != A->rows || C->cols != B->cols) return -1;
     
-    int M = A->rows;
-    int N = A->cols;
-    int P = B->cols;
-    
-    // Create transposed matrix of B (B_T is P x N)
-    Matrix* B_T = matrix_create(P, N);
+    // Transposed copy of B (tiled re-layout, see prepared.h)
+    PreparedB* B_T = matrix_prepare_b(B);
     if (!B_T) return -1;
     
-    // Transpose B into B_T
-    for (int i = 0; i < B->rows; i++) {
-        for (int j = 0; j < B->cols; j++) {
-            matrix_set(B_T, j, i, matrix_get(B, i, j));
+    // Multiply A * B using transposed B
+    // A rows and B_T rows are both contiguous; the register-blocked kernel
+    // computes small blocks of C so each loaded line is reused across the block
+    matrix_multiply_prepared(A, B_T, C);
+    
+    prepared_b_free(B_T);
+    return 0;
+}
+
+// Split rows into parts contiguous ranges with cache-line-aligned boundaries
+int matrix_partition_rows(const double* data, size_t row_stride, int rows, int parts, int* bounds) {
+    if (!data || !bounds || parts <= 0) return -1;
+    if (rows < 0) rows = 0;
+
+    // Rows whose start is line aligned: first, then every `step` rows
+    const size_t line = (size_t)get_cache_line_size();
+    const size_t row_bytes = row_stride * sizeof(double);
+    int first = -1;
+    for (size_t r = 0; r < line && r < (size_t)rows; r++) {
+        if (((uintptr_t)(data + r * row_stride)) % line == 0) {
+            first = (int)r;
+            break;
         }
     }
-    
-    // Multiply A * B using transposed B
-    // This makes inner loop access contiguous memory in both matrices
-    for (int i = 0; i < M; i++) {
-        for (int j = 0; j < P; j++) {
-            double sum = 0.0;
-            for (int k = 0; k < N; k++) {
-                // A row access is contiguous, B_T row access is contiguous
-                sum += matrix_get(A, i, k) * matrix_get(B_T, j, k);
-            }
-            matrix_set(C, i, j, sum);
+    int step = 1;
+    if (row_bytes % line != 0) {
+        size_t a = row_bytes % line, b = line;
+        while (b != 0) {
+            size_t t = a % b;
+            a = b;
+            b = t;
         }
+        step = (int)(line / a);
     }
-    
-    matrix_free(B_T);
-    return 0;
+
+    // Even split, each inner boundary moved to the nearest aligned row
+    int aligned = 1;
+    bounds[0] = 0;
+    for (int t = 1; t < parts; t++) {
+        int target = (int)(((long long)rows * t + parts / 2) / parts);
+        int boundary = target;
+        if (first >= 0 && target > first) {
+            int below = first + (target - first) / step * step;
+            int above = below + step;
+            boundary = (target - below <= above - target || above > rows) ? below : above;
+        } else if (first >= 0) {
+            boundary = first;
+        }
+        if (boundary < bounds[t - 1]) boundary = bounds[t - 1];
+        if (boundary > rows) boundary = rows;
+        if (boundary > 0 && boundary < rows &&
+            ((uintptr_t)(data + (size_t)boundary * row_stride)) % line != 0) {
+            aligned = 0;
+        }
+        bounds[t] = boundary;
+    }
+    bounds[parts] = rows;
+    return aligned;
 }
 
 // Get cache line size from system
@@ -162,6 +253,38 @@ int get_l1_cache_size(void) {
     return (int)cache_size;
 }
 
+// Get L2 cache size from system
+// Returns 262144 (256KB) as default if detection fails
+int get_l2_cache_size(void) {
+    long cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (cache_size <= 0) {
+        cache_size = 262144;
+    }
+    return (int)cache_size;
+}
+
+// Get L3 cache size from system
+// Returns 8388608 (8MB) as default if detection fails
+int get_l3_cache_size(void) {
+    long cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (cache_size <= 0) {
+        cache_size = 8388608;
+    }
+    return (int)cache_size;
+}
+
+int get_optimal_block_size(void) {
+    int l1_size = get_l1_cache_size();
+    int max_elements = l1_size / (4 * sizeof(double));
+    int block = 1;
+    while (block * block <= max_elements && block < 128) {
+        block *= 2;
+    }
+    block /= 2;
+    if (block < 16) block = 16;
+    return block;
+}
+
 // Cache-blocked matrix multiplication using tiling
 // Optimizes for cache size to maximize data reuse
 // block_size: size of sub-blocks (0 = auto-calculate optimal)
@@ -176,19 +299,7 @@ int matrix_multiply_blocked(Matrix* A, Matrix* B, Matrix* C, int block_size) {
     int P = B->cols;
     
     // Calculate optimal block size if not provided
-    int BLOCK;
-    if (block_size <= 0) {
-        int l1_size = get_l1_cache_size();
-        int max_elements = l1_size / (4 * sizeof(double));
-        BLOCK = 1;
-        while (BLOCK * BLOCK <= max_elements && BLOCK < 128) {
-            BLOCK *= 2;
-        }
-        BLOCK /= 2;
-        if (BLOCK < 16) BLOCK = 16;
-    } else {
-        BLOCK = block_size;
-    }
+    int BLOCK = block_size > 0 ? block_size : get_optimal_block_size();
     
     // Initialize C to zeros first
     matrix_zeros(C);
@@ -197,9 +308,10 @@ int matrix_multiply_blocked(Matrix* A, Matrix* B, Matrix* C, int block_size) {
     double* a_data = A->data;
     double* b_data = B->data;
     double* c_data = C->data;
-    int a_stride = A->cols;
-    int b_stride = B->cols;
-    int c_stride = C->cols;
+    // size_t strides keep i * stride + k exact beyond 2^31 elements
+    size_t a_stride = (size_t)A->cols;
+    size_t b_stride = (size_t)B->cols;
+    size_t c_stride = (size_t)C->cols;
     
     // Blocked/tiled matrix multiplication with i-k-j ordering
     // This gives contiguous access to both A and B within blocks
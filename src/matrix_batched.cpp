@@ -0,0 +1,186 @@
+#include "batched.h"
+#include "gemm_fixed.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+int normalize_thread_count(int num_threads, int max_items) {
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (num_threads <= 0) {
+        num_threads = 1;
+    }
+    return std::min(num_threads, std::max(1, max_items));
+}
+
+// Split [0, count) into contiguous chunks, one per thread; the calling
+// thread runs the last chunk so a single-threaded batch spawns nothing.
+template <typename Work>
+void run_over_batch(int count, int num_threads, Work work) {
+    int threads = normalize_thread_count(num_threads, count);
+    int per_thread = (count + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+
+    int start = 0;
+    for (int t = 0; t < threads - 1 && start < count; ++t) {
+        int end = std::min(count, start + per_thread);
+        workers.emplace_back(work, start, end);
+        start = end;
+    }
+    if (start < count) {
+        work(start, count);
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+}
+
+// Dense row-major C = A * B for a matrix small enough to stay in L1/L2.
+// The first k step stores instead of accumulating, so C needs no zeroing.
+inline void small_multiply(const double* a, const double* b, double* c, int M, int N, int P) {
+    for (int i = 0; i < M; ++i) {
+        const double* a_row = a + static_cast<size_t>(i) * N;
+        double* c_row = c + static_cast<size_t>(i) * P;
+        if (N == 0) {
+            std::fill(c_row, c_row + P, 0.0);
+            continue;
+        }
+        double a0 = a_row[0];
+        for (int j = 0; j < P; ++j) {
+            c_row[j] = a0 * b[j];
+        }
+        for (int k = 1; k < N; ++k) {
+            double a_val = a_row[k];
+            const double* b_row = b + static_cast<size_t>(k) * P;
+            for (int j = 0; j < P; ++j) {
+                c_row[j] += a_val * b_row[j];
+            }
+        }
+    }
+}
+
+// Batch entries processed together by the interleaved kernel; one chunk of
+// accumulators (64 doubles) plus the matching A and B lanes fit in L1.
+const int INTERLEAVE_CHUNK = 64;
+}
+
+extern "C" int matrix_multiply_batched(Matrix** A, Matrix** B, Matrix** C,
+                                       int batch_count, int num_threads) {
+    if (!A || !B || !C || batch_count < 0) return -1;
+
+    // Validate the whole batch once before any work is scheduled
+    for (int b = 0; b < batch_count; ++b) {
+        if (!A[b] || !B[b] || !C[b]) return -1;
+        if (A[b]->cols != B[b]->rows) return -1;
+        if (C[b]->rows != A[b]->rows || C[b]->cols != B[b]->cols) return -1;
+    }
+
+    run_over_batch(batch_count, num_threads, [A, B, C](int begin, int end) {
+        for (int b = begin; b < end; ++b) {
+            int M = A[b]->rows;
+            int N = A[b]->cols;
+            int P = B[b]->cols;
+            GemmFixedKernel fixed = gemm_fixed_lookup(M, P, N);
+            if (fixed) {
+                fixed(A[b]->data, B[b]->data, C[b]->data);
+            } else {
+                small_multiply(A[b]->data, B[b]->data, C[b]->data, M, N, P);
+            }
+        }
+    });
+
+    return 0;
+}
+
+extern "C" int matrix_multiply_batched_strided(int M, int N, int P,
+                                               const double* A, size_t stride_a,
+                                               const double* B, size_t stride_b,
+                                               double* C, size_t stride_c,
+                                               int batch_count, int num_threads) {
+    if (!A || !B || !C || M < 0 || N < 0 || P < 0 || batch_count < 0) return -1;
+    if (stride_a < static_cast<size_t>(M) * N) return -1;
+    if (stride_b < static_cast<size_t>(N) * P) return -1;
+    if (stride_c < static_cast<size_t>(M) * P) return -1;
+
+    // Shape is shared, so the specialised kernel is looked up once
+    GemmFixedKernel fixed = gemm_fixed_lookup(M, P, N);
+    run_over_batch(batch_count, num_threads, [=](int begin, int end) {
+        for (int b = begin; b < end; ++b) {
+            if (fixed) {
+                fixed(A + b * stride_a, B + b * stride_b, C + b * stride_c);
+            } else {
+                small_multiply(A + b * stride_a, B + b * stride_b, C + b * stride_c, M, N, P);
+            }
+        }
+    });
+
+    return 0;
+}
+
+extern "C" int matrix_multiply_batched_interleaved(int M, int N, int P,
+                                                   const double* A, const double* B, double* C,
+                                                   int batch_count, int num_threads) {
+    if (!A || !B || !C || M < 0 || N < 0 || P < 0 || batch_count < 0) return -1;
+
+    const size_t batch = static_cast<size_t>(batch_count);
+
+    // Threads take whole chunks of INTERLEAVE_CHUNK batch entries. A chunk
+    // of element (i, j) starts at (i * P + j) * batch_count + 64 * chunk, so
+    // chunk edges only fall on cache line boundaries when C is line aligned
+    // and batch_count is a multiple of 8; otherwise neighbouring threads
+    // share one line of C at each edge (at most one line per element, so
+    // the false sharing is limited to the chunk ends).
+    int chunks = (batch_count + INTERLEAVE_CHUNK - 1) / INTERLEAVE_CHUNK;
+    run_over_batch(chunks, num_threads, [=](int chunk_begin, int chunk_end) {
+        double acc[INTERLEAVE_CHUNK];
+        for (int chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            size_t b0 = static_cast<size_t>(chunk) * INTERLEAVE_CHUNK;
+            int lanes = static_cast<int>(std::min<size_t>(INTERLEAVE_CHUNK, batch - b0));
+
+            for (int i = 0; i < M; ++i) {
+                for (int j = 0; j < P; ++j) {
+                    std::fill(acc, acc + lanes, 0.0);
+                    for (int k = 0; k < N; ++k) {
+                        const double* a = A + (static_cast<size_t>(i) * N + k) * batch + b0;
+                        const double* b = B + (static_cast<size_t>(k) * P + j) * batch + b0;
+                        for (int t = 0; t < lanes; ++t) {
+                            acc[t] += a[t] * b[t];
+                        }
+                    }
+                    double* c = C + (static_cast<size_t>(i) * P + j) * batch + b0;
+                    std::copy(acc, acc + lanes, c);
+                }
+            }
+        }
+    });
+
+    return 0;
+}
+
+extern "C" void matrix_batch_interleave(const double* src, size_t stride, int rows, int cols,
+                                        int batch_count, double* dst) {
+    size_t elems = static_cast<size_t>(rows) * cols;
+    for (int b = 0; b < batch_count; ++b) {
+        const double* m = src + b * stride;
+        for (size_t e = 0; e < elems; ++e) {
+            dst[e * batch_count + b] = m[e];
+        }
+    }
+}
+
+extern "C" void matrix_batch_deinterleave(const double* src, int rows, int cols, int batch_count,
+                                          double* dst, size_t stride) {
+    size_t elems = static_cast<size_t>(rows) * cols;
+    for (int b = 0; b < batch_count; ++b) {
+        double* m = dst + b * stride;
+        for (size_t e = 0; e < elems; ++e) {
+            m[e] = src[e * batch_count + b];
+        }
+    }
+}
@@ -0,0 +1,526 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "matrix.h"
+#include "batched.h"
+#include "concurrent_matrix.h"
+#include "environment.h"
+#include "gemm.h"
+#include "gemm_fixed.h"
+#include "half_precision.h"
+#include "loop_order.h"
+#include "matrix_io.h"
+#include "matrix_random.h"
+#include "out_of_core.h"
+#include "pipelined.h"
+#include "prepared.h"
+#include "quantized.h"
+#include "transpose.h"
+
+// Google Benchmark cases for the kernels. Every case is named
+// BM_<Kernel>/size:<n>[/threads:<t>][/block:<b>], so --benchmark_filter
+// selects exactly one kernel, size, thread count and block size, e.g.
+//   matrix_bench --benchmark_filter='BM_Blocked/size:512/block:64$'
+//
+// Counters: FLOP/s (2 n^3 per product) and bytes_per_second for the
+// compulsory traffic (A and B read once, C written once), plus "bytes",
+// the compulsory traffic of one call.
+
+namespace {
+
+const std::vector<int64_t> SIZES = {128, 256, 512, 1024};
+const std::vector<int64_t> BLOCKS = {16, 32, 64, 128};
+// Batched and fixed-shape kernels target small matrices
+const std::vector<int64_t> SMALL_SIZES = {4, 8, 16, 32};
+const int BATCH_COUNT = 1024;
+
+// Powers of two up to the hardware threads, plus the hardware threads
+std::vector<int64_t> thread_counts() {
+    const int hardware = std::max(1, get_hardware_concurrency());
+    std::vector<int64_t> counts;
+    for (int t = 1; t < hardware; t *= 2) counts.push_back(t);
+    counts.push_back(hardware);
+    return counts;
+}
+
+// Square operands of one case, filled with fixed seeds
+struct Operands {
+    Matrix* A;
+    Matrix* B;
+    Matrix* C;
+
+    explicit Operands(int n)
+        : A(matrix_create(n, n)), B(matrix_create(n, n)), C(matrix_create(n, n)) {
+        if (A && B && C) {
+            matrix_randomize_parallel(A, 1, 0);
+            matrix_randomize_parallel(B, 2, 0);
+        }
+    }
+    ~Operands() {
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C);
+    }
+    bool ok() const { return A && B && C; }
+};
+
+// element_bytes: size of one stored operand element (8 for double);
+// products: n x n products per iteration (the batch count for batched cases)
+void set_gemm_counters(benchmark::State& state, int n, double element_bytes, double products = 1.0) {
+    const double flops = 2.0 * n * n * static_cast<double>(n) * products;
+    const double bytes = (2.0 * n * n * element_bytes + static_cast<double>(n) * n * sizeof(double)) * products;
+    state.counters["FLOP/s"] = benchmark::Counter(flops * state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["bytes"] = bytes;
+    state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+}
+
+// Run a C = A * B kernel on n x n operands
+template <typename Kernel>
+void run_gemm(benchmark::State& state, int n, Kernel kernel) {
+    Operands op(n);
+    if (!op.ok()) {
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    for (auto _ : state) {
+        if (kernel(op.A, op.B, op.C) != 0) {
+            state.SkipWithError("kernel failed");
+            break;
+        }
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    set_gemm_counters(state, n, sizeof(double));
+}
+
+// ============================================================================
+// Serial kernels
+// ============================================================================
+
+void BM_Naive(benchmark::State& state) {
+    run_gemm(state, static_cast<int>(state.range(0)), matrix_multiply_naive);
+}
+BENCHMARK(BM_Naive)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+void BM_Transpose(benchmark::State& state) {
+    run_gemm(state, static_cast<int>(state.range(0)), matrix_multiply_transpose);
+}
+BENCHMARK(BM_Transpose)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+void BM_Blocked(benchmark::State& state) {
+    const int block = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)),
+             [block](Matrix* A, Matrix* B, Matrix* C) { return matrix_multiply_blocked(A, B, C, block); });
+}
+BENCHMARK(BM_Blocked)->ArgNames({"size", "block"})->ArgsProduct({SIZES, BLOCKS})->Unit(benchmark::kMillisecond);
+
+void BM_Gemm(benchmark::State& state) {
+    const int block = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [block](Matrix* A, Matrix* B, Matrix* C) {
+        MatrixView a = matrix_view(A), b = matrix_view(B), c = matrix_view(C);
+        return matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &a, &b, 0.0, &c, block);
+    });
+}
+BENCHMARK(BM_Gemm)->ArgNames({"size", "block"})->ArgsProduct({SIZES, BLOCKS})->Unit(benchmark::kMillisecond);
+
+// B packed once outside the timed loop, as a caller reusing B would
+void BM_Prepared(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    Operands op(n);
+    PreparedB* prepared = op.ok() ? matrix_prepare_b(op.B) : nullptr;
+    if (!prepared) {
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    for (auto _ : state) {
+        matrix_multiply_prepared(op.A, prepared, op.C);
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    prepared_b_free(prepared);
+    set_gemm_counters(state, n, sizeof(double));
+}
+BENCHMARK(BM_Prepared)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+void BM_Pipelined(benchmark::State& state) {
+    PipelineOptions options = pipeline_default_options();
+    options.block_size = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [&options](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_pipelined(A, B, C, &options, nullptr, nullptr);
+    });
+}
+BENCHMARK(BM_Pipelined)
+    ->ArgNames({"size", "block"})
+    ->ArgsProduct({SIZES, BLOCKS})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+template <LoopOrder Order>
+void BM_LoopOrder(benchmark::State& state) {
+    run_gemm(state, static_cast<int>(state.range(0)),
+             [](Matrix* A, Matrix* B, Matrix* C) { return matrix_multiply_loop_order(A, B, C, Order); });
+}
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_IJK)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_IKJ)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_JIK)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_JKI)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_KIJ)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoopOrder, LOOP_KJI)->ArgName("size")->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Small-matrix kernels (sizes 4 to 32)
+// ============================================================================
+
+void BM_Fixed(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    GemmFixedKernel kernel = gemm_fixed_lookup(n, n, n);
+    if (!kernel) {
+        state.SkipWithError("no gemm_fixed specialisation for this size");
+        return;
+    }
+    run_gemm(state, n, [kernel](Matrix* A, Matrix* B, Matrix* C) {
+        kernel(A->data, B->data, C->data);
+        return 0;
+    });
+}
+BENCHMARK(BM_Fixed)->ArgName("size")->ArgsProduct({SMALL_SIZES})->Unit(benchmark::kNanosecond);
+
+// BATCH_COUNT products per iteration, each in its own Matrix
+void BM_Batched(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    std::vector<Matrix*> A(BATCH_COUNT), B(BATCH_COUNT), C(BATCH_COUNT);
+    bool ok = true;
+    for (int b = 0; b < BATCH_COUNT; ++b) {
+        A[b] = matrix_create(n, n);
+        B[b] = matrix_create(n, n);
+        C[b] = matrix_create(n, n);
+        if (!A[b] || !B[b] || !C[b]) {
+            ok = false;
+            continue;
+        }
+        matrix_randomize_seeded(A[b], 2 * static_cast<uint64_t>(b) + 1);
+        matrix_randomize_seeded(B[b], 2 * static_cast<uint64_t>(b) + 2);
+    }
+    if (!ok) state.SkipWithError("cannot allocate operands");
+    for (auto _ : state) {
+        if (!ok) break;
+        matrix_multiply_batched(A.data(), B.data(), C.data(), BATCH_COUNT, threads);
+        benchmark::ClobberMemory();
+    }
+    for (int b = 0; b < BATCH_COUNT; ++b) {
+        matrix_free(A[b]);
+        matrix_free(B[b]);
+        matrix_free(C[b]);
+    }
+    set_gemm_counters(state, n, sizeof(double), BATCH_COUNT);
+}
+BENCHMARK(BM_Batched)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SMALL_SIZES, thread_counts()})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// Dense strided batch; interleaved = batch-innermost layout
+template <bool Interleaved>
+void BM_BatchedStrided(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    const size_t elems = static_cast<size_t>(n) * n;
+    std::vector<double> A(elems * BATCH_COUNT), B(elems * BATCH_COUNT), C(elems * BATCH_COUNT);
+    random_fill_uniform(A.data(), A.size(), 1, 0);
+    random_fill_uniform(B.data(), B.size(), 2, 0);
+    for (auto _ : state) {
+        if (Interleaved) {
+            matrix_multiply_batched_interleaved(n, n, n, A.data(), B.data(), C.data(), BATCH_COUNT, threads);
+        } else {
+            matrix_multiply_batched_strided(n, n, n, A.data(), elems, B.data(), elems, C.data(), elems,
+                                            BATCH_COUNT, threads);
+        }
+        benchmark::DoNotOptimize(C.data());
+        benchmark::ClobberMemory();
+    }
+    set_gemm_counters(state, n, sizeof(double), BATCH_COUNT);
+}
+BENCHMARK_TEMPLATE(BM_BatchedStrided, false)
+    ->Name("BM_BatchedStrided")
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SMALL_SIZES, thread_counts()})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BatchedStrided, true)
+    ->Name("BM_BatchedInterleaved")
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SMALL_SIZES, thread_counts()})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// ============================================================================
+// Reduced-precision kernels (operands converted outside the timed loop)
+// ============================================================================
+
+template <QuantType Type>
+void BM_Quantized(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int block = static_cast<int>(state.range(1));
+    Operands op(n);
+    QMatrix* qa = qmatrix_create(n, n, Type);
+    QMatrix* qb = qmatrix_create(n, n, Type);
+    if (!op.ok() || !qa || !qb) {
+        qmatrix_free(qa);
+        qmatrix_free(qb);
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    matrix_quantize(op.A, qa);
+    matrix_quantize(op.B, qb);
+    for (auto _ : state) {
+        qmatrix_multiply(qa, qb, op.C, block);
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    qmatrix_free(qa);
+    qmatrix_free(qb);
+    set_gemm_counters(state, n, Type == QUANT_INT8 ? 1.0 : 2.0);
+}
+BENCHMARK_TEMPLATE(BM_Quantized, QUANT_INT8)
+    ->ArgNames({"size", "block"})
+    ->ArgsProduct({SIZES, BLOCKS})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Quantized, QUANT_INT16)
+    ->ArgNames({"size", "block"})
+    ->ArgsProduct({SIZES, BLOCKS})
+    ->Unit(benchmark::kMillisecond);
+
+template <HalfType Type>
+void BM_Half(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int block = static_cast<int>(state.range(1));
+    Operands op(n);
+    HMatrix* ha = hmatrix_create(n, n, Type);
+    HMatrix* hb = hmatrix_create(n, n, Type);
+    if (!op.ok() || !ha || !hb) {
+        hmatrix_free(ha);
+        hmatrix_free(hb);
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    matrix_to_half(op.A, ha);
+    matrix_to_half(op.B, hb);
+    for (auto _ : state) {
+        matrix_multiply_half_blocked(ha, hb, op.C, block, HALF_ACCUM_FP32);
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    hmatrix_free(ha);
+    hmatrix_free(hb);
+    set_gemm_counters(state, n, 2.0);
+}
+BENCHMARK_TEMPLATE(BM_Half, HALF_BF16)->ArgNames({"size", "block"})->ArgsProduct({SIZES, BLOCKS})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Half, HALF_FP16)->ArgNames({"size", "block"})->ArgsProduct({SIZES, BLOCKS})->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Multi-threaded kernels (wall time)
+// ============================================================================
+
+void BM_NaiveParallel(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_naive_parallel(A, B, C, threads);
+    });
+}
+BENCHMARK(BM_NaiveParallel)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_TransposeParallel(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_transpose_parallel(A, B, C, threads);
+    });
+}
+BENCHMARK(BM_TransposeParallel)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_BlockedParallel(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads, block](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_blocked_parallel(A, B, C, block, threads);
+    });
+}
+BENCHMARK(BM_BlockedParallel)
+    ->ArgNames({"size", "threads", "block"})
+    ->ArgsProduct({SIZES, thread_counts(), BLOCKS})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_PreparedParallel(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    Operands op(n);
+    PreparedB* prepared = op.ok() ? matrix_prepare_b(op.B) : nullptr;
+    if (!prepared) {
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    for (auto _ : state) {
+        matrix_multiply_prepared_parallel(op.A, prepared, op.C, threads);
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    prepared_b_free(prepared);
+    set_gemm_counters(state, n, sizeof(double));
+}
+BENCHMARK(BM_PreparedParallel)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_NaiveConcurrent(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_naive_concurrent(A, B, C, threads);
+    });
+}
+BENCHMARK(BM_NaiveConcurrent)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_TransposeConcurrent(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_transpose_concurrent(A, B, C, threads);
+    });
+}
+BENCHMARK(BM_TransposeConcurrent)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_BlockedConcurrent(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    run_gemm(state, static_cast<int>(state.range(0)), [threads, block](Matrix* A, Matrix* B, Matrix* C) {
+        return matrix_multiply_blocked_concurrent(A, B, C, block, threads);
+    });
+}
+BENCHMARK(BM_BlockedConcurrent)
+    ->ArgNames({"size", "threads", "block"})
+    ->ArgsProduct({SIZES, thread_counts(), BLOCKS})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ============================================================================
+// Out-of-core kernel (operands in files; the files stay in the page cache,
+// so this measures the streaming and overlap, not the disk)
+// ============================================================================
+
+void BM_OutOfCore(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::string dir = "/tmp";
+    if (const char* tmp = std::getenv("TMPDIR")) dir = tmp;
+    const std::string a_path = dir + "/matrix_bench_ooc_a.clm";
+    const std::string b_path = dir + "/matrix_bench_ooc_b.clm";
+    const std::string c_path = dir + "/matrix_bench_ooc_c.clm";
+    {
+        Operands op(n);
+        if (!op.ok() || matrix_save(a_path.c_str(), op.A, MATRIX_FORMAT_CLM) != 0 ||
+            matrix_save(b_path.c_str(), op.B, MATRIX_FORMAT_CLM) != 0) {
+            state.SkipWithError("cannot write operands");
+        }
+    }
+
+    // A budget of about one operand forces several panel passes
+    OocOptions options = ooc_default_options();
+    options.memory_budget = static_cast<size_t>(n) * n * sizeof(double);
+    options.double_buffer = static_cast<int>(state.range(1));
+    OocStats stats = {};
+    for (auto _ : state) {
+        if (matrix_multiply_out_of_core(a_path.c_str(), b_path.c_str(), c_path.c_str(), &options, &stats,
+                                        nullptr) != 0) {
+            state.SkipWithError("out-of-core multiply failed");
+            break;
+        }
+    }
+    std::remove(a_path.c_str());
+    std::remove(b_path.c_str());
+    std::remove(c_path.c_str());
+    set_gemm_counters(state, n, sizeof(double));
+    state.counters["tile"] = stats.tile;
+    state.counters["overlap"] = stats.overlap;
+}
+BENCHMARK(BM_OutOfCore)
+    ->ArgNames({"size", "double_buffer"})
+    ->ArgsProduct({{512, 1024}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// ============================================================================
+// Transpose (bytes only: n^2 read and n^2 written)
+// ============================================================================
+
+void BM_MatrixTranspose(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    Operands op(n);
+    if (!op.ok()) {
+        state.SkipWithError("cannot allocate operands");
+        return;
+    }
+    for (auto _ : state) {
+        if (threads > 1) {
+            matrix_transpose_parallel(op.A, op.C, threads);
+        } else {
+            matrix_transpose(op.A, op.C);
+        }
+        benchmark::DoNotOptimize(op.C->data);
+        benchmark::ClobberMemory();
+    }
+    const double bytes = 2.0 * n * n * sizeof(double);
+    state.counters["bytes"] = bytes;
+    state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+}
+BENCHMARK(BM_MatrixTranspose)
+    ->ArgNames({"size", "threads"})
+    ->ArgsProduct({SIZES, thread_counts()})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+
+// BENCHMARK_MAIN with the host description (environment.h) in the context
+// block of the console and JSON output
+int main(int argc, char** argv) {
+    BenchEnvironment env;
+    environment_capture(&env);
+    benchmark::AddCustomContext("cpu_model", env.cpu_model);
+    benchmark::AddCustomContext("governor", env.governor);
+    benchmark::AddCustomContext("turbo", env.turbo);
+    benchmark::AddCustomContext("thp", env.thp);
+    benchmark::AddCustomContext("smt", env.smt);
+    benchmark::AddCustomContext("kernel", env.kernel);
+    benchmark::AddCustomContext("compiler", env.compiler);
+    benchmark::AddCustomContext("build_type", env.build_type);
+    benchmark::AddCustomContext("build_flags", env.build_flags);
+    benchmark::AddCustomContext("affinity", env.affinity);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
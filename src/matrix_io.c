@@ -0,0 +1,449 @@
+// mmap/ftruncate/fseeko need POSIX.1-2008 (the build defines 199309L)
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "matrix_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define CLM_MAGIC "CLMATRIX"
+#define CLM_VERSION 1
+#define CLM_HEADER_SIZE 64
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_LEN 6
+#define NPY_ALIGNMENT 64
+
+// Largest header we need to look at (.npy v1 headers are at most 64 KB)
+#define MAX_HEADER_BYTES (65536 + 16)
+
+static int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char*)&probe == 1;
+}
+
+static uint32_t read_u32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t read_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void write_u32(unsigned char* p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static void write_u64(unsigned char* p, uint64_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static MatrixFileFormat resolve_format(const char* path, MatrixFileFormat format) {
+    if (format != MATRIX_FORMAT_AUTO) return format;
+    size_t len = strlen(path);
+    if (len >= 4 && strcmp(path + len - 4, ".npy") == 0) return MATRIX_FORMAT_NPY;
+    return MATRIX_FORMAT_CLM;
+}
+
+static size_t dtype_size(MatrixDType dtype) {
+    return (dtype == MATRIX_DTYPE_F32) ? sizeof(float) : sizeof(double);
+}
+
+// Bytes spanned by the payload: (lines - 1) * ld + line_length elements
+static int payload_bytes(const MatrixFileInfo* info, size_t* bytes) {
+    size_t lines = (info->layout == MATRIX_LAYOUT_ROW_MAJOR) ? (size_t)info->rows : (size_t)info->cols;
+    size_t line_len = (info->layout == MATRIX_LAYOUT_ROW_MAJOR) ? (size_t)info->cols : (size_t)info->rows;
+    if (info->ld < line_len) return -1;
+    if (lines == 0 || line_len == 0) {
+        *bytes = 0;
+        return 0;
+    }
+    if (info->ld > 0 && lines - 1 > (SIZE_MAX - line_len) / info->ld) return -1;
+    size_t elems = (lines - 1) * info->ld + line_len;
+    if (elems > SIZE_MAX / dtype_size(info->dtype)) return -1;
+    *bytes = elems * dtype_size(info->dtype);
+    return 0;
+}
+
+// ============================================================================
+// Header parsing
+// ============================================================================
+
+static int parse_clm(const unsigned char* buf, size_t n, MatrixFileInfo* info) {
+    if (n < CLM_HEADER_SIZE || memcmp(buf, CLM_MAGIC, 8) != 0) return -1;
+    if (read_u32(buf + 8) != CLM_VERSION) return -1;
+
+    uint32_t dtype = read_u32(buf + 12);
+    uint32_t layout = read_u32(buf + 16);
+    uint64_t rows = read_u64(buf + 24);
+    uint64_t cols = read_u64(buf + 32);
+    if (dtype != MATRIX_DTYPE_F64 && dtype != MATRIX_DTYPE_F32) return -1;
+    if (layout != MATRIX_LAYOUT_ROW_MAJOR && layout != MATRIX_LAYOUT_COL_MAJOR) return -1;
+    if (rows > INT_MAX || cols > INT_MAX) return -1;
+
+    info->format = MATRIX_FORMAT_CLM;
+    info->dtype = (MatrixDType)dtype;
+    info->layout = (MatrixLayout)layout;
+    info->alignment = read_u32(buf + 20);
+    info->rows = (int)rows;
+    info->cols = (int)cols;
+    info->ld = (size_t)read_u64(buf + 40);
+    info->data_offset = (size_t)read_u64(buf + 48);
+    return (info->data_offset >= CLM_HEADER_SIZE) ? 0 : -1;
+}
+
+// Value text following 'key': inside a .npy header dict, or NULL
+static const char* npy_value(const char* header, const char* key) {
+    const char* p = strstr(header, key);
+    if (!p) return NULL;
+    p = strchr(p + strlen(key), ':');
+    if (!p) return NULL;
+    p++;
+    while (*p == ' ') p++;
+    return p;
+}
+
+static int parse_npy(const unsigned char* buf, size_t n, MatrixFileInfo* info) {
+    if (n < 10 || memcmp(buf, NPY_MAGIC, NPY_MAGIC_LEN) != 0) return -1;
+
+    int major = buf[6];
+    size_t header_len;
+    size_t header_start;
+    if (major == 1) {
+        header_len = (size_t)buf[8] | ((size_t)buf[9] << 8);
+        header_start = 10;
+    } else if (major == 2 || major == 3) {
+        if (n < 12) return -1;
+        header_len = read_u32(buf + 8);
+        header_start = 12;
+    } else {
+        return -1;
+    }
+    if (header_start + header_len > n) return -1;
+
+    char* header = (char*)malloc(header_len + 1);
+    if (!header) return -1;
+    memcpy(header, buf + header_start, header_len);
+    header[header_len] = '\0';
+
+    int result = -1;
+    const char* descr = npy_value(header, "'descr'");
+    const char* order = npy_value(header, "'fortran_order'");
+    const char* shape = npy_value(header, "'shape'");
+    if (descr && order && shape && *shape == '(') {
+        info->format = MATRIX_FORMAT_NPY;
+        info->alignment = NPY_ALIGNMENT;
+        info->data_offset = header_start + header_len;
+
+        int dtype_ok = 1;
+        if (strncmp(descr, "'<f8'", 5) == 0) {
+            info->dtype = MATRIX_DTYPE_F64;
+        } else if (strncmp(descr, "'<f4'", 5) == 0) {
+            info->dtype = MATRIX_DTYPE_F32;
+        } else {
+            dtype_ok = 0;
+        }
+        info->layout = (strncmp(order, "True", 4) == 0) ? MATRIX_LAYOUT_COL_MAJOR
+                                                        : MATRIX_LAYOUT_ROW_MAJOR;
+
+        // shape is "(n,)" or "(r, c)"; 1-D arrays load as a single row
+        char* end = NULL;
+        long long d0 = strtoll(shape + 1, &end, 10);
+        long long d1 = -1;
+        if (end && *end == ',') {
+            const char* rest = end + 1;
+            while (*rest == ' ') rest++;
+            if (*rest == ')') {
+                d1 = d0;
+                d0 = 1;
+            } else {
+                d1 = strtoll(rest, &end, 10);
+                while (end && *end == ' ') end++;
+                if (!end || *end != ')') d1 = -1;
+            }
+        }
+
+        if (dtype_ok && d0 >= 0 && d1 >= 0 && d0 <= INT_MAX && d1 <= INT_MAX) {
+            info->rows = (int)d0;
+            info->cols = (int)d1;
+            info->ld = (info->layout == MATRIX_LAYOUT_ROW_MAJOR) ? (size_t)d1 : (size_t)d0;
+            result = 0;
+        }
+    }
+
+    free(header);
+    return result;
+}
+
+int matrix_file_info(const char* path, MatrixFileInfo* info) {
+    if (!path || !info || !host_is_little_endian()) return -1;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+
+    unsigned char* buf = (unsigned char*)malloc(MAX_HEADER_BYTES);
+    if (!buf) {
+        fclose(f);
+        return -1;
+    }
+    size_t n = fread(buf, 1, MAX_HEADER_BYTES, f);
+
+    struct stat st;
+    int result = -1;
+    if (fstat(fileno(f), &st) == 0) {
+        if (n >= NPY_MAGIC_LEN && memcmp(buf, NPY_MAGIC, NPY_MAGIC_LEN) == 0) {
+            result = parse_npy(buf, n, info);
+        } else {
+            result = parse_clm(buf, n, info);
+        }
+
+        // The whole payload must be inside the file
+        size_t bytes = 0;
+        if (result == 0 && (payload_bytes(info, &bytes) != 0 ||
+                            info->data_offset > (size_t)st.st_size ||
+                            bytes > (size_t)st.st_size - info->data_offset)) {
+            result = -1;
+        }
+    }
+
+    free(buf);
+    fclose(f);
+    return result;
+}
+
+// ============================================================================
+// Header writing (row-major float64)
+// ============================================================================
+
+// Fill header (at most MAX_HEADER_BYTES) and return its size, or 0 on error
+static size_t build_header(unsigned char* header, MatrixFileFormat format, int rows, int cols) {
+    if (format == MATRIX_FORMAT_NPY) {
+        char dict[256];
+        int len = snprintf(dict, sizeof(dict),
+                           "{'descr': '<f8', 'fortran_order': False, 'shape': (%d, %d), }",
+                           rows, cols);
+        if (len < 0 || (size_t)len >= sizeof(dict)) return 0;
+
+        // Pad with spaces and a final newline so the payload starts aligned
+        size_t total = 10 + (size_t)len + 1;
+        total = (total + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+        size_t header_len = total - 10;
+
+        memcpy(header, NPY_MAGIC, NPY_MAGIC_LEN);
+        header[6] = 1;
+        header[7] = 0;
+        header[8] = (unsigned char)(header_len & 0xff);
+        header[9] = (unsigned char)(header_len >> 8);
+        memcpy(header + 10, dict, (size_t)len);
+        memset(header + 10 + len, ' ', header_len - (size_t)len - 1);
+        header[total - 1] = '\n';
+        return total;
+    }
+
+    memset(header, 0, CLM_HEADER_SIZE);
+    memcpy(header, CLM_MAGIC, 8);
+    write_u32(header + 8, CLM_VERSION);
+    write_u32(header + 12, MATRIX_DTYPE_F64);
+    write_u32(header + 16, MATRIX_LAYOUT_ROW_MAJOR);
+    write_u32(header + 20, MATRIX_FILE_ALIGNMENT);
+    write_u64(header + 24, (uint64_t)rows);
+    write_u64(header + 32, (uint64_t)cols);
+    write_u64(header + 40, (uint64_t)cols);
+    write_u64(header + 48, MATRIX_FILE_ALIGNMENT);
+    return MATRIX_FILE_ALIGNMENT;
+}
+
+int matrix_save(const char* path, Matrix* m, MatrixFileFormat format) {
+    if (!path || !m || !host_is_little_endian()) return -1;
+
+    unsigned char header[CLM_HEADER_SIZE + 256];
+    size_t header_size = build_header(header, resolve_format(path, format), m->rows, m->cols);
+    if (header_size == 0) return -1;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+
+    size_t count = matrix_elements(m);
+    int ok = fwrite(header, 1, header_size, f) == header_size &&
+             fwrite(m->data, sizeof(double), count, f) == count;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+// ============================================================================
+// Copying load
+// ============================================================================
+
+Matrix* matrix_load(const char* path) {
+    MatrixFileInfo info;
+    if (matrix_file_info(path, &info) != 0) return NULL;
+
+    Matrix* m = matrix_create(info.rows, info.cols);
+    if (!m) return NULL;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        matrix_free(m);
+        return NULL;
+    }
+
+    // One line is a row (row-major) or a column (column-major) of the file
+    int row_major = (info.layout == MATRIX_LAYOUT_ROW_MAJOR);
+    size_t lines = row_major ? (size_t)info.rows : (size_t)info.cols;
+    size_t line_len = row_major ? (size_t)info.cols : (size_t)info.rows;
+    size_t elem = dtype_size(info.dtype);
+    int direct = row_major && info.dtype == MATRIX_DTYPE_F64;
+
+    void* line = direct ? NULL : malloc(line_len * elem + 1);
+    int ok = direct || line != NULL;
+
+    for (size_t l = 0; ok && l < lines; l++) {
+        off_t offset = (off_t)(info.data_offset + l * info.ld * elem);
+        if (fseeko(f, offset, SEEK_SET) != 0) {
+            ok = 0;
+            break;
+        }
+        if (direct) {
+            ok = fread(m->data + l * line_len, sizeof(double), line_len, f) == line_len;
+            continue;
+        }
+        if (fread(line, elem, line_len, f) != line_len) {
+            ok = 0;
+            break;
+        }
+        for (size_t e = 0; e < line_len; e++) {
+            double v = (info.dtype == MATRIX_DTYPE_F32) ? (double)((const float*)line)[e]
+                                                        : ((const double*)line)[e];
+            if (row_major) {
+                m->data[l * line_len + e] = v;
+            } else {
+                m->data[e * (size_t)info.cols + l] = v;
+            }
+        }
+    }
+
+    free(line);
+    fclose(f);
+    if (!ok) {
+        matrix_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+// ============================================================================
+// Zero-copy mapping
+// ============================================================================
+
+static MappedMatrix* map_file(int fd, size_t length, size_t data_offset, int rows, int cols,
+                              size_t ld, int writable, int shared) {
+    int prot = PROT_READ | PROT_WRITE;
+    int flags = shared ? MAP_SHARED : MAP_PRIVATE;
+    void* base = mmap(NULL, length, prot, flags, fd, 0);
+    if (base == MAP_FAILED) return NULL;
+
+    MappedMatrix* mm = (MappedMatrix*)malloc(sizeof(MappedMatrix));
+    if (!mm) {
+        munmap(base, length);
+        return NULL;
+    }
+
+    double* data = (double*)((unsigned char*)base + data_offset);
+    mm->matrix.data = data;
+    mm->matrix.rows = rows;
+    mm->matrix.cols = cols;
+    mm->view.data = data;
+    mm->view.rows = rows;
+    mm->view.cols = cols;
+    mm->view.ld = (int)ld;
+    mm->base = base;
+    mm->length = length;
+    mm->writable = writable;
+    return mm;
+}
+
+// A read-only request is mapped privately (copy-on-write): stray stores stay
+// in memory instead of faulting or reaching the file
+MappedMatrix* matrix_map(const char* path, int writable) {
+    MatrixFileInfo info;
+    if (matrix_file_info(path, &info) != 0) return NULL;
+    if (info.dtype != MATRIX_DTYPE_F64 || info.layout != MATRIX_LAYOUT_ROW_MAJOR) return NULL;
+    if (info.data_offset % sizeof(double) != 0 || info.ld > INT_MAX) return NULL;
+
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    MappedMatrix* mm = NULL;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mm = map_file(fd, (size_t)st.st_size, info.data_offset, info.rows, info.cols,
+                      info.ld, writable, writable);
+    }
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+    return mm;
+}
+
+int matrix_file_create(const char* path, int rows, int cols, MatrixFileFormat format,
+                       MatrixFileInfo* info) {
+    if (!path || rows < 0 || cols < 0 || !host_is_little_endian()) return -1;
+
+    MatrixFileFormat resolved = resolve_format(path, format);
+    unsigned char header[CLM_HEADER_SIZE + 256];
+    size_t header_size = build_header(header, resolved, rows, cols);
+    if (header_size == 0) return -1;
+
+    size_t count = (size_t)rows * (size_t)cols;
+    if (count > (SIZE_MAX - header_size) / sizeof(double)) return -1;
+    size_t length = header_size + count * sizeof(double);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    // ftruncate leaves the payload sparse; it reads as zeros until written
+    int ok = write(fd, header, header_size) == (ssize_t)header_size &&
+             ftruncate(fd, (off_t)length) == 0;
+    if (close(fd) != 0) ok = 0;
+    if (!ok) return -1;
+
+    if (info) {
+        info->format = resolved;
+        info->dtype = MATRIX_DTYPE_F64;
+        info->layout = MATRIX_LAYOUT_ROW_MAJOR;
+        info->rows = rows;
+        info->cols = cols;
+        info->ld = (size_t)cols;
+        info->alignment = (resolved == MATRIX_FORMAT_NPY) ? NPY_ALIGNMENT : MATRIX_FILE_ALIGNMENT;
+        info->data_offset = header_size;
+    }
+    return 0;
+}
+
+MappedMatrix* matrix_map_create(const char* path, int rows, int cols, MatrixFileFormat format) {
+    if (matrix_file_create(path, rows, cols, format, NULL) != 0) return NULL;
+    return matrix_map(path, 1);
+}
+
+int matrix_map_sync(MappedMatrix* mm) {
+    if (!mm || !mm->writable) return -1;
+    return msync(mm->base, mm->length, MS_SYNC) == 0 ? 0 : -1;
+}
+
+void matrix_unmap(MappedMatrix* mm) {
+    if (mm) {
+        munmap(mm->base, mm->length);
+        free(mm);
+    }
+}
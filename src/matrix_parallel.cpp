@@ -1,6 +1,12 @@
 #include "matrix.h"
+#include "gemm_fixed.h"
+#include "transpose.h"
+#include "prepared.h"
+#include "matrix_random.h"
+#include "worker_timeline.h"
 
 #include <algorithm>
+#include <cstring>
 #include <thread>
 #include <vector>
 
@@ -14,6 +20,50 @@ int normalize_thread_count(int num_threads, int max_rows) {
     }
     return std::min(num_threads, std::max(1, max_rows));
 }
+
+// Row ranges of C for threads, with boundaries on cache lines so that no
+// line of C is written by two threads (see matrix_partition_rows)
+std::vector<int> partition_rows(const Matrix* C, int threads) {
+    std::vector<int> bounds(static_cast<size_t>(threads) + 1);
+    matrix_partition_rows(C->data, static_cast<size_t>(C->cols), C->rows, threads, bounds.data());
+    return bounds;
+}
+
+// Below this many elements per thread, starting a thread costs more than
+// the memory traffic it takes over
+const size_t INIT_MIN_ELEMENTS_PER_THREAD = 1u << 16;
+
+// Split [0, count) into contiguous element ranges, one per thread; the
+// calling thread runs the last range
+template <typename Work>
+void run_over_elements(size_t count, int num_threads, Work work) {
+    size_t useful = std::min<size_t>(count / INIT_MIN_ELEMENTS_PER_THREAD, 1024);
+    int threads = normalize_thread_count(num_threads, static_cast<int>(useful));
+    size_t per_thread = (count + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+
+    WorkerPhase phase;
+    size_t start = 0;
+    for (int t = 0; t < threads - 1 && start < count; ++t) {
+        size_t end = std::min(count, start + per_thread);
+        WorkerSpan* span = phase.spawn(static_cast<long long>(end - start));
+        workers.emplace_back([work, span, start, end]() {
+            WorkerSpanScope scope(span);
+            work(start, end);
+        });
+        start = end;
+    }
+    if (start < count) {
+        WorkerSpanScope scope(phase.run_here(static_cast<long long>(count - start)));
+        work(start, count);
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+}
 }
 
 extern "C" int matrix_multiply_naive_parallel(Matrix* A, Matrix* B, Matrix* C, int num_threads) {
@@ -32,11 +82,11 @@ extern "C" int matrix_multiply_naive_parallel(Matrix* A, Matrix* B, Matrix* C, i
         for (int i = row_start; i < row_end; ++i) {
             for (int j = 0; j < P; ++j) {
                 double sum = 0.0;
-                int a_base = i * A->cols;
+                size_t a_base = static_cast<size_t>(i) * A->cols;
                 for (int k = 0; k < N; ++k) {
-                    sum += A->data[a_base + k] * B->data[k * B->cols + j];
+                    sum += A->data[a_base + k] * B->data[static_cast<size_t>(k) * B->cols + j];
                 }
-                C->data[i * C->cols + j] = sum;
+                C->data[static_cast<size_t>(i) * C->cols + j] = sum;
             }
         }
     };
@@ -44,12 +94,16 @@ extern "C" int matrix_multiply_naive_parallel(Matrix* A, Matrix* B, Matrix* C, i
     std::vector<std::thread> workers;
     workers.reserve(static_cast<size_t>(threads));
 
-    int rows_per_thread = (M + threads - 1) / threads;
-    int row_start = 0;
-    for (int t = 0; t < threads && row_start < M; ++t) {
-        int row_end = std::min(M, row_start + rows_per_thread);
-        workers.emplace_back(worker, row_start, row_end);
-        row_start = row_end;
+    WorkerPhase phase;
+    std::vector<int> bounds = partition_rows(C, threads);
+    for (int t = 0; t < threads; ++t) {
+        int row_start = bounds[t], row_end = bounds[t + 1];
+        if (row_start == row_end) continue;
+        WorkerSpan* span = phase.spawn(row_end - row_start);
+        workers.emplace_back([worker, span, row_start, row_end]() {
+            WorkerSpanScope scope(span);
+            worker(row_start, row_end);
+        });
     }
 
     for (auto& worker_thread : workers) {
@@ -64,52 +118,80 @@ extern "C" int matrix_multiply_transpose_parallel(Matrix* A, Matrix* B, Matrix*
     if (A->cols != B->rows) return -1;
     if (C->rows != A->rows || C->cols != B->cols) return -1;
 
-    int M = A->rows;
-    int N = A->cols;
-    int P = B->cols;
-
-    Matrix* B_T = matrix_create(P, N);
+    PreparedB* B_T = prepared_b_create(B->rows, B->cols);
     if (!B_T) return -1;
 
-    for (int i = 0; i < B->rows; ++i) {
-        for (int j = 0; j < B->cols; ++j) {
-            B_T->data[j * B_T->cols + i] = B->data[i * B->cols + j];
-        }
-    }
+    int threads = normalize_thread_count(num_threads, A->rows);
+    prepared_b_pack_parallel(B_T, B, threads);
+    matrix_multiply_prepared_parallel(A, B_T, C, threads);
 
-    int threads = normalize_thread_count(num_threads, M);
-    matrix_zeros(C);
+    prepared_b_free(B_T);
+    return 0;
+}
 
-    auto worker = [A, B_T, C, N, P](int row_start, int row_end) {
-        for (int i = row_start; i < row_end; ++i) {
-            int a_base = i * A->cols;
-            for (int j = 0; j < P; ++j) {
-                double sum = 0.0;
-                int b_base = j * B_T->cols;
-                for (int k = 0; k < N; ++k) {
-                    sum += A->data[a_base + k] * B_T->data[b_base + k];
-                }
-                C->data[i * C->cols + j] = sum;
-            }
-        }
-    };
+extern "C" int prepared_b_pack_parallel(PreparedB* prep, Matrix* B, int num_threads) {
+    if (!prep || !B) return -1;
+    if (B->rows != prepared_b_rows(prep) || B->cols != prepared_b_cols(prep)) return -1;
+
+    // Threads take whole transpose tiles of B rows
+    int rows = B->rows;
+    int tile_rows = (rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    int threads = normalize_thread_count(num_threads, tile_rows);
+    int rows_per_thread = (tile_rows + threads - 1) / threads * TRANSPOSE_TILE;
 
     std::vector<std::thread> workers;
     workers.reserve(static_cast<size_t>(threads));
 
-    int rows_per_thread = (M + threads - 1) / threads;
+    WorkerPhase phase;
     int row_start = 0;
-    for (int t = 0; t < threads && row_start < M; ++t) {
-        int row_end = std::min(M, row_start + rows_per_thread);
-        workers.emplace_back(worker, row_start, row_end);
+    for (int t = 0; t < threads - 1 && row_start < rows; ++t) {
+        int row_end = std::min(rows, row_start + rows_per_thread);
+        WorkerSpan* span = phase.spawn(row_end - row_start);
+        workers.emplace_back([prep, B, span, row_start, row_end]() {
+            WorkerSpanScope scope(span);
+            prepared_b_pack_rows(prep, B, row_start, row_end);
+        });
         row_start = row_end;
     }
+    if (row_start < rows) {
+        WorkerSpanScope scope(phase.run_here(rows - row_start));
+        prepared_b_pack_rows(prep, B, row_start, rows);
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+
+    return 0;
+}
+
+extern "C" int matrix_multiply_prepared_parallel(Matrix* A, const PreparedB* B, Matrix* C, int num_threads) {
+    if (!A || !B || !C) return -1;
+    if (A->cols != prepared_b_rows(B)) return -1;
+    if (C->rows != A->rows || C->cols != prepared_b_cols(B)) return -1;
+
+    int M = A->rows;
+    int threads = normalize_thread_count(num_threads, M);
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+
+    WorkerPhase phase;
+    std::vector<int> bounds = partition_rows(C, threads);
+    for (int t = 0; t < threads; ++t) {
+        int row_start = bounds[t], row_end = bounds[t + 1];
+        if (row_start == row_end) continue;
+        WorkerSpan* span = phase.spawn(row_end - row_start);
+        workers.emplace_back([A, B, C, span, row_start, row_end]() {
+            WorkerSpanScope scope(span);
+            matrix_multiply_prepared_rows(A, B, C, row_start, row_end);
+        });
+    }
 
     for (auto& worker_thread : workers) {
         worker_thread.join();
     }
 
-    matrix_free(B_T);
     return 0;
 }
 
@@ -122,6 +204,13 @@ extern "C" int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C,
     int N = A->cols;
     int P = B->cols;
 
+    // Small shapes with a compile-time kernel fit in L1: no tiling, no threads
+    GemmFixedKernel fixed = gemm_fixed_lookup(M, P, N);
+    if (fixed) {
+        fixed(A->data, B->data, C->data);
+        return 0;
+    }
+
     int BLOCK;
     if (block_size <= 0) {
         int l1_size = get_l1_cache_size();
@@ -139,15 +228,14 @@ extern "C" int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C,
     matrix_zeros(C);
 
     int threads = normalize_thread_count(num_threads, M);
-    int rows_per_thread = (M + threads - 1) / threads;
 
     auto worker = [A, B, C, N, P, BLOCK](int row_start, int row_end) {
         double* a_data = A->data;
         double* b_data = B->data;
         double* c_data = C->data;
-        int a_stride = A->cols;
-        int b_stride = B->cols;
-        int c_stride = C->cols;
+        size_t a_stride = static_cast<size_t>(A->cols);
+        size_t b_stride = static_cast<size_t>(B->cols);
+        size_t c_stride = static_cast<size_t>(C->cols);
 
         for (int ii = row_start; ii < row_end; ii += BLOCK) {
             int i_max = std::min(row_end, ii + BLOCK);
@@ -159,11 +247,11 @@ extern "C" int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C,
                     int j_max = std::min(P, jj + BLOCK);
 
                     for (int i = ii; i < i_max; ++i) {
-                        int a_base = i * a_stride;
-                        int c_base = i * c_stride;
+                        size_t a_base = i * a_stride;
+                        size_t c_base = i * c_stride;
                         for (int k = kk; k < k_max; ++k) {
                             double a_val = a_data[a_base + k];
-                            int b_base = k * b_stride;
+                            size_t b_base = k * b_stride;
                             for (int j = jj; j < j_max; ++j) {
                                 c_data[c_base + j] += a_val * b_data[b_base + j];
                             }
@@ -177,12 +265,60 @@ extern "C" int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C,
     std::vector<std::thread> workers;
     workers.reserve(static_cast<size_t>(threads));
 
+    WorkerPhase phase;
+    std::vector<int> bounds = partition_rows(C, threads);
+    for (int t = 0; t < threads; ++t) {
+        int row_start = bounds[t], row_end = bounds[t + 1];
+        if (row_start == row_end) continue;
+        WorkerSpan* span = phase.spawn(row_end - row_start);
+        workers.emplace_back([worker, span, row_start, row_end]() {
+            WorkerSpanScope scope(span);
+            worker(row_start, row_end);
+        });
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+
+    return 0;
+}
+
+extern "C" int matrix_transpose_parallel(Matrix* src, Matrix* dst, int num_threads) {
+    if (!src || !dst || src == dst) return -1;
+    if (dst->rows != src->cols || dst->cols != src->rows) return -1;
+
+    int rows = src->rows;
+    int cols = src->cols;
+
+    // Threads take whole tiles of source rows: each writes its own dst columns
+    int tile_rows = (rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    int threads = normalize_thread_count(num_threads, tile_rows);
+    int tiles_per_thread = (tile_rows + threads - 1) / threads;
+
+    auto worker = [src, dst, rows, cols](int row_start, int row_end) {
+        transpose_out_of_place_rows(src->data, rows, cols, src->cols, dst->data, dst->cols,
+                                    row_start, row_end);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+
+    WorkerPhase phase;
     int row_start = 0;
-    for (int t = 0; t < threads && row_start < M; ++t) {
-        int row_end = std::min(M, row_start + rows_per_thread);
-        workers.emplace_back(worker, row_start, row_end);
+    for (int t = 0; t < threads - 1 && row_start < rows; ++t) {
+        int row_end = std::min(rows, row_start + tiles_per_thread * TRANSPOSE_TILE);
+        WorkerSpan* span = phase.spawn(row_end - row_start);
+        workers.emplace_back([worker, span, row_start, row_end]() {
+            WorkerSpanScope scope(span);
+            worker(row_start, row_end);
+        });
         row_start = row_end;
     }
+    if (row_start < rows) {
+        WorkerSpanScope scope(phase.run_here(rows - row_start));
+        worker(row_start, rows);
+    }
 
     for (auto& worker_thread : workers) {
         worker_thread.join();
@@ -190,3 +326,35 @@ extern "C" int matrix_multiply_blocked_parallel(Matrix* A, Matrix* B, Matrix* C,
 
     return 0;
 }
+
+extern "C" void matrix_zeros_parallel(Matrix* m, int num_threads) {
+    if (!m) return;
+
+    double* data = m->data;
+    run_over_elements(matrix_elements(m), num_threads, [data](size_t start, size_t end) {
+        std::memset(data + start, 0, (end - start) * sizeof(double));
+    });
+}
+
+extern "C" int matrix_copy_parallel(Matrix* src, Matrix* dst, int num_threads) {
+    if (!src || !dst) return -1;
+    if (src->rows != dst->rows || src->cols != dst->cols) return -1;
+    if (src == dst) return 0;
+
+    const double* from = src->data;
+    double* to = dst->data;
+    run_over_elements(matrix_elements(src), num_threads, [from, to](size_t start, size_t end) {
+        std::memcpy(to + start, from + start, (end - start) * sizeof(double));
+    });
+    return 0;
+}
+
+extern "C" void matrix_randomize_parallel(Matrix* m, uint64_t seed, int num_threads) {
+    if (!m) return;
+
+    // Element k is value k of the stream wherever it is computed
+    double* data = m->data;
+    run_over_elements(matrix_elements(m), num_threads, [data, seed](size_t start, size_t end) {
+        random_fill_uniform(data + start, end - start, seed, start);
+    });
+}
@@ -0,0 +1,170 @@
+#include "matrix_random.h"
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RANDOM_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define RANDOM_HAVE_X86 0
+#endif
+
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ull
+#define MIX_MUL_1 0xBF58476D1CE4E5B9ull
+#define MIX_MUL_2 0x94D049BB133111EBull
+
+// Exponent bits of 1.0: (x >> 12) | ONE_BITS is a double in [1, 2)
+#define ONE_BITS 0x3FF0000000000000ull
+
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * MIX_MUL_1;
+    z = (z ^ (z >> 27)) * MIX_MUL_2;
+    return z ^ (z >> 31);
+}
+
+// Seeds are mixed once so that nearby seeds give unrelated streams
+static uint64_t stream_key(uint64_t seed) {
+    return mix64(seed ^ GOLDEN_GAMMA);
+}
+
+static double to_uniform(uint64_t x) {
+    uint64_t bits = (x >> 12) | ONE_BITS;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+uint64_t random_u64(uint64_t seed, uint64_t index) {
+    return mix64(stream_key(seed) + (index + 1) * GOLDEN_GAMMA);
+}
+
+double random_uniform(uint64_t seed, uint64_t index) {
+    return to_uniform(random_u64(seed, index));
+}
+
+// ============================================================================
+// Path selection
+// ============================================================================
+
+static RandomPath forced_path = RANDOM_PATH_AUTO;
+
+static int path_supported(RandomPath path) {
+    switch (path) {
+        case RANDOM_PATH_PORTABLE:
+            return 1;
+#if RANDOM_HAVE_X86
+        case RANDOM_PATH_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return 0;
+    }
+}
+
+RandomPath random_select_path(RandomPath path) {
+    forced_path = path;
+    return random_active_path();
+}
+
+RandomPath random_active_path(void) {
+    if (forced_path == RANDOM_PATH_AUTO || !path_supported(forced_path)) {
+        return path_supported(RANDOM_PATH_AVX2) ? RANDOM_PATH_AVX2 : RANDOM_PATH_PORTABLE;
+    }
+    return forced_path;
+}
+
+const char* random_path_name(RandomPath path) {
+    switch (path) {
+        case RANDOM_PATH_AUTO: return "auto";
+        case RANDOM_PATH_PORTABLE: return "portable";
+        case RANDOM_PATH_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Fill kernels: counter z advances by GOLDEN_GAMMA per element
+// ============================================================================
+
+static void fill_portable(double* data, size_t count, uint64_t z) {
+    for (size_t k = 0; k < count; k++) {
+        z += GOLDEN_GAMMA;
+        data[k] = to_uniform(mix64(z));
+    }
+}
+
+#if RANDOM_HAVE_X86
+// Low 64 bits of a * b per lane (AVX2 has only 32 x 32 -> 64 multiplies)
+__attribute__((target("avx2")))
+static inline __m256i mullo64(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2")))
+static void fill_avx2(double* data, size_t count, uint64_t z) {
+    const __m256i mul1 = _mm256_set1_epi64x((long long)MIX_MUL_1);
+    const __m256i mul2 = _mm256_set1_epi64x((long long)MIX_MUL_2);
+    const __m256i step = _mm256_set1_epi64x((long long)(4 * GOLDEN_GAMMA));
+    const __m256i one_bits = _mm256_set1_epi64x((long long)ONE_BITS);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    __m256i counter = _mm256_set_epi64x((long long)(z + 4 * GOLDEN_GAMMA), (long long)(z + 3 * GOLDEN_GAMMA),
+                                        (long long)(z + 2 * GOLDEN_GAMMA), (long long)(z + GOLDEN_GAMMA));
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256i x = counter;
+        x = mullo64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 30)), mul1);
+        x = mullo64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 27)), mul2);
+        x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 31));
+        x = _mm256_or_si256(_mm256_srli_epi64(x, 12), one_bits);
+        _mm256_storeu_pd(data + k, _mm256_sub_pd(_mm256_castsi256_pd(x), one));
+        counter = _mm256_add_epi64(counter, step);
+    }
+
+    fill_portable(data + k, count - k, z + k * GOLDEN_GAMMA);
+}
+#endif
+
+void random_fill_uniform(double* data, size_t count, uint64_t seed, uint64_t first_index) {
+    if (!data || count == 0) return;
+
+    uint64_t z = stream_key(seed) + first_index * GOLDEN_GAMMA;
+#if RANDOM_HAVE_X86
+    if (random_active_path() == RANDOM_PATH_AVX2) {
+        fill_avx2(data, count, z);
+        return;
+    }
+#endif
+    fill_portable(data, count, z);
+}
+
+// ============================================================================
+// Matrix helpers
+// ============================================================================
+
+static uint64_t base_seed = MATRIX_RANDOM_DEFAULT_SEED;
+static uint64_t call_count = 0;
+
+void matrix_randomize_seeded(Matrix* m, uint64_t seed) {
+    if (!m) return;
+    random_fill_uniform(m->data, matrix_elements(m), seed, 0);
+}
+
+void matrix_random_set_seed(uint64_t seed) {
+    base_seed = seed;
+    call_count = 0;
+}
+
+void matrix_randomize(Matrix* m) {
+    if (!m) return;
+
+    // Each call gets its own stream; the counter is the only shared state
+#if defined(__GNUC__)
+    uint64_t call = __atomic_fetch_add(&call_count, 1, __ATOMIC_RELAXED);
+#else
+    uint64_t call = call_count++;
+#endif
+    matrix_randomize_seeded(m, random_u64(base_seed, call));
+}
@@ -0,0 +1,237 @@
+#include "membench.h"
+#include "matrix.h"
+#include "matrix_random.h"
+#include "profiler.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int normalize_thread_count(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return std::max(1, num_threads);
+}
+
+// Split [0, count) into contiguous ranges, one per thread; the calling
+// thread runs the last range. The split depends only on count and threads,
+// so repeated calls give every thread the same range it first touched.
+template <typename Work>
+void run_chunks(size_t count, int threads, Work work) {
+    size_t per_thread = (count + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+
+    int t = 0;
+    size_t start = 0;
+    for (; t < threads - 1 && start < count; ++t) {
+        size_t end = std::min(count, start + per_thread);
+        workers.emplace_back(work, t, start, end);
+        start = end;
+    }
+    if (start < count) {
+        work(t, start, count);
+    }
+
+    for (auto& worker_thread : workers) {
+        worker_thread.join();
+    }
+}
+
+// Keeps results of the read kernel and the chase alive
+volatile double sink_value;
+void* volatile sink_pointer;
+
+}  // namespace
+
+extern "C" void membench_random_cycle(size_t* next, size_t count, uint64_t seed) {
+    if (!next || count == 0) return;
+
+    for (size_t i = 0; i < count; ++i) {
+        next[i] = i;
+    }
+    // Sattolo: swapping only with strictly earlier slots yields one cycle
+    for (size_t i = count - 1; i > 0; --i) {
+        size_t j = static_cast<size_t>(random_u64(seed, i) % i);
+        std::swap(next[i], next[j]);
+    }
+}
+
+extern "C" double membench_latency_ns(size_t bytes, size_t steps) {
+    const size_t line = static_cast<size_t>(get_cache_line_size());
+    const size_t lines = std::max<size_t>(2, bytes / line);
+    if (steps == 0) steps = 1;
+
+    void* raw = nullptr;
+    if (posix_memalign(&raw, line, lines * line) != 0) return -1.0;
+    char* base = static_cast<char*>(raw);
+
+    // Each line holds the address of the next line of the cycle
+    std::vector<size_t> next(lines);
+    membench_random_cycle(next.data(), lines, 0x1A7E);
+    for (size_t i = 0; i < lines; ++i) {
+        *reinterpret_cast<void**>(base + i * line) = base + next[i] * line;
+    }
+
+    // One untimed lap warms the caches (and TLB) that can hold the set
+    void* p = base;
+    for (size_t i = 0; i < lines; ++i) {
+        p = *static_cast<void**>(p);
+    }
+
+    size_t rounds = (steps + 7) / 8;
+    double start = get_time_ms();
+    for (size_t r = 0; r < rounds; ++r) {
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+        p = *static_cast<void**>(p);
+    }
+    double elapsed_ms = get_time_ms() - start;
+    sink_pointer = p;
+
+    free(raw);
+    return elapsed_ms * 1e6 / static_cast<double>(rounds * 8);
+}
+
+extern "C" double membench_bandwidth_gbs(MembenchKernel kernel, size_t bytes_per_array,
+                                         int num_threads, int iterations) {
+    if (kernel < MEMBENCH_READ || kernel > MEMBENCH_TRIAD) return -1.0;
+
+    const size_t count = std::max<size_t>(1, bytes_per_array / sizeof(double));
+    const int threads = std::min<int>(normalize_thread_count(num_threads),
+                                      static_cast<int>(std::min<size_t>(count, 1024)));
+    if (iterations <= 0) iterations = 1;
+
+    // Left uninitialised so that the pages are first touched below
+    std::unique_ptr<double[]> a(new (std::nothrow) double[count]);
+    std::unique_ptr<double[]> b(new (std::nothrow) double[count]);
+    std::unique_ptr<double[]> c(new (std::nothrow) double[count]);
+    double* pa = a.get();
+    double* pb = b.get();
+    double* pc = c.get();
+    if (!pa || !pb || !pc) return -1.0;
+
+    // First touch by the thread that will stream the chunk
+    run_chunks(count, threads, [pa, pb, pc](int, size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            pa[i] = 1.0;
+            pb[i] = 2.0;
+            pc[i] = 0.5;
+        }
+    });
+
+    const double scalar = 3.0;
+    std::vector<double> partial(static_cast<size_t>(threads), 0.0);
+    double* sums = partial.data();
+
+    double best_ms = 0.0;
+    for (int iter = 0; iter < iterations; ++iter) {
+        double start_ms = get_time_ms();
+        switch (kernel) {
+            case MEMBENCH_READ:
+                run_chunks(count, threads, [pa, sums](int t, size_t start, size_t end) {
+                    // Independent partial sums keep the loads from waiting on one add chain
+                    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+                    size_t i = start;
+                    for (; i + 4 <= end; i += 4) {
+                        s0 += pa[i];
+                        s1 += pa[i + 1];
+                        s2 += pa[i + 2];
+                        s3 += pa[i + 3];
+                    }
+                    for (; i < end; ++i) s0 += pa[i];
+                    sums[t] += s0 + s1 + s2 + s3;
+                });
+                break;
+            case MEMBENCH_WRITE:
+                run_chunks(count, threads, [pa, scalar](int, size_t start, size_t end) {
+                    std::fill(pa + start, pa + end, scalar);
+                });
+                break;
+            case MEMBENCH_COPY:
+                run_chunks(count, threads, [pa, pc](int, size_t start, size_t end) {
+                    std::memcpy(pc + start, pa + start, (end - start) * sizeof(double));
+                });
+                break;
+            case MEMBENCH_TRIAD:
+                run_chunks(count, threads, [pa, pb, pc, scalar](int, size_t start, size_t end) {
+                    for (size_t i = start; i < end; ++i) {
+                        pa[i] = pb[i] + scalar * pc[i];
+                    }
+                });
+                break;
+        }
+        double elapsed = get_time_ms() - start_ms;
+        if (iter == 0 || elapsed < best_ms) best_ms = elapsed;
+    }
+
+    double total = 0.0;
+    for (double s : partial) total += s;
+    sink_value = total;
+
+    const double bytes_per_element[] = {8.0, 8.0, 16.0, 24.0};
+    double moved = bytes_per_element[kernel] * static_cast<double>(count);
+    return best_ms > 0.0 ? moved / (best_ms * 1e6) : 0.0;
+}
+
+extern "C" const char* membench_kernel_name(MembenchKernel kernel) {
+    switch (kernel) {
+        case MEMBENCH_READ: return "read";
+        case MEMBENCH_WRITE: return "write";
+        case MEMBENCH_COPY: return "copy";
+        case MEMBENCH_TRIAD: return "triad";
+    }
+    return "unknown";
+}
+
+extern "C" int membench_find_knees(const LatencyPoint* points, int count, double min_rise,
+                                   MemoryKnee* knees, int max_knees) {
+    if (!points || !knees || count < 2) return 0;
+
+    // Median of three neighbours, so a single noisy point neither starts
+    // nor ends a climb; reported latencies are the measured ones
+    std::vector<double> smooth(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        if (i == 0 || i == count - 1) {
+            smooth[i] = points[i].latency_ns;
+        } else {
+            double a = points[i - 1].latency_ns, b = points[i].latency_ns, c = points[i + 1].latency_ns;
+            smooth[i] = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        }
+    }
+
+    // A step counts as climbing when latency grows by at least 10%
+    const double step_rise = 1.1;
+    int found = 0;
+    int i = 0;
+    while (i < count - 1 && found < max_knees) {
+        if (smooth[i + 1] < smooth[i] * step_rise) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i < count - 1 && smooth[i + 1] >= smooth[i] * step_rise) {
+            ++i;
+        }
+        if (smooth[i] >= smooth[start] * min_rise) {
+            knees[found].bytes = points[start].bytes;
+            knees[found].before_ns = points[start].latency_ns;
+            knees[found].after_ns = points[i].latency_ns;
+            ++found;
+        }
+    }
+    return found;
+}
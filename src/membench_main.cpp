@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "concurrent_matrix.h"
+#include "membench.h"
+#include "scaling_sweep.h"
+
+namespace {
+
+const int MAX_KNEES = 8;
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]\n\n";
+    std::cout << "Measures load latency over working-set sizes (random pointer chase),\n";
+    std::cout << "locates the L1/L2/L3/DRAM transitions and measures STREAM-style\n";
+    std::cout << "bandwidth per thread count.\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --min-kb <N>            Smallest latency working set in KB (default: 4)\n";
+    std::cout << "  --max-mb <N>            Largest latency working set in MB (default: 4 x L3, 64..1024)\n";
+    std::cout << "  --points-per-octave <N> Latency sizes per doubling (default: 4)\n";
+    std::cout << "  --steps <N>             Dependent loads per latency point (default: 2097152)\n";
+    std::cout << "  --min-rise <X>          Latency ratio that counts as a knee (default: 1.5)\n";
+    std::cout << "  --threads <a,b>         Bandwidth thread counts (default: powers of two, physical cores, all)\n";
+    std::cout << "  --stream-mb <N>         Bandwidth array size in MB (default: 4 x L3, 32..256)\n";
+    std::cout << "  --iterations <N>        Bandwidth passes, best is reported (default: 5)\n";
+    std::cout << "  --output <file>         Output JSON Lines file (default: memory_hierarchy.jsonl)\n";
+    std::cout << "  --help                  Show this help message\n";
+    std::cout << "\nExamples:\n";
+    std::cout << "  " << program_name << " --max-mb 256 --points-per-octave 2\n";
+    std::cout << "  " << program_name << " --threads 1,2,4 --stream-mb 128\n";
+}
+
+// Comma separated list of positive integers; empty on any invalid entry
+std::vector<int> parse_int_list(const char* text) {
+    std::vector<int> values;
+    std::string list = text;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        int value = std::atoi(list.substr(pos, comma - pos).c_str());
+        if (value <= 0) return std::vector<int>();
+        values.push_back(value);
+        pos = comma + 1;
+    }
+    return values;
+}
+
+// Geometric sizes from min_bytes to max_bytes, points_per_octave per doubling,
+// rounded to whole cache lines
+std::vector<size_t> latency_sizes(size_t min_bytes, size_t max_bytes, int points_per_octave) {
+    const size_t line = static_cast<size_t>(get_cache_line_size());
+    std::vector<size_t> sizes;
+    for (int i = 0;; ++i) {
+        double bytes = static_cast<double>(min_bytes) * std::pow(2.0, static_cast<double>(i) / points_per_octave);
+        if (bytes > static_cast<double>(max_bytes) * 1.0001) break;
+        size_t rounded = static_cast<size_t>(bytes) / line * line;
+        if (sizes.empty() || rounded > sizes.back()) sizes.push_back(rounded);
+    }
+    return sizes;
+}
+
+std::string format_bytes(size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= (1u << 20)) {
+        out << static_cast<double>(bytes) / (1 << 20) << " MB";
+    } else {
+        out << static_cast<double>(bytes) / (1 << 10) << " KB";
+    }
+    return out.str();
+}
+
+// Level filled up at knee i: L1, L2, L3, then L4 ... if the curve has more
+std::string knee_level(int index) {
+    return "L" + std::to_string(index + 1);
+}
+
+// Capacity reported by sysconf for a level, 0 if unknown
+size_t reported_capacity(int index) {
+    switch (index) {
+        case 0: return static_cast<size_t>(get_l1_cache_size());
+        case 1: return static_cast<size_t>(get_l2_cache_size());
+        case 2: return static_cast<size_t>(get_l3_cache_size());
+    }
+    return 0;
+}
+
+struct BandwidthRecord {
+    MembenchKernel kernel;
+    int threads;
+    double gbs;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t l3_bytes = static_cast<size_t>(get_l3_cache_size());
+    size_t min_kb = 4;
+    size_t max_mb = std::min<size_t>(1024, std::max<size_t>(64, 4 * l3_bytes >> 20));
+    int points_per_octave = 4;
+    size_t steps = 1u << 21;
+    double min_rise = 1.5;
+    std::vector<int> thread_counts;
+    size_t stream_mb = std::min<size_t>(256, std::max<size_t>(32, 4 * l3_bytes >> 20));
+    int iterations = 5;
+    const char* output_file = "memory_hierarchy.jsonl";
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--min-kb") == 0 && i + 1 < argc) {
+            int value = std::atoi(argv[++i]);
+            if (value <= 0) {
+                std::cerr << "Error: Min size must be > 0\n";
+                return 1;
+            }
+            min_kb = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--max-mb") == 0 && i + 1 < argc) {
+            int value = std::atoi(argv[++i]);
+            if (value <= 0) {
+                std::cerr << "Error: Max size must be > 0\n";
+                return 1;
+            }
+            max_mb = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--points-per-octave") == 0 && i + 1 < argc) {
+            points_per_octave = std::atoi(argv[++i]);
+            if (points_per_octave <= 0) {
+                std::cerr << "Error: Points per octave must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            long value = std::atol(argv[++i]);
+            if (value <= 0) {
+                std::cerr << "Error: Steps must be > 0\n";
+                return 1;
+            }
+            steps = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--min-rise") == 0 && i + 1 < argc) {
+            min_rise = std::atof(argv[++i]);
+            if (min_rise <= 1.0) {
+                std::cerr << "Error: Min rise must be > 1\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_counts = parse_int_list(argv[++i]);
+            if (thread_counts.empty()) {
+                std::cerr << "Error: --threads needs a comma separated list of positive counts\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--stream-mb") == 0 && i + 1 < argc) {
+            int value = std::atoi(argv[++i]);
+            if (value <= 0) {
+                std::cerr << "Error: Stream size must be > 0\n";
+                return 1;
+            }
+            stream_mb = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+            if (iterations <= 0) {
+                std::cerr << "Error: Iterations must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (min_kb << 10 >= max_mb << 20) {
+        std::cerr << "Error: Min size must be below max size\n";
+        return 1;
+    }
+    if (thread_counts.empty()) {
+        thread_counts = sweep_default_thread_counts(get_hardware_concurrency(), get_physical_core_count());
+    }
+
+    // ========================================================================
+    // Latency curve
+    // ========================================================================
+    std::vector<LatencyPoint> points;
+    std::cout << "Load latency (random pointer chase, " << steps << " steps per size)\n";
+    std::cout << std::setw(14) << "Working set" << std::setw(16) << "Latency (ns)" << "\n";
+    std::cout << std::string(30, '-') << "\n";
+    for (size_t bytes : latency_sizes(min_kb << 10, max_mb << 20, points_per_octave)) {
+        double ns = membench_latency_ns(bytes, steps);
+        if (ns < 0.0) {
+            std::cerr << "Error: cannot allocate " << format_bytes(bytes) << " working set\n";
+            break;
+        }
+        LatencyPoint point;
+        point.bytes = bytes;
+        point.latency_ns = ns;
+        points.push_back(point);
+        std::cout << std::setw(14) << format_bytes(bytes)
+                  << std::fixed << std::setprecision(2) << std::setw(16) << ns << "\n";
+    }
+
+    MemoryKnee knees[MAX_KNEES];
+    int knee_count = membench_find_knees(points.data(), static_cast<int>(points.size()),
+                                         min_rise, knees, MAX_KNEES);
+
+    std::cout << "\nDetected hierarchy (knee = largest set before latency climbs)\n";
+    std::cout << std::left << std::setw(7) << "Level" << std::right << std::setw(14) << "Capacity"
+              << std::setw(14) << "Reported" << std::setw(16) << "Latency (ns)" << "\n";
+    std::cout << std::string(51, '-') << "\n";
+    for (int k = 0; k < knee_count; ++k) {
+        size_t reported = reported_capacity(k);
+        std::cout << std::left << std::setw(7) << knee_level(k) << std::right
+                  << std::setw(14) << format_bytes(knees[k].bytes)
+                  << std::setw(14) << (reported ? format_bytes(reported) : std::string("-"))
+                  << std::fixed << std::setprecision(2) << std::setw(16) << knees[k].before_ns << "\n";
+    }
+    if (!points.empty()) {
+        // Past the last knee the chase is served by memory
+        double memory_ns = knee_count > 0 ? knees[knee_count - 1].after_ns : points.back().latency_ns;
+        std::cout << std::left << std::setw(7) << "DRAM" << std::right << std::setw(14) << "-"
+                  << std::setw(14) << "-" << std::fixed << std::setprecision(2)
+                  << std::setw(16) << memory_ns << "\n";
+    }
+    if (!points.empty() && points.back().bytes <= l3_bytes) {
+        std::cout << "Note: largest working set does not exceed the reported L3; raise --max-mb "
+                     "to reach DRAM\n";
+    }
+
+    // ========================================================================
+    // Bandwidth
+    // ========================================================================
+    std::vector<BandwidthRecord> bandwidth;
+    std::cout << "\nSTREAM bandwidth (" << stream_mb << " MB per array, best of "
+              << iterations << ")\n";
+    std::cout << std::left << std::setw(8) << "Kernel" << std::right << std::setw(9) << "Threads"
+              << std::setw(12) << "GB/s" << "\n";
+    std::cout << std::string(29, '-') << "\n";
+    for (int k = 0; k < MEMBENCH_KERNEL_COUNT; ++k) {
+        MembenchKernel kernel = static_cast<MembenchKernel>(k);
+        for (int t : thread_counts) {
+            double gbs = membench_bandwidth_gbs(kernel, stream_mb << 20, t, iterations);
+            if (gbs < 0.0) {
+                std::cerr << "Error: cannot allocate " << stream_mb << " MB arrays\n";
+                return 1;
+            }
+            BandwidthRecord record = {kernel, t, gbs};
+            bandwidth.push_back(record);
+            std::cout << std::left << std::setw(8) << membench_kernel_name(kernel) << std::right
+                      << std::setw(9) << t << std::fixed << std::setprecision(2)
+                      << std::setw(12) << gbs << "\n";
+        }
+    }
+
+    // ========================================================================
+    // Results
+    // ========================================================================
+    std::ofstream file(output_file);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open " << output_file << " for writing\n";
+        return 1;
+    }
+    write_system_record(file);
+    file << std::setprecision(6);
+    for (const LatencyPoint& p : points) {
+        file << "{\"record\":\"latency\",\"bytes\":" << p.bytes
+             << ",\"latency_ns\":" << p.latency_ns << "}\n";
+    }
+    for (int k = 0; k < knee_count; ++k) {
+        file << "{\"record\":\"knee\",\"level\":\"" << knee_level(k) << "\""
+             << ",\"bytes\":" << knees[k].bytes << ",\"reported_bytes\":" << reported_capacity(k)
+             << ",\"before_ns\":" << knees[k].before_ns << ",\"after_ns\":" << knees[k].after_ns << "}\n";
+    }
+    for (const BandwidthRecord& b : bandwidth) {
+        file << "{\"record\":\"bandwidth\",\"kernel\":\"" << membench_kernel_name(b.kernel) << "\""
+             << ",\"threads\":" << b.threads << ",\"bytes_per_array\":" << (stream_mb << 20)
+             << ",\"gbs\":" << b.gbs << "}\n";
+    }
+    file.close();
+    if (file.fail()) return 1;
+    std::cout << "Results saved to " << output_file << "\n";
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include "out_of_core.h"
+#include "matrix_io.h"
+#include "gemm.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct OperandFile {
+    int fd = -1;
+    MatrixFileInfo info;
+};
+
+bool read_full(int fd, void* buf, size_t bytes, off_t offset) {
+    char* p = static_cast<char*>(buf);
+    while (bytes > 0) {
+        ssize_t n = pread(fd, p, bytes, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+bool write_full(int fd, const void* buf, size_t bytes, off_t offset) {
+    const char* p = static_cast<const char*>(buf);
+    while (bytes > 0) {
+        ssize_t n = pwrite(fd, p, bytes, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+// Open an operand that can be read in place: row-major float64
+bool open_operand(const char* path, OperandFile* f) {
+    if (matrix_file_info(path, &f->info) != 0) return false;
+    if (f->info.dtype != MATRIX_DTYPE_F64 || f->info.layout != MATRIX_LAYOUT_ROW_MAJOR) return false;
+    f->fd = open(path, O_RDONLY);
+    return f->fd >= 0;
+}
+
+off_t element_offset(const MatrixFileInfo& info, int row, int col) {
+    return static_cast<off_t>(info.data_offset +
+                              (static_cast<size_t>(row) * info.ld + static_cast<size_t>(col)) * sizeof(double));
+}
+
+// Rows [row, row + rows) x columns [col, col + cols) into dst (ld = cols);
+// one pread per row, so panels should be wide enough to amortise the calls
+bool read_block(const OperandFile& f, int row, int rows, int col, int cols, double* dst) {
+    size_t row_bytes = static_cast<size_t>(cols) * sizeof(double);
+    for (int r = 0; r < rows; ++r) {
+        if (!read_full(f.fd, dst + static_cast<size_t>(r) * cols, row_bytes,
+                       element_offset(f.info, row + r, col))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool write_block(int fd, const MatrixFileInfo& info, int row, int rows, int col, int cols,
+                 const double* src) {
+    size_t row_bytes = static_cast<size_t>(cols) * sizeof(double);
+    for (int r = 0; r < rows; ++r) {
+        if (!write_full(fd, src + static_cast<size_t>(r) * cols, row_bytes,
+                        element_offset(info, row + r, col))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Largest tile edge T whose buffers fit the budget: each panel buffer holds
+// an A and a B panel (2 T^2 doubles), plus one C tile (T^2)
+int tile_for_budget(size_t budget, int buffers) {
+    double per_element = static_cast<double>((2 * buffers + 1) * sizeof(double));
+    int tile = static_cast<int>(std::sqrt(static_cast<double>(budget) / per_element));
+    if (tile >= 16) tile -= tile % 8;  // keep panel rows a multiple of the kernel blocks
+    return tile;
+}
+
+// Panel pair t in (i, j, k) order: C tile (i, j), depth step k
+struct Panel {
+    int row, rows;      // rows of A / C
+    int col, cols;      // columns of B / C
+    int depth, depths;  // columns of A / rows of B
+};
+
+struct PanelGrid {
+    int M, N, P, tile;
+    long long tiles_j, tiles_k;
+
+    long long count(long long tiles_i) const { return tiles_i * tiles_j * tiles_k; }
+
+    Panel at(long long t) const {
+        Panel p;
+        p.row = static_cast<int>(t / (tiles_j * tiles_k)) * tile;
+        p.col = static_cast<int>((t / tiles_k) % tiles_j) * tile;
+        p.depth = static_cast<int>(t % tiles_k) * tile;
+        p.rows = std::min(tile, M - p.row);
+        p.cols = std::min(tile, P - p.col);
+        p.depths = std::min(tile, N - p.depth);
+        return p;
+    }
+};
+
+struct PanelBuffer {
+    std::vector<double> a;
+    std::vector<double> b;
+    bool full = false;
+};
+
+}  // namespace
+
+extern "C" OocOptions ooc_default_options(void) {
+    OocOptions options;
+    options.memory_budget = OOC_DEFAULT_BUDGET;
+    options.tile = 0;
+    options.double_buffer = 1;
+    options.block_size = 0;
+    return options;
+}
+
+extern "C" int matrix_multiply_out_of_core(const char* a_path, const char* b_path, const char* c_path,
+                                           const OocOptions* options, OocStats* stats,
+                                           Profiler* profiler) {
+    if (!a_path || !b_path || !c_path) return -1;
+
+    OocOptions opts = options ? *options : ooc_default_options();
+    if (opts.memory_budget == 0) opts.memory_budget = OOC_DEFAULT_BUDGET;
+    int buffers = opts.double_buffer ? 2 : 1;
+
+    OocStats result = {};
+    double total_start = get_time_ms();
+
+    OperandFile a_file, b_file;
+    int c_fd = -1;
+    MatrixFileInfo c_info;
+    int status = -1;
+
+    if (open_operand(a_path, &a_file) && open_operand(b_path, &b_file) &&
+        a_file.info.cols == b_file.info.rows) {
+        const int M = a_file.info.rows;
+        const int N = a_file.info.cols;
+        const int P = b_file.info.cols;
+
+        int tile = opts.tile > 0 ? opts.tile : tile_for_budget(opts.memory_budget, buffers);
+        tile = std::min(tile, std::max(std::max(M, N), std::max(P, 1)));
+        result.tile = tile;
+
+        // The output payload starts out sparse (zeros), which is already the
+        // right answer when there is nothing to multiply
+        if (tile > 0 && matrix_file_create(c_path, M, P, MATRIX_FORMAT_AUTO, &c_info) == 0) {
+            c_fd = open(c_path, O_WRONLY);
+        }
+        if (c_fd >= 0 && (M == 0 || N == 0 || P == 0)) status = 0;
+
+        if (c_fd >= 0 && status != 0) {
+            PanelGrid grid = {M, N, P, tile, (P + tile - 1) / tile, (N + tile - 1) / tile};
+            const long long panels = grid.count((M + tile - 1) / tile);
+            const size_t panel_elems = static_cast<size_t>(tile) * tile;
+
+            PanelBuffer slots[2];
+            for (int s = 0; s < buffers; ++s) {
+                slots[s].a.resize(panel_elems);
+                slots[s].b.resize(panel_elems);
+            }
+            std::vector<double> c_tile(panel_elems);
+
+            std::mutex mutex;
+            std::condition_variable ready;
+            bool failed = false;
+
+            auto load = [&](const Panel& p, PanelBuffer& slot) {
+                return read_block(a_file, p.row, p.rows, p.depth, p.depths, slot.a.data()) &&
+                       read_block(b_file, p.depth, p.depths, p.col, p.cols, slot.b.data());
+            };
+
+            // Reader thread: fill slot t % 2 as soon as the kernel has released it
+            auto reader = [&]() {
+                for (long long t = 0; t < panels; ++t) {
+                    PanelBuffer& slot = slots[t % 2];
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [&]() { return !slot.full || failed; });
+                        if (failed) return;
+                    }
+                    double start = get_time_ms();
+                    bool ok = load(grid.at(t), slot);
+                    double elapsed = get_time_ms() - start;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        result.read_ms += elapsed;
+                        if (ok) {
+                            slot.full = true;
+                        } else {
+                            failed = true;
+                        }
+                    }
+                    ready.notify_all();
+                    if (!ok) return;
+                }
+            };
+
+            std::thread reader_thread;
+            if (opts.double_buffer) reader_thread = std::thread(reader);
+
+            bool ok = true;
+            for (long long t = 0; t < panels && ok; ++t) {
+                Panel p = grid.at(t);
+                PanelBuffer& slot = slots[opts.double_buffer ? t % 2 : 0];
+
+                double wait_start = get_time_ms();
+                if (opts.double_buffer) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&]() { return slot.full || failed; });
+                    ok = slot.full;
+                } else {
+                    ok = load(p, slot);
+                    result.read_ms += get_time_ms() - wait_start;
+                }
+                result.wait_ms += get_time_ms() - wait_start;
+                if (!ok) break;
+
+                double compute_start = get_time_ms();
+                MatrixView a_view = {slot.a.data(), p.rows, p.depths, p.depths};
+                MatrixView b_view = {slot.b.data(), p.depths, p.cols, p.cols};
+                MatrixView c_view = {c_tile.data(), p.rows, p.cols, p.cols};
+                matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &a_view, &b_view,
+                            p.depth == 0 ? 0.0 : 1.0, &c_view, opts.block_size);
+                result.compute_ms += get_time_ms() - compute_start;
+
+                if (opts.double_buffer) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        slot.full = false;
+                    }
+                    ready.notify_all();
+                }
+
+                // Last depth step: the C tile is final
+                if (p.depth + p.depths == N) {
+                    double write_start = get_time_ms();
+                    ok = write_block(c_fd, c_info, p.row, p.rows, p.col, p.cols, c_tile.data());
+                    result.write_ms += get_time_ms() - write_start;
+                    result.bytes_written += static_cast<size_t>(p.rows) * p.cols * sizeof(double);
+                }
+                result.bytes_read += (static_cast<size_t>(p.rows) + p.cols) * p.depths * sizeof(double);
+                result.panels++;
+            }
+
+            if (reader_thread.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!ok) failed = true;
+                }
+                ready.notify_all();
+                reader_thread.join();
+            }
+            if (ok && !failed) status = 0;
+        }
+    }
+
+    if (a_file.fd >= 0) close(a_file.fd);
+    if (b_file.fd >= 0) close(b_file.fd);
+    if (c_fd >= 0 && close(c_fd) != 0) status = -1;
+
+    result.total_ms = get_time_ms() - total_start;
+    double hidden = std::max(0.0, result.read_ms - result.wait_ms);
+    result.overlap = result.read_ms > 0.0 ? hidden / result.read_ms : 0.0;
+
+    if (profiler) {
+        profiler_record(profiler, "ooc_total", result.total_ms);
+        profiler_record(profiler, "ooc_read", result.read_ms);
+        profiler_record(profiler, "ooc_compute", result.compute_ms);
+        profiler_record(profiler, "ooc_wait", result.wait_ms);
+        profiler_record(profiler, "ooc_write", result.write_ms);
+        profiler_record(profiler, "ooc_read_hidden", hidden);
+    }
+    if (stats) *stats = result;
+    return status;
+}
@@ -0,0 +1,107 @@
+// syscall() is not declared under the strict _POSIX_C_SOURCE of the build
+#define _DEFAULT_SOURCE
+
+#include "perf_counters.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Generic hardware cache event: cache | (op << 8) | (result << 16)
+static uint64_t cache_event(uint64_t cache) {
+    return cache | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int perf_counters_open(PerfCounters* pc) {
+    if (!pc) return 0;
+    pc->fds[PERF_COUNTER_CACHE_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    pc->fds[PERF_COUNTER_L1D_MISSES] = open_counter(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D));
+    pc->fds[PERF_COUNTER_DTLB_MISSES] = open_counter(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB));
+
+    int available = 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (pc->fds[i] >= 0) available++;
+    }
+    return available;
+}
+
+void perf_counters_start(PerfCounters* pc) {
+    if (!pc) return;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perf_counters_stop(PerfCounters* pc, uint64_t* values) {
+    if (!pc) return;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        uint64_t value = 0;
+        if (pc->fds[i] >= 0) {
+            ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(pc->fds[i], &value, sizeof(value)) != (ssize_t)sizeof(value)) value = 0;
+        }
+        if (values) values[i] = value;
+    }
+}
+
+void perf_counters_close(PerfCounters* pc) {
+    if (!pc) return;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+        pc->fds[i] = -1;
+    }
+}
+
+#else
+
+int perf_counters_open(PerfCounters* pc) {
+    if (!pc) return 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) pc->fds[i] = -1;
+    return 0;
+}
+
+void perf_counters_start(PerfCounters* pc) {
+    (void)pc;
+}
+
+void perf_counters_stop(PerfCounters* pc, uint64_t* values) {
+    (void)pc;
+    if (values) memset(values, 0, sizeof(uint64_t) * PERF_COUNTER_COUNT);
+}
+
+void perf_counters_close(PerfCounters* pc) {
+    (void)pc;
+}
+
+#endif
+
+int perf_counter_available(const PerfCounters* pc, PerfCounter counter) {
+    return pc && counter >= 0 && counter < PERF_COUNTER_COUNT && pc->fds[counter] >= 0;
+}
+
+const char* perf_counter_name(PerfCounter counter) {
+    switch (counter) {
+        case PERF_COUNTER_CACHE_MISSES: return "cache-misses";
+        case PERF_COUNTER_L1D_MISSES: return "L1d-misses";
+        case PERF_COUNTER_DTLB_MISSES: return "dTLB-misses";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,267 @@
+#include "pipelined.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUC__)
+#define PIPELINE_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define PIPELINE_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace {
+
+// Pack rows [kk, kk + depth) of B into tiles of depth x BLOCK columns; the
+// tile for column jj starts at panel + depth * jj and is dense row-major
+void pack_panel(const Matrix* B, int kk, int depth, int block, double* panel) {
+    const int P = B->cols;
+    const size_t b_stride = static_cast<size_t>(B->cols);
+    for (int jj = 0; jj < P; jj += block) {
+        int width = std::min(block, P - jj);
+        double* tile = panel + static_cast<size_t>(depth) * jj;
+        for (int k = 0; k < depth; ++k) {
+            const double* src = B->data + (kk + k) * b_stride + jj;
+            std::copy(src, src + width, tile + static_cast<size_t>(k) * width);
+        }
+    }
+}
+
+// Helper thread that packs panels 1 .. panels - 1 into the two buffers in
+// turn. A buffer is refilled once the kernel has released it, so the thread
+// runs at most one panel ahead; one thread serves the whole multiplication.
+class PackThread {
+public:
+    PackThread(const Matrix* B, int block, int panels, std::vector<double>* buffers)
+        : B_(B), block_(block), panels_(panels), buffers_(buffers), pack_ms_(0.0) {
+        ready_[0] = true;   // panel 0 is packed by the caller
+        ready_[1] = false;
+        panel_[0] = 0;
+        panel_[1] = -1;
+        thread_ = std::thread(&PackThread::run, this);
+    }
+
+    ~PackThread() {
+        if (thread_.joinable()) thread_.join();
+    }
+
+    // Block until panel p is packed; returns the time spent blocked
+    double wait_for(int p) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        int slot = p % 2;
+        if (ready_[slot] && panel_[slot] == p) return 0.0;
+        double start = get_time_ms();
+        cond_.wait(lock, [this, slot, p]() { return ready_[slot] && panel_[slot] == p; });
+        return get_time_ms() - start;
+    }
+
+    // The kernel is done with panel p; its buffer may be refilled
+    void release(int p) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_[p % 2] = false;
+        }
+        cond_.notify_all();
+    }
+
+    // Joins the thread; returns its total packing time
+    double finish() {
+        if (thread_.joinable()) thread_.join();
+        return pack_ms_;
+    }
+
+private:
+    PackThread(const PackThread&);
+    PackThread& operator=(const PackThread&);
+
+    void run() {
+        const int N = B_->rows;
+        for (int q = 1; q < panels_; ++q) {
+            int slot = q % 2;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this, slot]() { return !ready_[slot]; });
+            }
+            int kk = q * block_;
+            double start = get_time_ms();
+            pack_panel(B_, kk, std::min(block_, N - kk), block_, buffers_[slot].data());
+            pack_ms_ += get_time_ms() - start;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_[slot] = true;
+                panel_[slot] = q;
+            }
+            cond_.notify_all();
+        }
+    }
+
+    const Matrix* B_;
+    int block_;
+    int panels_;
+    std::vector<double>* buffers_;
+    double pack_ms_;            // written by the pack thread, read after join
+    bool ready_[2];
+    int panel_[2];
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread thread_;
+};
+
+struct PanelContext {
+    const Matrix* A;
+    Matrix* C;
+    int block;
+    int distance;
+    int line_doubles;   // doubles per cache line
+};
+
+// C[ii:i_max, :] += A[ii:i_max, kk:kk + depth] * panel, one packed tile at a time
+void multiply_panel(const PanelContext& ctx, const double* panel, int kk, int depth) {
+    const int M = ctx.A->rows;
+    const int P = ctx.C->cols;
+    const int block = ctx.block;
+    const size_t a_stride = static_cast<size_t>(ctx.A->cols);
+    const size_t c_stride = static_cast<size_t>(ctx.C->cols);
+    const double* a_data = ctx.A->data;
+    double* c_data = ctx.C->data;
+    const int tiles = (P + block - 1) / block;
+
+    for (int ii = 0; ii < M; ii += block) {
+        int i_max = std::min(M, ii + block);
+        int rows = i_max - ii;
+
+        for (int t = 0; t < tiles; ++t) {
+            int jj = t * block;
+            int width = std::min(block, P - jj);
+            const double* tile = panel + static_cast<size_t>(depth) * jj;
+
+            // Tile to prefetch; past the last tile, the row block restarts at tile 0
+            const double* ahead = nullptr;
+            size_t ahead_lines = 0;
+            if (ctx.distance > 0) {
+                int t_ahead = (t + ctx.distance) % tiles;
+                int jj_ahead = t_ahead * block;
+                ahead = panel + static_cast<size_t>(depth) * jj_ahead;
+                size_t elems = static_cast<size_t>(depth) * std::min(block, P - jj_ahead);
+                ahead_lines = (elems + ctx.line_doubles - 1) / ctx.line_doubles;
+            }
+
+            for (int i = ii; i < i_max; ++i) {
+                // Row r of the tile requests its share of the lines ahead
+                if (ahead) {
+                    size_t r = static_cast<size_t>(i - ii);
+                    size_t first = r * ahead_lines / rows;
+                    size_t last = (r + 1) * ahead_lines / rows;
+                    for (size_t line = first; line < last; ++line) {
+                        PIPELINE_PREFETCH(ahead + line * ctx.line_doubles);
+                    }
+                }
+
+                const double* a_row = a_data + i * a_stride + kk;
+                double* c_row = c_data + i * c_stride + jj;
+                for (int k = 0; k < depth; ++k) {
+                    double a_val = a_row[k];
+                    const double* b_row = tile + static_cast<size_t>(k) * width;
+                    for (int j = 0; j < width; ++j) {
+                        c_row[j] += a_val * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+extern "C" PipelineOptions pipeline_default_options(void) {
+    PipelineOptions options;
+    options.block_size = 0;
+    options.prefetch_distance = PIPELINE_DEFAULT_PREFETCH_DISTANCE;
+    options.pack_thread = 1;
+    return options;
+}
+
+extern "C" int matrix_multiply_pipelined(Matrix* A, Matrix* B, Matrix* C, const PipelineOptions* options,
+                                         PipelineStats* stats, Profiler* profiler) {
+    if (!A || !B || !C) return -1;
+    if (A->cols != B->rows) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+
+    PipelineOptions opts = options ? *options : pipeline_default_options();
+    const int N = A->cols;
+    const int P = B->cols;
+    const int block = opts.block_size > 0 ? opts.block_size : get_optimal_block_size();
+
+    PipelineStats result = {};
+    double total_start = get_time_ms();
+
+    matrix_zeros(C);
+
+    // Two panel buffers: one being multiplied, one being packed
+    size_t panel_elems = static_cast<size_t>(std::min(block, N)) * static_cast<size_t>(P);
+    std::vector<double> buffers[2];
+    if (N > 0 && P > 0 && C->rows > 0) {
+        buffers[0].resize(panel_elems);
+        if (opts.pack_thread) buffers[1].resize(panel_elems);
+
+        PanelContext ctx = {A, C, block, std::max(0, opts.prefetch_distance),
+                            std::max(1, get_cache_line_size() / static_cast<int>(sizeof(double)))};
+        const int panels = (N + block - 1) / block;
+        result.panels = panels;
+
+        if (opts.pack_thread) {
+            // Slot 1 starts free, so the thread packs panel 1 while the
+            // caller packs panel 0
+            PackThread packer(B, block, panels, buffers);
+            double start = get_time_ms();
+            pack_panel(B, 0, std::min(block, N), block, buffers[0].data());
+            result.pack_ms = get_time_ms() - start;
+            result.wait_ms = result.pack_ms;  // nothing to overlap the first panel with
+
+            for (int p = 0; p < panels; ++p) {
+                int kk = p * block;
+                result.wait_ms += packer.wait_for(p);
+
+                start = get_time_ms();
+                multiply_panel(ctx, buffers[p % 2].data(), kk, std::min(block, N - kk));
+                result.compute_ms += get_time_ms() - start;
+                packer.release(p);
+            }
+            result.pack_ms += packer.finish();
+        } else {
+            double start = get_time_ms();
+            pack_panel(B, 0, std::min(block, N), block, buffers[0].data());
+            result.pack_ms = get_time_ms() - start;
+            result.wait_ms = result.pack_ms;
+
+            for (int p = 0; p < panels; ++p) {
+                int kk = p * block;
+                start = get_time_ms();
+                multiply_panel(ctx, buffers[0].data(), kk, std::min(block, N - kk));
+                result.compute_ms += get_time_ms() - start;
+
+                int next_kk = kk + block;
+                if (next_kk < N) {
+                    // Serial pipeline: the next pack sits on the critical path
+                    start = get_time_ms();
+                    pack_panel(B, next_kk, std::min(block, N - next_kk), block, buffers[0].data());
+                    double elapsed = get_time_ms() - start;
+                    result.pack_ms += elapsed;
+                    result.wait_ms += elapsed;
+                }
+            }
+        }
+    }
+
+    result.total_ms = get_time_ms() - total_start;
+    if (profiler) {
+        profiler_record(profiler, "pipeline_total", result.total_ms);
+        profiler_record(profiler, "pipeline_pack", result.pack_ms);
+        profiler_record(profiler, "pipeline_wait", result.wait_ms);
+        profiler_record(profiler, "pipeline_compute", result.compute_ms);
+    }
+    if (stats) *stats = result;
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "prepared.h"
+#include "dot_kernel.h"
+#include "transpose.h"
+#include <stdlib.h>
+
+// B (N x P) is stored transposed, so both kernel operands are read along rows
+struct PreparedB {
+    int rows;       // N
+    int cols;       // P
+    double* bt;     // P x N, row-major
+};
+
+PreparedB* prepared_b_create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) return NULL;
+
+    PreparedB* prep = (PreparedB*)malloc(sizeof(PreparedB));
+    if (!prep) return NULL;
+
+    prep->rows = rows;
+    prep->cols = cols;
+    prep->bt = (double*)malloc((size_t)rows * (size_t)cols * sizeof(double));
+    if (!prep->bt) {
+        free(prep);
+        return NULL;
+    }
+    matrix_count_allocation((size_t)rows * (size_t)cols * sizeof(double));
+
+    return prep;
+}
+
+void prepared_b_free(PreparedB* prep) {
+    if (prep) {
+        free(prep->bt);
+        free(prep);
+    }
+}
+
+int prepared_b_rows(const PreparedB* prep) {
+    return prep ? prep->rows : 0;
+}
+
+int prepared_b_cols(const PreparedB* prep) {
+    return prep ? prep->cols : 0;
+}
+
+int prepared_b_pack_rows(PreparedB* prep, Matrix* B, int row_start, int row_end) {
+    if (!prep || !B) return -1;
+    if (B->rows != prep->rows || B->cols != prep->cols) return -1;
+
+    transpose_out_of_place_rows(B->data, B->rows, B->cols, B->cols, prep->bt, prep->rows,
+                                row_start, row_end);
+    return 0;
+}
+
+int prepared_b_pack(PreparedB* prep, Matrix* B) {
+    return prepared_b_pack_rows(prep, B, 0, B ? B->rows : 0);
+}
+
+PreparedB* matrix_prepare_b(Matrix* B) {
+    if (!B) return NULL;
+
+    PreparedB* prep = prepared_b_create(B->rows, B->cols);
+    if (!prep) return NULL;
+
+    prepared_b_pack(prep, B);
+    return prep;
+}
+
+int matrix_multiply_prepared_rows(Matrix* A, const PreparedB* B, Matrix* C,
+                                  int row_start, int row_end) {
+    if (!A || !B || !C) return -1;
+    if (A->cols != B->rows) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+
+    if (row_start < 0) row_start = 0;
+    if (row_end > A->rows) row_end = A->rows;
+
+    dot_kernel_rows(A->data, A->cols, B->bt, B->rows, C->data, C->cols,
+                    B->rows, B->cols, row_start, row_end);
+    return 0;
+}
+
+int matrix_multiply_prepared(Matrix* A, const PreparedB* B, Matrix* C) {
+    return matrix_multiply_prepared_rows(A, B, C, 0, A ? A->rows : 0);
+}
+
+// ============================================================================
+// LRU cache
+// ============================================================================
+
+typedef struct {
+    Matrix* matrix;             // identity: NULL marks a free slot
+    const double* data;
+    int rows;
+    int cols;
+    unsigned long version;
+    unsigned long last_used;    // cache tick of the latest hit or fill
+    PreparedB* prepared;
+} PreparedCacheEntry;
+
+struct PreparedCache {
+    PreparedCacheEntry* entries;
+    int capacity;
+    unsigned long tick;
+    unsigned long hits;
+    unsigned long misses;
+};
+
+PreparedCache* prepared_cache_create(int capacity) {
+    if (capacity <= 0) return NULL;
+
+    PreparedCache* cache = (PreparedCache*)malloc(sizeof(PreparedCache));
+    if (!cache) return NULL;
+
+    cache->entries = (PreparedCacheEntry*)calloc((size_t)capacity, sizeof(PreparedCacheEntry));
+    if (!cache->entries) {
+        free(cache);
+        return NULL;
+    }
+    cache->capacity = capacity;
+    cache->tick = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+
+    return cache;
+}
+
+static void entry_release(PreparedCacheEntry* entry) {
+    prepared_b_free(entry->prepared);
+    entry->prepared = NULL;
+    entry->matrix = NULL;
+}
+
+void prepared_cache_clear(PreparedCache* cache) {
+    if (!cache) return;
+    for (int e = 0; e < cache->capacity; e++) {
+        entry_release(&cache->entries[e]);
+    }
+}
+
+void prepared_cache_free(PreparedCache* cache) {
+    if (cache) {
+        prepared_cache_clear(cache);
+        free(cache->entries);
+        free(cache);
+    }
+}
+
+void prepared_cache_invalidate(PreparedCache* cache, Matrix* B) {
+    if (!cache || !B) return;
+    for (int e = 0; e < cache->capacity; e++) {
+        if (cache->entries[e].matrix == B) entry_release(&cache->entries[e]);
+    }
+}
+
+const PreparedB* prepared_cache_get(PreparedCache* cache, Matrix* B, unsigned long version) {
+    if (!cache || !B) return NULL;
+
+    cache->tick++;
+
+    // One pass: exact hit, a stale entry of the same matrix, or a victim slot
+    PreparedCacheEntry* stale = NULL;
+    PreparedCacheEntry* victim = NULL;
+    for (int e = 0; e < cache->capacity; e++) {
+        PreparedCacheEntry* entry = &cache->entries[e];
+        if (entry->matrix == B && entry->data == B->data &&
+            entry->rows == B->rows && entry->cols == B->cols) {
+            if (entry->version == version) {
+                entry->last_used = cache->tick;
+                cache->hits++;
+                return entry->prepared;
+            }
+            stale = entry;
+        }
+        // Prefer a free slot, otherwise the least recently used one
+        if (!entry->matrix) {
+            if (!victim || victim->matrix) victim = entry;
+        } else if (!victim || (victim->matrix && entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+
+    cache->misses++;
+
+    // A new version of a cached matrix is re-packed into its existing buffer
+    PreparedCacheEntry* slot = stale ? stale : victim;
+    if (!stale) {
+        entry_release(slot);
+        slot->prepared = prepared_b_create(B->rows, B->cols);
+        if (!slot->prepared) return NULL;
+    }
+    prepared_b_pack(slot->prepared, B);
+
+    slot->matrix = B;
+    slot->data = B->data;
+    slot->rows = B->rows;
+    slot->cols = B->cols;
+    slot->version = version;
+    slot->last_used = cache->tick;
+    return slot->prepared;
+}
+
+void prepared_cache_stats(const PreparedCache* cache, unsigned long* hits, unsigned long* misses) {
+    if (hits) *hits = cache ? cache->hits : 0;
+    if (misses) *misses = cache ? cache->misses : 0;
+}
@@ -1,41 +1,74 @@
 #include "profiler.h"
+#include "matrix.h"
+#include "sampler.h"
 #include <math.h>
+#include <sys/resource.h>
 
 void profiler_init(Profiler* p) {
     p->count = 0;
     for (int i = 0; i < MAX_PROFILE_POINTS; i++) {
         p->points[i].active = 0;
         p->points[i].elapsed_ms = 0.0;
+        p->points[i].sample_count = 0;
+        memset(&p->points[i].usage, 0, sizeof(ProfileUsage));
     }
 }
 
-void profiler_start(Profiler* p, const char* name) {
-    // Find existing or create new profile point
-    int idx = -1;
+static void add_sample(ProfilePoint* point, double elapsed_ms) {
+    point->elapsed_ms += elapsed_ms;
+    if (point->sample_count < MAX_PROFILE_SAMPLES) {
+        point->samples[point->sample_count++] = elapsed_ms;
+    }
+}
+
+// Find existing or create new profile point; -1 when the table is full
+static int find_or_add_point(Profiler* p, const char* name) {
     for (int i = 0; i < p->count; i++) {
         if (strcmp(p->points[i].name, name) == 0) {
-            idx = i;
-            break;
+            return i;
         }
     }
     
-    if (idx == -1) {
-        if (p->count >= MAX_PROFILE_POINTS) {
-            fprintf(stderr, "Error: Too many profile points\n");
-            return;
-        }
-        idx = p->count++;
-        strncpy(p->points[idx].name, name, MAX_NAME_LEN - 1);
-        p->points[idx].name[MAX_NAME_LEN - 1] = '\0';
+    if (p->count >= MAX_PROFILE_POINTS) {
+        fprintf(stderr, "Error: Too many profile points\n");
+        return -1;
+    }
+    int idx = p->count++;
+    strncpy(p->points[idx].name, name, MAX_NAME_LEN - 1);
+    p->points[idx].name[MAX_NAME_LEN - 1] = '\0';
+    return idx;
+}
+
+void profiler_start(Profiler* p, const char* name) {
+    int idx = find_or_add_point(p, name);
+    if (idx == -1) return;
+    
+    // Sections do not nest with themselves; a second start would also push
+    // a sampler scope that the single profiler_end never pops
+    if (p->points[idx].active) {
+        fprintf(stderr, "Warning: Profile point '%s' is already active\n", name);
+        return;
     }
     
+    // Counters first, so reading them is not part of the timed section
+    sampler_push_scope(name);
+    profiler_read_usage(&p->points[idx].start_usage);
     clock_gettime(CLOCK_MONOTONIC, &p->points[idx].start_time);
     p->points[idx].active = 1;
 }
 
+void profiler_record(Profiler* p, const char* name, double elapsed_ms) {
+    int idx = find_or_add_point(p, name);
+    if (idx == -1) return;
+    
+    add_sample(&p->points[idx], elapsed_ms);
+}
+
 void profiler_end(Profiler* p, const char* name) {
     struct timespec end_time;
     clock_gettime(CLOCK_MONOTONIC, &end_time);
+    ProfileUsage end_usage;
+    profiler_read_usage(&end_usage);
     
     for (int i = 0; i < p->count; i++) {
         if (strcmp(p->points[i].name, name) == 0 && p->points[i].active) {
@@ -46,8 +79,15 @@ void profiler_end(Profiler* p, const char* name) {
             double end_ms = end_time.tv_sec * 1000.0 + 
                            end_time.tv_nsec / 1000000.0;
             
-            p->points[i].elapsed_ms += (end_ms - start_ms);
+            add_sample(&p->points[i], end_ms - start_ms);
+            ProfileUsage* usage = &p->points[i].usage;
+            const ProfileUsage* start = &p->points[i].start_usage;
+            usage->minor_faults += end_usage.minor_faults - start->minor_faults;
+            usage->major_faults += end_usage.major_faults - start->major_faults;
+            usage->peak_rss_kb += end_usage.peak_rss_kb - start->peak_rss_kb;
+            usage->alloc_bytes += end_usage.alloc_bytes - start->alloc_bytes;
             p->points[i].active = 0;
+            sampler_pop_scope(name);
             return;
         }
     }
@@ -56,21 +96,30 @@ void profiler_end(Profiler* p, const char* name) {
 }
 
 void profiler_print_results(Profiler* p) {
-    printf("\n========================================\n");
-    printf("         PROFILING RESULTS              \n");
-    printf("========================================\n");
-    printf("%-30s %15s\n", "Section", "Time (ms)");
-    printf("----------------------------------------\n");
+    printf("\n====================================================================================================\n");
+    printf("%*s\n", 58, "PROFILING RESULTS");
+    printf("====================================================================================================\n");
+    printf("%-30s %15s %12s %12s %14s %12s\n", "Section", "Time (ms)", "Minor flt", "Major flt",
+           "Peak RSS +KB", "Alloc (MB)");
+    printf("----------------------------------------------------------------------------------------------------\n");
     
     double total = 0.0;
+    ProfileUsage sum = {0, 0, 0, 0};
     for (int i = 0; i < p->count; i++) {
-        printf("%-30s %15.4f\n", p->points[i].name, p->points[i].elapsed_ms);
+        const ProfileUsage* u = &p->points[i].usage;
+        printf("%-30s %15.4f %12ld %12ld %14ld %12.2f\n", p->points[i].name, p->points[i].elapsed_ms,
+               u->minor_faults, u->major_faults, u->peak_rss_kb, u->alloc_bytes / (1024.0 * 1024.0));
         total += p->points[i].elapsed_ms;
+        sum.minor_faults += u->minor_faults;
+        sum.major_faults += u->major_faults;
+        sum.peak_rss_kb += u->peak_rss_kb;
+        sum.alloc_bytes += u->alloc_bytes;
     }
     
-    printf("----------------------------------------\n");
-    printf("%-30s %15.4f\n", "TOTAL", total);
-    printf("========================================\n");
+    printf("----------------------------------------------------------------------------------------------------\n");
+    printf("%-30s %15.4f %12ld %12ld %14ld %12.2f\n", "TOTAL", total, sum.minor_faults, sum.major_faults,
+           sum.peak_rss_kb, sum.alloc_bytes / (1024.0 * 1024.0));
+    printf("====================================================================================================\n");
 }
 
 void profiler_save_results(Profiler* p, const char* filename) {
@@ -80,9 +129,11 @@ void profiler_save_results(Profiler* p, const char* filename) {
         return;
     }
     
-    fprintf(fp, "section,time_ms\n");
+    fprintf(fp, "section,time_ms,minor_faults,major_faults,peak_rss_delta_kb,alloc_bytes\n");
     for (int i = 0; i < p->count; i++) {
-        fprintf(fp, "%s,%.6f\n", p->points[i].name, p->points[i].elapsed_ms);
+        const ProfileUsage* u = &p->points[i].usage;
+        fprintf(fp, "%s,%.6f,%ld,%ld,%ld,%zu\n", p->points[i].name, p->points[i].elapsed_ms,
+                u->minor_faults, u->major_faults, u->peak_rss_kb, u->alloc_bytes);
     }
     
     fclose(fp);
@@ -94,3 +145,14 @@ double get_time_ms(void) {
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
 }
+
+void profiler_read_usage(ProfileUsage* usage) {
+    struct rusage ru;
+    memset(usage, 0, sizeof(ProfileUsage));
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+        usage->minor_faults = ru.ru_minflt;
+        usage->major_faults = ru.ru_majflt;
+        usage->peak_rss_kb = ru.ru_maxrss;  // kilobytes on Linux
+    }
+    usage->alloc_bytes = matrix_allocated_bytes();
+}
@@ -0,0 +1,586 @@
+#include "quantized.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define QGEMM_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define QGEMM_HAVE_X86 0
+#endif
+
+// Packed B layout: panels of QGEMM_NR columns; inside a panel the k dimension
+// is split into groups of QGEMM_KG8 (int8) or QGEMM_KG16 (int16) consecutive
+// values stored per column, so one 32-byte load feeds 8 int32 accumulators.
+#define QGEMM_NR 8
+#define QGEMM_KG8 4
+#define QGEMM_KG16 2
+
+QMatrix* qmatrix_create(int rows, int cols, QuantType type) {
+    if (rows <= 0 || cols <= 0) return NULL;
+    if (type != QUANT_INT8 && type != QUANT_INT16) return NULL;
+
+    QMatrix* q = (QMatrix*)malloc(sizeof(QMatrix));
+    if (!q) return NULL;
+
+    size_t elem = (type == QUANT_INT8) ? sizeof(int8_t) : sizeof(int16_t);
+    q->rows = rows;
+    q->cols = cols;
+    q->type = type;
+    q->scale = 1.0;
+    q->zero_point = 0;
+    q->data = calloc((size_t)rows * (size_t)cols, elem);
+
+    if (!q->data) {
+        free(q);
+        return NULL;
+    }
+
+    return q;
+}
+
+void qmatrix_free(QMatrix* q) {
+    if (q) {
+        free(q->data);
+        free(q);
+    }
+}
+
+static void quant_range(QuantType type, int* qmin, int* qmax) {
+    if (type == QUANT_INT8) {
+        *qmin = -128;
+        *qmax = 127;
+    } else {
+        // -32768 is excluded so that a pair of int16 products always fits
+        // in the int32 lanes produced by pmaddwd
+        *qmin = -32767;
+        *qmax = 32767;
+    }
+}
+
+int quantize_params(Matrix* m, QuantType type, double* scale, int* zero_point) {
+    if (!m || !scale || !zero_point) return -1;
+    if (type != QUANT_INT8 && type != QUANT_INT16) return -1;
+
+    int qmin, qmax;
+    quant_range(type, &qmin, &qmax);
+
+    double lo = 0.0;
+    double hi = 0.0;
+    size_t count = (size_t)m->rows * (size_t)m->cols;
+    for (size_t i = 0; i < count; i++) {
+        if (m->data[i] < lo) lo = m->data[i];
+        if (m->data[i] > hi) hi = m->data[i];
+    }
+
+    double s = (hi - lo) / (double)(qmax - qmin);
+    if (s <= 0.0) s = 1.0;
+
+    long zp = lround((double)qmin - lo / s);
+    if (zp < qmin) zp = qmin;
+    if (zp > qmax) zp = qmax;
+
+    *scale = s;
+    *zero_point = (int)zp;
+    return 0;
+}
+
+int matrix_quantize(Matrix* m, QMatrix* q) {
+    if (!m || !q) return -1;
+    if (m->rows != q->rows || m->cols != q->cols) return -1;
+
+    double scale;
+    int zp;
+    if (quantize_params(m, q->type, &scale, &zp) != 0) return -1;
+
+    int qmin, qmax;
+    quant_range(q->type, &qmin, &qmax);
+
+    q->scale = scale;
+    q->zero_point = zp;
+
+    double inv_scale = 1.0 / scale;
+    size_t count = (size_t)m->rows * (size_t)m->cols;
+    for (size_t i = 0; i < count; i++) {
+        long v = lround(m->data[i] * inv_scale) + zp;
+        if (v < qmin) v = qmin;
+        if (v > qmax) v = qmax;
+        if (q->type == QUANT_INT8) {
+            ((int8_t*)q->data)[i] = (int8_t)v;
+        } else {
+            ((int16_t*)q->data)[i] = (int16_t)v;
+        }
+    }
+
+    return 0;
+}
+
+int matrix_dequantize(QMatrix* q, Matrix* m) {
+    if (!m || !q) return -1;
+    if (m->rows != q->rows || m->cols != q->cols) return -1;
+
+    size_t count = (size_t)m->rows * (size_t)m->cols;
+    for (size_t i = 0; i < count; i++) {
+        int v = (q->type == QUANT_INT8) ? ((int8_t*)q->data)[i] : ((int16_t*)q->data)[i];
+        m->data[i] = q->scale * (double)(v - q->zero_point);
+    }
+
+    return 0;
+}
+
+// ============================================================================
+// Path selection
+// ============================================================================
+
+static QGemmPath forced_path = QGEMM_PATH_AUTO;
+
+static int path_supported(QGemmPath path) {
+    switch (path) {
+        case QGEMM_PATH_PORTABLE:
+            return 1;
+#if QGEMM_HAVE_X86
+        case QGEMM_PATH_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case QGEMM_PATH_VNNI:
+            return __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("avx512vnni") &&
+                   __builtin_cpu_supports("avx512vl");
+#endif
+        default:
+            return 0;
+    }
+}
+
+static QGemmPath detect_path(void) {
+    if (path_supported(QGEMM_PATH_VNNI)) return QGEMM_PATH_VNNI;
+    if (path_supported(QGEMM_PATH_AVX2)) return QGEMM_PATH_AVX2;
+    return QGEMM_PATH_PORTABLE;
+}
+
+QGemmPath qgemm_select_path(QGemmPath path) {
+    forced_path = path;
+    return qgemm_active_path();
+}
+
+QGemmPath qgemm_active_path(void) {
+    if (forced_path == QGEMM_PATH_AUTO) return detect_path();
+
+    // Fall back one level at a time to the best supported path
+    QGemmPath path = forced_path;
+    while (path != QGEMM_PATH_PORTABLE && !path_supported(path)) {
+        path = (QGemmPath)(path - 1);
+    }
+    return path;
+}
+
+const char* qgemm_path_name(QGemmPath path) {
+    switch (path) {
+        case QGEMM_PATH_AUTO: return "auto";
+        case QGEMM_PATH_PORTABLE: return "portable";
+        case QGEMM_PATH_AVX2: return "avx2";
+        case QGEMM_PATH_VNNI: return "vnni";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Micro-kernels: one row of packed A against one packed B panel
+// ============================================================================
+
+// acc[c] += sum over groups g, t of a[g*4 + t] * b[g*32 + c*4 + t]
+static void kernel_int8_portable(const int8_t* a, const int8_t* b, int groups, int32_t* acc) {
+    for (int g = 0; g < groups; g++) {
+        const int8_t* ag = a + g * QGEMM_KG8;
+        const int8_t* bg = b + g * QGEMM_KG8 * QGEMM_NR;
+        for (int c = 0; c < QGEMM_NR; c++) {
+            int32_t s = 0;
+            for (int t = 0; t < QGEMM_KG8; t++) {
+                s += (int32_t)ag[t] * (int32_t)bg[c * QGEMM_KG8 + t];
+            }
+            acc[c] += s;
+        }
+    }
+}
+
+// acc[c] += sum over groups g, t of a[g*2 + t] * b[g*16 + c*2 + t]
+static void kernel_int16_portable(const int16_t* a, const int16_t* b, int groups, int64_t* acc) {
+    for (int g = 0; g < groups; g++) {
+        const int16_t* ag = a + g * QGEMM_KG16;
+        const int16_t* bg = b + g * QGEMM_KG16 * QGEMM_NR;
+        for (int c = 0; c < QGEMM_NR; c++) {
+            acc[c] += (int64_t)ag[0] * bg[c * 2] + (int64_t)ag[1] * bg[c * 2 + 1];
+        }
+    }
+}
+
+#if QGEMM_HAVE_X86
+// pmaddubsw saturates its int16 pair sums for full-range int8 operands, so
+// the AVX2 path sign-extends to int16 and uses the exact pmaddwd instead.
+__attribute__((target("avx2")))
+static void kernel_int8_avx2(const int8_t* a, const int8_t* b, int groups, int32_t* acc) {
+    __m256i acc_lo = _mm256_setzero_si256();  // columns 0..3, two partial sums each
+    __m256i acc_hi = _mm256_setzero_si256();  // columns 4..7
+
+    for (int g = 0; g < groups; g++) {
+        const int8_t* ag = a + g * QGEMM_KG8;
+        uint64_t pattern = (uint64_t)(uint16_t)ag[0] |
+                           ((uint64_t)(uint16_t)ag[1] << 16) |
+                           ((uint64_t)(uint16_t)ag[2] << 32) |
+                           ((uint64_t)(uint16_t)ag[3] << 48);
+        __m256i av = _mm256_set1_epi64x((long long)pattern);
+
+        __m256i bv = _mm256_loadu_si256((const __m256i*)(b + g * QGEMM_KG8 * QGEMM_NR));
+        __m256i b_lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(bv));
+        __m256i b_hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(bv, 1));
+
+        acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(b_lo, av));
+        acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(b_hi, av));
+    }
+
+    // hadd yields columns [0 1 4 5 | 2 3 6 7]; restore the natural order
+    __m256i sums = _mm256_hadd_epi32(acc_lo, acc_hi);
+    sums = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 1, 2, 0));
+
+    __m256i prev = _mm256_loadu_si256((const __m256i*)acc);
+    _mm256_storeu_si256((__m256i*)acc, _mm256_add_epi32(prev, sums));
+}
+
+// a holds A + 128 as unsigned bytes; the caller removes 128 * colsum(B)
+__attribute__((target("avx2,avx512vnni,avx512vl")))
+static void kernel_int8_vnni(const int8_t* a, const int8_t* b, int groups, int32_t* acc) {
+    __m256i sum = _mm256_loadu_si256((const __m256i*)acc);
+
+    for (int g = 0; g < groups; g++) {
+        int32_t word;
+        memcpy(&word, a + g * QGEMM_KG8, sizeof(word));
+        __m256i av = _mm256_set1_epi32(word);
+        __m256i bv = _mm256_loadu_si256((const __m256i*)(b + g * QGEMM_KG8 * QGEMM_NR));
+        sum = _mm256_dpbusd_epi32(sum, av, bv);
+    }
+
+    _mm256_storeu_si256((__m256i*)acc, sum);
+}
+
+__attribute__((target("avx2")))
+static void kernel_int16_avx2(const int16_t* a, const int16_t* b, int groups, int64_t* acc) {
+    __m256i acc_lo = _mm256_loadu_si256((const __m256i*)acc);        // columns 0..3
+    __m256i acc_hi = _mm256_loadu_si256((const __m256i*)(acc + 4));  // columns 4..7
+
+    for (int g = 0; g < groups; g++) {
+        const int16_t* ag = a + g * QGEMM_KG16;
+        uint32_t pair = (uint32_t)(uint16_t)ag[0] | ((uint32_t)(uint16_t)ag[1] << 16);
+        __m256i av = _mm256_set1_epi32((int)pair);
+        __m256i bv = _mm256_loadu_si256((const __m256i*)(b + g * QGEMM_KG16 * QGEMM_NR));
+
+        // Each pair sum fits in int32; widen before accumulating across k
+        __m256i prod = _mm256_madd_epi16(bv, av);
+        acc_lo = _mm256_add_epi64(acc_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(prod)));
+        acc_hi = _mm256_add_epi64(acc_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(prod, 1)));
+    }
+
+    _mm256_storeu_si256((__m256i*)acc, acc_lo);
+    _mm256_storeu_si256((__m256i*)(acc + 4), acc_hi);
+}
+#endif
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+static int round_up(int value, int multiple) {
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+// Copy A (M x N) into rows of Kp elements, zero padded.
+// With offset_u8 the int8 values are stored biased by +128 (for vpdpbusd).
+static void* pack_a(QMatrix* A, int Kp, int offset_u8) {
+    size_t elem = (A->type == QUANT_INT8) ? 1 : 2;
+    unsigned char* packed = (unsigned char*)calloc((size_t)A->rows * (size_t)Kp, elem);
+    if (!packed) return NULL;
+
+    for (int i = 0; i < A->rows; i++) {
+        const unsigned char* src = (const unsigned char*)A->data + (size_t)i * A->cols * elem;
+        unsigned char* dst = packed + (size_t)i * Kp * elem;
+        memcpy(dst, src, (size_t)A->cols * elem);
+        if (offset_u8) {
+            for (int k = 0; k < A->cols; k++) {
+                dst[k] ^= 0x80;
+            }
+        }
+    }
+
+    return packed;
+}
+
+// Reorder B (N x P) into column panels of QGEMM_NR with k grouped by kg
+static void* pack_b(QMatrix* B, int Kp, int Pp, int kg) {
+    size_t elem = (B->type == QUANT_INT8) ? 1 : 2;
+    unsigned char* packed = (unsigned char*)calloc((size_t)Kp * (size_t)Pp, elem);
+    if (!packed) return NULL;
+
+    int groups = Kp / kg;
+    for (int k = 0; k < B->rows; k++) {
+        int g = k / kg;
+        int t = k % kg;
+        for (int j = 0; j < B->cols; j++) {
+            int panel = j / QGEMM_NR;
+            int c = j % QGEMM_NR;
+            size_t dst = (((size_t)panel * groups + g) * QGEMM_NR + c) * kg + t;
+            if (elem == 1) {
+                packed[dst] = ((const unsigned char*)B->data)[(size_t)k * B->cols + j];
+            } else {
+                ((int16_t*)packed)[dst] = ((const int16_t*)B->data)[(size_t)k * B->cols + j];
+            }
+        }
+    }
+
+    return packed;
+}
+
+static int validate(QMatrix* A, QMatrix* B, QuantType type) {
+    if (!A || !B) return -1;
+    if (A->type != type || B->type != type) return -1;
+    if (A->cols != B->rows) return -1;
+    return 0;
+}
+
+// Apply zero-point corrections: (a - za)(b - zb) summed over k expands to
+// S - zb*rowsum(A) - za*colsum(B) + K*za*zb
+static void zero_point_terms(QMatrix* A, QMatrix* B, int64_t* row_sum, int64_t* col_sum) {
+    int K = A->cols;
+    for (int i = 0; i < A->rows; i++) {
+        int64_t s = 0;
+        for (int k = 0; k < K; k++) {
+            s += (A->type == QUANT_INT8) ? ((int8_t*)A->data)[(size_t)i * K + k]
+                                         : ((int16_t*)A->data)[(size_t)i * K + k];
+        }
+        row_sum[i] = s;
+    }
+    for (int j = 0; j < B->cols; j++) {
+        col_sum[j] = 0;
+    }
+    for (int k = 0; k < K; k++) {
+        for (int j = 0; j < B->cols; j++) {
+            col_sum[j] += (B->type == QUANT_INT8) ? ((int8_t*)B->data)[(size_t)k * B->cols + j]
+                                                  : ((int16_t*)B->data)[(size_t)k * B->cols + j];
+        }
+    }
+}
+
+// ============================================================================
+// Blocked integer GEMM
+// ============================================================================
+
+// Shared by the int32 and int64 entry points: exactly one of C32 / C64 is
+// set. Each kk panel is summed in int32 by the kernels (at most KB terms of
+// 255 * 128), then added to the output in the output's width.
+static int multiply_int8(QMatrix* A, QMatrix* B, int32_t* C32, int64_t* C64, int block_size) {
+
+    int M = A->rows;
+    int N = A->cols;
+    int P = B->cols;
+    int Kp = round_up(N, QGEMM_KG8);
+    int Pp = round_up(P, QGEMM_NR);
+    int groups_total = Kp / QGEMM_KG8;
+
+    int BLOCK = (block_size > 0) ? block_size : get_optimal_block_size();
+    int KB = round_up(BLOCK, QGEMM_KG8);
+    int JB = round_up(BLOCK, QGEMM_NR);
+
+    QGemmPath path = qgemm_active_path();
+    void (*kernel)(const int8_t*, const int8_t*, int, int32_t*) = kernel_int8_portable;
+#if QGEMM_HAVE_X86
+    if (path == QGEMM_PATH_VNNI) kernel = kernel_int8_vnni;
+    else if (path == QGEMM_PATH_AVX2) kernel = kernel_int8_avx2;
+#endif
+
+    int8_t* a_pack = (int8_t*)pack_a(A, Kp, path == QGEMM_PATH_VNNI);
+    int8_t* b_pack = (int8_t*)pack_b(B, Kp, Pp, QGEMM_KG8);
+    int64_t* row_sum = (int64_t*)malloc(sizeof(int64_t) * (size_t)M);
+    int64_t* col_sum = (int64_t*)malloc(sizeof(int64_t) * (size_t)P);
+    if (!a_pack || !b_pack || !row_sum || !col_sum) {
+        free(a_pack);
+        free(b_pack);
+        free(row_sum);
+        free(col_sum);
+        return -1;
+    }
+
+    if (C64) memset(C64, 0, sizeof(int64_t) * (size_t)M * (size_t)P);
+    else memset(C32, 0, sizeof(int32_t) * (size_t)M * (size_t)P);
+
+    // Same ii / kk / jj tiling as matrix_multiply_blocked; the innermost
+    // unit is one row against one packed panel of QGEMM_NR columns.
+    for (int ii = 0; ii < M; ii += BLOCK) {
+        int i_max = (ii + BLOCK < M) ? ii + BLOCK : M;
+
+        for (int kk = 0; kk < Kp; kk += KB) {
+            int k_max = (kk + KB < Kp) ? kk + KB : Kp;
+            int groups = (k_max - kk) / QGEMM_KG8;
+
+            for (int jj = 0; jj < Pp; jj += JB) {
+                int j_max = (jj + JB < Pp) ? jj + JB : Pp;
+
+                for (int i = ii; i < i_max; i++) {
+                    const int8_t* a_row = a_pack + (size_t)i * Kp + kk;
+                    size_t c_row = (size_t)i * P;
+
+                    for (int j = jj; j < j_max; j += QGEMM_NR) {
+                        const int8_t* panel = b_pack +
+                            ((size_t)(j / QGEMM_NR) * groups_total + kk / QGEMM_KG8) *
+                            QGEMM_KG8 * QGEMM_NR;
+                        int32_t acc[QGEMM_NR] = {0};
+                        kernel(a_row, panel, groups, acc);
+
+                        int cols = (P - j < QGEMM_NR) ? P - j : QGEMM_NR;
+                        if (C64) {
+                            for (int c = 0; c < cols; c++) C64[c_row + j + c] += acc[c];
+                        } else {
+                            for (int c = 0; c < cols; c++) C32[c_row + j + c] += acc[c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    zero_point_terms(A, B, row_sum, col_sum);
+    int64_t za = A->zero_point;
+    int64_t zb = B->zero_point;
+    // vpdpbusd saw A + 128; remove the 128 * colsum(B) bias as well
+    int64_t bias = (path == QGEMM_PATH_VNNI) ? 128 : 0;
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < P; j++) {
+            size_t idx = (size_t)i * P + j;
+            int64_t v = C64 ? C64[idx] : (int64_t)C32[idx];
+            v -= bias * col_sum[j];
+            v += -zb * row_sum[i] - za * col_sum[j] + (int64_t)N * za * zb;
+            if (C64) C64[idx] = v;
+            else C32[idx] = (int32_t)v;
+        }
+    }
+
+    free(a_pack);
+    free(b_pack);
+    free(row_sum);
+    free(col_sum);
+    return 0;
+}
+
+int qmatrix_multiply_int8(QMatrix* A, QMatrix* B, int32_t* C, int block_size) {
+    if (validate(A, B, QUANT_INT8) != 0 || !C) return -1;
+    if (A->cols > QGEMM_INT8_MAX_K) return -1;
+    return multiply_int8(A, B, C, NULL, block_size);
+}
+
+int qmatrix_multiply_int8_wide(QMatrix* A, QMatrix* B, int64_t* C, int block_size) {
+    if (validate(A, B, QUANT_INT8) != 0 || !C) return -1;
+    return multiply_int8(A, B, NULL, C, block_size);
+}
+
+int qmatrix_multiply_int16(QMatrix* A, QMatrix* B, int64_t* C, int block_size) {
+    if (validate(A, B, QUANT_INT16) != 0 || !C) return -1;
+
+    int M = A->rows;
+    int N = A->cols;
+    int P = B->cols;
+    int Kp = round_up(N, QGEMM_KG16);
+    int Pp = round_up(P, QGEMM_NR);
+    int groups_total = Kp / QGEMM_KG16;
+
+    int BLOCK = (block_size > 0) ? block_size : get_optimal_block_size();
+    int KB = round_up(BLOCK, QGEMM_KG16);
+    int JB = round_up(BLOCK, QGEMM_NR);
+
+    void (*kernel)(const int16_t*, const int16_t*, int, int64_t*) = kernel_int16_portable;
+#if QGEMM_HAVE_X86
+    if (qgemm_active_path() != QGEMM_PATH_PORTABLE) kernel = kernel_int16_avx2;
+#endif
+
+    int16_t* a_pack = (int16_t*)pack_a(A, Kp, 0);
+    int16_t* b_pack = (int16_t*)pack_b(B, Kp, Pp, QGEMM_KG16);
+    int64_t* row_sum = (int64_t*)malloc(sizeof(int64_t) * (size_t)M);
+    int64_t* col_sum = (int64_t*)malloc(sizeof(int64_t) * (size_t)P);
+    if (!a_pack || !b_pack || !row_sum || !col_sum) {
+        free(a_pack);
+        free(b_pack);
+        free(row_sum);
+        free(col_sum);
+        return -1;
+    }
+
+    memset(C, 0, sizeof(int64_t) * (size_t)M * (size_t)P);
+
+    for (int ii = 0; ii < M; ii += BLOCK) {
+        int i_max = (ii + BLOCK < M) ? ii + BLOCK : M;
+
+        for (int kk = 0; kk < Kp; kk += KB) {
+            int k_max = (kk + KB < Kp) ? kk + KB : Kp;
+            int groups = (k_max - kk) / QGEMM_KG16;
+
+            for (int jj = 0; jj < Pp; jj += JB) {
+                int j_max = (jj + JB < Pp) ? jj + JB : Pp;
+
+                for (int i = ii; i < i_max; i++) {
+                    const int16_t* a_row = a_pack + (size_t)i * Kp + kk;
+                    int64_t* c_row = C + (size_t)i * P;
+
+                    for (int j = jj; j < j_max; j += QGEMM_NR) {
+                        const int16_t* panel = b_pack +
+                            ((size_t)(j / QGEMM_NR) * groups_total + kk / QGEMM_KG16) *
+                            QGEMM_KG16 * QGEMM_NR;
+                        int64_t acc[QGEMM_NR] = {0};
+                        kernel(a_row, panel, groups, acc);
+
+                        int cols = (P - j < QGEMM_NR) ? P - j : QGEMM_NR;
+                        for (int c = 0; c < cols; c++) {
+                            c_row[j + c] += acc[c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    zero_point_terms(A, B, row_sum, col_sum);
+    int64_t za = A->zero_point;
+    int64_t zb = B->zero_point;
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < P; j++) {
+            C[(size_t)i * P + j] += -zb * row_sum[i] - za * col_sum[j] + (int64_t)N * za * zb;
+        }
+    }
+
+    free(a_pack);
+    free(b_pack);
+    free(row_sum);
+    free(col_sum);
+    return 0;
+}
+
+int qmatrix_multiply(QMatrix* A, QMatrix* B, Matrix* C, int block_size) {
+    if (!A || !B || !C) return -1;
+    if (A->type != B->type) return -1;
+    if (C->rows != A->rows || C->cols != B->cols) return -1;
+
+    size_t count = (size_t)C->rows * (size_t)C->cols;
+    double scale = A->scale * B->scale;
+
+    // int64 accumulators for both types, so no inner dimension overflows
+    int64_t* acc = (int64_t*)malloc(sizeof(int64_t) * count);
+    if (!acc) return -1;
+    int result = (A->type == QUANT_INT8) ? qmatrix_multiply_int8_wide(A, B, acc, block_size)
+                                         : qmatrix_multiply_int16(A, B, acc, block_size);
+    if (result != 0) {
+        free(acc);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        C->data[i] = scale * (double)acc[i];
+    }
+    free(acc);
+
+    return 0;
+}
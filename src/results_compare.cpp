@@ -0,0 +1,236 @@
+#include "results_compare.h"
+#include "results_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// Minimal readers for the flat records results_store.c writes. Values
+// are looked up by key; run records nest the environment, whose keys do
+// not clash with the ones read here.
+
+// Position just after "key": or npos
+size_t find_value(const std::string& line, const char* key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = line.find(pattern);
+    return pos == std::string::npos ? pos : pos + pattern.size();
+}
+
+bool read_string(const std::string& line, const char* key, std::string& out) {
+    size_t pos = find_value(line, key);
+    if (pos == std::string::npos || pos >= line.size() || line[pos] != '"') return false;
+    out.clear();
+    for (size_t i = pos + 1; i < line.size(); ++i) {
+        if (line[i] == '\\' && i + 1 < line.size()) {
+            out += line[++i];
+        } else if (line[i] == '"') {
+            return true;
+        } else {
+            out += line[i];
+        }
+    }
+    return false;
+}
+
+bool read_int(const std::string& line, const char* key, int& out) {
+    size_t pos = find_value(line, key);
+    if (pos == std::string::npos) return false;
+    char* end = nullptr;
+    long value = std::strtol(line.c_str() + pos, &end, 10);
+    if (end == line.c_str() + pos) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool read_numbers(const std::string& line, const char* key, std::vector<double>& out) {
+    size_t pos = find_value(line, key);
+    if (pos == std::string::npos || pos >= line.size() || line[pos] != '[') return false;
+    out.clear();
+    const char* p = line.c_str() + pos + 1;
+    while (*p && *p != ']') {
+        char* end = nullptr;
+        double value = std::strtod(p, &end);
+        if (end == p) return false;
+        out.push_back(value);
+        p = end;
+        if (*p == ',') ++p;
+    }
+    return *p == ']';
+}
+
+// Number of arrangements of n a's and m b's with each U value, for the
+// exact null distribution: count(n, m, u) = count(n - 1, m, u - m) + count(n, m - 1, u)
+std::vector<double> u_distribution(int n, int m) {
+    const int max_u = n * m;
+    // table[i][j] for the current i, built up row by row
+    std::vector<std::vector<double>> prev(static_cast<size_t>(m) + 1), cur(static_cast<size_t>(m) + 1);
+    for (int j = 0; j <= m; ++j) prev[j].assign(1, 1.0);  // i = 0: U = 0 only
+    for (int i = 1; i <= n; ++i) {
+        cur[0].assign(1, 1.0);  // j = 0: U = 0 only
+        for (int j = 1; j <= m; ++j) {
+            std::vector<double>& c = cur[j];
+            c.assign(static_cast<size_t>(i * j) + 1, 0.0);
+            // An a placed last beats all j b's
+            for (size_t u = 0; u < prev[j].size(); ++u) c[u + j] += prev[j][u];
+            for (size_t u = 0; u < cur[j - 1].size(); ++u) c[u] += cur[j - 1][u];
+        }
+        std::swap(prev, cur);
+    }
+    std::vector<double> counts = prev[m];
+    counts.resize(static_cast<size_t>(max_u) + 1, 0.0);
+    return counts;
+}
+
+}  // namespace
+
+int load_results_runs(const char* filename, std::vector<ResultsRun>& runs) {
+    runs.clear();
+    std::ifstream file(filename);
+    if (!file.is_open()) return -1;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string record;
+        if (!read_string(line, "record", record)) continue;
+
+        if (record == "run") {
+            ResultsRun run;
+            read_string(line, "run_id", run.run_id);
+            read_string(line, "tool", run.tool);
+            read_string(line, "time", run.time);
+            runs.push_back(run);
+        } else if (record == "result") {
+            std::string run_id;
+            ResultSeries series;
+            if (!read_string(line, "run_id", run_id) || !read_string(line, "kernel", series.kernel) ||
+                !read_int(line, "size", series.size) || !read_int(line, "threads", series.threads) ||
+                !read_numbers(line, "samples_ms", series.samples_ms)) {
+                continue;
+            }
+
+            // Attach to its run; repeated series (same size run twice) are merged
+            auto run = std::find_if(runs.rbegin(), runs.rend(),
+                                    [&](const ResultsRun& r) { return r.run_id == run_id; });
+            if (run == runs.rend()) continue;
+            auto existing = std::find_if(run->series.begin(), run->series.end(), [&](const ResultSeries& s) {
+                return s.kernel == series.kernel && s.size == series.size && s.threads == series.threads;
+            });
+            if (existing != run->series.end()) {
+                existing->samples_ms.insert(existing->samples_ms.end(), series.samples_ms.begin(),
+                                            series.samples_ms.end());
+            } else {
+                run->series.push_back(series);
+            }
+        }
+    }
+    return static_cast<int>(runs.size());
+}
+
+double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b, double* u) {
+    const size_t n = a.size();
+    const size_t m = b.size();
+    if (u) *u = 0.0;
+    if (n == 0 || m == 0) return 1.0;
+
+    // Average ranks over the pooled samples
+    std::vector<std::pair<double, int>> pooled;
+    pooled.reserve(n + m);
+    for (double x : a) pooled.push_back({x, 0});
+    for (double x : b) pooled.push_back({x, 1});
+    std::sort(pooled.begin(), pooled.end());
+
+    double rank_sum_a = 0.0;
+    double tie_term = 0.0;  // sum of t^3 - t over tie groups
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+        double rank = 0.5 * static_cast<double>(i + 1 + j);  // mean of ranks i+1 .. j
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second == 0) rank_sum_a += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+
+    const double nd = static_cast<double>(n);
+    const double md = static_cast<double>(m);
+    const double u_a = rank_sum_a - nd * (nd + 1.0) / 2.0;
+    if (u) *u = u_a;
+
+    if (tie_term == 0.0 && n * m <= 400) {
+        std::vector<double> counts = u_distribution(static_cast<int>(n), static_cast<int>(m));
+        double total = 0.0, lower = 0.0, upper = 0.0;
+        const int observed = static_cast<int>(std::lround(u_a));
+        for (size_t v = 0; v < counts.size(); ++v) {
+            total += counts[v];
+            if (static_cast<int>(v) <= observed) lower += counts[v];
+            if (static_cast<int>(v) >= observed) upper += counts[v];
+        }
+        return std::min(1.0, 2.0 * std::min(lower, upper) / total);
+    }
+
+    const double N = nd + md;
+    const double mean = nd * md / 2.0;
+    const double variance = nd * md / 12.0 * ((N + 1.0) - tie_term / (N * (N - 1.0)));
+    if (variance <= 0.0) return 1.0;
+    // Continuity correction
+    const double z = std::max(0.0, std::fabs(u_a - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+double mann_whitney_min_p(int n, int m) {
+    if (n <= 0 || m <= 0) return 1.0;
+    std::vector<double> a(static_cast<size_t>(n)), b(static_cast<size_t>(m));
+    for (int i = 0; i < n; ++i) a[static_cast<size_t>(i)] = i;
+    for (int j = 0; j < m; ++j) b[static_cast<size_t>(j)] = n + j;
+    return mann_whitney_p(a, b);
+}
+
+int compare_results_runs(const ResultsRun& baseline, const ResultsRun& candidate, double threshold,
+                         double alpha, std::vector<ResultComparison>& comparisons) {
+    comparisons.clear();
+    int regressions = 0;
+
+    for (const ResultSeries& base : baseline.series) {
+        auto match = std::find_if(candidate.series.begin(), candidate.series.end(), [&](const ResultSeries& s) {
+            return s.kernel == base.kernel && s.size == base.size && s.threads == base.threads;
+        });
+        if (match == candidate.series.end()) continue;
+
+        ResultComparison c;
+        c.kernel = base.kernel;
+        c.size = base.size;
+        c.threads = base.threads;
+        c.baseline_count = static_cast<int>(base.samples_ms.size());
+        c.candidate_count = static_cast<int>(match->samples_ms.size());
+        c.baseline_median_ms = results_median(base.samples_ms.data(), c.baseline_count);
+        c.candidate_median_ms = results_median(match->samples_ms.data(), c.candidate_count);
+        c.change = c.baseline_median_ms > 0.0 ? c.candidate_median_ms / c.baseline_median_ms - 1.0 : 0.0;
+        c.p_value = mann_whitney_p(base.samples_ms, match->samples_ms);
+        c.min_p_value = mann_whitney_min_p(c.baseline_count, c.candidate_count);
+
+        c.verdict = COMPARE_SAME;
+        if (c.p_value < alpha && c.change > threshold) {
+            c.verdict = COMPARE_SLOWER;
+            ++regressions;
+        } else if (c.p_value < alpha && c.change < -threshold) {
+            c.verdict = COMPARE_FASTER;
+        }
+        comparisons.push_back(c);
+    }
+    return regressions;
+}
+
+const char* compare_verdict_name(CompareVerdict verdict) {
+    switch (verdict) {
+        case COMPARE_SAME: return "same";
+        case COMPARE_FASTER: return "faster";
+        case COMPARE_SLOWER: return "slower";
+    }
+    return "unknown";
+}
@@ -0,0 +1,110 @@
+#include "results_store.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Kernel names are written inside JSON strings; profiler labels and the
+// drivers' method names never need escaping, but keep the output valid
+static void write_name(FILE* fp, const char* name) {
+    for (const char* c = name; *c; c++) {
+        if (*c != '"' && *c != '\\' && (unsigned char)*c >= 0x20) fputc(*c, fp);
+    }
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double results_median(const double* samples, int count) {
+    if (!samples || count <= 0) return 0.0;
+    double* sorted = (double*)malloc((size_t)count * sizeof(double));
+    if (!sorted) return 0.0;
+    memcpy(sorted, samples, (size_t)count * sizeof(double));
+    qsort(sorted, (size_t)count, sizeof(double), compare_doubles);
+    double median = (count % 2) ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+    free(sorted);
+    return median;
+}
+
+int results_store_open(ResultsStore* store, const char* filename, const char* tool,
+                       const BenchEnvironment* env) {
+    if (!store || !filename) return -1;
+    store->fp = fopen(filename, "a");
+    if (!store->fp) {
+        fprintf(stderr, "Error: Cannot open %s for writing\n", filename);
+        return -1;
+    }
+
+    // Run id: start time and pid, unique enough for runs sharing a file
+    time_t now = time(NULL);
+    struct tm utc = *gmtime(&now);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", &utc);
+    snprintf(store->run_id, sizeof(store->run_id), "%s-%ld", stamp, (long)getpid());
+
+    char iso[32];
+    strftime(iso, sizeof(iso), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    fprintf(store->fp, "{\"record\":\"run\",\"run_id\":\"%s\",\"tool\":\"", store->run_id);
+    write_name(store->fp, tool ? tool : "unknown");
+    fprintf(store->fp, "\",\"time\":\"%s\"", iso);
+    if (env) {
+        fprintf(store->fp, ",\"environment\":");
+        environment_write_json(env, store->fp, 1);
+    }
+    fprintf(store->fp, "}\n");
+    return 0;
+}
+
+int results_store_add(ResultsStore* store, const char* kernel, int size, int threads,
+                      const double* samples_ms, int count) {
+    if (!store || !store->fp || !kernel || !samples_ms || count <= 0) return -1;
+
+    fprintf(store->fp, "{\"record\":\"result\",\"run_id\":\"%s\",\"kernel\":\"", store->run_id);
+    write_name(store->fp, kernel);
+    fprintf(store->fp, "\",\"size\":%d,\"threads\":%d,\"samples_ms\":[", size, threads);
+    for (int i = 0; i < count; i++) {
+        fprintf(store->fp, "%s%.6f", i ? "," : "", samples_ms[i]);
+    }
+    fprintf(store->fp, "],\"median_ms\":%.6f}\n", results_median(samples_ms, count));
+    return 0;
+}
+
+int results_store_add_profiler(ResultsStore* store, const Profiler* profiler) {
+    if (!store || !profiler) return -1;
+
+    int written = 0;
+    for (int i = 0; i < profiler->count; i++) {
+        const ProfilePoint* point = &profiler->points[i];
+        if (point->sample_count == 0) continue;
+
+        // Split "<kernel>_<N>x<N>" and an optional "_t<T>" at the end of the kernel
+        char kernel[MAX_NAME_LEN];
+        snprintf(kernel, sizeof(kernel), "%s", point->name);
+        int size = 0;
+        int threads = 1;
+        char* sep = strrchr(kernel, '_');
+        int rows = 0, cols = 0;
+        char tail;
+        if (sep && sscanf(sep + 1, "%dx%d%c", &rows, &cols, &tail) == 2 && rows == cols) {
+            size = rows;
+            *sep = '\0';
+            sep = strrchr(kernel, '_');
+            int t = 0;
+            if (sep && sscanf(sep + 1, "t%d%c", &t, &tail) == 1 && t > 0) threads = t;
+        }
+
+        if (results_store_add(store, kernel, size, threads, point->samples, point->sample_count) == 0) {
+            written++;
+        }
+    }
+    return written;
+}
+
+void results_store_close(ResultsStore* store) {
+    if (!store || !store->fp) return;
+    fclose(store->fp);
+    store->fp = NULL;
+}
@@ -0,0 +1,770 @@
+// dl_iterate_phdr, RTLD_DEFAULT and the ucontext register names need _GNU_SOURCE
+#define _GNU_SOURCE
+
+#include "sampler.h"
+#include "profiler.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLER_MAX_SCOPES 128
+#define NO_SCOPE (-1)
+// Once the other slots are taken, new scope names share this last slot
+#define OTHER_SCOPE (SAMPLER_MAX_SCOPES - 1)
+// Largest distance from the interrupted stack pointer a frame may lie at
+// (the default thread stack size)
+#define SAMPLER_STACK_LIMIT ((uintptr_t)8 << 20)
+
+typedef struct {
+    void* ip;                               // interrupted instruction
+    void* callers[SAMPLER_MAX_FRAMES];      // return addresses, innermost first
+    int caller_count;
+    int scope_depth;
+    short scopes[SAMPLER_MAX_SCOPE_DEPTH];  // scope ids, outermost first
+} Sample;
+
+// Profile buffer; slots are claimed by the signal handler with an atomic
+// counter, so any thread can be interrupted at any time
+static Sample* samples = NULL;
+static int capacity = 0;
+static int sample_count = 0;
+static int sample_hz = 0;
+static int next_slot = 0;
+static int dropped = 0;
+static int collecting = 0;
+static int in_flight = 0;   // handlers between their collecting check and return
+
+// Open scopes. Only the thread driving the profiler changes them; the
+// handler reads the ids on whatever thread it interrupts.
+static char scope_names[SAMPLER_MAX_SCOPES][MAX_NAME_LEN];
+static int scope_name_count = 0;
+static volatile short scope_stack[SAMPLER_MAX_SCOPE_DEPTH];
+static int scope_depth = 0;  // may exceed SAMPLER_MAX_SCOPE_DEPTH
+
+static int find_scope(const char* name) {
+    for (int i = 0; i < scope_name_count; i++) {
+        if (strcmp(scope_names[i], name) == 0) return i;
+    }
+    return NO_SCOPE;
+}
+
+// Id of a scope name; names beyond the table map to OTHER_SCOPE, so every
+// push stores a real id and its pop finds it again
+static int scope_id(const char* name, int add) {
+    int id = find_scope(name);
+    if (id != NO_SCOPE) return id;
+    if (scope_name_count == SAMPLER_MAX_SCOPES) return OTHER_SCOPE;
+    if (!add) return NO_SCOPE;
+    if (scope_name_count == OTHER_SCOPE) {
+        strcpy(scope_names[OTHER_SCOPE], "(other)");
+        scope_name_count = SAMPLER_MAX_SCOPES;
+        return OTHER_SCOPE;
+    }
+    id = scope_name_count++;
+    strncpy(scope_names[id], name, MAX_NAME_LEN - 1);
+    scope_names[id][MAX_NAME_LEN - 1] = '\0';
+    return id;
+}
+
+void sampler_push_scope(const char* name) {
+    if (!name || !__atomic_load_n(&collecting, __ATOMIC_RELAXED)) return;
+    int id = scope_id(name, 1);
+    int depth = scope_depth;
+    if (depth < SAMPLER_MAX_SCOPE_DEPTH) scope_stack[depth] = (short)id;
+    __atomic_store_n(&scope_depth, depth + 1, __ATOMIC_RELEASE);
+}
+
+void sampler_pop_scope(const char* name) {
+    if (!name || !__atomic_load_n(&collecting, __ATOMIC_RELAXED)) return;
+    int id = scope_id(name, 0);
+    if (id == NO_SCOPE) return;
+    // Close the innermost scope with this name and anything left open in it
+    int depth = scope_depth < SAMPLER_MAX_SCOPE_DEPTH ? scope_depth : SAMPLER_MAX_SCOPE_DEPTH;
+    for (int i = depth - 1; i >= 0; i--) {
+        if (scope_stack[i] == id) {
+            __atomic_store_n(&scope_depth, i, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+    if (scope_depth > SAMPLER_MAX_SCOPE_DEPTH) {
+        __atomic_store_n(&scope_depth, scope_depth - 1, __ATOMIC_RELEASE);
+    }
+}
+
+int sampler_running(void) {
+    return __atomic_load_n(&collecting, __ATOMIC_RELAXED);
+}
+
+int sampler_sample_count(void) {
+    return sample_count;
+}
+
+int sampler_dropped_count(void) {
+    return dropped;
+}
+
+void sampler_clear(void) {
+    if (sampler_running()) return;
+    free(samples);
+    samples = NULL;
+    capacity = 0;
+    sample_count = 0;
+    next_slot = 0;
+    dropped = 0;
+    scope_name_count = 0;
+}
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <elf.h>
+#include <errno.h>
+#include <link.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+// Interrupted instruction, stack pointer and frame pointer
+static void context_registers(void* context, uintptr_t* ip, uintptr_t* sp, uintptr_t* fp) {
+    const ucontext_t* uc = (const ucontext_t*)context;
+#if defined(__x86_64__)
+    *ip = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+    *sp = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+    *fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+#elif defined(__i386__)
+    *ip = (uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+    *sp = (uintptr_t)uc->uc_mcontext.gregs[REG_ESP];
+    *fp = (uintptr_t)uc->uc_mcontext.gregs[REG_EBP];
+#elif defined(__aarch64__)
+    *ip = (uintptr_t)uc->uc_mcontext.pc;
+    *sp = (uintptr_t)uc->uc_mcontext.sp;
+    *fp = (uintptr_t)uc->uc_mcontext.regs[29];
+#else
+    (void)uc;
+    *ip = *sp = *fp = 0;
+#endif
+}
+
+// Follow the frame-pointer chain from the interrupted context. Every frame
+// record is {previous frame pointer, return address}; a record is only
+// read while it lies above sp, within SAMPLER_STACK_LIMIT of it, aligned,
+// and above the previous record, so a register that does not hold a frame
+// pointer ends the walk instead of leaving the stack.
+static int walk_frames(uintptr_t sp, uintptr_t fp, void** callers, int max) {
+    int count = 0;
+    uintptr_t lowest = sp;
+    while (count < max && fp >= lowest && fp - sp < SAMPLER_STACK_LIMIT &&
+           fp % sizeof(void*) == 0) {
+        const uintptr_t* record = (const uintptr_t*)fp;
+        uintptr_t next = record[0];
+        uintptr_t ret = record[1];
+        if (ret == 0) break;
+        callers[count++] = (void*)ret;
+        lowest = fp + 2 * sizeof(void*);
+        fp = next;
+    }
+    return count;
+}
+
+// Only async-signal-safe work: atomics, plain loads and stores, and a
+// frame-pointer walk bounded to the interrupted stack. Unlike backtrace(),
+// it never enters the unwinder, which can take the loader lock and
+// deadlock a thread interrupted inside dlopen, dl_iterate_phdr or C++
+// exception unwinding.
+static void on_sigprof(int sig, siginfo_t* info, void* context) {
+    (void)sig;
+    (void)info;
+    __atomic_fetch_add(&in_flight, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&collecting, __ATOMIC_SEQ_CST)) {
+        __atomic_fetch_sub(&in_flight, 1, __ATOMIC_SEQ_CST);
+        return;
+    }
+    int saved_errno = errno;
+
+    int slot = __atomic_fetch_add(&next_slot, 1, __ATOMIC_RELAXED);
+    if (slot >= capacity) {
+        __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        Sample* s = &samples[slot];
+        uintptr_t ip, sp, fp;
+        context_registers(context, &ip, &sp, &fp);
+        s->ip = (void*)ip;
+        s->caller_count = ip ? walk_frames(sp, fp, s->callers, SAMPLER_MAX_FRAMES) : 0;
+
+        int depth = __atomic_load_n(&scope_depth, __ATOMIC_ACQUIRE);
+        if (depth > SAMPLER_MAX_SCOPE_DEPTH) depth = SAMPLER_MAX_SCOPE_DEPTH;
+        for (int i = 0; i < depth; i++) s->scopes[i] = scope_stack[i];
+        s->scope_depth = depth;
+    }
+
+    errno = saved_errno;
+    __atomic_fetch_sub(&in_flight, 1, __ATOMIC_SEQ_CST);
+}
+
+int sampler_start(int hz, int max_samples) {
+    static int handler_installed = 0;
+    if (sampler_running() || hz < 0 || max_samples < 0) return -1;
+    if (hz == 0) hz = SAMPLER_DEFAULT_HZ;
+    if (max_samples == 0) max_samples = SAMPLER_DEFAULT_MAX_SAMPLES;
+
+    sampler_clear();
+    samples = (Sample*)calloc((size_t)max_samples, sizeof(Sample));
+    if (!samples) return -1;
+    capacity = max_samples;
+
+    // Installed once and left in place: a SIGPROF still pending when the
+    // timer is disarmed would otherwise kill the process
+    if (!handler_installed) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = on_sigprof;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, NULL) != 0) {
+            sampler_clear();
+            return -1;
+        }
+        handler_installed = 1;
+    }
+
+    sample_hz = hz;
+    scope_depth = 0;
+    __atomic_store_n(&collecting, 1, __ATOMIC_SEQ_CST);
+
+    long interval_us = 1000000L / hz;
+    struct itimerval timer;
+    timer.it_interval.tv_sec = interval_us / 1000000L;
+    timer.it_interval.tv_usec = interval_us > 0 ? interval_us % 1000000L : 1;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        __atomic_store_n(&collecting, 0, __ATOMIC_SEQ_CST);
+        sampler_clear();
+        return -1;
+    }
+    return 0;
+}
+
+int sampler_stop(void) {
+    if (!sampler_running()) return -1;
+
+    struct itimerval off;
+    memset(&off, 0, sizeof(off));
+    setitimer(ITIMER_PROF, &off, NULL);
+
+    // Let handlers already past their check finish their sample
+    __atomic_store_n(&collecting, 0, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&in_flight, __ATOMIC_SEQ_CST) > 0) {
+    }
+    sample_count = next_slot < capacity ? next_slot : capacity;
+    return sample_count;
+}
+
+// ============================================================================
+// Symbols: function symbols of every loaded ELF object, read from its file
+// ============================================================================
+
+typedef struct {
+    uintptr_t start;    // run-time address
+    uintptr_t end;      // start + size (== start for symbols without a size)
+    const char* name;
+} Symbol;
+
+typedef struct {
+    char path[512];
+    uintptr_t bias;     // run-time address minus link-time address
+    uintptr_t lo;       // run-time range of its loadable segments
+    uintptr_t hi;
+    int loaded;
+    Symbol* symbols;    // sorted by start
+    int symbol_count;
+    char* strings;      // string table the names point into
+} Module;
+
+typedef struct {
+    Module* modules;
+    int count;
+} ModuleList;
+
+static int add_module(struct dl_phdr_info* info, size_t size, void* data) {
+    (void)size;
+    ModuleList* list = (ModuleList*)data;
+    uintptr_t lo = UINTPTR_MAX, hi = 0;
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr)* ph = &info->dlpi_phdr[i];
+        if (ph->p_type != PT_LOAD) continue;
+        uintptr_t start = info->dlpi_addr + ph->p_vaddr;
+        if (start < lo) lo = start;
+        if (start + ph->p_memsz > hi) hi = start + ph->p_memsz;
+    }
+    if (hi == 0) return 0;
+
+    Module* grown = (Module*)realloc(list->modules, (size_t)(list->count + 1) * sizeof(Module));
+    if (!grown) return 1;
+    list->modules = grown;
+    Module* m = &list->modules[list->count++];
+    memset(m, 0, sizeof(Module));
+    // The main program has an empty name
+    const char* path = info->dlpi_name && info->dlpi_name[0] ? info->dlpi_name : "/proc/self/exe";
+    strncpy(m->path, path, sizeof(m->path) - 1);
+    m->bias = info->dlpi_addr;
+    m->lo = lo;
+    m->hi = hi;
+    return 0;
+}
+
+static void* read_at(FILE* fp, long offset, size_t bytes) {
+    void* buffer = malloc(bytes > 0 ? bytes : 1);
+    if (!buffer) return NULL;
+    if (fseek(fp, offset, SEEK_SET) != 0 || fread(buffer, 1, bytes, fp) != bytes) {
+        free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+static int compare_symbols(const void* a, const void* b) {
+    uintptr_t x = ((const Symbol*)a)->start, y = ((const Symbol*)b)->start;
+    return x < y ? -1 : x > y;
+}
+
+// .symtab (which includes static functions) or, in stripped objects, .dynsym
+static void load_symbols(Module* m) {
+    m->loaded = 1;
+    FILE* fp = fopen(m->path, "rb");
+    if (!fp) return;
+
+    ElfW(Ehdr) eh;
+    ElfW(Shdr)* sections = NULL;
+    ElfW(Sym)* syms = NULL;
+    if (fread(&eh, sizeof(eh), 1, fp) != 1 || memcmp(eh.e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh.e_shentsize != sizeof(ElfW(Shdr)) || eh.e_shnum == 0) {
+        fclose(fp);
+        return;
+    }
+    sections = (ElfW(Shdr)*)read_at(fp, (long)eh.e_shoff, (size_t)eh.e_shnum * sizeof(ElfW(Shdr)));
+    if (!sections) {
+        fclose(fp);
+        return;
+    }
+
+    int table = -1;
+    for (int i = 0; i < eh.e_shnum; i++) {
+        if (sections[i].sh_type == SHT_SYMTAB) table = i;
+        if (sections[i].sh_type == SHT_DYNSYM && table < 0) table = i;
+    }
+    if (table >= 0 && sections[table].sh_link < eh.e_shnum) {
+        const ElfW(Shdr)* strtab = &sections[sections[table].sh_link];
+        syms = (ElfW(Sym)*)read_at(fp, (long)sections[table].sh_offset, sections[table].sh_size);
+        m->strings = (char*)read_at(fp, (long)strtab->sh_offset, strtab->sh_size);
+        size_t count = sections[table].sh_size / sizeof(ElfW(Sym));
+        m->symbols = syms && m->strings ? (Symbol*)malloc(count * sizeof(Symbol) + 1) : NULL;
+        for (size_t i = 0; m->symbols && i < count; i++) {
+            const ElfW(Sym)* s = &syms[i];
+            if (ELF64_ST_TYPE(s->st_info) != STT_FUNC || s->st_shndx == SHN_UNDEF || s->st_value == 0 ||
+                s->st_name >= strtab->sh_size) {
+                continue;
+            }
+            Symbol* out = &m->symbols[m->symbol_count++];
+            out->start = m->bias + s->st_value;
+            out->end = out->start + s->st_size;
+            out->name = m->strings + s->st_name;
+        }
+        if (m->symbols) qsort(m->symbols, (size_t)m->symbol_count, sizeof(Symbol), compare_symbols);
+    }
+
+    free(syms);
+    free(sections);
+    fclose(fp);
+}
+
+// Symbol name of the function containing addr, or NULL
+static const char* lookup_symbol(ModuleList* list, uintptr_t addr, const Module** module) {
+    *module = NULL;
+    for (int i = 0; i < list->count; i++) {
+        Module* m = &list->modules[i];
+        if (addr < m->lo || addr >= m->hi) continue;
+        *module = m;
+        if (!m->loaded) load_symbols(m);
+
+        // Last symbol starting at or before addr
+        int lo = 0, hi = m->symbol_count - 1, found = -1;
+        while (lo <= hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (m->symbols[mid].start <= addr) {
+                found = mid;
+                lo = mid + 1;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        if (found < 0) return NULL;
+        const Symbol* s = &m->symbols[found];
+        if (addr < s->end || s->end == s->start) return s->name;
+        return NULL;
+    }
+    return NULL;
+}
+
+static void free_modules(ModuleList* list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->modules[i].symbols);
+        free(list->modules[i].strings);
+    }
+    free(list->modules);
+    list->modules = NULL;
+    list->count = 0;
+}
+
+typedef char* (*DemangleFn)(const char*, char*, size_t*, int*);
+
+// abi::__cxa_demangle when libstdc++ is loaded (C++ programs), else NULL
+static DemangleFn find_demangler(void) {
+    void* symbol = dlsym(RTLD_DEFAULT, "__cxa_demangle");
+    DemangleFn fn = NULL;
+    memcpy(&fn, &symbol, sizeof(fn));
+    return fn;
+}
+
+// Printable name of addr (malloc'd): the demangled function, else
+// object+offset, else the raw address
+static char* describe_address(ModuleList* list, DemangleFn demangle, uintptr_t addr) {
+    const Module* module;
+    const char* name = lookup_symbol(list, addr, &module);
+    char buffer[600];
+    if (name) {
+        int status = -1;
+        char* demangled = demangle && name[0] == '_' && name[1] == 'Z' ? demangle(name, NULL, NULL, &status) : NULL;
+        if (demangled && status == 0) return demangled;
+        free(demangled);
+        snprintf(buffer, sizeof(buffer), "%s", name);
+    } else if (module) {
+        const char* base = strrchr(module->path, '/');
+        snprintf(buffer, sizeof(buffer), "%s+0x%lx", base ? base + 1 : module->path,
+                 (unsigned long)(addr - module->bias));
+    } else {
+        snprintf(buffer, sizeof(buffer), "0x%lx", (unsigned long)addr);
+    }
+    return strdup(buffer);
+}
+
+#else
+
+int sampler_start(int hz, int max_samples) {
+    (void)hz;
+    (void)max_samples;
+    return -1;
+}
+
+int sampler_stop(void) {
+    return -1;
+}
+
+typedef struct {
+    int count;
+} ModuleList;
+
+typedef void* DemangleFn;
+
+static DemangleFn find_demangler(void) {
+    return NULL;
+}
+
+static void free_modules(ModuleList* list) {
+    (void)list;
+}
+
+static char* describe_address(ModuleList* list, DemangleFn demangle, uintptr_t addr) {
+    (void)list;
+    (void)demangle;
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "0x%lx", (unsigned long)addr);
+    return strdup(buffer);
+}
+
+#endif // __linux__
+
+// ============================================================================
+// Reports
+// ============================================================================
+
+// Every distinct address of the profile mapped to a function id
+typedef struct {
+    uintptr_t* addresses;   // sorted
+    int* functions;         // function id of each address
+    int address_count;
+    char** names;           // function names by id
+    int name_count;
+} Resolved;
+
+// Caller frames hold return addresses; the call itself is the byte before
+static uintptr_t caller_address(void* frame) {
+    return (uintptr_t)frame - 1;
+}
+
+static int compare_addresses(const void* a, const void* b) {
+    uintptr_t x = *(const uintptr_t*)a, y = *(const uintptr_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static int resolve_profile(Resolved* r) {
+    memset(r, 0, sizeof(Resolved));
+    size_t total = 0;
+    for (int i = 0; i < sample_count; i++) total += 1 + (size_t)samples[i].caller_count;
+    r->addresses = (uintptr_t*)malloc(total * sizeof(uintptr_t) + 1);
+    if (!r->addresses) return -1;
+
+    size_t n = 0;
+    for (int i = 0; i < sample_count; i++) {
+        r->addresses[n++] = (uintptr_t)samples[i].ip;
+        for (int f = 0; f < samples[i].caller_count; f++) {
+            r->addresses[n++] = caller_address(samples[i].callers[f]);
+        }
+    }
+    qsort(r->addresses, n, sizeof(uintptr_t), compare_addresses);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique == 0 || r->addresses[i] != r->addresses[unique - 1]) r->addresses[unique++] = r->addresses[i];
+    }
+    r->address_count = (int)unique;
+    r->functions = (int*)malloc(unique * sizeof(int) + 1);
+    r->names = (char**)malloc(unique * sizeof(char*) + 1);
+    if (!r->functions || !r->names) return -1;
+
+    ModuleList modules = {0};
+#ifdef __linux__
+    dl_iterate_phdr(add_module, &modules);
+#endif
+    DemangleFn demangle = find_demangler();
+    for (size_t i = 0; i < unique; i++) {
+        char* name = describe_address(&modules, demangle, r->addresses[i]);
+        int id = -1;
+        for (int k = 0; name && k < r->name_count; k++) {
+            if (strcmp(r->names[k], name) == 0) {
+                id = k;
+                break;
+            }
+        }
+        if (id < 0) {
+            id = r->name_count++;
+            r->names[id] = name ? name : strdup("?");
+        } else {
+            free(name);
+        }
+        r->functions[i] = id;
+    }
+    free_modules(&modules);
+    return 0;
+}
+
+static void free_resolved(Resolved* r) {
+    for (int i = 0; i < r->name_count; i++) free(r->names[i]);
+    free(r->names);
+    free(r->functions);
+    free(r->addresses);
+}
+
+static int function_of(const Resolved* r, uintptr_t addr) {
+    int lo = 0, hi = r->address_count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (r->addresses[mid] == addr) return r->functions[mid];
+        if (r->addresses[mid] < addr) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+static int innermost_scope(const Sample* s) {
+    return s->scope_depth > 0 ? s->scopes[s->scope_depth - 1] : NO_SCOPE;
+}
+
+int sampler_scope_samples(const char* name) {
+    int id = name ? find_scope(name) : NO_SCOPE;
+    if (name && id == NO_SCOPE) return 0;
+    int count = 0;
+    for (int i = 0; i < sample_count; i++) {
+        if (innermost_scope(&samples[i]) == id) count++;
+    }
+    return count;
+}
+
+// Sort helpers for the hot-spot tables
+static const int* sort_keys;
+static const int* sort_keys2;
+
+static int compare_by_keys(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    if (sort_keys[x] != sort_keys[y]) return sort_keys[y] - sort_keys[x];
+    if (sort_keys2 && sort_keys2[x] != sort_keys2[y]) return sort_keys2[y] - sort_keys2[x];
+    return x - y;
+}
+
+void sampler_print_hotspots(FILE* fp, int top) {
+    if (!fp) return;
+    fprintf(fp, "\nSampling profile: %d samples at %d Hz of CPU time (%d dropped)\n", sample_count, sample_hz,
+            dropped);
+    Resolved r;
+    if (sample_count == 0 || resolve_profile(&r) != 0) {
+        if (sample_count > 0) free_resolved(&r);
+        return;
+    }
+
+    // Scope index 0 is "outside any scope", scope id s is index s + 1
+    int scopes = scope_name_count + 1;
+    int* scope_total = (int*)calloc((size_t)scopes, sizeof(int));
+    int* order = (int*)malloc((size_t)scopes * sizeof(int));
+    int* ranked = (int*)malloc((size_t)r.name_count * sizeof(int) + 1);
+    int* self = (int*)malloc((size_t)r.name_count * sizeof(int) + 1);
+    int* total = (int*)malloc((size_t)r.name_count * sizeof(int) + 1);
+    int* seen = (int*)malloc((size_t)r.name_count * sizeof(int) + 1);
+    if (!scope_total || !order || !ranked || !self || !total || !seen) {
+        free(scope_total);
+        free(order);
+        free(ranked);
+        free(self);
+        free(total);
+        free(seen);
+        free_resolved(&r);
+        return;
+    }
+    for (int i = 0; i < sample_count; i++) scope_total[innermost_scope(&samples[i]) + 1]++;
+    for (int s = 0; s < scopes; s++) order[s] = s;
+    sort_keys = scope_total;
+    sort_keys2 = NULL;
+    qsort(order, (size_t)scopes, sizeof(int), compare_by_keys);
+
+    for (int o = 0; o < scopes; o++) {
+        int scope = order[o];
+        if (scope_total[scope] == 0) break;
+        const char* name = scope == 0 ? "(no profiler section)" : scope_names[scope - 1];
+        fprintf(fp, "\n%-50s %8d samples %6.1f%%\n", name, scope_total[scope],
+                100.0 * scope_total[scope] / sample_count);
+        fprintf(fp, "  %7s %7s  %s\n", "self%", "total%", "function");
+
+        // Self: the interrupted function; total: anywhere on the stack
+        for (int f = 0; f < r.name_count; f++) {
+            self[f] = 0;
+            total[f] = 0;
+            seen[f] = -1;
+        }
+        for (int i = 0; i < sample_count; i++) {
+            const Sample* s = &samples[i];
+            if (innermost_scope(s) + 1 != scope) continue;
+            int leaf = function_of(&r, (uintptr_t)s->ip);
+            if (leaf >= 0) {
+                self[leaf]++;
+                total[leaf]++;
+                seen[leaf] = i;
+            }
+            for (int c = 0; c < s->caller_count; c++) {
+                int f = function_of(&r, caller_address(s->callers[c]));
+                if (f >= 0 && seen[f] != i) {
+                    total[f]++;
+                    seen[f] = i;
+                }
+            }
+        }
+        for (int f = 0; f < r.name_count; f++) ranked[f] = f;
+        sort_keys = self;
+        sort_keys2 = total;
+        qsort(ranked, (size_t)r.name_count, sizeof(int), compare_by_keys);
+        for (int k = 0; k < r.name_count && k < top && self[ranked[k]] > 0; k++) {
+            int f = ranked[k];
+            fprintf(fp, "  %7.1f %7.1f  %.100s\n", 100.0 * self[f] / scope_total[scope],
+                    100.0 * total[f] / scope_total[scope], r.names[f]);
+        }
+    }
+
+    free(scope_total);
+    free(order);
+    free(ranked);
+    free(self);
+    free(total);
+    free(seen);
+    free_resolved(&r);
+}
+
+// Growable string for one folded line
+typedef struct {
+    char* text;
+    size_t length;
+    size_t capacity;
+} Line;
+
+static int line_append(Line* line, const char* text, char separator) {
+    size_t add = strlen(text) + 1;
+    if (line->length + add + 1 > line->capacity) {
+        size_t grown = (line->capacity + add + 1) * 2;
+        char* bigger = (char*)realloc(line->text, grown);
+        if (!bigger) return -1;
+        line->text = bigger;
+        line->capacity = grown;
+    }
+    if (line->length > 0) line->text[line->length++] = separator;
+    for (const char* c = text; *c; c++) {
+        // ';' separates frames
+        line->text[line->length++] = *c == ';' ? ':' : *c;
+    }
+    line->text[line->length] = '\0';
+    return 0;
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+int sampler_write_folded(const char* filename) {
+    if (!filename) return -1;
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open %s for writing\n", filename);
+        return -1;
+    }
+    Resolved r;
+    if (sample_count == 0 || resolve_profile(&r) != 0) {
+        if (sample_count > 0) free_resolved(&r);
+        fclose(fp);
+        return 0;
+    }
+
+    char** lines = (char**)calloc((size_t)sample_count, sizeof(char*));
+    int ok = lines != NULL;
+    for (int i = 0; ok && i < sample_count; i++) {
+        const Sample* s = &samples[i];
+        Line line = {NULL, 0, 0};
+        char scope[MAX_NAME_LEN + 2];
+        for (int d = 0; ok && d < s->scope_depth; d++) {
+            if (s->scopes[d] == NO_SCOPE) continue;
+            snprintf(scope, sizeof(scope), "[%s]", scope_names[s->scopes[d]]);
+            ok = line_append(&line, scope, ';') == 0;
+        }
+        for (int c = s->caller_count - 1; ok && c >= 0; c--) {
+            int f = function_of(&r, caller_address(s->callers[c]));
+            ok = line_append(&line, f >= 0 ? r.names[f] : "?", ';') == 0;
+        }
+        int leaf = function_of(&r, (uintptr_t)s->ip);
+        if (ok) ok = line_append(&line, leaf >= 0 ? r.names[leaf] : "?", ';') == 0;
+        lines[i] = line.text;
+    }
+
+    int written = 0;
+    if (ok) {
+        qsort(lines, (size_t)sample_count, sizeof(char*), compare_strings);
+        for (int i = 0; i < sample_count;) {
+            int j = i + 1;
+            while (j < sample_count && strcmp(lines[j], lines[i]) == 0) j++;
+            fprintf(fp, "%s %d\n", lines[i], j - i);
+            written++;
+            i = j;
+        }
+    }
+
+    for (int i = 0; lines && i < sample_count; i++) free(lines[i]);
+    free(lines);
+    free_resolved(&r);
+    fclose(fp);
+    return ok ? written : -1;
+}
@@ -0,0 +1,278 @@
+#include "scaling_sweep.h"
+#include "concurrent_matrix.h"
+#include "matrix_random.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <utility>
+
+namespace {
+
+typedef int (*SerialKernel)(Matrix*, Matrix*, Matrix*);
+typedef int (*ParallelKernel)(Matrix*, Matrix*, Matrix*, int);
+
+int blocked_serial(Matrix* A, Matrix* B, Matrix* C) {
+    return matrix_multiply_blocked(A, B, C, 0);
+}
+
+int blocked_parallel(Matrix* A, Matrix* B, Matrix* C, int num_threads) {
+    return matrix_multiply_blocked_parallel(A, B, C, 0, num_threads);
+}
+
+struct SweepKernel {
+    const char* name;
+    SerialKernel serial;
+    ParallelKernel parallel;
+};
+
+const SweepKernel KERNELS[] = {
+    {"naive", matrix_multiply_naive, matrix_multiply_naive_parallel},
+    {"transpose", matrix_multiply_transpose, matrix_multiply_transpose_parallel},
+    {"blocked", blocked_serial, blocked_parallel},
+};
+
+const SweepKernel* find_kernel(const std::string& name) {
+    for (const SweepKernel& kernel : KERNELS) {
+        if (name == kernel.name) return &kernel;
+    }
+    return nullptr;
+}
+
+// Square operands of one size, randomized once with fixed seeds
+struct Operands {
+    Matrix* A;
+    Matrix* B;
+    Matrix* C;
+
+    explicit Operands(int n)
+        : A(matrix_create(n, n)), B(matrix_create(n, n)), C(matrix_create(n, n)) {
+        if (A && B) {
+            matrix_randomize_parallel(A, 1, 0);
+            matrix_randomize_parallel(B, 2, 0);
+        }
+    }
+    ~Operands() {
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C);
+    }
+    bool ok() const { return A && B && C; }
+};
+
+// One untimed warm-up call, then the average over iterations
+template <typename Fn>
+double time_kernel_ms(int iterations, Fn fn) {
+    fn();
+    double start = get_time_ms();
+    for (int iter = 0; iter < iterations; ++iter) {
+        fn();
+    }
+    return (get_time_ms() - start) / iterations;
+}
+
+double gemm_gflops(int n, double ms) {
+    return ms > 0.0 ? 2.0 * n * n * static_cast<double>(n) / (ms * 1e6) : 0.0;
+}
+
+SweepRecord make_record(const char* scaling, const char* kernel, int n, int threads,
+                        double time_ms, double serial_ms) {
+    SweepRecord r;
+    r.scaling = scaling;
+    r.kernel = kernel;
+    r.size = n;
+    r.threads = threads;
+    r.time_ms = time_ms;
+    r.gflops = gemm_gflops(n, time_ms);
+    r.serial_ms = serial_ms;
+    r.speedup = time_ms > 0.0 ? serial_ms / time_ms : 0.0;
+    r.efficiency = r.speedup / threads;
+    r.overhead_ms = time_ms - serial_ms / threads;
+    return r;
+}
+
+void print_record(const SweepRecord& r) {
+    std::cout << std::left << std::setw(8) << r.scaling << std::setw(11) << r.kernel
+              << std::right << std::setw(7) << r.size << std::setw(9) << r.threads
+              << std::fixed << std::setprecision(3) << std::setw(13) << r.time_ms
+              << std::setprecision(2) << std::setw(10) << r.gflops
+              << std::setw(9) << r.speedup << "x"
+              << std::setw(8) << std::setprecision(1) << r.efficiency * 100.0 << "%"
+              << std::setprecision(3) << std::setw(14) << r.overhead_ms << "\n";
+}
+
+}  // namespace
+
+int get_physical_core_count() {
+    // A core is a (package, core id) pair; SMT siblings share both
+    std::set<std::pair<int, int>> cores;
+    int hardware_threads = get_hardware_concurrency();
+    for (int cpu = 0; cpu < hardware_threads; ++cpu) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::ifstream package_file(base + "physical_package_id");
+        std::ifstream core_file(base + "core_id");
+        int package = -1, core = -1;
+        if (!(package_file >> package) || !(core_file >> core)) {
+            return hardware_threads;
+        }
+        cores.insert(std::make_pair(package, core));
+    }
+    return cores.empty() ? hardware_threads : static_cast<int>(cores.size());
+}
+
+void write_system_record(std::ostream& out) {
+    out << "{\"record\":\"system\",\"hardware_threads\":" << get_hardware_concurrency()
+        << ",\"physical_cores\":" << get_physical_core_count()
+        << ",\"cache_line\":" << get_cache_line_size()
+        << ",\"l1_bytes\":" << get_l1_cache_size()
+        << ",\"l2_bytes\":" << get_l2_cache_size()
+        << ",\"l3_bytes\":" << get_l3_cache_size() << "}\n";
+}
+
+std::vector<int> sweep_default_thread_counts(int hardware_threads, int physical_cores) {
+    hardware_threads = std::max(1, hardware_threads);
+    std::set<int> counts;
+    for (int t = 1; t <= hardware_threads; t *= 2) {
+        counts.insert(t);
+    }
+    if (physical_cores >= 1 && physical_cores <= hardware_threads) {
+        counts.insert(physical_cores);
+        if (physical_cores < hardware_threads) counts.insert(physical_cores + 1);
+    }
+    counts.insert(hardware_threads);
+    return std::vector<int>(counts.begin(), counts.end());
+}
+
+std::vector<int> sweep_default_sizes(int max_size, int l1_bytes, int l2_bytes, int l3_bytes) {
+    std::set<int> sizes;
+    for (int n = 64; n <= max_size; n *= 2) {
+        sizes.insert(n);
+    }
+
+    const int capacities[] = {l1_bytes, l2_bytes, l3_bytes};
+    for (int capacity : capacities) {
+        if (capacity <= 0) continue;
+        double fit = std::sqrt(capacity / (3.0 * sizeof(double)));
+        const double factors[] = {0.8, 1.25};
+        for (double factor : factors) {
+            int n = static_cast<int>(std::lround(fit * factor / 16.0)) * 16;
+            if (n >= 16 && n <= max_size) sizes.insert(n);
+        }
+    }
+    return std::vector<int>(sizes.begin(), sizes.end());
+}
+
+int sweep_weak_size(int base_size, int threads) {
+    return static_cast<int>(std::lround(base_size * std::cbrt(static_cast<double>(threads))));
+}
+
+int run_scaling_sweep(const SweepConfig& config, std::vector<SweepRecord>& records) {
+    records.clear();
+
+    std::vector<const SweepKernel*> kernels;
+    if (config.kernels.empty()) {
+        for (const SweepKernel& kernel : KERNELS) kernels.push_back(&kernel);
+    }
+    for (const std::string& name : config.kernels) {
+        const SweepKernel* kernel = find_kernel(name);
+        if (!kernel) {
+            std::cerr << "Error: unknown kernel '" << name << "'\n";
+            return -1;
+        }
+        kernels.push_back(kernel);
+    }
+
+    std::vector<int> threads = config.threads;
+    if (threads.empty()) {
+        threads = sweep_default_thread_counts(get_hardware_concurrency(), get_physical_core_count());
+    }
+    std::vector<int> sizes = config.sizes;
+    if (sizes.empty()) {
+        sizes = sweep_default_sizes(config.max_size, get_l1_cache_size(), get_l2_cache_size(),
+                                    get_l3_cache_size());
+    }
+    int iterations = std::max(1, config.iterations);
+
+    std::cout << std::left << std::setw(8) << "Scaling" << std::setw(11) << "Kernel"
+              << std::right << std::setw(7) << "Size" << std::setw(9) << "Threads"
+              << std::setw(13) << "Time (ms)" << std::setw(10) << "GFLOP/s"
+              << std::setw(10) << "Speedup" << std::setw(9) << "Eff."
+              << std::setw(14) << "Overhead (ms)" << "\n";
+    std::cout << std::string(91, '-') << "\n";
+
+    // Strong scaling: fixed size, growing thread count
+    for (int n : sizes) {
+        Operands ops(n);
+        if (!ops.ok()) {
+            std::cerr << "Error: cannot allocate " << n << " x " << n << " operands\n";
+            continue;
+        }
+        for (const SweepKernel* kernel : kernels) {
+            double serial_ms = time_kernel_ms(iterations, [&]() { kernel->serial(ops.A, ops.B, ops.C); });
+            for (int t : threads) {
+                double ms = time_kernel_ms(iterations, [&]() { kernel->parallel(ops.A, ops.B, ops.C, t); });
+                records.push_back(make_record("strong", kernel->name, n, t, ms, serial_ms));
+                print_record(records.back());
+            }
+        }
+    }
+
+    // Weak scaling: n^3 work grows with the thread count
+    if (config.weak_base_size > 0) {
+        for (const SweepKernel* kernel : kernels) {
+            double base_rate = 0.0;  // GFLOP/s of one thread at the base size
+            for (int t : threads) {
+                int n = sweep_weak_size(config.weak_base_size, t);
+                Operands ops(n);
+                if (!ops.ok()) {
+                    std::cerr << "Error: cannot allocate " << n << " x " << n << " operands\n";
+                    continue;
+                }
+                if (base_rate == 0.0) {
+                    Operands base(config.weak_base_size);
+                    if (!base.ok()) break;
+                    double base_ms = time_kernel_ms(iterations, [&]() {
+                        kernel->parallel(base.A, base.B, base.C, 1);
+                    });
+                    base_rate = gemm_gflops(config.weak_base_size, base_ms);
+                }
+                double serial_ms = time_kernel_ms(iterations, [&]() { kernel->serial(ops.A, ops.B, ops.C); });
+                double ms = time_kernel_ms(iterations, [&]() { kernel->parallel(ops.A, ops.B, ops.C, t); });
+                SweepRecord r = make_record("weak", kernel->name, n, t, ms, serial_ms);
+                r.efficiency = base_rate > 0.0 ? r.gflops / (t * base_rate) : 0.0;
+                records.push_back(r);
+                print_record(r);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int save_sweep_results(const std::vector<SweepRecord>& records, const char* filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open " << filename << " for writing\n";
+        return -1;
+    }
+
+    write_system_record(file);
+
+    file << std::setprecision(6);
+    for (const SweepRecord& r : records) {
+        file << "{\"record\":\"" << r.scaling << "\",\"kernel\":\"" << r.kernel << "\""
+             << ",\"size\":" << r.size << ",\"threads\":" << r.threads
+             << ",\"time_ms\":" << r.time_ms << ",\"gflops\":" << r.gflops
+             << ",\"serial_ms\":" << r.serial_ms << ",\"speedup\":" << r.speedup
+             << ",\"efficiency\":" << r.efficiency << ",\"overhead_ms\":" << r.overhead_ms << "}\n";
+    }
+
+    file.close();
+    if (file.fail()) return -1;
+    std::cout << "Results saved to " << filename << "\n";
+    return 0;
+}
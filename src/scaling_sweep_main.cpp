@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "scaling_sweep.h"
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]\n\n";
+    std::cout << "Sweeps thread counts and sizes for the parallel kernels and reports\n";
+    std::cout << "strong/weak scaling efficiency and parallel overhead.\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --kernels <a,b>  Kernels: naive, transpose, blocked (default: all)\n";
+    std::cout << "  --threads <a,b>  Thread counts (default: powers of two, physical cores, all)\n";
+    std::cout << "  --sizes <a,b>    Matrix sizes (default: powers of two and cache transitions)\n";
+    std::cout << "  --max-size <N>   Largest default size (default: 1024)\n";
+    std::cout << "  --weak-size <N>  One-thread size for weak scaling, 0 = skip (default: 256)\n";
+    std::cout << "  --iterations <N> Number of iterations (default: 3)\n";
+    std::cout << "  --output <file>  Output JSON Lines file (default: scaling_sweep.jsonl)\n";
+    std::cout << "  --help           Show this help message\n";
+    std::cout << "\nExamples:\n";
+    std::cout << "  " << program_name << " --kernels blocked --max-size 2048\n";
+    std::cout << "  " << program_name << " --threads 1,2,4,8 --sizes 512,1024 --weak-size 0\n";
+}
+
+// Comma separated list of positive integers; empty on any invalid entry
+std::vector<int> parse_int_list(const char* text) {
+    std::vector<int> values;
+    std::string list = text;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        int value = std::atoi(list.substr(pos, comma - pos).c_str());
+        if (value <= 0) return std::vector<int>();
+        values.push_back(value);
+        pos = comma + 1;
+    }
+    return values;
+}
+
+std::vector<std::string> parse_name_list(const char* text) {
+    std::vector<std::string> names;
+    std::string list = text;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        if (comma > pos) names.push_back(list.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return names;
+}
+
+int main(int argc, char* argv[]) {
+    SweepConfig config;
+    const char* output_file = "scaling_sweep.jsonl";
+
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--kernels") == 0 && i + 1 < argc) {
+            config.kernels = parse_name_list(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = parse_int_list(argv[++i]);
+            if (config.threads.empty()) {
+                std::cerr << "Error: --threads needs a comma separated list of positive counts\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            config.sizes = parse_int_list(argv[++i]);
+            if (config.sizes.empty()) {
+                std::cerr << "Error: --sizes needs a comma separated list of positive sizes\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            config.max_size = std::atoi(argv[++i]);
+            if (config.max_size <= 0) {
+                std::cerr << "Error: Max size must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--weak-size") == 0 && i + 1 < argc) {
+            config.weak_base_size = std::atoi(argv[++i]);
+            if (config.weak_base_size < 0) {
+                std::cerr << "Error: Weak size must be >= 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            config.iterations = std::atoi(argv[++i]);
+            if (config.iterations <= 0) {
+                std::cerr << "Error: Iterations must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<SweepRecord> records;
+    if (run_scaling_sweep(config, records) != 0) {
+        return 1;
+    }
+    return save_sweep_results(records, output_file) == 0 ? 0 : 1;
+}
@@ -1,9 +1,14 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include "concurrent_matrix.h"
+#include "environment.h"
+#include "results_store.h"
+#include "false_sharing.h"
 #include "matrix.h"
 
 void print_usage(const char* program_name) {
@@ -11,20 +16,67 @@ void print_usage(const char* program_name) {
     std::cout << "Options:\n";
     std::cout << "  --size <N>       Matrix size (default: 512)\n";
     std::cout << "  --threads <N>    Number of threads (0 = auto, default: auto)\n";
-    std::cout << "  --iterations <N> Number of iterations (default: 3)\n";
+    std::cout << "  --iterations <N> Number of iterations (default: 8)\n";
     std::cout << "  --output <file>  Output CSV file (default: concurrent_benchmark.csv)\n";
+    std::cout << "  --results <file> Append timing samples as JSON Lines (default: concurrent_results.jsonl)\n";
+    std::cout << "  --false-sharing  Run the false-sharing diagnostic instead: --size rows of\n";
+    std::cout << "                   --cols doubles updated by interleaved, contiguous and\n";
+    std::cout << "                   cache-line aligned row assignments\n";
+    std::cout << "  --cols <N>       Row length for --false-sharing (default: 3)\n";
+    std::cout << "  --passes <N>     Updates per element for --false-sharing (default: 1000)\n";
+    std::cout << "  --pin <cpus>     Pin to a CPU list (e.g. 2-5) or 'isolated' (isolcpus)\n";
+    std::cout << "  --warmup <ms>    Busy-loop before measuring so the clock ramps up (default: 0)\n";
+    std::cout << "  --strict         Refuse to run on a noisy host (governor, turbo, THP, SMT, load)\n";
     std::cout << "  --help           Show this help message\n";
     std::cout << "\nExamples:\n";
     std::cout << "  " << program_name << " --size 1024 --threads 4\n";
     std::cout << "  " << program_name << " --size 2048 --iterations 5\n";
+    std::cout << "  " << program_name << " --false-sharing --threads 4 --cols 3\n";
+    std::cout << "  " << program_name << " --pin isolated --warmup 500 --strict\n";
+}
+
+// Diagnostic mode: the three row layouts with the same rows, cols and threads
+int run_false_sharing_diagnostic(int rows, int cols, int num_threads, int passes, int iterations) {
+    // Sharing needs at least two writers
+    int threads = num_threads > 0 ? num_threads : std::max(2, get_hardware_concurrency());
+
+    std::vector<FalseSharingResult> results;
+    for (int l = 0; l < ROW_LAYOUT_COUNT; l++) {
+        FalseSharingResult result;
+        if (run_false_sharing(static_cast<RowLayout>(l), rows, cols, threads, passes, iterations, result) != 0) {
+            std::cerr << "Error: false-sharing run failed\n";
+            return 1;
+        }
+        results.push_back(result);
+    }
+    print_false_sharing_results(results);
+    return 0;
+}
+
+// Matrix dimension from text; 0 if not a number in [1, INT_MAX]
+int parse_size(const char* text) {
+    char* end = nullptr;
+    long long value = std::strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || value <= 0 || value > std::numeric_limits<int>::max()) {
+        return 0;
+    }
+    return static_cast<int>(value);
 }
 
 int main(int argc, char* argv[]) {
     // Default values
     int size = 512;
     int num_threads = 0;  // 0 = auto-detect
-    int iterations = 3;
+    int iterations = 8;
     const char* output_file = "concurrent_benchmark.csv";
+    bool false_sharing = false;
+    int size_given = 0;
+    int cols = 3;
+    int passes = 1000;
+    const char* pin_cpus = nullptr;
+    double warmup_ms = 0.0;
+    bool strict = false;
+    const char* results_file = "concurrent_results.jsonl";
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -32,9 +84,24 @@ int main(int argc, char* argv[]) {
             print_usage(argv[0]);
             return 0;
         } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
-            size = std::atoi(argv[++i]);
-            if (size <= 0 || size > 4096) {
-                std::cerr << "Error: Size must be between 1 and 4096\n";
+            size = parse_size(argv[++i]);
+            if (size <= 0) {
+                std::cerr << "Error: Size must be between 1 and " << std::numeric_limits<int>::max() << "\n";
+                return 1;
+            }
+            size_given = 1;
+        } else if (strcmp(argv[i], "--false-sharing") == 0) {
+            false_sharing = true;
+        } else if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc) {
+            cols = parse_size(argv[++i]);
+            if (cols <= 0) {
+                std::cerr << "Error: Cols must be > 0\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = parse_size(argv[++i]);
+            if (passes <= 0) {
+                std::cerr << "Error: Passes must be > 0\n";
                 return 1;
             }
         } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
@@ -51,6 +118,18 @@ int main(int argc, char* argv[]) {
             }
         } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_file = argv[++i];
+        } else if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            pin_cpus = argv[++i];
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup_ms = std::atof(argv[++i]);
+            if (warmup_ms < 0.0) {
+                std::cerr << "Error: Warmup must be >= 0 ms\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
         } else {
             // Check if it's just a number (positional size argument)
             std::string arg = argv[i];
@@ -62,9 +141,9 @@ int main(int argc, char* argv[]) {
                 }
             }
             if (is_number && !arg.empty()) {
-                size = std::atoi(argv[i]);
-                if (size <= 0 || size > 4096) {
-                    std::cerr << "Error: Size must be between 1 and 4096\n";
+                size = parse_size(argv[i]);
+                if (size <= 0) {
+                    std::cerr << "Error: Size must be between 1 and " << std::numeric_limits<int>::max() << "\n";
                     return 1;
                 }
             } else {
@@ -75,8 +154,25 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    BenchEnvironment env;
+    if (environment_prepare(pin_cpus, warmup_ms, strict ? 1 : 0, &env) != 0) {
+        return 2;
+    }
+    
+    if (false_sharing) {
+        // Default rows: a small matrix that stays in L1, so misses come from sharing
+        return run_false_sharing_diagnostic(size_given ? size : 512, cols, num_threads, passes, iterations);
+    }
+    
     // Run the concurrent matrix multiplication test
-    test_concurrent_matrix_multiplication(size, iterations, num_threads, output_file);
+    ResultsStore store;
+    if (results_store_open(&store, results_file, "matrix_concurrent_bench", &env) != 0) {
+        return 1;
+    }
+    test_concurrent_matrix_multiplication(size, iterations, num_threads, output_file, &store);
+    results_store_close(&store);
+    std::cout << "Samples appended to " << results_file << " (run " << store.run_id << ")\n";
+    environment_save_sidecar(&env, output_file);
     
     return 0;
 }
@@ -0,0 +1,276 @@
+#include "transpose.h"
+#include <stdlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TRANSPOSE_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define TRANSPOSE_HAVE_X86 0
+#endif
+
+// ============================================================================
+// Path selection
+// ============================================================================
+
+static TransposePath forced_path = TRANSPOSE_PATH_AUTO;
+
+static int path_supported(TransposePath path) {
+    switch (path) {
+        case TRANSPOSE_PATH_PORTABLE:
+            return 1;
+#if TRANSPOSE_HAVE_X86
+        case TRANSPOSE_PATH_AVX:
+            return __builtin_cpu_supports("avx");
+#endif
+        default:
+            return 0;
+    }
+}
+
+TransposePath transpose_select_path(TransposePath path) {
+    forced_path = path;
+    return transpose_active_path();
+}
+
+TransposePath transpose_active_path(void) {
+    if (forced_path == TRANSPOSE_PATH_AUTO || !path_supported(forced_path)) {
+        return path_supported(TRANSPOSE_PATH_AVX) ? TRANSPOSE_PATH_AVX : TRANSPOSE_PATH_PORTABLE;
+    }
+    return forced_path;
+}
+
+const char* transpose_path_name(TransposePath path) {
+    switch (path) {
+        case TRANSPOSE_PATH_AUTO: return "auto";
+        case TRANSPOSE_PATH_PORTABLE: return "portable";
+        case TRANSPOSE_PATH_AVX: return "avx";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Tile kernels: source rows [i0, i1) x columns [j0, j1)
+// ============================================================================
+
+static void tile_portable(const double* src, int ld_src, double* dst, int ld_dst,
+                          int i0, int i1, int j0, int j1) {
+    for (int i = i0; i < i1; i++) {
+        const double* s = src + (size_t)i * ld_src;
+        for (int j = j0; j < j1; j++) {
+            dst[(size_t)j * ld_dst + i] = s[j];
+        }
+    }
+}
+
+#if TRANSPOSE_HAVE_X86
+// Transpose the 4 x 4 block held in r0..r3 (one row each)
+#define TRANSPOSE_4X4(r0, r1, r2, r3) do {                      \
+        __m256d t0_ = _mm256_unpacklo_pd(r0, r1);               \
+        __m256d t1_ = _mm256_unpackhi_pd(r0, r1);               \
+        __m256d t2_ = _mm256_unpacklo_pd(r2, r3);               \
+        __m256d t3_ = _mm256_unpackhi_pd(r2, r3);               \
+        r0 = _mm256_permute2f128_pd(t0_, t2_, 0x20);            \
+        r1 = _mm256_permute2f128_pd(t1_, t3_, 0x20);            \
+        r2 = _mm256_permute2f128_pd(t0_, t2_, 0x31);            \
+        r3 = _mm256_permute2f128_pd(t1_, t3_, 0x31);            \
+    } while (0)
+
+__attribute__((target("avx")))
+static void tile_avx(const double* src, int ld_src, double* dst, int ld_dst,
+                     int i0, int i1, int j0, int j1) {
+    int i4 = i0 + (i1 - i0) / 4 * 4;
+    int j4 = j0 + (j1 - j0) / 4 * 4;
+
+    for (int i = i0; i < i4; i += 4) {
+        const double* s = src + (size_t)i * ld_src;
+        for (int j = j0; j < j4; j += 4) {
+            __m256d r0 = _mm256_loadu_pd(s + j);
+            __m256d r1 = _mm256_loadu_pd(s + ld_src + j);
+            __m256d r2 = _mm256_loadu_pd(s + 2 * (size_t)ld_src + j);
+            __m256d r3 = _mm256_loadu_pd(s + 3 * (size_t)ld_src + j);
+            TRANSPOSE_4X4(r0, r1, r2, r3);
+            double* d = dst + (size_t)j * ld_dst + i;
+            _mm256_storeu_pd(d, r0);
+            _mm256_storeu_pd(d + ld_dst, r1);
+            _mm256_storeu_pd(d + 2 * (size_t)ld_dst, r2);
+            _mm256_storeu_pd(d + 3 * (size_t)ld_dst, r3);
+        }
+    }
+
+    // Column and row remainders
+    tile_portable(src, ld_src, dst, ld_dst, i0, i4, j4, j1);
+    tile_portable(src, ld_src, dst, ld_dst, i4, i1, j0, j1);
+}
+#endif
+
+// ============================================================================
+// Out-of-place
+// ============================================================================
+
+void transpose_out_of_place_rows(const double* src, int rows, int cols, int ld_src,
+                                 double* dst, int ld_dst, int row_start, int row_end) {
+    if (row_start < 0) row_start = 0;
+    if (row_end > rows) row_end = rows;
+    if (row_start >= row_end || cols <= 0) return;
+
+    void (*tile)(const double*, int, double*, int, int, int, int, int) = tile_portable;
+#if TRANSPOSE_HAVE_X86
+    if (transpose_active_path() == TRANSPOSE_PATH_AVX) tile = tile_avx;
+#endif
+
+    for (int ii = row_start; ii < row_end; ii += TRANSPOSE_TILE) {
+        int i_max = (ii + TRANSPOSE_TILE < row_end) ? ii + TRANSPOSE_TILE : row_end;
+        for (int jj = 0; jj < cols; jj += TRANSPOSE_TILE) {
+            int j_max = (jj + TRANSPOSE_TILE < cols) ? jj + TRANSPOSE_TILE : cols;
+            tile(src, ld_src, dst, ld_dst, ii, i_max, jj, j_max);
+        }
+    }
+}
+
+void transpose_out_of_place(const double* src, int rows, int cols, int ld_src,
+                            double* dst, int ld_dst) {
+    transpose_out_of_place_rows(src, rows, cols, ld_src, dst, ld_dst, 0, rows);
+}
+
+// ============================================================================
+// In-place, square: swap tile pairs across the diagonal
+// ============================================================================
+
+// Swap (i, j) with (j, i) for i in [i0, i1), j in [j0, j1), j > i
+static void swap_region_portable(double* data, int n, int i0, int i1, int j0, int j1) {
+    for (int i = i0; i < i1; i++) {
+        int j_start = (j0 > i + 1) ? j0 : i + 1;
+        for (int j = j_start; j < j1; j++) {
+            double t = data[(size_t)i * n + j];
+            data[(size_t)i * n + j] = data[(size_t)j * n + i];
+            data[(size_t)j * n + i] = t;
+        }
+    }
+}
+
+#if TRANSPOSE_HAVE_X86
+// Region [i0, i1) x [j0, j1) with bounds on multiples of 4 and i0 <= j0:
+// each 4 x 4 block and its mirror are transposed in registers and exchanged
+__attribute__((target("avx")))
+static void swap_region_avx(double* data, int n, int i0, int i1, int j0, int j1) {
+    for (int i = i0; i < i1; i += 4) {
+        int j_start = (j0 > i) ? j0 : i;
+        for (int j = j_start; j < j1; j += 4) {
+            double* x = data + (size_t)i * n + j;
+            __m256d x0 = _mm256_loadu_pd(x);
+            __m256d x1 = _mm256_loadu_pd(x + n);
+            __m256d x2 = _mm256_loadu_pd(x + 2 * (size_t)n);
+            __m256d x3 = _mm256_loadu_pd(x + 3 * (size_t)n);
+            TRANSPOSE_4X4(x0, x1, x2, x3);
+            if (i == j) {
+                _mm256_storeu_pd(x, x0);
+                _mm256_storeu_pd(x + n, x1);
+                _mm256_storeu_pd(x + 2 * (size_t)n, x2);
+                _mm256_storeu_pd(x + 3 * (size_t)n, x3);
+                continue;
+            }
+            double* y = data + (size_t)j * n + i;
+            __m256d y0 = _mm256_loadu_pd(y);
+            __m256d y1 = _mm256_loadu_pd(y + n);
+            __m256d y2 = _mm256_loadu_pd(y + 2 * (size_t)n);
+            __m256d y3 = _mm256_loadu_pd(y + 3 * (size_t)n);
+            TRANSPOSE_4X4(y0, y1, y2, y3);
+            _mm256_storeu_pd(y, x0);
+            _mm256_storeu_pd(y + n, x1);
+            _mm256_storeu_pd(y + 2 * (size_t)n, x2);
+            _mm256_storeu_pd(y + 3 * (size_t)n, x3);
+            _mm256_storeu_pd(x, y0);
+            _mm256_storeu_pd(x + n, y1);
+            _mm256_storeu_pd(x + 2 * (size_t)n, y2);
+            _mm256_storeu_pd(x + 3 * (size_t)n, y3);
+        }
+    }
+}
+#endif
+
+void transpose_in_place_square(double* data, int n) {
+    if (!data || n <= 1) return;
+
+    int n4 = n;
+    void (*swap_region)(double*, int, int, int, int, int) = swap_region_portable;
+#if TRANSPOSE_HAVE_X86
+    if (transpose_active_path() == TRANSPOSE_PATH_AVX) {
+        swap_region = swap_region_avx;
+        n4 = n - n % 4;
+    }
+#endif
+
+    // Tile pairs (ii, jj) with jj >= ii; both tiles of a pair stay in L1
+    for (int ii = 0; ii < n4; ii += TRANSPOSE_TILE) {
+        int i_max = (ii + TRANSPOSE_TILE < n4) ? ii + TRANSPOSE_TILE : n4;
+        for (int jj = ii; jj < n4; jj += TRANSPOSE_TILE) {
+            int j_max = (jj + TRANSPOSE_TILE < n4) ? jj + TRANSPOSE_TILE : n4;
+            swap_region(data, n, ii, i_max, jj, j_max);
+        }
+    }
+
+    // Columns past the last full 4-block (SIMD path only)
+    if (n4 < n) {
+        swap_region_portable(data, n, 0, n, n4, n);
+    }
+}
+
+// ============================================================================
+// In-place, rectangular: cycle following
+// ============================================================================
+
+// Element p = i * cols + j of the rows x cols source moves to j * rows + i,
+// which equals p * rows mod (rows * cols - 1) for every p except the last.
+int transpose_in_place(double* data, int rows, int cols) {
+    if (!data || rows <= 0 || cols <= 0) return -1;
+    if (rows == cols) {
+        transpose_in_place_square(data, rows);
+        return 0;
+    }
+    if (rows == 1 || cols == 1) return 0;  // same memory layout
+
+    size_t size = (size_t)rows * (size_t)cols;
+    size_t last = size - 1;
+    unsigned char* visited = (unsigned char*)calloc((size + 7) / 8, 1);
+    if (!visited) return -1;
+
+    for (size_t start = 1; start < last; start++) {
+        if (visited[start >> 3] & (1u << (start & 7))) continue;
+
+        double carried = data[start];
+        size_t p = start;
+        do {
+            size_t q = (size_t)(((unsigned long long)p * (unsigned long long)rows) % last);
+            double t = data[q];
+            data[q] = carried;
+            carried = t;
+            visited[q >> 3] |= (unsigned char)(1u << (q & 7));
+            p = q;
+        } while (p != start);
+    }
+
+    free(visited);
+    return 0;
+}
+
+// ============================================================================
+// Matrix wrappers
+// ============================================================================
+
+int matrix_transpose(Matrix* src, Matrix* dst) {
+    if (!src || !dst || src == dst) return -1;
+    if (dst->rows != src->cols || dst->cols != src->rows) return -1;
+
+    transpose_out_of_place(src->data, src->rows, src->cols, src->cols, dst->data, dst->cols);
+    return 0;
+}
+
+int matrix_transpose_in_place(Matrix* m) {
+    if (!m) return -1;
+    if (transpose_in_place(m->data, m->rows, m->cols) != 0) return -1;
+
+    int rows = m->rows;
+    m->rows = m->cols;
+    m->cols = rows;
+    return 0;
+}
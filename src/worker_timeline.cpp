@@ -0,0 +1,91 @@
+#include "worker_timeline.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+thread_local WorkerTimeline* attached_timeline = nullptr;
+}
+
+void worker_timeline_attach(WorkerTimeline* timeline) {
+    attached_timeline = timeline;
+}
+
+WorkerTimeline* worker_timeline_attached() {
+    return attached_timeline;
+}
+
+WorkerTimelineStats worker_timeline_stats(const WorkerTimeline& timeline) {
+    WorkerTimelineStats stats = {0, timeline.phases, -1, 0.0, 0.0, 0.0, 0.0};
+    if (timeline.spans.empty()) return stats;
+
+    // Spawn latency of every worker thread
+    int spawned = 0;
+    for (const WorkerSpan& span : timeline.spans) {
+        if (span.caller_thread) continue;
+        double latency = span.start_ms - span.spawn_ms;
+        stats.spawn_latency_ms += latency;
+        stats.max_spawn_latency_ms = std::max(stats.max_spawn_latency_ms, latency);
+        ++spawned;
+    }
+    if (spawned > 0) stats.spawn_latency_ms /= spawned;
+
+    // Per phase: busy time, and the spread of finishing times
+    std::vector<double> busy(static_cast<size_t>(timeline.phases), 0.0);
+    std::vector<double> first_end(busy.size(), 0.0), last_end(busy.size(), 0.0);
+    std::vector<int> count(busy.size(), 0);
+    for (const WorkerSpan& span : timeline.spans) {
+        if (span.phase < 0 || span.phase >= timeline.phases) continue;
+        size_t p = static_cast<size_t>(span.phase);
+        busy[p] += span.end_ms - span.start_ms;
+        first_end[p] = count[p] == 0 ? span.end_ms : std::min(first_end[p], span.end_ms);
+        last_end[p] = count[p] == 0 ? span.end_ms : std::max(last_end[p], span.end_ms);
+        ++count[p];
+    }
+    for (size_t p = 0; p < busy.size(); ++p) {
+        if (count[p] == 0) continue;
+        stats.idle_tail_ms += last_end[p] - first_end[p];
+        if (stats.main_phase < 0 || busy[p] > busy[static_cast<size_t>(stats.main_phase)]) {
+            stats.main_phase = static_cast<int>(p);
+        }
+    }
+    if (stats.main_phase < 0) return stats;
+
+    double max_busy = 0.0;
+    for (const WorkerSpan& span : timeline.spans) {
+        if (span.phase == stats.main_phase) max_busy = std::max(max_busy, span.end_ms - span.start_ms);
+    }
+    size_t main = static_cast<size_t>(stats.main_phase);
+    stats.workers = count[main];
+    double mean_busy = busy[main] / count[main];
+    stats.imbalance = mean_busy > 0.0 ? max_busy / mean_busy : 1.0;
+    return stats;
+}
+
+WorkerPhase::WorkerPhase()
+    : timeline_(attached_timeline), phase_(timeline_ ? timeline_->phases++ : 0) {}
+
+WorkerSpan* WorkerPhase::spawn(long long items) {
+    return add(items, false);
+}
+
+WorkerSpan* WorkerPhase::run_here(long long items) {
+    return add(items, true);
+}
+
+WorkerSpan* WorkerPhase::add(long long items, bool caller_thread) {
+    if (!timeline_) return nullptr;
+    WorkerSpan span = {phase_, caller_thread, get_time_ms(), 0.0, 0.0, items};
+    span.start_ms = span.end_ms = span.spawn_ms;
+    timeline_->spans.push_back(span);
+    return &timeline_->spans.back();
+}
+
+WorkerSpanScope::WorkerSpanScope(WorkerSpan* span) : span_(span) {
+    if (span_) span_->start_ms = get_time_ms();
+}
+
+WorkerSpanScope::~WorkerSpanScope() {
+    if (span_) span_->end_ms = get_time_ms();
+}
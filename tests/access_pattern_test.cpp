@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "access_pattern.h"
+#include "matrix.h"
+#include "perf_counters.h"
+#include "profiler.h"
+#include <string>
+#include <vector>
+
+class AccessPatternTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m = matrix_create(64, 96);
+        ASSERT_NE(m, nullptr);
+        // Small integers keep every summation order exact
+        for (int i = 0; i < m->rows; i++) {
+            for (int j = 0; j < m->cols; j++) {
+                matrix_set(m, i, j, (double)((i * 7 + j) % 13));
+            }
+        }
+        expected = 0.0;
+        for (size_t k = 0; k < matrix_elements(m); k++) expected += m->data[k];
+    }
+
+    void TearDown() override {
+        matrix_free(m);
+    }
+
+    Matrix* m = nullptr;
+    double expected = 0.0;
+};
+
+TEST_F(AccessPatternTest, WalksLoadEveryElementOnce) {
+    EXPECT_DOUBLE_EQ(access_sum_row_major(m), expected);
+    EXPECT_DOUBLE_EQ(access_sum_column_major(m), expected);
+    const size_t strides[] = {1, 3, 64, 4096, 10000};
+    for (size_t stride : strides) {
+        EXPECT_DOUBLE_EQ(access_sum_stride(m, stride), expected) << "stride " << stride;
+    }
+
+    std::vector<size_t> indices(matrix_elements(m));
+    access_random_permutation(indices.data(), indices.size(), 5);
+    EXPECT_DOUBLE_EQ(access_sum_gather(m, indices.data(), indices.size()), expected);
+}
+
+TEST_F(AccessPatternTest, RandomPermutationIsAPermutation) {
+    std::vector<size_t> indices(1000);
+    access_random_permutation(indices.data(), indices.size(), 9);
+    std::vector<bool> seen(indices.size(), false);
+    size_t in_place = 0;
+    for (size_t k = 0; k < indices.size(); k++) {
+        ASSERT_LT(indices[k], indices.size());
+        EXPECT_FALSE(seen[indices[k]]);
+        seen[indices[k]] = true;
+        if (indices[k] == k) in_place++;
+    }
+    EXPECT_LT(in_place, 20u);
+}
+
+TEST_F(AccessPatternTest, PageStrideTouchesOneLinePerPage) {
+    size_t pages = access_page_count(m);
+    ASSERT_GE(pages, 2u);
+    const size_t page_elems = access_page_size() / sizeof(double);
+    const size_t line_elems = (size_t)get_cache_line_size() / sizeof(double);
+
+    double one_round = 0.0;
+    for (size_t p = 0; p < pages; p++) {
+        one_round += m->data[p * page_elems + (p % (page_elems / line_elems)) * line_elems];
+    }
+    EXPECT_DOUBLE_EQ(access_sum_page_stride(m, pages, 3), 3.0 * one_round);
+    EXPECT_EQ(access_sum_page_stride(m, pages + 1, 1), 0.0);
+}
+
+TEST_F(AccessPatternTest, RunFillsResultAndProfiler) {
+    Profiler profiler;
+    profiler_init(&profiler);
+
+    AccessResult result;
+    ASSERT_EQ(access_run(m, ACCESS_STRIDE, 16, 2, nullptr, &profiler, &result), 0);
+    EXPECT_EQ(result.pattern, ACCESS_STRIDE);
+    EXPECT_EQ(result.param, 16u);
+    EXPECT_EQ(result.accesses, matrix_elements(m));
+    EXPECT_DOUBLE_EQ(result.checksum, expected);
+    EXPECT_GE(result.ms, 0.0);
+    ASSERT_EQ(profiler.count, 1);
+    EXPECT_STREQ(profiler.points[0].name, "access_stride_16");
+
+    size_t pages = access_page_count(m);
+    ASSERT_EQ(access_run(m, ACCESS_PAGE_STRIDE, pages, 1, nullptr, &profiler, &result), 0);
+    EXPECT_EQ(result.accesses, matrix_elements(m) / pages * pages);
+
+    EXPECT_EQ(access_run(m, ACCESS_STRIDE, 0, 1, nullptr, nullptr, &result), -1);
+    EXPECT_EQ(access_run(m, ACCESS_PAGE_STRIDE, pages + 1, 1, nullptr, nullptr, &result), -1);
+    EXPECT_EQ(access_run(nullptr, ACCESS_ROW_MAJOR, 0, 1, nullptr, nullptr, &result), -1);
+}
+
+TEST_F(AccessPatternTest, CountersDegradeGracefully) {
+    PerfCounters counters;
+    int available = perf_counters_open(&counters);
+    EXPECT_GE(available, 0);
+    EXPECT_LE(available, PERF_COUNTER_COUNT);
+
+    AccessResult result;
+    ASSERT_EQ(access_run(m, ACCESS_RANDOM_GATHER, 0, 1, &counters, nullptr, &result), 0);
+    EXPECT_DOUBLE_EQ(result.checksum, expected);
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (!perf_counter_available(&counters, (PerfCounter)c)) {
+            EXPECT_EQ(result.counters[c], 0u);
+        }
+    }
+    perf_counters_close(&counters);
+}
+
+TEST_F(AccessPatternTest, PatternNames) {
+    EXPECT_EQ(std::string(access_pattern_name(ACCESS_ROW_MAJOR)), "row_major");
+    EXPECT_EQ(std::string(access_pattern_name(ACCESS_COLUMN_MAJOR)), "column_major");
+    EXPECT_EQ(std::string(access_pattern_name(ACCESS_STRIDE)), "stride");
+    EXPECT_EQ(std::string(access_pattern_name(ACCESS_PAGE_STRIDE)), "page_stride");
+    EXPECT_EQ(std::string(access_pattern_name(ACCESS_RANDOM_GATHER)), "random_gather");
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "antagonist.h"
+#include "matrix.h"
+#include <string>
+
+class AntagonistTest : public ::testing::Test {
+};
+
+TEST_F(AntagonistTest, EveryKindRunsAndStops) {
+    for (int k = 0; k < ANTAGONIST_KIND_COUNT; k++) {
+        AntagonistKind kind = static_cast<AntagonistKind>(k);
+        // Small working sets keep the test fast
+        Antagonists* antagonists = antagonists_start(kind, 2, 1 << 20, 0);
+        ASSERT_NE(antagonists, nullptr) << antagonist_kind_name(kind);
+
+        // Give the threads some time to generate traffic
+        Matrix* A = matrix_create(64, 64);
+        Matrix* C = matrix_create(64, 64);
+        matrix_randomize(A);
+        for (int i = 0; i < 20; i++) matrix_multiply_naive(A, A, C);
+        matrix_free(A);
+        matrix_free(C);
+
+        EXPECT_GE(antagonists_stop(antagonists), 0.0) << antagonist_kind_name(kind);
+    }
+}
+
+TEST_F(AntagonistTest, RejectsInvalidArguments) {
+    EXPECT_EQ(antagonists_start(ANTAGONIST_CACHE, 0, 1 << 20, 0), nullptr);
+    EXPECT_EQ(antagonists_start(static_cast<AntagonistKind>(2), 1, 1 << 20, 0), nullptr);
+    EXPECT_LT(antagonists_stop(nullptr), 0.0);
+}
+
+TEST_F(AntagonistTest, DefaultWorkingSets) {
+    size_t l3 = static_cast<size_t>(get_l3_cache_size());
+    EXPECT_EQ(antagonist_default_working_set(ANTAGONIST_CACHE), l3);
+    size_t bandwidth = antagonist_default_working_set(ANTAGONIST_BANDWIDTH);
+    EXPECT_GE(bandwidth, static_cast<size_t>(64) << 20);
+    EXPECT_LE(bandwidth, static_cast<size_t>(256) << 20);
+}
+
+TEST_F(AntagonistTest, NamesRoundTrip) {
+    for (int k = 0; k < ANTAGONIST_KIND_COUNT; k++) {
+        AntagonistKind kind = static_cast<AntagonistKind>(k);
+        AntagonistKind parsed;
+        ASSERT_EQ(antagonist_kind_from_name(antagonist_kind_name(kind), &parsed), 0);
+        EXPECT_EQ(parsed, kind);
+    }
+    EXPECT_EQ(std::string(antagonist_kind_name(ANTAGONIST_BANDWIDTH)), "bandwidth");
+    AntagonistKind parsed;
+    EXPECT_EQ(antagonist_kind_from_name("memory", &parsed), -1);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "batched.h"
+#include <vector>
+
+class BatchedTest : public ::testing::Test {
+};
+
+TEST_F(BatchedTest, PointerArrayMatchesNaive) {
+    const int batch = 37;
+    std::vector<Matrix*> A(batch), B(batch), C(batch), C_ref(batch);
+    for (int b = 0; b < batch; b++) {
+        // Mixed shapes are allowed in a pointer-array batch
+        int M = 1 + b % 5, N = 2 + b % 3, P = 1 + b % 4;
+        A[b] = matrix_create(M, N);
+        B[b] = matrix_create(N, P);
+        C[b] = matrix_create(M, P);
+        C_ref[b] = matrix_create(M, P);
+        matrix_randomize(A[b]);
+        matrix_randomize(B[b]);
+        matrix_randomize(C[b]);  // must be overwritten, not accumulated into
+        matrix_multiply_naive(A[b], B[b], C_ref[b]);
+    }
+
+    for (int threads = 1; threads <= 3; threads++) {
+        ASSERT_EQ(matrix_multiply_batched(A.data(), B.data(), C.data(), batch, threads), 0);
+        for (int b = 0; b < batch; b++) {
+            for (int i = 0; i < C[b]->rows * C[b]->cols; i++) {
+                EXPECT_NEAR(C[b]->data[i], C_ref[b]->data[i], 1e-12);
+            }
+        }
+    }
+
+    for (int b = 0; b < batch; b++) {
+        matrix_free(A[b]);
+        matrix_free(B[b]);
+        matrix_free(C[b]);
+        matrix_free(C_ref[b]);
+    }
+}
+
+TEST_F(BatchedTest, StridedAndInterleavedMatchNaive) {
+    const int M = 3, N = 5, P = 4, batch = 130;
+    const size_t sa = M * N + 2, sb = N * P, sc = M * P + 1;  // padded strides
+    std::vector<double> A(sa * batch), B(sb * batch), C(sc * batch, -1.0), ref(M * P * batch);
+
+    Matrix* a = matrix_create(M, N);
+    Matrix* b = matrix_create(N, P);
+    Matrix* c = matrix_create(M, P);
+    for (int k = 0; k < batch; k++) {
+        matrix_randomize(a);
+        matrix_randomize(b);
+        matrix_multiply_naive(a, b, c);
+        std::copy(a->data, a->data + M * N, A.begin() + k * sa);
+        std::copy(b->data, b->data + N * P, B.begin() + k * sb);
+        std::copy(c->data, c->data + M * P, ref.begin() + k * M * P);
+    }
+
+    ASSERT_EQ(matrix_multiply_batched_strided(M, N, P, A.data(), sa, B.data(), sb, C.data(), sc, batch, 2), 0);
+    for (int k = 0; k < batch; k++) {
+        for (int e = 0; e < M * P; e++) {
+            EXPECT_NEAR(C[k * sc + e], ref[k * M * P + e], 1e-12);
+        }
+    }
+
+    std::vector<double> A_i(M * N * batch), B_i(N * P * batch), C_i(M * P * batch), C_back(M * P * batch);
+    matrix_batch_interleave(A.data(), sa, M, N, batch, A_i.data());
+    matrix_batch_interleave(B.data(), sb, N, P, batch, B_i.data());
+    ASSERT_EQ(matrix_multiply_batched_interleaved(M, N, P, A_i.data(), B_i.data(), C_i.data(), batch, 3), 0);
+    matrix_batch_deinterleave(C_i.data(), M, P, batch, C_back.data(), M * P);
+    for (size_t e = 0; e < ref.size(); e++) {
+        EXPECT_NEAR(C_back[e], ref[e], 1e-12);
+    }
+
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(c);
+}
+
+TEST_F(BatchedTest, InvalidArguments) {
+    Matrix* A = matrix_create(2, 3);
+    Matrix* B = matrix_create(4, 2);
+    Matrix* C = matrix_create(2, 2);
+    Matrix* As[] = {A};
+    Matrix* Bs[] = {B};
+    Matrix* Cs[] = {C};
+    EXPECT_EQ(matrix_multiply_batched(As, Bs, Cs, 1, 1), -1);
+
+    double buf[16] = {0};
+    // Stride shorter than a matrix
+    EXPECT_EQ(matrix_multiply_batched_strided(2, 2, 2, buf, 3, buf, 4, buf, 4, 2, 1), -1);
+    EXPECT_EQ(matrix_multiply_batched_interleaved(2, 2, 2, nullptr, buf, buf, 1, 1), -1);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
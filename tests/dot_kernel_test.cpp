@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "dot_kernel.h"
+#include "concurrent_matrix.h"
+#include <vector>
+
+class DotKernelTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        dot_kernel_select_path(DOT_PATH_AUTO);
+    }
+};
+
+// Reference C = A * B_T^T with a single serial accumulator
+static void reference_abt(const std::vector<double>& A, const std::vector<double>& B_T,
+                          std::vector<double>& C, int M, int N, int P) {
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < P; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < N; k++) {
+                sum += A[i * N + k] * B_T[j * N + k];
+            }
+            C[i * P + j] = sum;
+        }
+    }
+}
+
+TEST_F(DotKernelTest, EveryPathMatchesReferenceWithEdges) {
+    // Shapes exercise row, column and k remainders of both block sizes
+    const int shapes[][3] = {{1, 1, 1}, {4, 4, 4}, {7, 9, 5}, {13, 3, 11}, {2, 17, 6}, {33, 31, 29}};
+    const DotKernelPath paths[] = {DOT_PATH_PORTABLE, DOT_PATH_AVX2};
+
+    for (const auto& shape : shapes) {
+        int M = shape[0], N = shape[1], P = shape[2];
+        std::vector<double> A(M * N), B_T(P * N), C_ref(M * P);
+        for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<double>((i * 7) % 11) - 5.0;
+        for (size_t i = 0; i < B_T.size(); i++) B_T[i] = static_cast<double>((i * 5) % 13) * 0.25;
+        reference_abt(A, B_T, C_ref, M, N, P);
+
+        for (DotKernelPath path : paths) {
+            dot_kernel_select_path(path);
+            std::vector<double> C(M * P, -1.0);
+            dot_kernel_rows(A.data(), N, B_T.data(), N, C.data(), P, N, P, 0, M);
+            for (int i = 0; i < M * P; i++) {
+                EXPECT_NEAR(C[i], C_ref[i], 1e-9) << dot_kernel_path_name(dot_kernel_active_path())
+                                                  << " " << M << "x" << N << "x" << P;
+            }
+        }
+    }
+}
+
+TEST_F(DotKernelTest, RowRangeAndLeadingDimensions) {
+    const int M = 10, N = 6, P = 9, lda = 8, ldb = 7, ldc = 12;
+    std::vector<double> A(M * lda, 99.0), B_T(P * ldb, 99.0), C(M * ldc, -1.0);
+    std::vector<double> A_dense(M * N), B_dense(P * N), C_ref(M * P);
+    for (int i = 0; i < M; i++) {
+        for (int k = 0; k < N; k++) A[i * lda + k] = A_dense[i * N + k] = i - k * 0.5;
+    }
+    for (int j = 0; j < P; j++) {
+        for (int k = 0; k < N; k++) B_T[j * ldb + k] = B_dense[j * N + k] = j * 0.25 + k;
+    }
+    reference_abt(A_dense, B_dense, C_ref, M, N, P);
+
+    dot_kernel_rows(A.data(), lda, B_T.data(), ldb, C.data(), ldc, N, P, 3, 8);
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < ldc; j++) {
+            if (i >= 3 && i < 8 && j < P) {
+                EXPECT_NEAR(C[i * ldc + j], C_ref[i * P + j], 1e-9);
+            } else {
+                EXPECT_EQ(C[i * ldc + j], -1.0);  // outside the range: untouched
+            }
+        }
+    }
+}
+
+TEST_F(DotKernelTest, TransposeEntryPointsMatchNaive) {
+    const int M = 37, N = 41, P = 23;
+    Matrix* A = matrix_create(M, N);
+    Matrix* B = matrix_create(N, P);
+    Matrix* C_ref = matrix_create(M, P);
+    Matrix* C = matrix_create(M, P);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    matrix_multiply_naive(A, B, C_ref);
+
+    ASSERT_EQ(matrix_multiply_transpose(A, B, C), 0);
+    for (int i = 0; i < M * P; i++) EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-9);
+
+    matrix_zeros(C);
+    ASSERT_EQ(matrix_multiply_transpose_parallel(A, B, C, 3), 0);
+    for (int i = 0; i < M * P; i++) EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-9);
+
+    matrix_zeros(C);
+    ASSERT_EQ(matrix_multiply_transpose_concurrent(A, B, C, 3), 0);
+    for (int i = 0; i < M * P; i++) EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-9);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+    matrix_free(C);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "environment.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+class EnvironmentTest : public ::testing::Test {
+protected:
+    // A quiet host; tests switch on one noisy setting at a time
+    BenchEnvironment quiet() {
+        BenchEnvironment env;
+        std::memset(&env, 0, sizeof(env));
+        std::strcpy(env.governor, "performance");
+        std::strcpy(env.turbo, "off");
+        std::strcpy(env.thp, "madvise");
+        std::strcpy(env.smt, "off");
+        env.online_cpus = 8;
+        env.load_average = 0.5;
+        return env;
+    }
+};
+
+TEST_F(EnvironmentTest, CaptureFillsEveryField) {
+    BenchEnvironment env;
+    environment_capture(&env);
+    EXPECT_GT(std::strlen(env.cpu_model), 0u);
+    EXPECT_GT(std::strlen(env.governor), 0u);
+    EXPECT_GT(std::strlen(env.kernel), 0u);
+    EXPECT_GT(std::strlen(env.compiler), 0u);
+    EXPECT_GT(std::strlen(env.build_type), 0u);
+    EXPECT_GT(env.online_cpus, 0);
+    EXPECT_GT(env.cache_line, 0);
+    EXPECT_GT(env.l1d_bytes, 0);
+}
+
+TEST_F(EnvironmentTest, SidecarPathReplacesExtension) {
+    char path[256];
+    environment_sidecar_path("profile_results.csv", path, sizeof(path));
+    EXPECT_STREQ(path, "profile_results.env.json");
+    environment_sidecar_path("out/run.v2/results", path, sizeof(path));
+    EXPECT_STREQ(path, "out/run.v2/results.env.json");
+    environment_sidecar_path("/tmp/a.b.jsonl", path, sizeof(path));
+    EXPECT_STREQ(path, "/tmp/a.b.env.json");
+}
+
+TEST_F(EnvironmentTest, SaveWritesJson) {
+    BenchEnvironment env;
+    environment_capture(&env);
+    std::strcpy(env.cpu_model, "Quoted \"model\"");
+    const char* filename = "environment_test.env.json";
+    ASSERT_EQ(environment_save(&env, filename), 0);
+
+    std::ifstream file(filename);
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string json = text.str();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_NE(json.find("\"cpu_model\": \"Quoted \\\"model\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"l3_bytes\": "), std::string::npos);
+    std::remove(filename);
+}
+
+TEST_F(EnvironmentTest, CheckFindsNoisySettings) {
+    char warnings[1024];
+    BenchEnvironment env = quiet();
+    EXPECT_EQ(environment_check(&env, warnings, sizeof(warnings)), 0);
+    EXPECT_STREQ(warnings, "");
+
+    std::strcpy(env.governor, "powersave");
+    EXPECT_EQ(environment_check(&env, warnings, sizeof(warnings)), 1);
+    EXPECT_NE(std::strstr(warnings, "powersave"), nullptr);
+
+    std::strcpy(env.turbo, "on");
+    std::strcpy(env.thp, "always");
+    std::strcpy(env.smt, "on");
+    env.load_average = 6.0;
+    EXPECT_EQ(environment_check(&env, warnings, sizeof(warnings)), 5);
+
+    // Unknown settings are not findings
+    env = quiet();
+    std::strcpy(env.governor, "unknown");
+    std::strcpy(env.turbo, "unknown");
+    EXPECT_EQ(environment_check(&env, nullptr, 0), 0);
+}
+
+TEST_F(EnvironmentTest, ParsesCpuLists) {
+    int cpus[16];
+    ASSERT_EQ(environment_parse_cpulist("0-3,6", cpus, 16), 5);
+    EXPECT_EQ(cpus[3], 3);
+    EXPECT_EQ(cpus[4], 6);
+    EXPECT_EQ(environment_parse_cpulist("2\n", cpus, 16), 1);
+    EXPECT_EQ(environment_parse_cpulist("", cpus, 16), 0);
+    EXPECT_EQ(environment_parse_cpulist("3-1", cpus, 16), -1);
+    EXPECT_EQ(environment_parse_cpulist("a", cpus, 16), -1);
+    EXPECT_EQ(environment_parse_cpulist("0-20", cpus, 16), -1);
+    EXPECT_EQ(environment_pin("x"), -1);
+}
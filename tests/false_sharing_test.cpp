@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "false_sharing.h"
+#include "matrix.h"
+#include <cstdint>
+
+class FalseSharingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        line = get_cache_line_size();
+    }
+
+    int line = 64;
+};
+
+TEST_F(FalseSharingTest, MatrixDataIsCacheLineAligned) {
+    for (int n : {1, 3, 7, 64, 129}) {
+        Matrix* m = matrix_create(n, n);
+        ASSERT_NE(m, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(m->data) % MATRIX_ALIGNMENT, 0u) << n;
+        for (size_t i = 0; i < matrix_elements(m); i++) {
+            EXPECT_EQ(m->data[i], 0.0);
+        }
+        matrix_free(m);
+    }
+}
+
+TEST_F(FalseSharingTest, PartitionRowsOnCacheLines) {
+    if (line != 64) GTEST_SKIP() << "expected bounds assume 64-byte lines";
+    Matrix* m = matrix_create(10, 3);
+    int bounds[4];
+    // 24-byte rows: every 8th row starts a line
+    ASSERT_EQ(matrix_partition_rows(m->data, 3, 10, 2, bounds), 1);
+    EXPECT_EQ(bounds[0], 0);
+    EXPECT_EQ(bounds[1], 8);
+    EXPECT_EQ(bounds[2], 10);
+
+    // Rows that are whole lines split evenly
+    int wide[5];
+    Matrix* w = matrix_create(100, 8);
+    ASSERT_EQ(matrix_partition_rows(w->data, 8, 100, 4, wide), 1);
+    EXPECT_EQ(wide[1], 25);
+    EXPECT_EQ(wide[2], 50);
+    EXPECT_EQ(wide[3], 75);
+    EXPECT_EQ(wide[4], 100);
+
+    // More parts than aligned rows: empty ranges, still aligned
+    int many[9];
+    EXPECT_EQ(matrix_partition_rows(m->data, 3, 10, 8, many), 1);
+    for (int t = 0; t < 8; t++) EXPECT_LE(many[t], many[t + 1]);
+    EXPECT_EQ(many[8], 10);
+
+    // Row starts that never meet a line: plain even split
+    EXPECT_EQ(matrix_partition_rows(w->data + 1, 8, 99, 3, bounds), 0);
+    EXPECT_EQ(bounds[1], 33);
+    EXPECT_EQ(bounds[2], 66);
+    EXPECT_EQ(bounds[3], 99);
+
+    EXPECT_EQ(matrix_partition_rows(m->data, 3, 10, 0, bounds), -1);
+    EXPECT_EQ(matrix_partition_rows(nullptr, 3, 10, 2, bounds), -1);
+    matrix_free(m);
+    matrix_free(w);
+}
+
+TEST_F(FalseSharingTest, LayoutOwners) {
+    Matrix* m = matrix_create(10, 3);
+    std::vector<int> interleaved = row_layout_owners(ROW_LAYOUT_INTERLEAVED, m, 2);
+    std::vector<int> contiguous = row_layout_owners(ROW_LAYOUT_CONTIGUOUS, m, 2);
+    std::vector<int> aligned = row_layout_owners(ROW_LAYOUT_ALIGNED, m, 2);
+    ASSERT_EQ(interleaved.size(), 10u);
+    for (int r = 0; r < 10; r++) {
+        EXPECT_EQ(interleaved[r], r % 2);
+        EXPECT_EQ(contiguous[r], r < 5 ? 0 : 1);
+    }
+    if (line == 64) {
+        for (int r = 0; r < 10; r++) EXPECT_EQ(aligned[r], r < 8 ? 0 : 1);
+    }
+    matrix_free(m);
+}
+
+TEST_F(FalseSharingTest, CountsSharedLines) {
+    if (line != 64) GTEST_SKIP() << "expected counts assume 64-byte lines";
+    // 10 x 3 doubles = 240 bytes over 4 lines from an aligned base
+    Matrix* m = matrix_create(10, 3);
+    EXPECT_EQ(count_shared_lines(m, row_layout_owners(ROW_LAYOUT_INTERLEAVED, m, 2)), 4);
+    EXPECT_EQ(count_shared_lines(m, row_layout_owners(ROW_LAYOUT_CONTIGUOUS, m, 2)), 1);
+    EXPECT_EQ(count_shared_lines(m, row_layout_owners(ROW_LAYOUT_ALIGNED, m, 2)), 0);
+    EXPECT_EQ(count_shared_lines(m, std::vector<int>(10, 0)), 0);
+    matrix_free(m);
+}
+
+TEST_F(FalseSharingTest, RunUpdatesEveryLayout) {
+    for (int l = 0; l < ROW_LAYOUT_COUNT; l++) {
+        FalseSharingResult result;
+        ASSERT_EQ(run_false_sharing(static_cast<RowLayout>(l), 64, 3, 2, 10, 1, result), 0);
+        EXPECT_EQ(result.layout, static_cast<RowLayout>(l));
+        EXPECT_EQ(result.rows, 64);
+        EXPECT_EQ(result.threads, 2);
+        EXPECT_GE(result.ms, 0.0);
+        EXPECT_GE(result.ns_per_update, 0.0);
+    }
+    FalseSharingResult result;
+    EXPECT_EQ(run_false_sharing(ROW_LAYOUT_ALIGNED, 0, 3, 2, 10, 1, result), -1);
+    EXPECT_EQ(run_false_sharing(ROW_LAYOUT_ALIGNED, 8, 3, 0, 10, 1, result), -1);
+}
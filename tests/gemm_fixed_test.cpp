@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "gemm_fixed.h"
+#include "batched.h"
+#include <vector>
+
+class GemmFixedTest : public ::testing::Test {
+};
+
+TEST_F(GemmFixedTest, EverySquareSizeMatchesNaive) {
+    for (int n = GEMM_FIXED_MIN_SIZE; n <= GEMM_FIXED_MAX_SIZE; n++) {
+        Matrix* A = matrix_create(n, n);
+        Matrix* B = matrix_create(n, n);
+        Matrix* C = matrix_create(n, n);
+        Matrix* C_ref = matrix_create(n, n);
+        matrix_randomize(A);
+        matrix_randomize(B);
+        matrix_randomize(C);  // must be overwritten, not accumulated into
+
+        ASSERT_TRUE(matrix_fixed_kernel_available(n, n, n));
+        ASSERT_EQ(matrix_multiply_fixed(A, B, C), 0);
+        matrix_multiply_naive(A, B, C_ref);
+        for (int i = 0; i < n * n; i++) {
+            EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-12) << "size " << n;
+        }
+
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C);
+        matrix_free(C_ref);
+    }
+}
+
+TEST_F(GemmFixedTest, RectangularTemplateMatchesNaive) {
+    Matrix* A = matrix_create(3, 5);
+    Matrix* B = matrix_create(5, 7);
+    Matrix* C = matrix_create(3, 7);
+    Matrix* C_ref = matrix_create(3, 7);
+    matrix_randomize(A);
+    matrix_randomize(B);
+
+    gemm_fixed<3, 7, 5>(A->data, B->data, C->data);
+    matrix_multiply_naive(A, B, C_ref);
+    for (int i = 0; i < 3 * 7; i++) {
+        EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-12);
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    matrix_free(C_ref);
+}
+
+TEST_F(GemmFixedTest, UnsupportedShapesAreRejected) {
+    EXPECT_FALSE(matrix_fixed_kernel_available(1, 1, 1));
+    EXPECT_FALSE(matrix_fixed_kernel_available(GEMM_FIXED_MAX_SIZE + 1, GEMM_FIXED_MAX_SIZE + 1,
+                                               GEMM_FIXED_MAX_SIZE + 1));
+    EXPECT_FALSE(matrix_fixed_kernel_available(4, 4, 8));
+
+    Matrix* A = matrix_create(4, 8);
+    Matrix* B = matrix_create(8, 4);
+    Matrix* C = matrix_create(4, 4);
+    EXPECT_EQ(matrix_multiply_fixed(A, B, C), -1);
+    EXPECT_EQ(matrix_multiply_fixed(A, A, C), -1);
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
+
+TEST_F(GemmFixedTest, DispatchFromParallelAndStridedEntryPoints) {
+    const int n = 8, batch = 5;
+    const size_t elems = n * n;
+    std::vector<double> A(elems * batch), B(elems * batch), C(elems * batch, -1.0);
+    for (size_t i = 0; i < A.size(); i++) {
+        A[i] = static_cast<double>(i % 7) - 3.0;
+        B[i] = static_cast<double>(i % 5) * 0.5;
+    }
+    ASSERT_EQ(matrix_multiply_batched_strided(n, n, n, A.data(), elems, B.data(), elems,
+                                              C.data(), elems, batch, 2), 0);
+
+    Matrix* Am = matrix_create(n, n);
+    Matrix* Bm = matrix_create(n, n);
+    Matrix* Cm = matrix_create(n, n);
+    Matrix* C_ref = matrix_create(n, n);
+    for (int b = 0; b < batch; b++) {
+        std::copy(A.begin() + b * elems, A.begin() + (b + 1) * elems, Am->data);
+        std::copy(B.begin() + b * elems, B.begin() + (b + 1) * elems, Bm->data);
+        matrix_multiply_naive(Am, Bm, C_ref);
+        ASSERT_EQ(matrix_multiply_blocked_parallel(Am, Bm, Cm, 0, 2), 0);
+        for (size_t i = 0; i < elems; i++) {
+            EXPECT_NEAR(C[b * elems + i], C_ref->data[i], 1e-12);
+            EXPECT_NEAR(Cm->data[i], C_ref->data[i], 1e-12);
+        }
+    }
+    matrix_free(Am);
+    matrix_free(Bm);
+    matrix_free(Cm);
+    matrix_free(C_ref);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "gemm.h"
+#include <cmath>
+#include <limits>
+
+class GemmTest : public ::testing::Test {
+};
+
+static Matrix* transposed_copy(Matrix* m) {
+    Matrix* t = matrix_create(m->cols, m->rows);
+    for (int i = 0; i < m->rows; i++) {
+        for (int j = 0; j < m->cols; j++) {
+            matrix_set(t, j, i, matrix_get(m, i, j));
+        }
+    }
+    return t;
+}
+
+TEST_F(GemmTest, AllTransposeCombinationsWithAlphaBeta) {
+    int M = 13, K = 21, N = 10;
+    Matrix* A = matrix_create(M, K);
+    Matrix* B = matrix_create(K, N);
+    Matrix* AB = matrix_create(M, N);
+    Matrix* C0 = matrix_create(M, N);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    matrix_randomize(C0);
+    matrix_multiply_naive(A, B, AB);
+
+    Matrix* A_T = transposed_copy(A);
+    Matrix* B_T = transposed_copy(B);
+    const double alpha = 1.5;
+    const double beta = -0.5;
+
+    for (int ta = 0; ta < 2; ta++) {
+        for (int tb = 0; tb < 2; tb++) {
+            Matrix* C = matrix_create(M, N);
+            for (int i = 0; i < M * N; i++) C->data[i] = C0->data[i];
+
+            MatrixView a = matrix_view(ta ? A_T : A);
+            MatrixView b = matrix_view(tb ? B_T : B);
+            MatrixView c = matrix_view(C);
+            ASSERT_EQ(matrix_gemm(ta ? GEMM_TRANS : GEMM_NO_TRANS, tb ? GEMM_TRANS : GEMM_NO_TRANS,
+                                  alpha, &a, &b, beta, &c, 4), 0);
+
+            for (int i = 0; i < M * N; i++) {
+                EXPECT_NEAR(C->data[i], alpha * AB->data[i] + beta * C0->data[i], 1e-12)
+                    << "transA=" << ta << " transB=" << tb;
+            }
+            matrix_free(C);
+        }
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(AB);
+    matrix_free(C0);
+    matrix_free(A_T);
+    matrix_free(B_T);
+}
+
+TEST_F(GemmTest, SubviewsLeaveSurroundingElementsUntouched) {
+    // Multiply 3x4 and 4x2 windows out of larger matrices into a 3x2 window of C
+    Matrix* A_big = matrix_create(8, 9);
+    Matrix* B_big = matrix_create(7, 6);
+    Matrix* C_big = matrix_create(5, 5);
+    matrix_randomize(A_big);
+    matrix_randomize(B_big);
+    for (int i = 0; i < 25; i++) C_big->data[i] = 7.0;
+
+    MatrixView a = matrix_subview(A_big, 2, 3, 3, 4);
+    MatrixView b = matrix_subview(B_big, 1, 2, 4, 2);
+    MatrixView c = matrix_subview(C_big, 1, 1, 3, 2);
+    ASSERT_NE(a.data, nullptr);
+    ASSERT_NE(b.data, nullptr);
+    ASSERT_NE(c.data, nullptr);
+    ASSERT_EQ(matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &a, &b, 0.0, &c, 0), 0);
+
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            if (i >= 1 && i < 4 && j >= 1 && j < 3) {
+                double expected = 0.0;
+                for (int k = 0; k < 4; k++) {
+                    expected += matrix_get(A_big, 2 + i - 1, 3 + k) * matrix_get(B_big, 1 + k, 2 + j - 1);
+                }
+                EXPECT_NEAR(matrix_get(C_big, i, j), expected, 1e-12);
+            } else {
+                EXPECT_DOUBLE_EQ(matrix_get(C_big, i, j), 7.0);
+            }
+        }
+    }
+
+    matrix_free(A_big);
+    matrix_free(B_big);
+    matrix_free(C_big);
+}
+
+TEST_F(GemmTest, BetaZeroIgnoresGarbageInC) {
+    Matrix* A = matrix_create(4, 4);
+    Matrix* B = matrix_create(4, 4);
+    Matrix* C = matrix_create(4, 4);
+    Matrix* C_ref = matrix_create(4, 4);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    for (int i = 0; i < 16; i++) C->data[i] = std::numeric_limits<double>::quiet_NaN();
+    matrix_multiply_naive(A, B, C_ref);
+
+    MatrixView a = matrix_view(A);
+    MatrixView b = matrix_view(B);
+    MatrixView c = matrix_view(C);
+    ASSERT_EQ(matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &a, &b, 0.0, &c, 0), 0);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-12);
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    matrix_free(C_ref);
+}
+
+TEST_F(GemmTest, InvalidViewsAndDimensionMismatch) {
+    Matrix* A = matrix_create(2, 3);
+    Matrix* B = matrix_create(4, 2);
+    Matrix* C = matrix_create(2, 2);
+
+    MatrixView a = matrix_view(A);
+    MatrixView b = matrix_view(B);
+    MatrixView c = matrix_view(C);
+    EXPECT_EQ(matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &a, &b, 0.0, &c, 0), -1);
+    // A^T is 3x2, B^T is 2x4: inner dimensions still disagree
+    EXPECT_EQ(matrix_gemm(GEMM_TRANS, GEMM_TRANS, 1.0, &a, &b, 0.0, &c, 0), -1);
+
+    MatrixView out_of_range = matrix_subview(A, 1, 1, 2, 2);
+    EXPECT_EQ(out_of_range.data, nullptr);
+    EXPECT_EQ(matrix_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 1.0, &out_of_range, &b, 0.0, &c, 0), -1);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
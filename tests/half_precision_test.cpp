@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "half_precision.h"
+#include <cmath>
+#include <limits>
+
+class HalfPrecisionTest : public ::testing::Test {
+};
+
+TEST_F(HalfPrecisionTest, ScalarConversionsKnownValues) {
+    EXPECT_EQ(float_to_bf16(1.0f), 0x3F80);
+    EXPECT_EQ(float_to_bf16(-2.0f), 0xC000);
+    EXPECT_EQ(float_to_fp16(1.0f), 0x3C00);
+    EXPECT_EQ(float_to_fp16(-2.0f), 0xC000);
+    EXPECT_EQ(float_to_fp16(65504.0f), 0x7BFF);
+    EXPECT_EQ(float_to_fp16(70000.0f), 0x7C00);
+
+    EXPECT_FLOAT_EQ(bf16_to_float(0x3F80), 1.0f);
+    EXPECT_FLOAT_EQ(fp16_to_float(0x3C00), 1.0f);
+    EXPECT_FLOAT_EQ(fp16_to_float(0x7BFF), 65504.0f);
+
+    // Smallest fp16 subnormal is 2^-24
+    EXPECT_EQ(float_to_fp16(std::ldexp(1.0f, -24)), 0x0001);
+    EXPECT_FLOAT_EQ(fp16_to_float(0x0001), std::ldexp(1.0f, -24));
+
+    EXPECT_TRUE(std::isnan(fp16_to_float(float_to_fp16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isnan(bf16_to_float(float_to_bf16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST_F(HalfPrecisionTest, RoundToNearestEven) {
+    // 1 + 2^-11 is halfway between 1 and the next fp16 value: ties to even (1.0)
+    EXPECT_EQ(float_to_fp16(1.0f + std::ldexp(1.0f, -11)), 0x3C00);
+    // 1 + 3 * 2^-11 is halfway between odd and even: rounds up to even
+    EXPECT_EQ(float_to_fp16(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3C02);
+    // Same for bf16 with 7 mantissa bits
+    EXPECT_EQ(float_to_bf16(1.0f + std::ldexp(1.0f, -8)), 0x3F80);
+    EXPECT_EQ(float_to_bf16(1.0f + 3.0f * std::ldexp(1.0f, -8)), 0x3F82);
+}
+
+TEST_F(HalfPrecisionTest, MatrixRoundTrip) {
+    Matrix* m = matrix_create(9, 11);
+    Matrix* back = matrix_create(9, 11);
+    matrix_randomize(m);
+
+    const HalfType types[] = {HALF_BF16, HALF_FP16};
+    const double tolerance[] = {1.0 / 256.0, 1.0 / 2048.0};
+    for (int t = 0; t < 2; t++) {
+        HMatrix* h = hmatrix_create(9, 11, types[t]);
+        ASSERT_NE(h, nullptr);
+        ASSERT_EQ(matrix_to_half(m, h), 0);
+        ASSERT_EQ(matrix_from_half(h, back), 0);
+        for (int i = 0; i < 9 * 11; i++) {
+            EXPECT_NEAR(back->data[i], m->data[i], tolerance[t]);
+        }
+        hmatrix_free(h);
+    }
+
+    matrix_free(m);
+    matrix_free(back);
+}
+
+TEST_F(HalfPrecisionTest, BlockedMultiplyMatchesDouble) {
+    int M = 21, N = 35, P = 18;
+    Matrix* A = matrix_create(M, N);
+    Matrix* B = matrix_create(N, P);
+    Matrix* C_ref = matrix_create(M, P);
+    Matrix* C = matrix_create(M, P);
+    Matrix* A_rounded = matrix_create(M, N);
+    Matrix* B_rounded = matrix_create(N, P);
+    matrix_randomize(A);
+    matrix_randomize(B);
+
+    const HalfType types[] = {HALF_BF16, HALF_FP16};
+    for (HalfType type : types) {
+        HMatrix* A_h = hmatrix_create(M, N, type);
+        HMatrix* B_h = hmatrix_create(N, P, type);
+        matrix_to_half(A, A_h);
+        matrix_to_half(B, B_h);
+
+        // With fp64 accumulation the only error is the storage rounding
+        matrix_from_half(A_h, A_rounded);
+        matrix_from_half(B_h, B_rounded);
+        matrix_multiply_naive(A_rounded, B_rounded, C_ref);
+
+        ASSERT_EQ(matrix_multiply_half_blocked(A_h, B_h, C, 8, HALF_ACCUM_FP64), 0);
+        double max_err = 1.0;
+        ASSERT_EQ(matrix_compare(C_ref, C, &max_err, nullptr), 0);
+        EXPECT_LT(max_err, 1e-12);
+
+        ASSERT_EQ(matrix_multiply_half_blocked(A_h, B_h, C, 0, HALF_ACCUM_FP32), 0);
+        matrix_compare(C_ref, C, &max_err, nullptr);
+        EXPECT_LT(max_err, 1e-4);
+
+        hmatrix_free(A_h);
+        hmatrix_free(B_h);
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+    matrix_free(C);
+    matrix_free(A_rounded);
+    matrix_free(B_rounded);
+}
+
+TEST_F(HalfPrecisionTest, DimensionAndTypeMismatch) {
+    HMatrix* A = hmatrix_create(2, 3, HALF_BF16);
+    HMatrix* B = hmatrix_create(4, 2, HALF_BF16);
+    HMatrix* B_fp16 = hmatrix_create(3, 2, HALF_FP16);
+    Matrix* C = matrix_create(2, 2);
+
+    EXPECT_EQ(matrix_multiply_half_blocked(A, B, C, 0, HALF_ACCUM_FP32), -1);
+    EXPECT_EQ(matrix_multiply_half_blocked(A, B_fp16, C, 0, HALF_ACCUM_FP32), -1);
+    EXPECT_EQ(matrix_multiply_half_blocked(nullptr, B, C, 0, HALF_ACCUM_FP32), -1);
+
+    hmatrix_free(A);
+    hmatrix_free(B);
+    hmatrix_free(B_fp16);
+    matrix_free(C);
+}
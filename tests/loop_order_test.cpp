@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "loop_order.h"
+#include "matrix.h"
+#include <cmath>
+#include <string>
+
+class LoopOrderTest : public ::testing::Test {
+protected:
+    double max_diff(const Matrix* X, const Matrix* Y) {
+        double diff = 0.0;
+        for (size_t i = 0; i < matrix_elements(X); i++) {
+            diff = std::max(diff, std::fabs(X->data[i] - Y->data[i]));
+        }
+        return diff;
+    }
+};
+
+TEST_F(LoopOrderTest, EveryOrderMatchesNaive) {
+    // Rectangular, with edges that do not divide the block size
+    Matrix* A = matrix_create(37, 29);
+    Matrix* B = matrix_create(29, 41);
+    Matrix* C_ref = matrix_create(37, 41);
+    Matrix* C = matrix_create(37, 41);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    ASSERT_EQ(matrix_multiply_naive(A, B, C_ref), 0);
+
+    for (int o = 0; o < LOOP_ORDER_COUNT; o++) {
+        LoopOrder order = static_cast<LoopOrder>(o);
+        // Stale contents must be overwritten
+        for (size_t i = 0; i < matrix_elements(C); i++) C->data[i] = 99.0;
+        ASSERT_EQ(matrix_multiply_loop_order(A, B, C, order), 0);
+        EXPECT_LT(max_diff(C_ref, C), 1e-12) << loop_order_name(order) << " unblocked";
+
+        for (size_t i = 0; i < matrix_elements(C); i++) C->data[i] = 99.0;
+        ASSERT_EQ(matrix_multiply_loop_order_blocked(A, B, C, order, 8), 0);
+        EXPECT_LT(max_diff(C_ref, C), 1e-12) << loop_order_name(order) << " blocked";
+
+        ASSERT_EQ(matrix_multiply_loop_order_blocked(A, B, C, order, 0), 0);
+        EXPECT_LT(max_diff(C_ref, C), 1e-12) << loop_order_name(order) << " default block";
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+    matrix_free(C);
+}
+
+TEST_F(LoopOrderTest, RejectsMismatchAndInvalidOrder) {
+    Matrix* A = matrix_create(4, 3);
+    Matrix* B = matrix_create(4, 3);
+    Matrix* C = matrix_create(4, 3);
+    EXPECT_EQ(matrix_multiply_loop_order(A, B, C, LOOP_IJK), -1);
+    EXPECT_EQ(matrix_multiply_loop_order_blocked(A, B, C, LOOP_KJI, 0), -1);
+    EXPECT_EQ(matrix_multiply_loop_order(nullptr, B, C, LOOP_IJK), -1);
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+
+    // Conforming operands, so only the order can be rejected
+    Matrix* S = matrix_create(3, 3);
+    Matrix* T = matrix_create(3, 3);
+    Matrix* U = matrix_create(3, 3);
+    EXPECT_EQ(matrix_multiply_loop_order(S, T, U, LOOP_KJI), 0);
+    EXPECT_EQ(matrix_multiply_loop_order(S, T, U, static_cast<LoopOrder>(LOOP_ORDER_COUNT)), -1);
+    EXPECT_EQ(matrix_multiply_loop_order_blocked(S, T, U, static_cast<LoopOrder>(LOOP_ORDER_COUNT), 0), -1);
+    matrix_free(S);
+    matrix_free(T);
+    matrix_free(U);
+}
+
+TEST_F(LoopOrderTest, NamesRoundTrip) {
+    const char* expected[] = {"ijk", "ikj", "jik", "jki", "kij", "kji"};
+    for (int o = 0; o < LOOP_ORDER_COUNT; o++) {
+        EXPECT_EQ(std::string(loop_order_name(static_cast<LoopOrder>(o))), expected[o]);
+        LoopOrder parsed;
+        ASSERT_EQ(loop_order_from_name(expected[o], &parsed), 0);
+        EXPECT_EQ(parsed, static_cast<LoopOrder>(o));
+    }
+    LoopOrder parsed;
+    EXPECT_EQ(loop_order_from_name("ikk", &parsed), -1);
+}
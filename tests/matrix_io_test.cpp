@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "matrix_io.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class MatrixIoTest : public ::testing::Test {
+protected:
+    std::string path(const char* name) {
+        return ::testing::TempDir() + name;
+    }
+
+    void TearDown() override {
+        for (const std::string& p : created_) std::remove(p.c_str());
+    }
+
+    std::string track(const std::string& p) {
+        created_.push_back(p);
+        return p;
+    }
+
+private:
+    std::vector<std::string> created_;
+};
+
+static void fill_index(Matrix* m) {
+    for (size_t i = 0; i < matrix_elements(m); i++) m->data[i] = static_cast<double>(i) * 0.5;
+}
+
+static void write_raw(const std::string& p, const std::string& header, const void* data, size_t bytes) {
+    FILE* f = std::fopen(p.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fwrite(header.data(), 1, header.size(), f);
+    std::fwrite(data, 1, bytes, f);
+    std::fclose(f);
+}
+
+// .npy v1.0 header as NumPy writes it (padded to 64 bytes)
+static std::string npy_header(const char* dict) {
+    std::string h = dict;
+    size_t total = 10 + h.size() + 1;
+    total = (total + 63) / 64 * 64;
+    h.append(total - 10 - h.size() - 1, ' ');
+    h += '\n';
+    std::string out = "\x93NUMPY";
+    out += static_cast<char>(1);
+    out += static_cast<char>(0);
+    out += static_cast<char>(h.size() & 0xff);
+    out += static_cast<char>(h.size() >> 8);
+    return out + h;
+}
+
+TEST_F(MatrixIoTest, SaveLoadRoundTripBothFormats) {
+    const char* names[] = {"/io_roundtrip.clm", "/io_roundtrip.npy"};
+    const MatrixFileFormat formats[] = {MATRIX_FORMAT_CLM, MATRIX_FORMAT_NPY};
+    Matrix* m = matrix_create(7, 5);
+    fill_index(m);
+
+    for (int f = 0; f < 2; f++) {
+        std::string p = track(path(names[f]));
+        ASSERT_EQ(matrix_save(p.c_str(), m, MATRIX_FORMAT_AUTO), 0);
+
+        MatrixFileInfo info;
+        ASSERT_EQ(matrix_file_info(p.c_str(), &info), 0);
+        EXPECT_EQ(info.format, formats[f]);
+        EXPECT_EQ(info.dtype, MATRIX_DTYPE_F64);
+        EXPECT_EQ(info.rows, 7);
+        EXPECT_EQ(info.cols, 5);
+        EXPECT_EQ(info.data_offset % 64, 0u);
+
+        Matrix* loaded = matrix_load(p.c_str());
+        ASSERT_NE(loaded, nullptr);
+        ASSERT_EQ(loaded->rows, 7);
+        ASSERT_EQ(loaded->cols, 5);
+        EXPECT_EQ(std::memcmp(loaded->data, m->data, 35 * sizeof(double)), 0);
+        matrix_free(loaded);
+    }
+    matrix_free(m);
+}
+
+TEST_F(MatrixIoTest, MapIsZeroCopyAndCopyOnWriteWhenReadOnly) {
+    std::string p = track(path("/io_map.clm"));
+    Matrix* m = matrix_create(4, 6);
+    fill_index(m);
+    ASSERT_EQ(matrix_save(p.c_str(), m, MATRIX_FORMAT_CLM), 0);
+
+    MappedMatrix* mm = matrix_map(p.c_str(), 0);
+    ASSERT_NE(mm, nullptr);
+    EXPECT_EQ(mm->matrix.rows, 4);
+    EXPECT_EQ(mm->view.ld, 6);
+    EXPECT_EQ(reinterpret_cast<unsigned char*>(mm->matrix.data) - static_cast<unsigned char*>(mm->base), 64);
+    EXPECT_EQ(std::memcmp(mm->matrix.data, m->data, 24 * sizeof(double)), 0);
+
+    // Private mapping: the store is visible here but not in the file
+    mm->matrix.data[0] = 42.0;
+    EXPECT_EQ(matrix_map_sync(mm), -1);
+    matrix_unmap(mm);
+    Matrix* loaded = matrix_load(p.c_str());
+    EXPECT_EQ(loaded->data[0], m->data[0]);
+    matrix_free(loaded);
+    matrix_free(m);
+}
+
+TEST_F(MatrixIoTest, MapCreateWritesResultsToFile) {
+    std::string p = track(path("/io_result.npy"));
+    Matrix* A = matrix_create(3, 4);
+    Matrix* B = matrix_create(4, 2);
+    Matrix* C_ref = matrix_create(3, 2);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    matrix_multiply_naive(A, B, C_ref);
+
+    MappedMatrix* out = matrix_map_create(p.c_str(), 3, 2, MATRIX_FORMAT_AUTO);
+    ASSERT_NE(out, nullptr);
+    ASSERT_EQ(matrix_multiply_naive(A, B, &out->matrix), 0);
+    ASSERT_EQ(matrix_map_sync(out), 0);
+    matrix_unmap(out);
+
+    Matrix* loaded = matrix_load(p.c_str());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(std::memcmp(loaded->data, C_ref->data, 6 * sizeof(double)), 0);
+
+    matrix_free(loaded);
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+}
+
+TEST_F(MatrixIoTest, NpyFloat32FortranAndOneDimensional) {
+    // 2 x 3 Fortran-order float32: columns stored contiguously
+    std::string p = track(path("/io_f4.npy"));
+    const float col_major[] = {1, 4, 2, 5, 3, 6};
+    write_raw(p, npy_header("{'descr': '<f4', 'fortran_order': True, 'shape': (2, 3), }"),
+              col_major, sizeof(col_major));
+
+    MatrixFileInfo info;
+    ASSERT_EQ(matrix_file_info(p.c_str(), &info), 0);
+    EXPECT_EQ(info.dtype, MATRIX_DTYPE_F32);
+    EXPECT_EQ(info.layout, MATRIX_LAYOUT_COL_MAJOR);
+    EXPECT_EQ(matrix_map(p.c_str(), 0), nullptr);  // needs conversion
+
+    Matrix* m = matrix_load(p.c_str());
+    ASSERT_NE(m, nullptr);
+    ASSERT_EQ(m->rows, 2);
+    ASSERT_EQ(m->cols, 3);
+    for (int i = 0; i < 6; i++) EXPECT_EQ(m->data[i], static_cast<double>(i + 1));
+    matrix_free(m);
+
+    std::string p1 = track(path("/io_1d.npy"));
+    const double vec[] = {3.0, 1.0, 2.0};
+    write_raw(p1, npy_header("{'descr': '<f8', 'fortran_order': False, 'shape': (3,), }"),
+              vec, sizeof(vec));
+    MappedMatrix* mm = matrix_map(p1.c_str(), 0);
+    ASSERT_NE(mm, nullptr);
+    EXPECT_EQ(mm->matrix.rows, 1);
+    EXPECT_EQ(mm->matrix.cols, 3);
+    EXPECT_EQ(mm->matrix.data[2], 2.0);
+    matrix_unmap(mm);
+}
+
+TEST_F(MatrixIoTest, RejectsTruncatedAndForeignFiles) {
+    std::string p = track(path("/io_truncated.npy"));
+    const double two[] = {1.0, 2.0};
+    write_raw(p, npy_header("{'descr': '<f8', 'fortran_order': False, 'shape': (2, 2), }"),
+              two, sizeof(two));
+    MatrixFileInfo info;
+    EXPECT_EQ(matrix_file_info(p.c_str(), &info), -1);
+    EXPECT_EQ(matrix_load(p.c_str()), nullptr);
+
+    std::string q = track(path("/io_int.npy"));
+    const long long ints[] = {1, 2};
+    write_raw(q, npy_header("{'descr': '<i8', 'fortran_order': False, 'shape': (2,), }"),
+              ints, sizeof(ints));
+    EXPECT_EQ(matrix_file_info(q.c_str(), &info), -1);
+    EXPECT_EQ(matrix_load(path("/io_missing.clm").c_str()), nullptr);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "matrix_random.h"
+#include <cstring>
+#include <vector>
+
+class MatrixRandomTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        random_select_path(RANDOM_PATH_AUTO);
+        matrix_random_set_seed(MATRIX_RANDOM_DEFAULT_SEED);
+    }
+};
+
+TEST_F(MatrixRandomTest, FillMatchesPointwiseValuesOnEveryPath) {
+    const RandomPath paths[] = {RANDOM_PATH_PORTABLE, RANDOM_PATH_AVX2};
+    const size_t count = 1003;  // not a multiple of the vector width
+    const uint64_t offset = 77;
+
+    for (RandomPath path : paths) {
+        if (random_select_path(path) != path) continue;  // not supported here
+        std::vector<double> data(count);
+        random_fill_uniform(data.data(), count, 42, offset);
+        for (size_t k = 0; k < count; k++) {
+            double expected = random_uniform(42, offset + k);
+            ASSERT_EQ(std::memcmp(&data[k], &expected, sizeof(double)), 0)
+                << random_path_name(path) << " element " << k;
+            EXPECT_GE(data[k], 0.0);
+            EXPECT_LT(data[k], 1.0);
+        }
+    }
+}
+
+TEST_F(MatrixRandomTest, StreamsDependOnSeedAndLookUniform) {
+    EXPECT_EQ(random_u64(1, 5), random_u64(1, 5));
+    EXPECT_NE(random_u64(1, 5), random_u64(2, 5));
+    EXPECT_NE(random_u64(1, 5), random_u64(1, 6));
+
+    const size_t count = 100000;
+    std::vector<double> data(count);
+    random_fill_uniform(data.data(), count, 7, 0);
+    double sum = 0.0;
+    int below_tenth = 0;
+    for (double v : data) {
+        sum += v;
+        if (v < 0.1) below_tenth++;
+    }
+    EXPECT_NEAR(sum / count, 0.5, 0.01);
+    EXPECT_NEAR(below_tenth / static_cast<double>(count), 0.1, 0.01);
+}
+
+TEST_F(MatrixRandomTest, ParallelFillIsIdenticalForEveryThreadCount) {
+    // Large enough for several threads to take a range each
+    Matrix* serial = matrix_create(700, 800);
+    Matrix* parallel = matrix_create(700, 800);
+    matrix_randomize_seeded(serial, 123);
+
+    const int thread_counts[] = {1, 2, 3, 7, 0};
+    for (int threads : thread_counts) {
+        matrix_zeros(parallel);
+        matrix_randomize_parallel(parallel, 123, threads);
+        EXPECT_EQ(std::memcmp(serial->data, parallel->data, matrix_elements(serial) * sizeof(double)), 0)
+            << threads << " threads";
+    }
+
+    matrix_free(serial);
+    matrix_free(parallel);
+}
+
+TEST_F(MatrixRandomTest, RandomizeIsReproducibleFromBaseSeed) {
+    Matrix* a1 = matrix_create(5, 6);
+    Matrix* b1 = matrix_create(5, 6);
+    Matrix* a2 = matrix_create(5, 6);
+    Matrix* b2 = matrix_create(5, 6);
+    const size_t bytes = 30 * sizeof(double);
+
+    matrix_random_set_seed(99);
+    matrix_randomize(a1);
+    matrix_randomize(b1);
+    matrix_random_set_seed(99);
+    matrix_randomize(a2);
+    matrix_randomize(b2);
+
+    EXPECT_EQ(std::memcmp(a1->data, a2->data, bytes), 0);
+    EXPECT_EQ(std::memcmp(b1->data, b2->data, bytes), 0);
+    EXPECT_NE(std::memcmp(a1->data, b1->data, bytes), 0);
+
+    matrix_free(a1);
+    matrix_free(b1);
+    matrix_free(a2);
+    matrix_free(b2);
+}
+
+TEST_F(MatrixRandomTest, ParallelZerosAndCopy) {
+    Matrix* src = matrix_create(513, 300);
+    Matrix* dst = matrix_create(513, 300);
+    Matrix* wrong = matrix_create(300, 513);
+    matrix_randomize_seeded(src, 5);
+    const size_t bytes = matrix_elements(src) * sizeof(double);
+
+    for (int threads : {1, 4}) {
+        matrix_zeros(dst);
+        ASSERT_EQ(matrix_copy_parallel(src, dst, threads), 0);
+        EXPECT_EQ(std::memcmp(src->data, dst->data, bytes), 0);
+
+        matrix_zeros_parallel(dst, threads);
+        for (size_t i = 0; i < matrix_elements(dst); i++) {
+            ASSERT_EQ(dst->data[i], 0.0);
+        }
+    }
+
+    ASSERT_EQ(matrix_copy(src, dst), 0);
+    EXPECT_EQ(std::memcmp(src->data, dst->data, bytes), 0);
+    EXPECT_EQ(matrix_copy(src, wrong), -1);
+    EXPECT_EQ(matrix_copy_parallel(src, wrong, 2), -1);
+
+    matrix_free(src);
+    matrix_free(dst);
+    matrix_free(wrong);
+}
@@ -22,6 +22,21 @@ TEST_F(MatrixTest, CreateAndFree) {
     matrix_free(m);
 }
 
+TEST_F(MatrixTest, CreateRejectsInvalidAndOverflowingSizes) {
+    EXPECT_EQ(matrix_create(-1, 10), nullptr);
+    EXPECT_EQ(matrix_create(10, -1), nullptr);
+    // INT_MAX^2 doubles overflow the byte count on every platform
+    EXPECT_EQ(matrix_create(2147483647, 2147483647), nullptr);
+}
+
+TEST_F(MatrixTest, ElementCountUsesSizeT) {
+    // 46341^2 exceeds INT_MAX; only the header is needed to check the count
+    Matrix big = {nullptr, 46341, 46341};
+    EXPECT_EQ(matrix_elements(&big), static_cast<size_t>(46341) * 46341);
+    EXPECT_GT(matrix_elements(&big), static_cast<size_t>(2147483647));
+    EXPECT_EQ(matrix_elements(nullptr), 0u);
+}
+
 TEST_F(MatrixTest, SetAndGet) {
     Matrix* m = matrix_create(5, 5);
     ASSERT_NE(m, nullptr);
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "membench.h"
+#include <string>
+#include <vector>
+
+class MembenchTest : public ::testing::Test {
+};
+
+TEST_F(MembenchTest, RandomCycleVisitsEveryIndexOnce) {
+    const size_t count = 1000;
+    std::vector<size_t> next(count);
+    membench_random_cycle(next.data(), count, 42);
+
+    std::vector<bool> seen(count, false);
+    size_t index = 0;
+    for (size_t step = 0; step < count; ++step) {
+        ASSERT_LT(next[index], count);
+        ASSERT_FALSE(seen[index]);
+        seen[index] = true;
+        index = next[index];
+    }
+    // Back at the start after exactly count steps: one cycle over all indices
+    EXPECT_EQ(index, 0u);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_NE(next[i], i);
+    }
+}
+
+TEST_F(MembenchTest, RandomCycleDependsOnSeed) {
+    std::vector<size_t> a(64), b(64);
+    membench_random_cycle(a.data(), a.size(), 1);
+    membench_random_cycle(b.data(), b.size(), 2);
+    EXPECT_NE(a, b);
+}
+
+TEST_F(MembenchTest, FindsKneesOnSyntheticCurve) {
+    // Plateaus of 1, 4, 12 and 80 ns; the L2 -> L3 step ramps over two
+    // points and must count once, the spike at 8 KB not at all
+    const LatencyPoint points[] = {
+        {4096, 1.0},    {8192, 1.6},    {16384, 1.0},  {32768, 1.0},
+        {65536, 4.0},   {131072, 4.1},  {262144, 4.0},  {524288, 7.0},
+        {1048576, 12.0}, {2097152, 12.1}, {4194304, 80.0}, {8388608, 81.0},
+    };
+    MemoryKnee knees[8];
+    int found = membench_find_knees(points, 12, 1.5, knees, 8);
+    ASSERT_EQ(found, 3);
+    EXPECT_EQ(knees[0].bytes, 32768u);
+    EXPECT_DOUBLE_EQ(knees[0].after_ns, 4.0);
+    EXPECT_EQ(knees[1].bytes, 262144u);
+    EXPECT_DOUBLE_EQ(knees[1].before_ns, 4.0);
+    EXPECT_DOUBLE_EQ(knees[1].after_ns, 12.0);
+    EXPECT_EQ(knees[2].bytes, 2097152u);
+    EXPECT_DOUBLE_EQ(knees[2].after_ns, 80.0);
+
+    // Isolated spikes are not knees; max_knees is honoured
+    EXPECT_EQ(membench_find_knees(points, 4, 1.5, knees, 8), 0);
+    EXPECT_EQ(membench_find_knees(points, 12, 1.5, knees, 1), 1);
+}
+
+TEST_F(MembenchTest, LatencyIsPositive) {
+    double ns = membench_latency_ns(16 * 1024, 100000);
+    EXPECT_GT(ns, 0.0);
+    EXPECT_LT(ns, 1000.0);
+}
+
+TEST_F(MembenchTest, BandwidthIsPositiveForEveryKernel) {
+    for (int k = 0; k < MEMBENCH_KERNEL_COUNT; ++k) {
+        MembenchKernel kernel = static_cast<MembenchKernel>(k);
+        for (int threads = 1; threads <= 2; ++threads) {
+            EXPECT_GT(membench_bandwidth_gbs(kernel, 1 << 20, threads, 2), 0.0)
+                << membench_kernel_name(kernel) << " with " << threads << " threads";
+        }
+    }
+    EXPECT_LT(membench_bandwidth_gbs(static_cast<MembenchKernel>(7), 1 << 20, 1, 1), 0.0);
+}
+
+TEST_F(MembenchTest, KernelNames) {
+    EXPECT_EQ(std::string(membench_kernel_name(MEMBENCH_READ)), "read");
+    EXPECT_EQ(std::string(membench_kernel_name(MEMBENCH_WRITE)), "write");
+    EXPECT_EQ(std::string(membench_kernel_name(MEMBENCH_COPY)), "copy");
+    EXPECT_EQ(std::string(membench_kernel_name(MEMBENCH_TRIAD)), "triad");
+}
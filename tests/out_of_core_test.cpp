@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "matrix_io.h"
+#include "out_of_core.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class OutOfCoreTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const std::string& p : created_) std::remove(p.c_str());
+    }
+
+    std::string track(const char* name) {
+        created_.push_back(::testing::TempDir() + name);
+        return created_.back();
+    }
+
+    // Save random M x N and N x P operands and their reference product
+    void write_operands(int M, int N, int P, const std::string& a_path, const std::string& b_path) {
+        Matrix* A = matrix_create(M, N);
+        Matrix* B = matrix_create(N, P);
+        matrix_randomize(A);
+        matrix_randomize(B);
+        ASSERT_EQ(matrix_save(a_path.c_str(), A, MATRIX_FORMAT_AUTO), 0);
+        ASSERT_EQ(matrix_save(b_path.c_str(), B, MATRIX_FORMAT_AUTO), 0);
+        matrix_free(C_ref_);
+        C_ref_ = matrix_create(M, P);
+        matrix_multiply_naive(A, B, C_ref_);
+        matrix_free(A);
+        matrix_free(B);
+    }
+
+    void expect_matches_reference(const std::string& c_path) {
+        Matrix* C = matrix_load(c_path.c_str());
+        ASSERT_NE(C, nullptr);
+        ASSERT_EQ(C->rows, C_ref_->rows);
+        ASSERT_EQ(C->cols, C_ref_->cols);
+        double max_err = 0.0, rel_err = 0.0;
+        matrix_compare(C_ref_, C, &max_err, &rel_err);
+        EXPECT_LT(max_err, 1e-9);
+        matrix_free(C);
+    }
+
+    ~OutOfCoreTest() override { matrix_free(C_ref_); }
+
+    Matrix* C_ref_ = nullptr;
+
+private:
+    std::vector<std::string> created_;
+};
+
+TEST_F(OutOfCoreTest, MatchesInMemoryProductWithAndWithoutDoubleBuffering) {
+    std::string a = track("/ooc_a.clm");
+    std::string b = track("/ooc_b.npy");
+    std::string c = track("/ooc_c.clm");
+    write_operands(37, 29, 23, a, b);
+
+    // Tile 8 leaves partial tiles in every dimension
+    for (int double_buffer = 0; double_buffer <= 1; double_buffer++) {
+        OocOptions opts = ooc_default_options();
+        opts.tile = 8;
+        opts.double_buffer = double_buffer;
+        OocStats stats;
+        ASSERT_EQ(matrix_multiply_out_of_core(a.c_str(), b.c_str(), c.c_str(), &opts, &stats, nullptr), 0);
+        expect_matches_reference(c);
+
+        EXPECT_EQ(stats.tile, 8);
+        EXPECT_EQ(stats.panels, 5LL * 3 * 4);
+        EXPECT_EQ(stats.bytes_written, 37u * 23u * sizeof(double));
+        // Every A panel is read once per column tile, every B panel once per row tile
+        EXPECT_EQ(stats.bytes_read, (37u * 29u * 3u + 29u * 23u * 5u) * sizeof(double));
+        EXPECT_GE(stats.overlap, 0.0);
+        EXPECT_LE(stats.overlap, 1.0);
+        if (!double_buffer) {
+            EXPECT_EQ(stats.overlap, 0.0);
+        }
+    }
+}
+
+TEST_F(OutOfCoreTest, TileIsDerivedFromMemoryBudget) {
+    std::string a = track("/ooc_budget_a.clm");
+    std::string b = track("/ooc_budget_b.clm");
+    std::string c = track("/ooc_budget_c.npy");
+    write_operands(64, 48, 40, a, b);
+
+    // Double buffered: 5 T^2 doubles, so 40 KB allows T = 32
+    OocOptions opts = ooc_default_options();
+    opts.memory_budget = 40 * 1024;
+    OocStats stats;
+    ASSERT_EQ(matrix_multiply_out_of_core(a.c_str(), b.c_str(), c.c_str(), &opts, &stats, nullptr), 0);
+    EXPECT_EQ(stats.tile, 32);
+    expect_matches_reference(c);
+
+    // Not even one element per buffer
+    opts.memory_budget = 16;
+    EXPECT_EQ(matrix_multiply_out_of_core(a.c_str(), b.c_str(), c.c_str(), &opts, nullptr, nullptr), -1);
+}
+
+TEST_F(OutOfCoreTest, RecordsPhasesInProfiler) {
+    std::string a = track("/ooc_prof_a.clm");
+    std::string b = track("/ooc_prof_b.clm");
+    std::string c = track("/ooc_prof_c.clm");
+    write_operands(20, 20, 20, a, b);
+
+    Profiler profiler;
+    profiler_init(&profiler);
+    OocOptions opts = ooc_default_options();
+    opts.tile = 8;
+    ASSERT_EQ(matrix_multiply_out_of_core(a.c_str(), b.c_str(), c.c_str(), &opts, nullptr, &profiler), 0);
+
+    const char* expected[] = {"ooc_total", "ooc_read", "ooc_compute", "ooc_wait", "ooc_write", "ooc_read_hidden"};
+    ASSERT_EQ(profiler.count, 6);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_STREQ(profiler.points[i].name, expected[i]);
+        EXPECT_GE(profiler.points[i].elapsed_ms, 0.0);
+    }
+}
+
+TEST_F(OutOfCoreTest, RejectsMismatchedAndMissingOperands) {
+    std::string a = track("/ooc_bad_a.clm");
+    std::string b = track("/ooc_bad_b.clm");
+    std::string c = track("/ooc_bad_c.clm");
+    Matrix* A = matrix_create(4, 5);
+    Matrix* B = matrix_create(4, 5);
+    ASSERT_EQ(matrix_save(a.c_str(), A, MATRIX_FORMAT_CLM), 0);
+    ASSERT_EQ(matrix_save(b.c_str(), B, MATRIX_FORMAT_CLM), 0);
+
+    EXPECT_EQ(matrix_multiply_out_of_core(a.c_str(), b.c_str(), c.c_str(), nullptr, nullptr, nullptr), -1);
+    std::string missing = ::testing::TempDir() + "/ooc_missing.clm";
+    EXPECT_EQ(matrix_multiply_out_of_core(missing.c_str(), b.c_str(), c.c_str(), nullptr, nullptr, nullptr), -1);
+
+    matrix_free(A);
+    matrix_free(B);
+}
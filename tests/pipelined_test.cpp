@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "pipelined.h"
+
+class PipelinedTest : public ::testing::Test {
+};
+
+static void expect_matches_naive(Matrix* A, Matrix* B, Matrix* C) {
+    Matrix* C_ref = matrix_create(C->rows, C->cols);
+    matrix_multiply_naive(A, B, C_ref);
+    for (size_t i = 0; i < matrix_elements(C); i++) {
+        EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-9);
+    }
+    matrix_free(C_ref);
+}
+
+TEST_F(PipelinedTest, AllModesMatchNaive) {
+    // Block 8 leaves partial panels, tiles and row blocks
+    Matrix* A = matrix_create(29, 37);
+    Matrix* B = matrix_create(37, 19);
+    Matrix* C = matrix_create(29, 19);
+    matrix_randomize(A);
+    matrix_randomize(B);
+
+    const int distances[] = {0, 1, 3, 10};
+    for (int pack_thread = 0; pack_thread <= 1; pack_thread++) {
+        for (int distance : distances) {
+            PipelineOptions opts = pipeline_default_options();
+            opts.block_size = 8;
+            opts.prefetch_distance = distance;
+            opts.pack_thread = pack_thread;
+            matrix_randomize(C);  // must be overwritten
+            ASSERT_EQ(matrix_multiply_pipelined(A, B, C, &opts, nullptr, nullptr), 0);
+            expect_matches_naive(A, B, C);
+        }
+    }
+
+    // Defaults (automatic block size)
+    ASSERT_EQ(matrix_multiply_pipelined(A, B, C, nullptr, nullptr, nullptr), 0);
+    expect_matches_naive(A, B, C);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
+
+TEST_F(PipelinedTest, StatsAndProfilerPhases) {
+    Matrix* A = matrix_create(40, 40);
+    Matrix* B = matrix_create(40, 40);
+    Matrix* C = matrix_create(40, 40);
+    matrix_randomize(A);
+    matrix_randomize(B);
+
+    PipelineOptions opts = pipeline_default_options();
+    opts.block_size = 16;
+    opts.pack_thread = 0;
+    PipelineStats stats;
+    Profiler profiler;
+    profiler_init(&profiler);
+    ASSERT_EQ(matrix_multiply_pipelined(A, B, C, &opts, &stats, &profiler), 0);
+
+    EXPECT_EQ(stats.panels, 3);
+    // Serial packing stalls the kernel for exactly the packing time
+    EXPECT_DOUBLE_EQ(stats.wait_ms, stats.pack_ms);
+    EXPECT_LE(stats.compute_ms, stats.total_ms);
+
+    const char* expected[] = {"pipeline_total", "pipeline_pack", "pipeline_wait", "pipeline_compute"};
+    ASSERT_EQ(profiler.count, 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_STREQ(profiler.points[i].name, expected[i]);
+    }
+    EXPECT_DOUBLE_EQ(profiler.points[1].elapsed_ms, stats.pack_ms);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
+
+TEST_F(PipelinedTest, DimensionChecksAndEmptyShapes) {
+    Matrix* A = matrix_create(4, 5);
+    Matrix* B = matrix_create(6, 3);
+    Matrix* C = matrix_create(4, 3);
+    EXPECT_EQ(matrix_multiply_pipelined(A, B, C, nullptr, nullptr, nullptr), -1);
+    EXPECT_EQ(matrix_multiply_pipelined(nullptr, B, C, nullptr, nullptr, nullptr), -1);
+
+    // Zero inner dimension: C becomes zeros
+    Matrix* A0 = matrix_create(4, 0);
+    Matrix* B0 = matrix_create(0, 3);
+    matrix_randomize(C);
+    ASSERT_EQ(matrix_multiply_pipelined(A0, B0, C, nullptr, nullptr, nullptr), 0);
+    for (size_t i = 0; i < matrix_elements(C); i++) {
+        EXPECT_EQ(C->data[i], 0.0);
+    }
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    matrix_free(A0);
+    matrix_free(B0);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "prepared.h"
+
+class PreparedTest : public ::testing::Test {
+};
+
+static void expect_matches_naive(Matrix* A, Matrix* B, Matrix* C) {
+    Matrix* C_ref = matrix_create(C->rows, C->cols);
+    matrix_multiply_naive(A, B, C_ref);
+    for (int i = 0; i < C->rows * C->cols; i++) {
+        EXPECT_NEAR(C->data[i], C_ref->data[i], 1e-9);
+    }
+    matrix_free(C_ref);
+}
+
+TEST_F(PreparedTest, PreparedOperandReusedAcrossCalls) {
+    Matrix* B = matrix_create(23, 17);
+    matrix_randomize(B);
+    PreparedB* prep = matrix_prepare_b(B);
+    ASSERT_NE(prep, nullptr);
+    EXPECT_EQ(prepared_b_rows(prep), 23);
+    EXPECT_EQ(prepared_b_cols(prep), 17);
+
+    const int rows[] = {1, 5, 31};
+    for (int M : rows) {
+        Matrix* A = matrix_create(M, 23);
+        Matrix* C = matrix_create(M, 17);
+        matrix_randomize(A);
+        ASSERT_EQ(matrix_multiply_prepared(A, prep, C), 0);
+        expect_matches_naive(A, B, C);
+
+        matrix_zeros(C);
+        ASSERT_EQ(matrix_multiply_prepared_parallel(A, prep, C, 3), 0);
+        expect_matches_naive(A, B, C);
+        matrix_free(A);
+        matrix_free(C);
+    }
+
+    prepared_b_free(prep);
+    matrix_free(B);
+}
+
+TEST_F(PreparedTest, RepackAndDimensionChecks) {
+    Matrix* B = matrix_create(40, 9);
+    Matrix* A = matrix_create(6, 40);
+    Matrix* C = matrix_create(6, 9);
+    Matrix* wrong = matrix_create(9, 40);
+    matrix_randomize(A);
+
+    PreparedB* prep = prepared_b_create(40, 9);
+    ASSERT_NE(prep, nullptr);
+    EXPECT_EQ(prepared_b_pack(prep, wrong), -1);
+    EXPECT_EQ(matrix_multiply_prepared(wrong, prep, C), -1);
+
+    for (int round = 0; round < 2; round++) {
+        matrix_randomize(B);
+        ASSERT_EQ(prepared_b_pack_parallel(prep, B, 2), 0);
+        ASSERT_EQ(matrix_multiply_prepared(A, prep, C), 0);
+        expect_matches_naive(A, B, C);
+    }
+
+    prepared_b_free(prep);
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    matrix_free(wrong);
+}
+
+TEST_F(PreparedTest, CacheHitsVersionsAndLruEviction) {
+    PreparedCache* cache = prepared_cache_create(2);
+    ASSERT_NE(cache, nullptr);
+    Matrix* B1 = matrix_create(8, 8);
+    Matrix* B2 = matrix_create(8, 8);
+    Matrix* B3 = matrix_create(8, 8);
+    Matrix* A = matrix_create(3, 8);
+    Matrix* C = matrix_create(3, 8);
+    matrix_randomize(A);
+    matrix_randomize(B1);
+    matrix_randomize(B2);
+    matrix_randomize(B3);
+    unsigned long hits = 0, misses = 0;
+
+    const PreparedB* p1 = prepared_cache_get(cache, B1, 0);
+    EXPECT_EQ(prepared_cache_get(cache, B1, 0), p1);
+    prepared_cache_stats(cache, &hits, &misses);
+    EXPECT_EQ(hits, 1u);
+    EXPECT_EQ(misses, 1u);
+
+    // A new version is re-packed into the same handle
+    matrix_randomize(B1);
+    EXPECT_EQ(prepared_cache_get(cache, B1, 1), p1);
+    ASSERT_EQ(matrix_multiply_prepared(A, p1, C), 0);
+    expect_matches_naive(A, B1, C);
+
+    // B1 is touched after B2, so B3 evicts B2
+    prepared_cache_get(cache, B2, 0);
+    prepared_cache_get(cache, B1, 1);
+    prepared_cache_get(cache, B3, 0);
+    prepared_cache_get(cache, B1, 1);
+    prepared_cache_stats(cache, &hits, &misses);
+    EXPECT_EQ(hits, 3u);
+    EXPECT_EQ(misses, 4u);
+    prepared_cache_get(cache, B2, 0);
+    prepared_cache_stats(cache, &hits, &misses);
+    EXPECT_EQ(misses, 5u);
+
+    prepared_cache_invalidate(cache, B1);
+    prepared_cache_get(cache, B1, 1);
+    prepared_cache_stats(cache, &hits, &misses);
+    EXPECT_EQ(misses, 6u);
+
+    const PreparedB* p2 = prepared_cache_get(cache, B2, 0);
+    ASSERT_EQ(matrix_multiply_prepared(A, p2, C), 0);
+    expect_matches_naive(A, B2, C);
+
+    prepared_cache_free(cache);
+    matrix_free(A);
+    matrix_free(B1);
+    matrix_free(B2);
+    matrix_free(B3);
+    matrix_free(C);
+}
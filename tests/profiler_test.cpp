@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    const char* filename = "profiler_test.csv";
+
+    void SetUp() override { profiler_init(&profiler); }
+    void TearDown() override { std::remove(filename); }
+
+    Profiler profiler;
+};
+
+TEST_F(ProfilerTest, CountsBytesFromMatrixAllocator) {
+    const int n = 64;
+    Matrix* A = matrix_create(n, n);
+    Matrix* B = matrix_create(n, n);
+    Matrix* C = matrix_create(n, n);
+
+    // The transpose kernel's B^T copy is counted even though the caller
+    // never sees it
+    profiler_start(&profiler, "transpose");
+    ASSERT_EQ(matrix_multiply_transpose(A, B, C), 0);
+    profiler_end(&profiler, "transpose");
+    EXPECT_EQ(profiler.points[0].usage.alloc_bytes, static_cast<size_t>(n) * n * sizeof(double));
+
+    profiler_start(&profiler, "create");
+    Matrix* D = matrix_create(n, 2 * n);
+    profiler_end(&profiler, "create");
+    EXPECT_EQ(profiler.points[1].usage.alloc_bytes, static_cast<size_t>(n) * 2 * n * sizeof(double));
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    matrix_free(D);
+}
+
+TEST_F(ProfilerTest, FirstTouchShowsAsMinorFaults) {
+    // calloc leaves a large block unmapped until it is written
+    const int rows = 2048, cols = 1024;  // 16 MB
+    Matrix* m = matrix_create(rows, cols);
+    ASSERT_NE(m, nullptr);
+
+    profiler_start(&profiler, "first_touch");
+    for (size_t i = 0; i < matrix_elements(m); i++) m->data[i] = 1.0;
+    profiler_end(&profiler, "first_touch");
+
+    const ProfileUsage& usage = profiler.points[0].usage;
+    const long pages = static_cast<long>(matrix_elements(m) * sizeof(double) / 4096);
+    EXPECT_GT(usage.minor_faults, 0);
+    EXPECT_LE(usage.minor_faults, pages + 64);
+    EXPECT_GE(usage.major_faults, 0);
+    EXPECT_GE(usage.peak_rss_kb, 0);
+    EXPECT_EQ(usage.alloc_bytes, 0u);
+    matrix_free(m);
+}
+
+TEST_F(ProfilerTest, UsageAccumulatesOverSamples) {
+    for (int i = 0; i < 3; i++) {
+        profiler_start(&profiler, "alloc");
+        Matrix* m = matrix_create(8, 8);
+        profiler_end(&profiler, "alloc");
+        matrix_free(m);
+    }
+    EXPECT_EQ(profiler.points[0].sample_count, 3);
+    EXPECT_EQ(profiler.points[0].usage.alloc_bytes, 3 * 64 * sizeof(double));
+
+    // Times measured elsewhere carry no usage
+    profiler_record(&profiler, "recorded", 2.0);
+    EXPECT_EQ(profiler.points[1].usage.alloc_bytes, 0u);
+    EXPECT_EQ(profiler.points[1].usage.minor_faults, 0);
+}
+
+TEST_F(ProfilerTest, CsvHasUsageColumns) {
+    profiler_start(&profiler, "alloc");
+    Matrix* m = matrix_create(16, 16);
+    profiler_end(&profiler, "alloc");
+    matrix_free(m);
+    profiler_save_results(&profiler, filename);
+
+    std::ifstream in(filename);
+    std::string header, row;
+    ASSERT_TRUE(std::getline(in, header));
+    ASSERT_TRUE(std::getline(in, row));
+    EXPECT_EQ(header, "section,time_ms,minor_faults,major_faults,peak_rss_delta_kb,alloc_bytes");
+    EXPECT_EQ(std::count(row.begin(), row.end(), ','), 5);
+    EXPECT_EQ(row.substr(0, 6), "alloc,");
+    EXPECT_EQ(row.substr(row.rfind(',') + 1), std::to_string(16 * 16 * sizeof(double)));
+}
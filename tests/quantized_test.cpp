@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "quantized.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class QuantizedTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        qgemm_select_path(QGEMM_PATH_AUTO);
+    }
+};
+
+// Reference: sum_k (A[i][k] - zA) * (B[k][j] - zB) computed in int64
+template <typename T>
+static std::vector<int64_t> reference_product(QMatrix* A, QMatrix* B) {
+    const T* a = static_cast<const T*>(A->data);
+    const T* b = static_cast<const T*>(B->data);
+    std::vector<int64_t> C(static_cast<size_t>(A->rows) * B->cols, 0);
+    for (int i = 0; i < A->rows; i++) {
+        for (int j = 0; j < B->cols; j++) {
+            int64_t sum = 0;
+            for (int k = 0; k < A->cols; k++) {
+                sum += (static_cast<int64_t>(a[i * A->cols + k]) - A->zero_point) *
+                       (static_cast<int64_t>(b[k * B->cols + j]) - B->zero_point);
+            }
+            C[i * B->cols + j] = sum;
+        }
+    }
+    return C;
+}
+
+static void fill_signed(Matrix* m, double offset) {
+    matrix_randomize(m);
+    for (int i = 0; i < m->rows * m->cols; i++) {
+        m->data[i] = 2.0 * m->data[i] - offset;
+    }
+}
+
+TEST_F(QuantizedTest, QuantizeRoundTrip) {
+    Matrix* m = matrix_create(13, 7);
+    Matrix* back = matrix_create(13, 7);
+    fill_signed(m, 0.5);
+
+    const QuantType types[] = {QUANT_INT8, QUANT_INT16};
+    for (QuantType type : types) {
+        QMatrix* q = qmatrix_create(13, 7, type);
+        ASSERT_NE(q, nullptr);
+        ASSERT_EQ(matrix_quantize(m, q), 0);
+        ASSERT_EQ(matrix_dequantize(q, back), 0);
+
+        for (int i = 0; i < 13 * 7; i++) {
+            EXPECT_NEAR(back->data[i], m->data[i], q->scale * 0.5 + 1e-12);
+        }
+        qmatrix_free(q);
+    }
+
+    matrix_free(m);
+    matrix_free(back);
+}
+
+TEST_F(QuantizedTest, ZeroIsExact) {
+    Matrix* m = matrix_create(2, 2);
+    Matrix* back = matrix_create(2, 2);
+    matrix_set(m, 0, 0, 0.25);
+    matrix_set(m, 0, 1, 3.0);
+    matrix_set(m, 1, 0, 0.0);
+    matrix_set(m, 1, 1, 1.0);
+
+    QMatrix* q = qmatrix_create(2, 2, QUANT_INT8);
+    ASSERT_EQ(matrix_quantize(m, q), 0);
+    ASSERT_EQ(matrix_dequantize(q, back), 0);
+    EXPECT_DOUBLE_EQ(matrix_get(back, 1, 0), 0.0);
+
+    qmatrix_free(q);
+    matrix_free(m);
+    matrix_free(back);
+}
+
+TEST_F(QuantizedTest, Int8MatchesReferenceOnAllPaths) {
+    // Odd sizes exercise the k-group and column-panel padding
+    int M = 19, N = 37, P = 23;
+    Matrix* A = matrix_create(M, N);
+    Matrix* B = matrix_create(N, P);
+    fill_signed(A, 0.3);
+    fill_signed(B, 1.0);
+
+    QMatrix* A_q = qmatrix_create(M, N, QUANT_INT8);
+    QMatrix* B_q = qmatrix_create(N, P, QUANT_INT8);
+    matrix_quantize(A, A_q);
+    matrix_quantize(B, B_q);
+    std::vector<int64_t> expected = reference_product<int8_t>(A_q, B_q);
+
+    const QGemmPath paths[] = {QGEMM_PATH_PORTABLE, QGEMM_PATH_AVX2, QGEMM_PATH_VNNI};
+    for (QGemmPath path : paths) {
+        QGemmPath used = qgemm_select_path(path);
+        std::vector<int32_t> C(static_cast<size_t>(M) * P, -1);
+        ASSERT_EQ(qmatrix_multiply_int8(A_q, B_q, C.data(), 8), 0);
+        for (size_t i = 0; i < C.size(); i++) {
+            ASSERT_EQ(C[i], expected[i]) << "path " << qgemm_path_name(used) << " index " << i;
+        }
+    }
+
+    qmatrix_free(A_q);
+    qmatrix_free(B_q);
+    matrix_free(A);
+    matrix_free(B);
+}
+
+TEST_F(QuantizedTest, Int16MatchesReferenceOnAllPaths) {
+    int M = 9, N = 33, P = 17;
+    Matrix* A = matrix_create(M, N);
+    Matrix* B = matrix_create(N, P);
+    fill_signed(A, 1.0);
+    fill_signed(B, 0.2);
+
+    QMatrix* A_q = qmatrix_create(M, N, QUANT_INT16);
+    QMatrix* B_q = qmatrix_create(N, P, QUANT_INT16);
+    matrix_quantize(A, A_q);
+    matrix_quantize(B, B_q);
+    std::vector<int64_t> expected = reference_product<int16_t>(A_q, B_q);
+
+    const QGemmPath paths[] = {QGEMM_PATH_PORTABLE, QGEMM_PATH_AVX2};
+    for (QGemmPath path : paths) {
+        QGemmPath used = qgemm_select_path(path);
+        std::vector<int64_t> C(static_cast<size_t>(M) * P, -1);
+        ASSERT_EQ(qmatrix_multiply_int16(A_q, B_q, C.data(), 0), 0);
+        for (size_t i = 0; i < C.size(); i++) {
+            ASSERT_EQ(C[i], expected[i]) << "path " << qgemm_path_name(used) << " index " << i;
+        }
+    }
+
+    qmatrix_free(A_q);
+    qmatrix_free(B_q);
+    matrix_free(A);
+    matrix_free(B);
+}
+
+TEST_F(QuantizedTest, DequantizedProductApproximatesDouble) {
+    int size = 32;
+    Matrix* A = matrix_create(size, size);
+    Matrix* B = matrix_create(size, size);
+    Matrix* C_ref = matrix_create(size, size);
+    Matrix* C_q = matrix_create(size, size);
+    matrix_randomize(A);
+    matrix_randomize(B);
+    matrix_multiply_naive(A, B, C_ref);
+
+    QMatrix* A_q = qmatrix_create(size, size, QUANT_INT16);
+    QMatrix* B_q = qmatrix_create(size, size, QUANT_INT16);
+    matrix_quantize(A, A_q);
+    matrix_quantize(B, B_q);
+    ASSERT_EQ(qmatrix_multiply(A_q, B_q, C_q, 0), 0);
+
+    for (int i = 0; i < size * size; i++) {
+        EXPECT_NEAR(C_q->data[i], C_ref->data[i], 1e-3);
+    }
+
+    qmatrix_free(A_q);
+    qmatrix_free(B_q);
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C_ref);
+    matrix_free(C_q);
+}
+
+TEST_F(QuantizedTest, TypeAndDimensionMismatch) {
+    QMatrix* A8 = qmatrix_create(2, 3, QUANT_INT8);
+    QMatrix* B8 = qmatrix_create(4, 2, QUANT_INT8);
+    QMatrix* B16 = qmatrix_create(3, 2, QUANT_INT16);
+    int32_t C32[4];
+    int64_t C64[4];
+
+    EXPECT_EQ(qmatrix_multiply_int8(A8, B8, C32, 0), -1);
+    EXPECT_EQ(qmatrix_multiply_int16(A8, B16, C64, 0), -1);
+    EXPECT_EQ(qmatrix_multiply_int8(nullptr, B8, C32, 0), -1);
+    EXPECT_EQ(qmatrix_create(0, 3, QUANT_INT8), nullptr);
+
+    qmatrix_free(A8);
+    qmatrix_free(B8);
+    qmatrix_free(B16);
+}
+
+// Every term at +-255 * 255: the int32 result is exact up to
+// QGEMM_INT8_MAX_K, one step further needs the int64 entry point
+TEST_F(QuantizedTest, Int8ExtremeInputsAtTheBound) {
+    const QGemmPath paths[] = {QGEMM_PATH_PORTABLE, QGEMM_PATH_AVX2, QGEMM_PATH_VNNI};
+    const int8_t extremes[2][2] = {{127, -128}, {-128, 127}};  // value, zero point
+
+    for (int K = QGEMM_INT8_MAX_K; K <= QGEMM_INT8_MAX_K + 1; K++) {
+        int64_t magnitude = static_cast<int64_t>(K) * 255 * 255;
+        for (const int8_t* a_ext : extremes) {
+            QMatrix* A = qmatrix_create(2, K, QUANT_INT8);
+            QMatrix* B = qmatrix_create(K, 3, QUANT_INT8);
+            std::fill_n(static_cast<int8_t*>(A->data), static_cast<size_t>(2) * K, a_ext[0]);
+            std::fill_n(static_cast<int8_t*>(B->data), static_cast<size_t>(K) * 3, int8_t(127));
+            A->zero_point = a_ext[1];
+            B->zero_point = -128;
+            int64_t expected = a_ext[0] > 0 ? magnitude : -magnitude;
+
+            for (QGemmPath path : paths) {
+                qgemm_select_path(path);
+                std::vector<int64_t> C64(6, 0);
+                ASSERT_EQ(qmatrix_multiply_int8_wide(A, B, C64.data(), 0), 0);
+                std::vector<int32_t> C32(6, 0);
+                int result = qmatrix_multiply_int8(A, B, C32.data(), 0);
+                for (int i = 0; i < 6; i++) {
+                    EXPECT_EQ(C64[i], expected) << qgemm_path_name(qgemm_active_path());
+                }
+                if (K <= QGEMM_INT8_MAX_K) {
+                    ASSERT_EQ(result, 0);
+                    for (int i = 0; i < 6; i++) {
+                        EXPECT_EQ(C32[i], expected) << qgemm_path_name(qgemm_active_path());
+                    }
+                } else {
+                    EXPECT_EQ(result, -1);
+                }
+            }
+
+            qmatrix_free(A);
+            qmatrix_free(B);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "results_compare.h"
+#include "results_store.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class ResultsStoreTest : public ::testing::Test {
+protected:
+    const char* filename = "results_store_test.jsonl";
+
+    void SetUp() override { std::remove(filename); }
+    void TearDown() override { std::remove(filename); }
+};
+
+TEST_F(ResultsStoreTest, MedianOfSamples) {
+    const double odd[] = {3.0, 1.0, 2.0};
+    const double even[] = {4.0, 1.0, 3.0, 2.0};
+    EXPECT_DOUBLE_EQ(results_median(odd, 3), 2.0);
+    EXPECT_DOUBLE_EQ(results_median(even, 4), 2.5);
+    EXPECT_DOUBLE_EQ(results_median(nullptr, 0), 0.0);
+}
+
+TEST_F(ResultsStoreTest, RoundTripsRunsAndProfilerSections) {
+    ResultsStore store;
+    ASSERT_EQ(results_store_open(&store, filename, "test", nullptr), 0);
+    const double samples[] = {1.5, 1.25, 1.75};
+    ASSERT_EQ(results_store_add(&store, "naive", 64, 1, samples, 3), 0);
+    EXPECT_EQ(results_store_add(&store, "naive", 64, 1, samples, 0), -1);
+
+    Profiler profiler;
+    profiler_init(&profiler);
+    profiler_record(&profiler, "matrix_multiply_blocked_parallel_t2_128x128", 4.0);
+    profiler_record(&profiler, "matrix_multiply_blocked_parallel_t2_128x128", 5.0);
+    profiler_record(&profiler, "setup", 1.0);
+    EXPECT_EQ(results_store_add_profiler(&store, &profiler), 2);
+    std::string first_id = store.run_id;
+    results_store_close(&store);
+
+    // A second run appended to the same file
+    ASSERT_EQ(results_store_open(&store, filename, "test", nullptr), 0);
+    ASSERT_EQ(results_store_add(&store, "naive", 64, 1, samples, 3), 0);
+    results_store_close(&store);
+
+    std::vector<ResultsRun> runs;
+    ASSERT_EQ(load_results_runs(filename, runs), 2);
+    EXPECT_EQ(runs[0].run_id, first_id);
+    EXPECT_EQ(runs[0].tool, "test");
+    ASSERT_EQ(runs[0].series.size(), 3u);
+    EXPECT_EQ(runs[0].series[0].kernel, "naive");
+    EXPECT_EQ(runs[0].series[0].samples_ms, std::vector<double>({1.5, 1.25, 1.75}));
+
+    const ResultSeries& blocked = runs[0].series[1];
+    EXPECT_EQ(blocked.kernel, "matrix_multiply_blocked_parallel_t2");
+    EXPECT_EQ(blocked.size, 128);
+    EXPECT_EQ(blocked.threads, 2);
+    EXPECT_EQ(blocked.samples_ms.size(), 2u);
+
+    EXPECT_EQ(runs[0].series[2].kernel, "setup");
+    EXPECT_EQ(runs[0].series[2].size, 0);
+    EXPECT_EQ(runs[1].series.size(), 1u);
+
+    EXPECT_EQ(load_results_runs("missing_results.jsonl", runs), -1);
+}
+
+TEST_F(ResultsStoreTest, MannWhitneyExactAndApproximate) {
+    double u = -1.0;
+    // Complete separation of 4 vs 4: exact two-sided p = 2 / C(8, 4)
+    EXPECT_NEAR(mann_whitney_p({1, 2, 3, 4}, {5, 6, 7, 8}, &u), 2.0 / 70.0, 1e-12);
+    EXPECT_DOUBLE_EQ(u, 0.0);
+    EXPECT_NEAR(mann_whitney_p({5, 6, 7, 8}, {1, 2, 3, 4}, &u), 2.0 / 70.0, 1e-12);
+    EXPECT_DOUBLE_EQ(u, 16.0);
+    // 3 vs 3 can never reach 0.05
+    EXPECT_NEAR(mann_whitney_p({1, 2, 3}, {4, 5, 6}), 0.1, 1e-12);
+    // Interleaved samples are not different
+    EXPECT_GT(mann_whitney_p({1, 3, 5, 7, 9}, {2, 4, 6, 8, 10}), 0.5);
+
+    // Ties use the normal approximation
+    EXPECT_LT(mann_whitney_p({1, 1, 2, 2, 2, 3, 3, 3}, {5, 5, 6, 6, 7, 7, 8, 8}), 0.01);
+    EXPECT_DOUBLE_EQ(mann_whitney_p({2, 2, 2}, {2, 2, 2}), 1.0);
+    EXPECT_DOUBLE_EQ(mann_whitney_p({}, {1}), 1.0);
+
+    // Smallest reachable p: 3 vs 3 never gets below alpha 0.05, 4 vs 4 does
+    EXPECT_NEAR(mann_whitney_min_p(3, 3), 0.1, 1e-12);
+    EXPECT_NEAR(mann_whitney_min_p(4, 4), 2.0 / 70.0, 1e-12);
+    EXPECT_LT(mann_whitney_min_p(8, 8), 0.001);
+    EXPECT_LT(mann_whitney_min_p(30, 30), 1e-6);
+    EXPECT_DOUBLE_EQ(mann_whitney_min_p(0, 5), 1.0);
+}
+
+TEST_F(ResultsStoreTest, ComparisonFlagsRegressions) {
+    ResultsRun baseline, candidate;
+    baseline.series = {{"naive", 256, 1, {10.0, 10.1, 10.2, 9.9, 10.0}},
+                       {"blocked", 256, 1, {5.0, 5.1, 4.9, 5.0, 5.2}},
+                       {"transpose", 256, 1, {3.0, 3.1, 2.9, 3.0, 3.0}},
+                       {"only_in_baseline", 256, 1, {1.0}}};
+    candidate.series = {{"naive", 256, 1, {12.0, 12.2, 11.9, 12.1, 12.0}},   // 20% slower
+                        {"blocked", 256, 1, {5.0, 5.1, 5.0, 4.9, 5.1}},      // unchanged
+                        {"transpose", 256, 1, {2.0, 2.1, 1.9, 2.0, 2.0}}};  // faster
+
+    std::vector<ResultComparison> comparisons;
+    EXPECT_EQ(compare_results_runs(baseline, candidate, 0.05, 0.05, comparisons), 1);
+    ASSERT_EQ(comparisons.size(), 3u);
+    EXPECT_EQ(comparisons[0].verdict, COMPARE_SLOWER);
+    EXPECT_NEAR(comparisons[0].change, 0.2, 1e-9);
+    EXPECT_EQ(comparisons[1].verdict, COMPARE_SAME);
+    EXPECT_EQ(comparisons[2].verdict, COMPARE_FASTER);
+    EXPECT_NEAR(comparisons[0].min_p_value, 2.0 / 252.0, 1e-12);
+
+    // Above the threshold only counts if it is large enough
+    EXPECT_EQ(compare_results_runs(baseline, candidate, 0.25, 0.05, comparisons), 0);
+    EXPECT_EQ(std::string(compare_verdict_name(COMPARE_SLOWER)), "slower");
+}
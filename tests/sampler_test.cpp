@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "profiler.h"
+#include "sampler.h"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Busy for at least ms of this thread's CPU time; a named frame the
+// profile should show
+__attribute__((noinline)) double burn_cpu(double ms) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    volatile double x = 1.0;
+    do {
+        for (int i = 0; i < 10000; i++) x = x * 1.0000001 + 1e-9;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000.0 + (now.tv_nsec - start.tv_nsec) / 1e6 < ms);
+    return x;
+}
+
+class SamplerTest : public ::testing::Test {
+protected:
+    const char* filename = "sampler_test.folded";
+
+    void TearDown() override {
+        if (sampler_running()) sampler_stop();
+        sampler_clear();
+        std::remove(filename);
+    }
+
+    std::string read_folded() {
+        EXPECT_GT(sampler_write_folded(filename), 0);
+        std::ifstream in(filename);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(SamplerTest, StartAndStopOnce) {
+    EXPECT_EQ(sampler_start(-1, 0), -1);
+    EXPECT_EQ(sampler_stop(), -1);
+    ASSERT_EQ(sampler_start(0, 16), 0);
+    EXPECT_TRUE(sampler_running());
+    EXPECT_EQ(sampler_start(0, 0), -1);
+    burn_cpu(100.0);
+    int count = sampler_stop();
+    EXPECT_FALSE(sampler_running());
+    EXPECT_EQ(count, sampler_sample_count());
+    // 16 slots at ~1 kHz for 100 ms: the rest are dropped, not overwritten
+    EXPECT_LE(count, 16);
+    EXPECT_EQ(sampler_stop(), -1);
+}
+
+TEST_F(SamplerTest, AttributesSamplesToProfilerSections) {
+    Profiler profiler;
+    profiler_init(&profiler);
+    ASSERT_EQ(sampler_start(1000, 0), 0);
+    profiler_start(&profiler, "outer");
+    profiler_start(&profiler, "inner");
+    burn_cpu(200.0);
+    profiler_end(&profiler, "inner");
+    burn_cpu(100.0);
+    profiler_end(&profiler, "outer");
+    sampler_stop();
+
+    EXPECT_GT(sampler_scope_samples("inner"), 0);
+    EXPECT_GT(sampler_scope_samples("outer"), 0);
+    EXPECT_EQ(sampler_scope_samples("unknown"), 0);
+
+    // Scopes are the root frames, outermost first, then the call stack
+    std::string folded = read_folded();
+    EXPECT_NE(folded.find("[outer];[inner];"), std::string::npos);
+    EXPECT_NE(folded.find("burn_cpu"), std::string::npos);
+    EXPECT_NE(folded.find("AttributesSamplesToProfilerSections"), std::string::npos);
+    EXPECT_EQ(folded.find("on_sigprof"), std::string::npos);
+
+    // Every line is "frames count"
+    std::ifstream in(filename);
+    std::string line;
+    int total = 0;
+    while (std::getline(in, line)) {
+        size_t space = line.rfind(' ');
+        ASSERT_NE(space, std::string::npos);
+        total += std::stoi(line.substr(space + 1));
+    }
+    EXPECT_EQ(total, sampler_sample_count());
+}
+
+TEST_F(SamplerTest, SamplesWorkerThreads) {
+    Profiler profiler;
+    profiler_init(&profiler);
+    ASSERT_EQ(sampler_start(1000, 0), 0);
+    profiler_start(&profiler, "workers");
+    std::thread worker([]() { burn_cpu(200.0); });
+    worker.join();
+    profiler_end(&profiler, "workers");
+    sampler_stop();
+
+    EXPECT_GT(sampler_scope_samples("workers"), 0);
+    std::string folded = read_folded();
+    EXPECT_NE(folded.find("[workers];"), std::string::npos);
+    EXPECT_NE(folded.find("burn_cpu"), std::string::npos);
+}
+
+TEST_F(SamplerTest, RestartingAnActiveSectionDoesNotLeaveItOpen) {
+    Profiler profiler;
+    profiler_init(&profiler);
+    ASSERT_EQ(sampler_start(1000, 0), 0);
+    profiler_start(&profiler, "section");
+    profiler_start(&profiler, "section");  // ignored: already active
+    burn_cpu(50.0);
+    profiler_end(&profiler, "section");
+    burn_cpu(200.0);
+    sampler_stop();
+
+    // After the single end, samples fall outside every section
+    EXPECT_GT(sampler_scope_samples(nullptr), 0);
+    EXPECT_EQ(profiler.points[0].sample_count, 1);
+}
+
+TEST_F(SamplerTest, ScopesBeyondTheNameTableShareOneSlot) {
+    ASSERT_EQ(sampler_start(1000, 0), 0);
+    for (int i = 0; i < 200; i++) {
+        std::string name = "scope_" + std::to_string(i);
+        sampler_push_scope(name.c_str());
+        sampler_pop_scope(name.c_str());
+    }
+    sampler_push_scope("late");
+    burn_cpu(100.0);
+    sampler_pop_scope("late");
+    burn_cpu(100.0);
+    sampler_stop();
+
+    // Overflowing names still pop, so the stack returns to empty
+    EXPECT_GT(sampler_scope_samples("(other)"), 0);
+    EXPECT_GT(sampler_scope_samples(nullptr), 0);
+    EXPECT_NE(read_folded().find("[(other)];"), std::string::npos);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "scaling_sweep.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class ScalingSweepTest : public ::testing::Test {
+};
+
+TEST_F(ScalingSweepTest, DefaultThreadCountsCoverPowersAndCoreBoundary) {
+    EXPECT_EQ(sweep_default_thread_counts(1, 1), std::vector<int>({1}));
+    // 12 cores with SMT: powers of two, the last core, the first sibling, all threads
+    EXPECT_EQ(sweep_default_thread_counts(24, 12), std::vector<int>({1, 2, 4, 8, 12, 13, 16, 24}));
+    EXPECT_EQ(sweep_default_thread_counts(8, 8), std::vector<int>({1, 2, 4, 8}));
+}
+
+TEST_F(ScalingSweepTest, DefaultSizesBracketCacheCapacities) {
+    // Three n x n operands fill 32 KB at n ~ 37 and 1 MB at n ~ 209; the
+    // 16-multiples near 0.8x and 1.25x of each join the powers of two
+    std::vector<int> sizes = sweep_default_sizes(512, 32768, 1 << 20, 32 << 20);
+    EXPECT_EQ(sizes, std::vector<int>({32, 48, 64, 128, 160, 256, 512}));
+    for (int n : sizes) EXPECT_EQ(n % 16, 0);
+}
+
+TEST_F(ScalingSweepTest, WeakSizeKeepsWorkPerThread) {
+    EXPECT_EQ(sweep_weak_size(256, 1), 256);
+    EXPECT_EQ(sweep_weak_size(256, 8), 512);
+    EXPECT_EQ(sweep_weak_size(100, 2), 126);
+}
+
+TEST_F(ScalingSweepTest, SmallSweepWritesJsonLines) {
+    SweepConfig config;
+    config.kernels = {"blocked"};
+    config.threads = {1, 2};
+    config.sizes = {32};
+    config.weak_base_size = 16;
+    config.iterations = 1;
+    std::vector<SweepRecord> records;
+    ASSERT_EQ(run_scaling_sweep(config, records), 0);
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].scaling, "strong");
+    EXPECT_EQ(records[0].threads, 1);
+    EXPECT_EQ(records[3].scaling, "weak");
+    EXPECT_EQ(records[3].size, sweep_weak_size(16, 2));
+    for (const SweepRecord& r : records) {
+        EXPECT_GT(r.time_ms, 0.0);
+        EXPECT_NEAR(r.overhead_ms, r.time_ms - r.serial_ms / r.threads, 1e-12);
+    }
+
+    std::string path = ::testing::TempDir() + "/scaling_sweep.jsonl";
+    ASSERT_EQ(save_sweep_results(records, path.c_str()), 0);
+    std::ifstream file(path);
+    std::string line;
+    int lines = 0;
+    while (std::getline(file, line)) {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_EQ(line.back(), '}');
+        if (lines == 0) {
+            EXPECT_NE(line.find("\"record\":\"system\""), std::string::npos);
+        }
+        lines++;
+    }
+    EXPECT_EQ(lines, 5);
+    std::remove(path.c_str());
+
+    config.kernels = {"unknown"};
+    EXPECT_EQ(run_scaling_sweep(config, records), -1);
+}
+
+TEST_F(ScalingSweepTest, CacheSizeQueriesArePositive) {
+    EXPECT_GT(get_l2_cache_size(), 0);
+    EXPECT_GT(get_l3_cache_size(), 0);
+    EXPECT_GE(get_physical_core_count(), 1);
+}
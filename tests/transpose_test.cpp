@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "transpose.h"
+#include <vector>
+
+class TransposeTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        transpose_select_path(TRANSPOSE_PATH_AUTO);
+    }
+};
+
+static const TransposePath kPaths[] = {TRANSPOSE_PATH_PORTABLE, TRANSPOSE_PATH_AVX};
+
+static void fill_index(Matrix* m) {
+    for (int i = 0; i < m->rows * m->cols; i++) m->data[i] = static_cast<double>(i);
+}
+
+static void expect_transposed(Matrix* src, Matrix* dst) {
+    ASSERT_EQ(dst->rows, src->cols);
+    ASSERT_EQ(dst->cols, src->rows);
+    for (int i = 0; i < src->rows; i++) {
+        for (int j = 0; j < src->cols; j++) {
+            ASSERT_EQ(matrix_get(dst, j, i), matrix_get(src, i, j)) << i << "," << j;
+        }
+    }
+}
+
+TEST_F(TransposeTest, OutOfPlaceAllPathsAndShapes) {
+    const int shapes[][2] = {{1, 1}, {1, 7}, {5, 1}, {4, 4}, {33, 65}, {70, 31}, {64, 64}};
+    for (TransposePath path : kPaths) {
+        transpose_select_path(path);
+        for (const auto& shape : shapes) {
+            Matrix* src = matrix_create(shape[0], shape[1]);
+            Matrix* dst = matrix_create(shape[1], shape[0]);
+            fill_index(src);
+            ASSERT_EQ(matrix_transpose(src, dst), 0);
+            expect_transposed(src, dst);
+            matrix_free(src);
+            matrix_free(dst);
+        }
+    }
+}
+
+TEST_F(TransposeTest, OutOfPlaceRejectsWrongShape) {
+    Matrix* src = matrix_create(3, 5);
+    Matrix* dst = matrix_create(3, 5);
+    EXPECT_EQ(matrix_transpose(src, dst), -1);
+    EXPECT_EQ(matrix_transpose(src, src), -1);
+    EXPECT_EQ(matrix_transpose_parallel(src, dst, 2), -1);
+    matrix_free(src);
+    matrix_free(dst);
+}
+
+TEST_F(TransposeTest, LeadingDimensionsAreHonoured) {
+    const int rows = 6, cols = 9, ld_src = 11, ld_dst = 8;
+    std::vector<double> src(rows * ld_src, -1.0), dst(cols * ld_dst, -2.0);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) src[i * ld_src + j] = i * 100 + j;
+    }
+    transpose_out_of_place(src.data(), rows, cols, ld_src, dst.data(), ld_dst);
+    for (int j = 0; j < cols; j++) {
+        for (int i = 0; i < ld_dst; i++) {
+            EXPECT_EQ(dst[j * ld_dst + i], i < rows ? i * 100 + j : -2.0);
+        }
+    }
+}
+
+TEST_F(TransposeTest, InPlaceSquare) {
+    const int sizes[] = {2, 3, 4, 7, 32, 45, 96};
+    for (TransposePath path : kPaths) {
+        transpose_select_path(path);
+        for (int n : sizes) {
+            Matrix* ref = matrix_create(n, n);
+            Matrix* m = matrix_create(n, n);
+            fill_index(ref);
+            fill_index(m);
+            ASSERT_EQ(matrix_transpose_in_place(m), 0);
+            expect_transposed(ref, m);
+            matrix_free(ref);
+            matrix_free(m);
+        }
+    }
+}
+
+TEST_F(TransposeTest, InPlaceRectangularCycleFollowing) {
+    const int shapes[][2] = {{2, 3}, {3, 2}, {1, 9}, {7, 13}, {16, 40}, {64, 3}};
+    for (const auto& shape : shapes) {
+        Matrix* ref = matrix_create(shape[0], shape[1]);
+        Matrix* m = matrix_create(shape[0], shape[1]);
+        fill_index(ref);
+        fill_index(m);
+        ASSERT_EQ(matrix_transpose_in_place(m), 0);
+        expect_transposed(ref, m);
+
+        // Transposing back restores the original
+        ASSERT_EQ(matrix_transpose_in_place(m), 0);
+        ASSERT_EQ(m->rows, ref->rows);
+        for (int i = 0; i < m->rows * m->cols; i++) EXPECT_EQ(m->data[i], ref->data[i]);
+        matrix_free(ref);
+        matrix_free(m);
+    }
+}
+
+TEST_F(TransposeTest, ParallelMatchesSequential) {
+    Matrix* src = matrix_create(130, 77);
+    Matrix* dst = matrix_create(77, 130);
+    fill_index(src);
+    for (int threads = 0; threads <= 5; threads++) {
+        matrix_zeros(dst);
+        ASSERT_EQ(matrix_transpose_parallel(src, dst, threads), 0);
+        expect_transposed(src, dst);
+    }
+    matrix_free(src);
+    matrix_free(dst);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "concurrent_matrix.h"
+#include "matrix.h"
+#include "worker_timeline.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+class WorkerTimelineTest : public ::testing::Test {
+protected:
+    const char* filename = "worker_timeline_test.csv";
+
+    void TearDown() override {
+        worker_timeline_attach(nullptr);
+        std::remove(filename);
+    }
+
+    static WorkerSpan span(int phase, double spawn, double start, double end, long long items,
+                           bool caller = false) {
+        WorkerSpan s = {phase, caller, spawn, start, end, items};
+        return s;
+    }
+
+    static long long total_items(const WorkerTimeline& timeline, int phase) {
+        long long items = 0;
+        for (const WorkerSpan& s : timeline.spans) {
+            if (s.phase == phase) items += s.items;
+        }
+        return items;
+    }
+};
+
+TEST_F(WorkerTimelineTest, StatsSeparateSpawnImbalanceAndTail) {
+    WorkerTimeline timeline;
+    timeline.phases = 2;
+    // Phase 0: short, run partly on the launching thread
+    timeline.spans.push_back(span(0, 0.0, 0.5, 1.5, 10));
+    timeline.spans.push_back(span(0, 0.2, 0.2, 1.0, 10, true));
+    // Phase 1: the main phase, busy 4, 2 and 6 ms
+    timeline.spans.push_back(span(1, 2.0, 3.0, 7.0, 20));
+    timeline.spans.push_back(span(1, 2.0, 2.0, 4.0, 20));
+    timeline.spans.push_back(span(1, 2.0, 2.5, 8.5, 20));
+
+    WorkerTimelineStats stats = worker_timeline_stats(timeline);
+    EXPECT_EQ(stats.phases, 2);
+    EXPECT_EQ(stats.main_phase, 1);
+    EXPECT_EQ(stats.workers, 3);
+    // Spawned workers only: 0.5, 1.0, 0.0, 0.5
+    EXPECT_DOUBLE_EQ(stats.spawn_latency_ms, 0.5);
+    EXPECT_DOUBLE_EQ(stats.max_spawn_latency_ms, 1.0);
+    // 6 / mean(4, 2, 6)
+    EXPECT_DOUBLE_EQ(stats.imbalance, 1.5);
+    // (1.5 - 1.0) + (8.5 - 4.0)
+    EXPECT_DOUBLE_EQ(stats.idle_tail_ms, 5.0);
+
+    WorkerTimeline empty;
+    stats = worker_timeline_stats(empty);
+    EXPECT_EQ(stats.main_phase, -1);
+    EXPECT_EQ(stats.workers, 0);
+    EXPECT_DOUBLE_EQ(stats.imbalance, 0.0);
+}
+
+TEST_F(WorkerTimelineTest, KernelsRecordOnlyWhileAttached) {
+    // 8 doubles per row: one cache line, so every row boundary is aligned
+    Matrix* A = matrix_create(48, 8);
+    Matrix* B = matrix_create(8, 8);
+    Matrix* C = matrix_create(48, 8);
+    matrix_randomize(A);
+    matrix_randomize(B);
+
+    WorkerTimeline timeline;
+    worker_timeline_attach(&timeline);
+    EXPECT_EQ(worker_timeline_attached(), &timeline);
+
+    ASSERT_EQ(matrix_multiply_naive_parallel(A, B, C, 3), 0);
+    EXPECT_EQ(timeline.phases, 1);
+    ASSERT_EQ(timeline.spans.size(), 3u);
+    EXPECT_EQ(total_items(timeline, 0), 48);
+    for (const WorkerSpan& s : timeline.spans) {
+        EXPECT_FALSE(s.caller_thread);
+        EXPECT_LE(s.spawn_ms, s.start_ms);
+        EXPECT_LE(s.start_ms, s.end_ms);
+    }
+
+    // Transpose: packing B, then the multiplication
+    timeline.clear();
+    ASSERT_EQ(matrix_multiply_transpose_parallel(A, B, C, 2), 0);
+    EXPECT_EQ(timeline.phases, 2);
+    EXPECT_EQ(total_items(timeline, 1), 48);
+
+    timeline.clear();
+    ASSERT_EQ(matrix_multiply_blocked_concurrent(A, B, C, 16, 3), 0);
+    EXPECT_EQ(timeline.phases, 1);
+    EXPECT_EQ(timeline.spans.size(), 3u);
+    EXPECT_EQ(total_items(timeline, 0), 48);
+    EXPECT_EQ(worker_timeline_stats(timeline).workers, 3);
+
+    worker_timeline_attach(nullptr);
+    timeline.clear();
+    ASSERT_EQ(matrix_multiply_naive_concurrent(A, B, C, 3), 0);
+    EXPECT_TRUE(timeline.spans.empty());
+    EXPECT_EQ(timeline.phases, 0);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+}
+
+TEST_F(WorkerTimelineTest, BenchmarkCsvGainsWorkerColumns) {
+    // A file from before the worker columns
+    {
+        std::ofstream old(filename);
+        old << "method,sequential_ms,concurrent_ms,speedup,num_threads\n";
+        old << "Naive,19.388,8.881,2.183,2\n";
+    }
+
+    ConcurrentBenchmarkResult result;
+    result.method_name = "Blocked";
+    result.sequential_ms = 4.0;
+    result.concurrent_ms = 2.0;
+    result.speedup = 2.0;
+    result.num_threads = 2;
+    result.size = 64;
+    result.worker_stats = {2, 1, 0, 0.05, 0.08, 1.25, 0.5};
+    save_benchmark_results(std::vector<ConcurrentBenchmarkResult>(1, result), filename);
+
+    std::ifstream in(filename);
+    std::string header, old_row, new_row;
+    ASSERT_TRUE(std::getline(in, header));
+    ASSERT_TRUE(std::getline(in, old_row));
+    ASSERT_TRUE(std::getline(in, new_row));
+    EXPECT_EQ(header, "method,sequential_ms,concurrent_ms,speedup,num_threads,spawn_latency_ms,imbalance,idle_tail_ms");
+    EXPECT_EQ(old_row, "Naive,19.388,8.881,2.183,2,,,");
+    EXPECT_EQ(new_row, "Blocked,4.000,2.000,2.000,2,0.0500,1.250,0.500");
+}